@@ -0,0 +1,162 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "ucx_info.h"
+
+#include <ucs/datastruct/array.inl>
+#include <ucs/debug/assert.h>
+#include <ucs/debug/memtrack.h>
+#include <ucs/sys/string.h>
+#include <ucs/sys/math.h>
+#include <string.h>
+#include <errno.h>
+
+
+/* Protocol trace records with the same selection */
+typedef struct {
+    char     proto[64];
+    char     op[32];
+    char     mem_type[32];
+    size_t   size;
+    char     lanes[32];
+    unsigned count;        /* Number of records */
+    unsigned queued;       /* Records which were added to a pending queue */
+    unsigned errors;       /* Records which completed with an error */
+    unsigned num_send;     /* Records with a send time */
+    double   send_total;   /* Total time to first send, in nanoseconds */
+    double   send_max;     /* Maximal time to first send, in nanoseconds */
+    unsigned num_complete; /* Records with a completion time */
+    double   complete_total;
+    double   complete_max;
+} proto_trace_group_t;
+
+UCS_ARRAY_DEFINE_INLINE(proto_trace_groups, unsigned, proto_trace_group_t);
+
+
+static proto_trace_group_t *
+proto_trace_group_get(ucs_array_t(proto_trace_groups) *groups,
+                      const proto_trace_group_t *key)
+{
+    proto_trace_group_t *group;
+
+    ucs_array_for_each(group, groups) {
+        if (!strcmp(group->proto, key->proto) && !strcmp(group->op, key->op) &&
+            !strcmp(group->mem_type, key->mem_type) &&
+            (group->size == key->size) && !strcmp(group->lanes, key->lanes)) {
+            return group;
+        }
+    }
+
+    if (ucs_array_append(proto_trace_groups, groups) != UCS_OK) {
+        return NULL;
+    }
+
+    group = ucs_array_last(groups);
+    *group = *key;
+    return group;
+}
+
+static void proto_trace_group_add_time(const char *str, unsigned *count,
+                                       double *total, double *max)
+{
+    double value;
+
+    if (sscanf(str, "%lf", &value) != 1) {
+        return;
+    }
+
+    ++(*count);
+    *total += value;
+    *max    = ucs_max(*max, value);
+}
+
+static void proto_trace_print_time(unsigned count, double total, double max)
+{
+    if (count == 0) {
+        printf(" %10s %10s", "-", "-");
+    } else {
+        printf(" %10.2f %10.2f", total / count / 1000.0, max / 1000.0);
+    }
+}
+
+ucs_status_t print_proto_trace(const char *file_name)
+{
+    ucs_array_t(proto_trace_groups) groups = UCS_ARRAY_DYNAMIC_INITIALIZER;
+    char send_str[32], complete_str[32], queued[8], status[16];
+    char line[256], size_str[16];
+    proto_trace_group_t key, *group;
+    unsigned num_records;
+    FILE *file;
+
+    file = fopen(file_name, "r");
+    if (file == NULL) {
+        printf("<Failed to open '%s': %m>\n", file_name);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    num_records = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (line[0] == '#') {
+            continue;
+        }
+
+        memset(&key, 0, sizeof(key));
+        if (sscanf(line, "%63s %31s %31s %zu %31s %7s %15s %31s %31s",
+                   key.proto, key.op, key.mem_type, &key.size, key.lanes,
+                   queued, status, send_str, complete_str) != 9) {
+            continue;
+        }
+
+        group = proto_trace_group_get(&groups, &key);
+        if (group == NULL) {
+            printf("<Failed to allocate protocol trace summary>\n");
+            fclose(file);
+            ucs_array_cleanup_dynamic(&groups);
+            return UCS_ERR_NO_MEMORY;
+        }
+
+        ++num_records;
+        ++group->count;
+        group->queued += !strcmp(queued, "yes");
+        group->errors += !strcmp(status, "error");
+        proto_trace_group_add_time(send_str, &group->num_send,
+                                   &group->send_total, &group->send_max);
+        proto_trace_group_add_time(complete_str, &group->num_complete,
+                                   &group->complete_total,
+                                   &group->complete_max);
+    }
+
+    fclose(file);
+
+    printf("#\n");
+    printf("# Protocol trace of %u requests from %s\n", num_records,
+           file_name);
+    printf("# Time is in microseconds, from protocol selection\n");
+    printf("#\n");
+    printf("# %-20s %-14s %-8s %6s %-8s %7s %6s %6s %21s %21s\n", "", "",
+           "", "", "", "", "", "", "first send", "completion");
+    printf("# %-20s %-14s %-8s %6s %-8s %7s %6s %6s %10s %10s %10s %10s\n",
+           "protocol", "operation", "memory", "size", "lanes", "count",
+           "queued", "errors", "avg", "max", "avg", "max");
+    ucs_array_for_each(group, &groups) {
+        printf("  %-20s %-14s %-8s %6s %-8s %7u %6u %6u", group->proto,
+               group->op, group->mem_type,
+               ucs_memunits_to_str(group->size, size_str, sizeof(size_str)),
+               group->lanes, group->count, group->queued, group->errors);
+        proto_trace_print_time(group->num_send, group->send_total,
+                               group->send_max);
+        proto_trace_print_time(group->num_complete, group->complete_total,
+                               group->complete_max);
+        printf("\n");
+    }
+
+    ucs_array_cleanup_dynamic(&groups);
+    return UCS_OK;
+}
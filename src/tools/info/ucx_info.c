@@ -30,6 +30,8 @@ static void usage() {
     printf("  -c              Show UCX configuration\n");
     printf("  -a              Show also hidden configuration\n");
     printf("  -f              Display fully decorated output\n");
+    printf("  -T <file>       Summarize protocol trace records, read from the\n"
+           "                  \"proto_trace/records\" VFS file of a UCP worker\n");
     printf("\nUCP information (-u is required):\n");
     printf("  -p              Show UCP context information\n");
     printf("  -w              Show UCP worker information\n");
@@ -69,7 +71,7 @@ int main(int argc, char **argv)
     size_t ucp_num_eps;
     size_t ucp_num_ppn;
     unsigned print_opts;
-    char *tl_name, *mem_size;
+    char *tl_name, *mem_size, *proto_trace_file;
     const char *f;
     int c;
 
@@ -80,10 +82,11 @@ int main(int argc, char **argv)
     ucp_num_eps              = 1;
     ucp_num_ppn              = 1;
     mem_size                 = NULL;
+    proto_trace_file         = NULL;
     dev_type_bitmap          = UINT_MAX;
     ucp_ep_params.field_mask = 0;
 
-    while ((c = getopt(argc, argv, "fahvcydbswpet:n:u:D:m:N:A:")) != -1) {
+    while ((c = getopt(argc, argv, "fahvcydbswpet:n:u:D:m:N:A:T:")) != -1) {
         switch (c) {
         case 'f':
             print_flags |= UCS_CONFIG_PRINT_CONFIG | UCS_CONFIG_PRINT_HEADER | UCS_CONFIG_PRINT_DOC;
@@ -176,6 +179,10 @@ int main(int argc, char **argv)
         case 'A':
             ip_addr = optarg;
             break;
+        case 'T':
+            print_opts      |= PRINT_PROTO_TRACE;
+            proto_trace_file = optarg;
+            break;
         case 'h':
             usage();
             return 0;
@@ -206,6 +213,12 @@ int main(int argc, char **argv)
         print_type_info(tl_name);
     }
 
+    if (print_opts & PRINT_PROTO_TRACE) {
+        if (print_proto_trace(proto_trace_file) != UCS_OK) {
+            return -1;
+        }
+    }
+
     if ((print_opts & PRINT_DEVICES) || (print_flags & UCS_CONFIG_PRINT_CONFIG)) {
         /* if UCS_CONFIG_PRINT_CONFIG is ON, trigger loading UCT modules by
          * calling print_uct_info()->uct_component_query()
@@ -23,7 +23,8 @@ enum {
     PRINT_UCP_CONTEXT    = UCS_BIT(5),
     PRINT_UCP_WORKER     = UCS_BIT(6),
     PRINT_UCP_EP         = UCS_BIT(7),
-    PRINT_MEM_MAP        = UCS_BIT(8)
+    PRINT_MEM_MAP        = UCS_BIT(8),
+    PRINT_PROTO_TRACE    = UCS_BIT(9)
 };
 
 
@@ -38,6 +39,8 @@ void print_uct_info(int print_opts, ucs_config_print_flags_t print_flags,
 
 void print_type_info(const char * tl_name);
 
+ucs_status_t print_proto_trace(const char *file_name);
+
 ucs_status_t
 print_ucp_info(int print_opts, ucs_config_print_flags_t print_flags,
                uint64_t ctx_features, const ucp_ep_params_t *base_ep_params,
@@ -48,10 +48,23 @@ typedef enum {
                                             ucp_worker_wait_mem() */
     UCX_PERF_TEST_TYPE_STREAM_UNI,       /* Unidirectional stream */
     UCX_PERF_TEST_TYPE_STREAM_BI,        /* Bidirectional stream */
+    UCX_PERF_TEST_TYPE_RPC,              /* Requests answered on the reply
+                                            endpoint, with responses of
+                                            variable size */
     UCX_PERF_TEST_TYPE_LAST
 } ucx_perf_test_type_t;
 
 
+typedef enum {
+    UCX_PERF_SIZE_DIST_FIXED,            /* Always max_size */
+    UCX_PERF_SIZE_DIST_UNIFORM,          /* Uniform in [min_size, max_size] */
+    UCX_PERF_SIZE_DIST_LOGNORMAL,        /* exp(N(mu, sigma^2)), clamped to
+                                            [min_size, max_size] */
+    UCX_PERF_SIZE_DIST_TRACE,            /* Sizes from a trace, in order */
+    UCX_PERF_SIZE_DIST_LAST
+} ucx_perf_size_dist_t;
+
+
 typedef enum {
     UCP_PERF_DATATYPE_CONTIG,
     UCP_PERF_DATATYPE_IOV,
@@ -85,7 +98,12 @@ enum ucx_perf_test_flags {
     UCX_PERF_TEST_FLAG_VERBOSE          = UCS_BIT(7), /* Print error messages */
     UCX_PERF_TEST_FLAG_STREAM_RECV_DATA = UCS_BIT(8), /* For stream tests, use recv data API */
     UCX_PERF_TEST_FLAG_FLUSH_EP         = UCS_BIT(9), /* Issue flush on endpoint instead of worker */
-    UCX_PERF_TEST_FLAG_WAKEUP           = UCS_BIT(10) /* Create context with wakeup feature enabled */
+    UCX_PERF_TEST_FLAG_WAKEUP           = UCS_BIT(10), /* Create context with wakeup feature enabled */
+    UCX_PERF_TEST_FLAG_PERSISTENT       = UCS_BIT(11), /* For tag tests, send with persistent requests */
+    UCX_PERF_TEST_FLAG_RKEY_UNPACK      = UCS_BIT(12), /* For PUT/GET tests, unpack the remote key for
+                                                          every operation */
+    UCX_PERF_TEST_FLAG_SHARED_WORKER    = UCS_BIT(13)  /* For UCP tests, all threads use a single worker
+                                                          with UCS_THREAD_MODE_MULTI */
 };
 
 
@@ -94,6 +112,20 @@ enum {
 };
 
 
+/*
+ * Latency histogram geometry: values below UCX_PERF_HIST_SUB_BUCKETS are
+ * counted exactly, and every power-of-two range above is split into
+ * UCX_PERF_HIST_SUB_BUCKETS linear buckets, so the relative error of a bucket
+ * is bounded by 1/UCX_PERF_HIST_SUB_BUCKETS.
+ */
+#define UCX_PERF_HIST_SUB_BUCKETS_LOG        5
+#define UCX_PERF_HIST_SUB_BUCKETS            UCS_BIT(UCX_PERF_HIST_SUB_BUCKETS_LOG)
+#define UCX_PERF_HIST_NUM_BUCKETS            ((64 - UCX_PERF_HIST_SUB_BUCKETS_LOG + 1) * \
+                                              UCX_PERF_HIST_SUB_BUCKETS)
+
+
+#define UCX_PERF_CONFIG_NAME_MAX             64
+#define UCX_PERF_CONFIG_VALUE_MAX            64
 #define UCT_PERF_TEST_PARAMS_FMT             "%s/%s"
 #define UCT_PERF_TEST_PARAMS_ARG(_params)    (_params)->uct.tl_name, \
                                              (_params)->uct.dev_name
@@ -105,6 +137,44 @@ enum {
 typedef uint64_t ucx_perf_counter_t;
 
 
+/**
+ * Reported latency percentiles.
+ */
+typedef enum {
+    UCX_PERF_PERCENTILE_50,
+    UCX_PERF_PERCENTILE_90,
+    UCX_PERF_PERCENTILE_99,
+    UCX_PERF_PERCENTILE_99_9,
+    UCX_PERF_PERCENTILE_LAST
+} ucx_perf_percentile_t;
+
+
+/**
+ * Histogram of per-iteration latencies.
+ */
+typedef struct ucx_perf_histogram {
+    double                  unit;     /* Duration of one histogram unit, in seconds */
+    ucx_perf_counter_t      count;    /* Total number of samples */
+    uint64_t                max;      /* Largest sample, in histogram units */
+    ucx_perf_counter_t      buckets[UCX_PERF_HIST_NUM_BUCKETS];
+} ucx_perf_histogram_t;
+
+
+/**
+ * Result of the requests whose response size is in [min_size, max_size].
+ */
+typedef struct ucx_perf_size_class_result {
+    size_t                  min_size;
+    size_t                  max_size;
+    ucx_perf_counter_t      iters;    /* Number of completed requests */
+    ucx_perf_counter_t      bytes;    /* Total size of the responses */
+    double                  msgrate;  /* Completed requests per second */
+    double                  bandwidth; /* Response bytes per second */
+    double                  percentile[UCX_PERF_PERCENTILE_LAST];
+    double                  max_latency;
+} ucx_perf_size_class_result_t;
+
+
 /*
  * Performance test result.
  *
@@ -115,12 +185,28 @@ typedef struct ucx_perf_result {
     ucx_perf_counter_t      iters;
     double                  elapsed_time;
     ucx_perf_counter_t      bytes;
+    size_t                  msg_size;       /* Total size of a single message */
     struct {
         double              typical;
         double              moment_average; /* Average since last report */
         double              total_average;  /* Average of the whole test */
     }
     latency, bandwidth, msgrate;
+    /* Results of every thread of a multi-threaded test, valid only during the
+     * final report callback */
+    unsigned                num_threads;
+    const struct ucx_perf_result *thread_results;
+    struct {
+        double              percentile[UCX_PERF_PERCENTILE_LAST];
+        double              max;
+        /* Latency histogram of the whole test, aggregated over all processes
+         * for the final report. Valid only during the report callback. */
+        const ucx_perf_histogram_t *histogram;
+    } latency_dist;
+    /* Results by response size class of RPC tests, reported by the side which
+     * sends the requests. Valid only during the report callback. */
+    unsigned                num_size_classes;
+    const ucx_perf_size_class_result_t *size_classes;
 } ucx_perf_result_t;
 
 
@@ -175,6 +261,9 @@ typedef struct ucx_perf_params {
     ucx_perf_test_type_t   test_type;       /* Test communication type */
     ucs_thread_mode_t      thread_mode;     /* Thread mode for communication objects */
     unsigned               thread_count;    /* Number of threads in the test program */
+    const unsigned         *thread_cpus;    /* If not NULL, bind thread i to CPU
+                                               thread_cpus[i % thread_cpu_count] */
+    unsigned               thread_cpu_count; /* Number of entries in thread_cpus */
     ucs_async_mode_t       async_mode;      /* how async progress and locking is done */
     ucx_perf_wait_mode_t   wait_mode;       /* How to wait */
     ucs_memory_type_t      send_mem_type;   /* Send memory type */
@@ -195,6 +284,16 @@ typedef struct ucx_perf_params {
     double                 max_time;        /* Time limit (seconds), 0 - unlimited */
     double                 report_interval; /* Interval at which to call the report callback */
 
+    struct {
+        size_t                 max_size;    /* If nonzero, run the test for every
+                                               message size from msg_size_list[0]
+                                               up to max_size, reusing the
+                                               connections */
+        size_t                 step;        /* Size increment, 0 - multiply the
+                                               size by factor */
+        double                 factor;      /* Size multiplier */
+    } sweep;
+
     void                   *rte_group;      /* Opaque RTE group handle */
     ucx_perf_rte_t         *rte;            /* RTE functions used to exchange data */
     void                   *report_arg;     /* Custom argument for report function */
@@ -215,6 +314,23 @@ typedef struct ucx_perf_params {
         ucp_perf_datatype_t    recv_datatype;
         size_t                 am_hdr_size; /* UCP Active Message header size
                                                (not included in message size) */
+        unsigned               ep_count;    /* Number of endpoints of every thread,
+                                               used in round-robin. 0 means 1 */
+        struct {
+            ucx_perf_size_dist_t size_dist; /* Response size distribution */
+            size_t             min_size;    /* Smallest response size */
+            size_t             max_size;    /* Largest response size */
+            double             mu;          /* Lognormal distribution parameters */
+            double             sigma;
+            size_t             *trace;      /* Response sizes to replay, used
+                                               only by the requesting side */
+            size_t             trace_length; /* Number of entries in trace */
+        } rpc;                              /* RPC test parameters, the request
+                                               size is the message size */
+        char                   config_name[UCX_PERF_CONFIG_NAME_MAX];
+                                            /* If not empty, UCP configuration
+                                               variable to modify */
+        char                   config_value[UCX_PERF_CONFIG_VALUE_MAX];
     } ucp;
 
 } ucx_perf_params_t;
@@ -238,6 +354,14 @@ ucs_status_t ucx_perf_run(const ucx_perf_params_t *params,
                           ucx_perf_result_t *result);
 
 
+/**
+ * Get the range of values, in histogram units, counted by a latency histogram
+ * bucket.
+ */
+void ucx_perf_hist_bucket_range(unsigned index, uint64_t *min_p,
+                                uint64_t *max_p);
+
+
 END_C_DECLS
 
 #endif /* UCX_PERF_H_ */
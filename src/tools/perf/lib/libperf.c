@@ -15,6 +15,7 @@
 #include <ucs/arch/bitops.h>
 #include <ucs/sys/module.h>
 #include <ucs/sys/string.h>
+#include <ucs/sys/sys.h>
 #include <string.h>
 #include <tools/perf/lib/libperf_int.h>
 #include <unistd.h>
@@ -58,6 +59,16 @@ typedef struct {
     unsigned long      recv_buffer;
 } ucx_perf_ep_info_t;
 
+/* Latency histogram as exchanged between the processes of the test: the
+ * header is followed by the counters of buckets [first, first + length) */
+typedef struct {
+    double             unit;
+    ucx_perf_counter_t count;
+    uint64_t           max;
+    unsigned           first;
+    unsigned           length;
+} ucx_perf_hist_info_t;
+
 
 const ucx_perf_allocator_t* ucx_perf_mem_type_allocators[UCS_MEMORY_TYPE_LAST];
 
@@ -278,6 +289,26 @@ void ucx_perf_test_start_clock(ucx_perf_context_t *perf)
     perf->current.time_acc = perf->start_time_acc;
 }
 
+static double ucx_perf_latency_factor(const ucx_perf_context_t *perf)
+{
+    if ((perf->params.test_type == UCX_PERF_TEST_TYPE_PINGPONG) ||
+        (perf->params.test_type == UCX_PERF_TEST_TYPE_PINGPONG_WAIT_MEM)) {
+        return 2.0;
+    } else {
+        return 1.0;
+    }
+}
+
+static void ucx_perf_size_classes_reset(ucx_perf_context_t *perf)
+{
+    unsigned i;
+
+    for (i = 0; i < perf->num_size_classes; ++i) {
+        memset(&perf->size_classes[i], 0, sizeof(perf->size_classes[i]));
+        perf->size_classes[i].lat_hist.unit = ucs_time_to_sec(1);
+    }
+}
+
 /* Initialize/reset all parameters that could be modified by the warm-up run */
 static void ucx_perf_test_prepare_new_run(ucx_perf_context_t *perf,
                                           const ucx_perf_params_t *params)
@@ -299,6 +330,11 @@ static void ucx_perf_test_prepare_new_run(ucx_perf_context_t *perf,
     for (i = 0; i < TIMING_QUEUE_SIZE; ++i) {
         perf->timing_queue[i] = 0;
     }
+
+    memset(&perf->lat_hist, 0, sizeof(perf->lat_hist));
+    perf->lat_hist.unit = ucs_time_to_sec(1) / ucx_perf_latency_factor(perf);
+    ucx_perf_size_classes_reset(perf);
+
     ucx_perf_test_start_clock(perf);
 }
 
@@ -307,8 +343,22 @@ static void ucx_perf_test_init(ucx_perf_context_t *perf,
 {
     unsigned group_index;
 
-    perf->params = *params;
-    group_index  = rte_call(perf, group_index);
+    perf->params             = *params;
+    perf->num_size_classes   = 0;
+    perf->size_classes       = NULL;
+    perf->size_class_results = NULL;
+    group_index              = rte_call(perf, group_index);
+
+    if (params->sweep.max_size != 0) {
+        /* resources are set up for the largest message size, and every step
+         * of the sweep runs with its own size in sweep_msg_size */
+        perf->sweep_msg_size       = params->sweep.max_size;
+        perf->params.msg_size_list = &perf->sweep_msg_size;
+    }
+
+    if (perf->params.ucp.ep_count == 0) {
+        perf->params.ucp.ep_count = 1;
+    }
 
     if (0 == group_index) {
         perf->allocator = ucx_perf_mem_type_allocators[params->send_mem_type];
@@ -319,21 +369,201 @@ static void ucx_perf_test_init(ucx_perf_context_t *perf,
     ucx_perf_test_prepare_new_run(perf, params);
 }
 
-void ucx_perf_calc_result(ucx_perf_context_t *perf, ucx_perf_result_t *result)
+void ucx_perf_hist_bucket_range(unsigned index, uint64_t *min_p,
+                                uint64_t *max_p)
 {
-    ucs_time_t median;
-    double factor;
+    unsigned shift;
 
-    if ((perf->params.test_type == UCX_PERF_TEST_TYPE_PINGPONG) ||
-        (perf->params.test_type == UCX_PERF_TEST_TYPE_PINGPONG_WAIT_MEM)) {
-        factor = 2.0;
-    } else {
-        factor = 1.0;
+    if (index < UCX_PERF_HIST_SUB_BUCKETS) {
+        *min_p = *max_p = index;
+        return;
+    }
+
+    shift  = (index >> UCX_PERF_HIST_SUB_BUCKETS_LOG) - 1;
+    *min_p = (uint64_t)(index - (shift << UCX_PERF_HIST_SUB_BUCKETS_LOG)) <<
+             shift;
+    *max_p = *min_p + UCS_MASK(shift);
+}
+
+static void ucx_perf_hist_merge(ucx_perf_histogram_t *dst,
+                                const ucx_perf_hist_info_t *src_info,
+                                const ucx_perf_counter_t *src_buckets)
+{
+    uint64_t min, max;
+    double scale;
+    unsigned i;
+
+    if (src_info->unit == dst->unit) {
+        for (i = 0; i < src_info->length; ++i) {
+            dst->buckets[src_info->first + i] += src_buckets[i];
+        }
+        dst->count += src_info->count;
+        dst->max    = ucs_max(dst->max, src_info->max);
+        return;
+    }
+
+    /* Different time units, e.g processes on hosts with different clock
+     * frequency: re-bucket by the upper bound of every source bucket */
+    scale = src_info->unit / dst->unit;
+    for (i = 0; i < src_info->length; ++i) {
+        if (src_buckets[i] != 0) {
+            ucx_perf_hist_bucket_range(src_info->first + i, &min, &max);
+            ucx_perf_hist_add(dst,
+                              (uint64_t)(ucs_min(max, src_info->max) * scale),
+                              src_buckets[i]);
+        }
+    }
+}
+
+static void ucx_perf_hist_merge_local(ucx_perf_histogram_t *dst,
+                                      const ucx_perf_histogram_t *src)
+{
+    ucx_perf_hist_info_t info;
+
+    info.unit   = src->unit;
+    info.count  = src->count;
+    info.max    = src->max;
+    info.first  = 0;
+    info.length = UCX_PERF_HIST_NUM_BUCKETS;
+    ucx_perf_hist_merge(dst, &info, src->buckets);
+}
+
+/* Merge the latency histograms of all processes in the group */
+static void ucx_perf_exchange_latency_hist(ucx_perf_context_t *perf,
+                                           ucx_perf_histogram_t *hist)
+{
+    unsigned group_size  = rte_call(perf, group_size);
+    unsigned group_index = rte_call(perf, group_index);
+    ucx_perf_hist_info_t info, *remote_info;
+    struct iovec vec[2];
+    void *req = NULL;
+    size_t max_size;
+    unsigned i, last;
+    void *buffer;
+
+    max_size = sizeof(*remote_info) + sizeof(hist->buckets);
+    buffer   = malloc(max_size);
+    if (buffer == NULL) {
+        ucs_error("failed to allocate latency histogram buffer");
+        return;
+    }
+
+    /* send only the range of non-empty buckets */
+    info.unit  = hist->unit;
+    info.count = hist->count;
+    info.max   = hist->max;
+    info.first = 0;
+    last       = 0;
+    if (hist->count != 0) {
+        while (hist->buckets[info.first] == 0) {
+            ++info.first;
+        }
+        last = ucx_perf_hist_bucket_index(hist->max) + 1;
+    }
+    info.length = last - info.first;
+
+    vec[0].iov_base = &info;
+    vec[0].iov_len  = sizeof(info);
+    vec[1].iov_base = &hist->buckets[info.first];
+    vec[1].iov_len  = info.length * sizeof(hist->buckets[0]);
+
+    rte_call(perf, post_vec, vec, 2, &req);
+    rte_call(perf, exchange_vec, req);
+    for (i = 0; i < group_size; ++i) {
+        if (i == group_index) {
+            continue;
+        }
+
+        rte_call(perf, recv, i, buffer, max_size, req);
+        remote_info = buffer;
+        ucx_perf_hist_merge(hist, remote_info,
+                            UCS_PTR_TYPE_OFFSET(remote_info, *remote_info));
     }
 
+    free(buffer);
+}
+
+static void ucx_perf_hist_calc_percentiles(const ucx_perf_histogram_t *hist,
+                                           double *percentiles)
+{
+    static const double quantiles[] = {
+        [UCX_PERF_PERCENTILE_50]   = 0.5,
+        [UCX_PERF_PERCENTILE_90]   = 0.9,
+        [UCX_PERF_PERCENTILE_99]   = 0.99,
+        [UCX_PERF_PERCENTILE_99_9] = 0.999
+    };
+    ucx_perf_counter_t count;
+    uint64_t min, max;
+    unsigned i, index;
+    double rank;
+
+    count = 0;
+    index = 0;
+    for (i = 0; i < UCX_PERF_PERCENTILE_LAST; ++i) {
+        if (hist->count == 0) {
+            percentiles[i] = 0.0;
+            continue;
+        }
+
+        /* find the first bucket where the cumulative count reaches the rank */
+        rank = quantiles[i] * hist->count;
+        while ((count + hist->buckets[index]) < rank) {
+            count += hist->buckets[index];
+            ++index;
+        }
+
+        ucx_perf_hist_bucket_range(index, &min, &max);
+        percentiles[i] = ucs_min(max, hist->max) * hist->unit;
+    }
+}
+
+static void ucx_perf_calc_latency_dist(const ucx_perf_histogram_t *hist,
+                                       ucx_perf_result_t *result)
+{
+    result->latency_dist.histogram = hist;
+    result->latency_dist.max       = hist->max * hist->unit;
+    ucx_perf_hist_calc_percentiles(hist, result->latency_dist.percentile);
+}
+
+static void ucx_perf_calc_size_classes(const ucx_perf_context_t *perf,
+                                       ucx_perf_result_t *result)
+{
+    double elapsed = perf->current.time_acc - perf->start_time_acc;
+    const ucx_perf_size_class_t *size_class;
+    ucx_perf_size_class_result_t *class_result;
+    unsigned i;
+
+    result->num_size_classes = perf->num_size_classes;
+    result->size_classes     = perf->size_class_results;
+
+    for (i = 0; i < perf->num_size_classes; ++i) {
+        size_class   = &perf->size_classes[i];
+        class_result = &perf->size_class_results[i];
+
+        class_result->min_size    = (i == 0) ? 0 : UCS_BIT(i - 1);
+        class_result->max_size    = (i == 0) ? 0 : (UCS_BIT(i) - 1);
+        class_result->iters       = size_class->iters;
+        class_result->bytes       = size_class->bytes;
+        class_result->msgrate     = size_class->iters / elapsed;
+        class_result->bandwidth   = size_class->bytes / elapsed;
+        class_result->max_latency = size_class->lat_hist.max *
+                                    size_class->lat_hist.unit;
+        ucx_perf_hist_calc_percentiles(&size_class->lat_hist,
+                                       class_result->percentile);
+    }
+}
+
+void ucx_perf_calc_result(ucx_perf_context_t *perf, ucx_perf_result_t *result)
+{
+    double factor = ucx_perf_latency_factor(perf);
+    ucs_time_t median;
+
     result->iters = perf->current.iters;
     result->bytes = perf->current.bytes;
+    result->msg_size = ucx_perf_get_message_size(&perf->params);
     result->elapsed_time = perf->current.time_acc - perf->start_time_acc;
+    result->num_threads    = 0;
+    result->thread_results = NULL;
 
     /* Latency */
     median = __find_median_quick_select(perf->timing_queue, TIMING_QUEUE_SIZE);
@@ -375,6 +605,10 @@ void ucx_perf_calc_result(ucx_perf_context_t *perf, ucx_perf_result_t *result)
         perf->current.msgs /
         (perf->current.time_acc - perf->start_time_acc) * factor;
 
+    /* Latency distribution */
+    ucx_perf_calc_latency_dist(&perf->lat_hist, result);
+
+    ucx_perf_calc_size_classes(perf, result);
 }
 
 static ucs_status_t ucx_perf_test_check_params(ucx_perf_params_t *params)
@@ -416,6 +650,60 @@ static ucs_status_t ucx_perf_test_check_params(ucx_perf_params_t *params)
         return UCS_ERR_INVALID_PARAM;
     }
 
+    if ((params->flags & UCX_PERF_TEST_FLAG_RKEY_UNPACK) &&
+        ((params->api != UCX_PERF_API_UCP) ||
+         ((params->command != UCX_PERF_CMD_PUT) &&
+          (params->command != UCX_PERF_CMD_GET)))) {
+        if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+            ucs_error("Remote key unpack is supported only by UCP PUT and GET "
+                      "tests");
+        }
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    if ((params->flags & UCX_PERF_TEST_FLAG_SHARED_WORKER) &&
+        (params->api == UCX_PERF_API_UCP) &&
+        (params->command == UCX_PERF_CMD_AM) && (params->thread_count > 1)) {
+        if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+            ucs_error("Shared worker is not supported by multi-threaded UCP "
+                      "AM tests");
+        }
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    if (params->test_type == UCX_PERF_TEST_TYPE_RPC) {
+        if ((params->api != UCX_PERF_API_UCP) ||
+            (params->command != UCX_PERF_CMD_AM)) {
+            if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+                ucs_error("RPC test is supported only by UCP AM");
+            }
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        if (params->thread_count > 1) {
+            if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+                ucs_error("RPC test does not support multiple threads");
+            }
+            return UCS_ERR_UNSUPPORTED;
+        }
+
+        if ((params->ucp.send_datatype != UCP_PERF_DATATYPE_CONTIG) ||
+            (params->ucp.recv_datatype != UCP_PERF_DATATYPE_CONTIG)) {
+            if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+                ucs_error("RPC test supports only contiguous datatype");
+            }
+            return UCS_ERR_UNSUPPORTED;
+        }
+
+        if ((params->ucp.rpc.size_dist >= UCX_PERF_SIZE_DIST_LAST) ||
+            (params->ucp.rpc.min_size > params->ucp.rpc.max_size)) {
+            if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+                ucs_error("Invalid response size distribution");
+            }
+            return UCS_ERR_INVALID_PARAM;
+        }
+    }
+
     if (params->max_outstanding < 1) {
         if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
             ucs_error("max_outstanding, need to be at least 1");
@@ -1079,6 +1367,11 @@ static ucs_status_t ucp_perf_test_alloc_mem(ucx_perf_context_t *perf)
         buffer_size = ucx_perf_get_message_size(params);
     }
 
+    if (params->test_type == UCX_PERF_TEST_TYPE_RPC) {
+        /* The same buffers are used to send and receive responses */
+        buffer_size = ucs_max(buffer_size, params->ucp.rpc.max_size);
+    }
+
     /* Allocate send buffer memory */
     perf->send_buffer = NULL;
     status = perf->allocator->ucp_alloc(perf, buffer_size * params->thread_count,
@@ -1126,8 +1419,30 @@ static ucs_status_t ucp_perf_test_alloc_mem(ucx_perf_context_t *perf)
         goto err_free_send_iov_buffers;
     }
 
+    if (params->test_type == UCX_PERF_TEST_TYPE_RPC) {
+        perf->num_size_classes   =
+                ucx_perf_size_class_index(params->ucp.rpc.max_size) + 1;
+        perf->size_classes       = calloc(perf->num_size_classes,
+                                          sizeof(*perf->size_classes));
+        perf->size_class_results = calloc(perf->num_size_classes,
+                                          sizeof(*perf->size_class_results));
+        if ((perf->size_classes == NULL) ||
+            (perf->size_class_results == NULL)) {
+            goto err_free_size_classes;
+        }
+
+        ucx_perf_size_classes_reset(perf);
+    }
+
     return UCS_OK;
 
+err_free_size_classes:
+    free(perf->size_class_results);
+    free(perf->size_classes);
+    perf->num_size_classes   = 0;
+    perf->size_classes       = NULL;
+    perf->size_class_results = NULL;
+    free(perf->ucp.recv_iov);
 err_free_send_iov_buffers:
     free(perf->ucp.send_iov);
 err_free_am_hdr:
@@ -1142,6 +1457,8 @@ err:
 
 static void ucp_perf_test_free_mem(ucx_perf_context_t *perf)
 {
+    free(perf->size_class_results);
+    free(perf->size_classes);
     free(perf->ucp.recv_iov);
     free(perf->ucp.send_iov);
     free(perf->ucp.am_hdr);
@@ -1151,19 +1468,29 @@ static void ucp_perf_test_free_mem(ucx_perf_context_t *perf)
 
 static void ucp_perf_test_destroy_eps(ucx_perf_context_t* perf)
 {
-    unsigned i, thread_count = perf->params.thread_count;
+    unsigned i, j, thread_count = perf->params.thread_count;
     ucs_status_ptr_t    *req;
     ucs_status_t        status;
+    ucp_perf_ep_t       *eps;
 
     for (i = 0; i < thread_count; ++i) {
-        if (perf->ucp.tctx[i].perf.ucp.rkey != NULL) {
-            ucp_rkey_destroy(perf->ucp.tctx[i].perf.ucp.rkey);
+        free(perf->ucp.tctx[i].perf.ucp.rkey_buffer);
+
+        eps = perf->ucp.tctx[i].perf.ucp.eps;
+        if (eps == NULL) {
+            continue;
         }
 
-        if (perf->ucp.tctx[i].perf.ucp.ep != NULL) {
-            req = ucp_ep_close_nb(perf->ucp.tctx[i].perf.ucp.ep,
-                                  UCP_EP_CLOSE_MODE_FLUSH);
+        for (j = 0; j < perf->params.ucp.ep_count; ++j) {
+            if (eps[j].rkey != NULL) {
+                ucp_rkey_destroy(eps[j].rkey);
+            }
+
+            if (eps[j].ep == NULL) {
+                continue;
+            }
 
+            req = ucp_ep_close_nb(eps[j].ep, UCP_EP_CLOSE_MODE_FLUSH);
             if (UCS_PTR_IS_PTR(req)) {
                 do {
                     ucp_worker_progress(perf->ucp.tctx[i].perf.ucp.worker);
@@ -1173,10 +1500,14 @@ static void ucp_perf_test_destroy_eps(ucx_perf_context_t* perf)
                 ucp_request_release(req);
             } else if (UCS_PTR_STATUS(req) != UCS_OK) {
                 ucs_warn("failed to close ep %p on thread %d: %s\n",
-                         perf->ucp.tctx[i].perf.ucp.ep, i,
-                         ucs_status_string(UCS_PTR_STATUS(req)));
+                         eps[j].ep, i, ucs_status_string(UCS_PTR_STATUS(req)));
             }
         }
+
+        free(eps);
+        perf->ucp.tctx[i].perf.ucp.eps  = NULL;
+        perf->ucp.tctx[i].perf.ucp.ep   = NULL;
+        perf->ucp.tctx[i].perf.ucp.rkey = NULL;
     }
 }
 
@@ -1206,10 +1537,12 @@ static ucs_status_t ucp_perf_test_exchange_status(ucx_perf_context_t *perf,
 static ucs_status_t ucp_perf_test_receive_remote_data(ucx_perf_context_t *perf)
 {
     unsigned thread_count = perf->params.thread_count;
+    unsigned ep_count     = perf->params.ucp.ep_count;
     void *rkey_buffer     = NULL;
     void *req             = NULL;
-    unsigned group_size, group_index, i;
+    unsigned group_size, group_index, i, j;
     ucx_perf_ep_info_t *remote_info;
+    ucp_perf_ep_t *eps;
     ucp_ep_params_t ep_params;
     ucp_address_t *address;
     ucs_status_t status;
@@ -1236,8 +1569,10 @@ static ucs_status_t ucp_perf_test_receive_remote_data(ucx_perf_context_t *perf)
 
     /* Initialize all endpoints and rkeys to NULL to handle error flow */
     for (i = 0; i < thread_count; i++) {
-        perf->ucp.tctx[i].perf.ucp.ep   = NULL;
-        perf->ucp.tctx[i].perf.ucp.rkey = NULL;
+        perf->ucp.tctx[i].perf.ucp.ep          = NULL;
+        perf->ucp.tctx[i].perf.ucp.rkey        = NULL;
+        perf->ucp.tctx[i].perf.ucp.eps         = NULL;
+        perf->ucp.tctx[i].perf.ucp.rkey_buffer = NULL;
     }
 
     /* receive the data from the remote peer, extract the address from it
@@ -1251,29 +1586,60 @@ static ucs_status_t ucp_perf_test_receive_remote_data(ucx_perf_context_t *perf)
                                                                      remote_info->ucp.worker_addr_len);
         perf->ucp.tctx[i].perf.ucp.remote_addr = remote_info->recv_buffer;
 
+        eps = calloc(ep_count, sizeof(*eps));
+        if (eps == NULL) {
+            ucs_error("failed to allocate endpoints array");
+            status = UCS_ERR_NO_MEMORY;
+            goto err_free_eps_buffer;
+        }
+
+        perf->ucp.tctx[i].perf.ucp.eps = eps;
+
         ep_params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
         ep_params.address    = address;
 
-        status = ucp_ep_create(perf->ucp.tctx[i].perf.ucp.worker, &ep_params,
-                               &perf->ucp.tctx[i].perf.ucp.ep);
-        if (status != UCS_OK) {
-            if (perf->params.flags & UCX_PERF_TEST_FLAG_VERBOSE) {
-                ucs_error("ucp_ep_create() failed: %s", ucs_status_string(status));
+        /* all endpoints of the thread are connected to the same remote worker */
+        for (j = 0; j < ep_count; ++j) {
+            status = ucp_ep_create(perf->ucp.tctx[i].perf.ucp.worker,
+                                   &ep_params, &eps[j].ep);
+            if (status != UCS_OK) {
+                if (perf->params.flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+                    ucs_error("ucp_ep_create() failed: %s", ucs_status_string(status));
+                }
+                goto err_free_eps_buffer;
             }
-            goto err_free_eps_buffer;
-        }
 
-        if (remote_info->rkey_size > 0) {
-            status = ucp_ep_rkey_unpack(perf->ucp.tctx[i].perf.ucp.ep, rkey_buffer,
-                                        &perf->ucp.tctx[i].perf.ucp.rkey);
+            if (remote_info->rkey_size == 0) {
+                continue;
+            }
+
+            status = ucp_ep_rkey_unpack(eps[j].ep, rkey_buffer, &eps[j].rkey);
             if (status != UCS_OK) {
                 if (perf->params.flags & UCX_PERF_TEST_FLAG_VERBOSE) {
                     ucs_fatal("ucp_rkey_unpack() failed: %s", ucs_status_string(status));
                 }
                 goto err_free_eps_buffer;
             }
-        } else {
-            perf->ucp.tctx[i].perf.ucp.rkey = NULL;
+        }
+
+        perf->ucp.tctx[i].perf.ucp.ep   = eps[0].ep;
+        perf->ucp.tctx[i].perf.ucp.rkey = eps[0].rkey;
+
+        if (remote_info->rkey_size > 0) {
+
+            /* Keep the packed key to unpack it again for every operation */
+            if (perf->params.flags & UCX_PERF_TEST_FLAG_RKEY_UNPACK) {
+                perf->ucp.tctx[i].perf.ucp.rkey_buffer =
+                        malloc(remote_info->rkey_size);
+                if (perf->ucp.tctx[i].perf.ucp.rkey_buffer == NULL) {
+                    ucs_error("failed to allocate packed remote key buffer");
+                    status = UCS_ERR_NO_MEMORY;
+                    goto err_free_eps_buffer;
+                }
+
+                memcpy(perf->ucp.tctx[i].perf.ucp.rkey_buffer, rkey_buffer,
+                       remote_info->rkey_size);
+            }
         }
 
         remote_info = UCS_PTR_BYTE_OFFSET(remote_info,
@@ -1442,9 +1808,11 @@ static void ucp_perf_test_cleanup_endpoints(ucx_perf_context_t *perf)
 
 static void ucp_perf_test_destroy_workers(ucx_perf_context_t *perf)
 {
-    unsigned i;
+    unsigned i, num_workers;
 
-    for (i = 0; i < perf->params.thread_count; i++) {
+    num_workers = (perf->params.flags & UCX_PERF_TEST_FLAG_SHARED_WORKER) ?
+                  1 : perf->params.thread_count;
+    for (i = 0; i < num_workers; i++) {
         if (perf->ucp.tctx[i].perf.ucp.worker != NULL) {
             ucp_worker_destroy(perf->ucp.tctx[i].perf.ucp.worker);
         }
@@ -1459,6 +1827,50 @@ static void ucx_perf_set_warmup(ucx_perf_context_t* perf,
     perf->report_interval = ULONG_MAX;
 }
 
+static ucs_status_t
+ucx_perf_check_sweep_params(const ucx_perf_params_t *params)
+{
+    if (params->sweep.max_size == 0) {
+        return UCS_OK;
+    }
+
+    if ((params->api != UCX_PERF_API_UCP) || (params->thread_count > 1)) {
+        if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+            ucs_error("Message size sweep is supported only by single-threaded "
+                      "UCP tests");
+        }
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    if (params->msg_size_cnt != 1) {
+        if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+            ucs_error("Message size sweep requires a single message size");
+        }
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    if ((params->msg_size_list[0] > params->sweep.max_size) ||
+        ((params->sweep.step == 0) && (params->sweep.factor <= 1.0))) {
+        if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+            ucs_error("Invalid message size sweep from %zu to %zu",
+                      params->msg_size_list[0], params->sweep.max_size);
+        }
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    return UCS_OK;
+}
+
+static size_t ucx_perf_sweep_next_size(const ucx_perf_params_t *params,
+                                       size_t size)
+{
+    if (params->sweep.step != 0) {
+        return size + params->sweep.step;
+    }
+
+    return ucs_max((size_t)(size * params->sweep.factor), size + 1);
+}
+
 static ucs_status_t uct_perf_create_md(ucx_perf_context_t *perf)
 {
     uct_component_h *uct_components;
@@ -1554,11 +1966,7 @@ void uct_perf_barrier(ucx_perf_context_t *perf)
 void ucp_perf_barrier(ucx_perf_context_t *perf)
 {
     rte_call(perf, barrier, (void(*)(void*))ucp_worker_progress,
-#if _OPENMP
-             (void*)perf->ucp.tctx[omp_get_thread_num()].perf.ucp.worker);
-#else
-             (void*)perf->ucp.tctx[0].perf.ucp.worker);
-#endif
+             (void*)perf->ucp.tctx[ucx_perf_thread_index()].perf.ucp.worker);
 }
 
 static ucs_status_t uct_perf_setup(ucx_perf_context_t *perf)
@@ -1702,6 +2110,18 @@ static ucs_status_t ucp_perf_setup(ucx_perf_context_t *perf)
         goto err;
     }
 
+    if (perf->params.ucp.config_name[0] != '\0') {
+        status = ucp_config_modify(config, perf->params.ucp.config_name,
+                                   perf->params.ucp.config_value);
+        if (status != UCS_OK) {
+            ucs_error("failed to set UCP configuration %s=%s",
+                      perf->params.ucp.config_name,
+                      perf->params.ucp.config_value);
+            ucp_config_release(config);
+            goto err;
+        }
+    }
+
     status = ucp_init(&ucp_params, config, &perf->ucp.context);
     ucp_config_release(config);
     if (status != UCS_OK) {
@@ -1725,6 +2145,10 @@ static ucs_status_t ucp_perf_setup(ucx_perf_context_t *perf)
 
     worker_params.field_mask  = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
     worker_params.thread_mode = perf->params.thread_mode;
+    if ((perf->params.flags & UCX_PERF_TEST_FLAG_SHARED_WORKER) &&
+        (thread_count > 1)) {
+        worker_params.thread_mode = UCS_THREAD_MODE_MULTI;
+    }
 
     for (i = 0; i < thread_count; i++) {
         perf->ucp.tctx[i].tid              = i;
@@ -1735,6 +2159,12 @@ static ucs_status_t ucp_perf_setup(ucx_perf_context_t *perf)
         perf->ucp.tctx[i].perf.recv_buffer =
                         UCS_PTR_BYTE_OFFSET(perf->recv_buffer, i * message_size);
 
+        if ((perf->params.flags & UCX_PERF_TEST_FLAG_SHARED_WORKER) &&
+            (i > 0)) {
+            perf->ucp.tctx[i].perf.ucp.worker = perf->ucp.tctx[0].perf.ucp.worker;
+            continue;
+        }
+
         status = ucp_worker_create(perf->ucp.context, &worker_params,
                                    &perf->ucp.tctx[i].perf.ucp.worker);
         if (status != UCS_OK) {
@@ -1742,6 +2172,23 @@ static ucs_status_t ucp_perf_setup(ucx_perf_context_t *perf)
         }
     }
 
+    if ((perf->params.flags & UCX_PERF_TEST_FLAG_SHARED_WORKER) &&
+        (thread_count > 1)) {
+        worker_attr.field_mask = UCP_WORKER_ATTR_FIELD_THREAD_MODE;
+        status = ucp_worker_query(perf->ucp.tctx[0].perf.ucp.worker,
+                                  &worker_attr);
+        if (status != UCS_OK) {
+            goto err_free_tctx_destroy_workers;
+        }
+
+        if (worker_attr.thread_mode != UCS_THREAD_MODE_MULTI) {
+            ucs_error("Shared worker requires multi-threading support, which "
+                      "is not available");
+            status = UCS_ERR_UNSUPPORTED;
+            goto err_free_tctx_destroy_workers;
+        }
+    }
+
     if (perf->params.command == UCX_PERF_CMD_AM) {
         /* Check that requested AM header size is not larger than max supported. */
         worker_attr.field_mask = UCP_WORKER_ATTR_FIELD_MAX_AM_HEADER;
@@ -1805,6 +2252,56 @@ static struct {
 static ucs_status_t ucx_perf_thread_spawn(ucx_perf_context_t *perf,
                                           ucx_perf_result_t* result);
 
+static void ucx_perf_thread_set_affinity(const ucx_perf_context_t *perf,
+                                         unsigned thread_index)
+{
+    ucs_sys_cpuset_t cpuset;
+    unsigned cpu;
+
+    if (perf->params.thread_cpu_count == 0) {
+        return;
+    }
+
+    cpu = perf->params.thread_cpus[thread_index %
+                                   perf->params.thread_cpu_count];
+
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    if (ucs_sys_setaffinity(&cpuset) != 0) {
+        ucs_warn("failed to bind thread %u to cpu %u: %m", thread_index, cpu);
+    }
+}
+
+static ucs_status_t ucx_perf_run_single(ucx_perf_context_t *perf,
+                                        const ucx_perf_params_t *params,
+                                        ucx_perf_result_t *result)
+{
+    ucs_status_t status;
+
+    if (params->warmup_iter > 0) {
+        ucx_perf_set_warmup(perf, params);
+        status = ucx_perf_funcs[params->api].run(perf);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        ucx_perf_funcs[params->api].barrier(perf);
+    }
+
+    ucx_perf_test_prepare_new_run(perf, params);
+
+    /* Run test */
+    status = ucx_perf_funcs[params->api].run(perf);
+    ucx_perf_funcs[params->api].barrier(perf);
+    ucx_perf_exchange_latency_hist(perf, &perf->lat_hist);
+    if (status == UCS_OK) {
+        ucx_perf_calc_result(perf, result);
+        rte_call(perf, report, result, perf->params.report_arg, 1, 0);
+    }
+
+    return status;
+}
+
 ucs_status_t ucx_perf_run(const ucx_perf_params_t *params,
                           ucx_perf_result_t *result)
 {
@@ -1825,6 +2322,11 @@ ucs_status_t ucx_perf_run(const ucx_perf_params_t *params,
         goto out;
     }
 
+    status = ucx_perf_check_sweep_params(params);
+    if (status != UCS_OK) {
+        goto out;
+    }
+
     perf = malloc(sizeof(*perf));
     if (perf == NULL) {
         status = UCS_ERR_NO_MEMORY;
@@ -1865,25 +2367,25 @@ ucs_status_t ucx_perf_run(const ucx_perf_params_t *params,
             perf->ucp.ep          = perf->ucp.tctx[0].perf.ucp.ep;
             perf->ucp.remote_addr = perf->ucp.tctx[0].perf.ucp.remote_addr;
             perf->ucp.rkey        = perf->ucp.tctx[0].perf.ucp.rkey;
+            perf->ucp.eps         = perf->ucp.tctx[0].perf.ucp.eps;
+            perf->ucp.rkey_buffer = perf->ucp.tctx[0].perf.ucp.rkey_buffer;
         }
 
-        if (params->warmup_iter > 0) {
-            ucx_perf_set_warmup(perf, params);
-            status = ucx_perf_funcs[params->api].run(perf);
-            if (status != UCS_OK) {
-                goto out_cleanup;
-            }
-
-            ucx_perf_funcs[params->api].barrier(perf);
-            ucx_perf_test_prepare_new_run(perf, params);
-        }
+        ucx_perf_thread_set_affinity(perf, 0);
 
-        /* Run test */
-        status = ucx_perf_funcs[params->api].run(perf);
-        ucx_perf_funcs[params->api].barrier(perf);
-        if (status == UCS_OK) {
-            ucx_perf_calc_result(perf, result);
-            rte_call(perf, report, result, perf->params.report_arg, 1, 0);
+        if (params->sweep.max_size == 0) {
+            status = ucx_perf_run_single(perf, params, result);
+        } else {
+            /* every message size is warmed up and reported separately */
+            for (perf->sweep_msg_size = params->msg_size_list[0];
+                 perf->sweep_msg_size <= params->sweep.max_size;
+                 perf->sweep_msg_size = ucx_perf_sweep_next_size(
+                         params, perf->sweep_msg_size)) {
+                status = ucx_perf_run_single(perf, params, result);
+                if (status != UCS_OK) {
+                    break;
+                }
+            }
         }
     } else {
         status = ucx_perf_thread_spawn(perf, result);
@@ -1907,6 +2409,8 @@ static ucs_status_t ucx_perf_thread_run_test(void* arg)
     ucx_perf_params_t* params       = &perf->params;
     ucs_status_t status;
 
+    ucx_perf_thread_set_affinity(perf, tctx->tid);
+
     /* new threads need explicit device association */
     status = perf->allocator->init(perf);
     if (status != UCS_OK) {
@@ -1942,11 +2446,15 @@ static void ucx_perf_thread_report_aggregated_results(ucx_perf_context_t *perf)
     ucx_perf_thread_context_t* tctx = perf->ucp.tctx;  /* all the thread contexts on perf */
     unsigned i, thread_count        = perf->params.thread_count;
     double lat_sum_total_avegare    = 0.0;
+    ucx_perf_result_t *thread_results;
     ucx_perf_result_t agg_result;
 
-    agg_result.iters        = tctx[0].result.iters;
-    agg_result.bytes        = tctx[0].result.bytes;
-    agg_result.elapsed_time = tctx[0].result.elapsed_time;
+    agg_result.iters            = tctx[0].result.iters;
+    agg_result.bytes            = tctx[0].result.bytes;
+    agg_result.msg_size         = tctx[0].result.msg_size;
+    agg_result.elapsed_time     = tctx[0].result.elapsed_time;
+    agg_result.num_size_classes = 0;
+    agg_result.size_classes     = NULL;
 
     agg_result.bandwidth.total_average  = 0.0;
     agg_result.bandwidth.typical        = 0.0; /* Undefined since used only for latency calculations */
@@ -1976,7 +2484,27 @@ static void ucx_perf_thread_report_aggregated_results(ucx_perf_context_t *perf)
 
     agg_result.latency.total_average = lat_sum_total_avegare / thread_count;
 
+    /* latency distribution of all the iterations from all the threads */
+    for (i = 0; i < thread_count; i++) {
+        ucx_perf_hist_merge_local(&perf->lat_hist, &tctx[i].perf.lat_hist);
+    }
+    ucx_perf_exchange_latency_hist(perf, &perf->lat_hist);
+    ucx_perf_calc_latency_dist(&perf->lat_hist, &agg_result);
+
+    /* report also the result of every thread, to show the scaling */
+    thread_results = calloc(thread_count, sizeof(*thread_results));
+    if (thread_results != NULL) {
+        for (i = 0; i < thread_count; i++) {
+            thread_results[i] = tctx[i].result;
+        }
+        agg_result.num_threads = thread_count;
+    } else {
+        agg_result.num_threads = 0;
+    }
+    agg_result.thread_results = thread_results;
+
     rte_call(perf, report, &agg_result, perf->params.report_arg, 1, 1);
+    free(thread_results);
 }
 
 static ucs_status_t ucx_perf_thread_spawn(ucx_perf_context_t *perf,
@@ -33,7 +33,9 @@ BEGIN_C_DECLS
 typedef struct ucx_perf_context        ucx_perf_context_t;
 typedef struct uct_peer                uct_peer_t;
 typedef struct ucp_perf_request        ucp_perf_request_t;
+typedef struct ucp_perf_ep             ucp_perf_ep_t;
 typedef struct ucx_perf_thread_context ucx_perf_thread_context_t;
+typedef struct ucx_perf_size_class     ucx_perf_size_class_t;
 
 
 struct ucx_perf_allocator {
@@ -53,6 +55,13 @@ struct ucx_perf_allocator {
     void*        (*memset)(void *dst, int value, size_t count);
 };
 
+/* Statistics of the requests with responses of similar size */
+struct ucx_perf_size_class {
+    ucx_perf_counter_t           iters;
+    ucx_perf_counter_t           bytes;
+    ucx_perf_histogram_t         lat_hist;
+};
+
 struct ucx_perf_context {
     ucx_perf_params_t            params;
 
@@ -78,6 +87,16 @@ struct ucx_perf_context {
 
     ucs_time_t                   timing_queue[TIMING_QUEUE_SIZE];
     unsigned                     timing_queue_head;
+    ucx_perf_histogram_t         lat_hist;        /* latency of all iterations */
+
+    /* Response size classes of RPC tests, class 0 is for empty responses and
+     * class i > 0 is for sizes in [2^(i-1), 2^i - 1] */
+    unsigned                     num_size_classes;
+    ucx_perf_size_class_t        *size_classes;
+    ucx_perf_size_class_result_t *size_class_results;
+
+    /* Message size of the current step of a message size sweep */
+    size_t                       sweep_msg_size;
     const ucx_perf_allocator_t   *allocator;
 
     union {
@@ -97,8 +116,10 @@ struct ucx_perf_context {
             ucp_context_h              context;
             ucx_perf_thread_context_t* tctx;
             ucp_worker_h               worker;
-            ucp_ep_h                   ep;
-            ucp_rkey_h                 rkey;
+            ucp_ep_h                   ep;          /* First endpoint */
+            ucp_rkey_h                 rkey;        /* Remote key of 'ep' */
+            ucp_perf_ep_t              *eps;        /* All endpoints of the thread */
+            void                       *rkey_buffer; /* Packed remote key */
             unsigned long              remote_addr;
             ucp_mem_h                  send_memh;
             ucp_mem_h                  recv_memh;
@@ -131,6 +152,12 @@ struct ucp_perf_request {
 };
 
 
+struct ucp_perf_ep {
+    ucp_ep_h                     ep;
+    ucp_rkey_h                   rkey;
+};
+
+
 #define UCX_PERF_TEST_FOREACH(perf) \
     while (!ucx_perf_context_done(perf))
 
@@ -169,6 +196,16 @@ static UCS_F_ALWAYS_INLINE int ucx_perf_context_done(ucx_perf_context_t *perf)
 }
 
 
+static inline unsigned ucx_perf_thread_index(void)
+{
+#if _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+
 static inline void ucx_perf_get_time(ucx_perf_context_t *perf)
 {
     perf->current.time_acc = ucs_get_accurate_time();
@@ -183,23 +220,59 @@ static inline void ucx_perf_omp_barrier(ucx_perf_context_t *perf)
 #endif
 }
 
-static inline void ucx_perf_update(ucx_perf_context_t *perf,
-                                   ucx_perf_counter_t iters, size_t bytes)
+static UCS_F_ALWAYS_INLINE unsigned ucx_perf_hist_bucket_index(uint64_t value)
+{
+    unsigned shift;
+
+    if (value < UCX_PERF_HIST_SUB_BUCKETS) {
+        return value;
+    }
+
+    shift = ucs_ilog2(value) - UCX_PERF_HIST_SUB_BUCKETS_LOG;
+    return (shift << UCX_PERF_HIST_SUB_BUCKETS_LOG) + (value >> shift);
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucx_perf_hist_add(ucx_perf_histogram_t *hist, uint64_t value,
+                  ucx_perf_counter_t count)
+{
+    hist->buckets[ucx_perf_hist_bucket_index(value)] += count;
+    hist->count                                      += count;
+    hist->max                                         = ucs_max(hist->max,
+                                                                value);
+}
+
+static UCS_F_ALWAYS_INLINE unsigned ucx_perf_size_class_index(size_t size)
+{
+    return (size == 0) ? 0 : (ucs_ilog2(size) + 1);
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucx_perf_size_class_update(ucx_perf_context_t *perf, size_t size,
+                           ucs_time_t latency)
+{
+    ucx_perf_size_class_t *size_class =
+            &perf->size_classes[ucx_perf_size_class_index(size)];
+
+    ++size_class->iters;
+    size_class->bytes += size;
+    ucx_perf_hist_add(&size_class->lat_hist, latency, 1);
+}
+
+/*
+ * Account for completed iterations without taking a latency sample.
+ * perf->current.time must be updated by the caller.
+ */
+static inline void ucx_perf_update_counters(ucx_perf_context_t *perf,
+                                            ucx_perf_counter_t iters,
+                                            size_t bytes)
 {
     ucx_perf_result_t result;
 
-    perf->current.time   = ucs_get_time();
     perf->current.iters += iters;
     perf->current.bytes += bytes;
     perf->current.msgs  += 1;
 
-    perf->timing_queue[perf->timing_queue_head] =
-                    perf->current.time - perf->prev_time;
-    ++perf->timing_queue_head;
-    if (perf->timing_queue_head == TIMING_QUEUE_SIZE) {
-        perf->timing_queue_head = 0;
-    }
-
     perf->prev_time = perf->current.time;
 
     if (perf->current.time - perf->prev.time >= perf->report_interval) {
@@ -212,6 +285,35 @@ static inline void ucx_perf_update(ucx_perf_context_t *perf,
     }
 }
 
+/*
+ * Account for completed iterations, the time since start_time is a latency
+ * sample.
+ */
+static inline void ucx_perf_update_latency(ucx_perf_context_t *perf,
+                                           ucx_perf_counter_t iters,
+                                           size_t bytes, ucs_time_t start_time)
+{
+    ucs_time_t latency;
+
+    perf->current.time = ucs_get_time();
+    latency            = perf->current.time - start_time;
+
+    perf->timing_queue[perf->timing_queue_head] = latency;
+    ucx_perf_hist_add(&perf->lat_hist, latency, 1);
+    ++perf->timing_queue_head;
+    if (perf->timing_queue_head == TIMING_QUEUE_SIZE) {
+        perf->timing_queue_head = 0;
+    }
+
+    ucx_perf_update_counters(perf, iters, bytes);
+}
+
+static inline void ucx_perf_update(ucx_perf_context_t *perf,
+                                   ucx_perf_counter_t iters, size_t bytes)
+{
+    ucx_perf_update_latency(perf, iters, bytes, perf->prev_time);
+}
+
 
 /**
  * Get the total length of the message size given by parameters
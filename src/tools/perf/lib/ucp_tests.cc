@@ -23,41 +23,114 @@
 template <ucx_perf_cmd_t CMD, ucx_perf_test_type_t TYPE, unsigned FLAGS>
 class ucp_perf_test_runner {
 public:
-    static const unsigned AM_ID     = 1;
+    static const unsigned AM_ID           = 1;
+    static const unsigned AM_RPC_REPLY_ID = 2;
     static const ucp_tag_t TAG      = 0x1337a880u;
     static const ucp_tag_t TAG_MASK = (FLAGS & UCX_PERF_TEST_FLAG_TAG_WILDCARD) ?
                                       0 : (ucp_tag_t)-1;
 
     typedef uint8_t psn_t;
 
+    enum {
+        RPC_FLAG_STOP = UCS_BIT(0) /* No more requests, not replied */
+    };
+
+    typedef struct {
+        uint32_t id;        /* Request slot on the requesting side */
+        uint32_t flags;
+        uint64_t resp_size; /* Requested response size */
+    } rpc_hdr_t;
+
+    /* RPC request, indexed by its slot on the requesting side */
+    typedef struct {
+        ucp_perf_test_runner *test;
+        rpc_hdr_t            hdr;        /* Request or reply header, must be
+                                            valid until the send completes */
+        ucs_time_t           start_time; /* Requester: time of sending */
+        ucp_ep_h             reply_ep;   /* Responder: endpoint to reply on */
+        bool                 ready;      /* Responder: request data arrived */
+    } rpc_op_t;
+
     ucp_perf_test_runner(ucx_perf_context_t &perf)
         : m_perf(perf),
           m_outstanding(0),
           m_max_outstanding(m_perf.params.max_outstanding),
+          m_tag(TAG + ucx_perf_thread_index()),
           m_am_rx_buffer(NULL),
-          m_am_rx_length(0ul)
-
+          m_am_rx_length(0ul),
+          m_persist_reqs(NULL),
+          m_persist_count(0),
+          m_persist_free(0),
+          m_rpc_ops(NULL),
+          m_rpc_ids(NULL),
+          m_rpc_ids_head(0),
+          m_rpc_ids_count(0),
+          m_rpc_req_length(0),
+          m_rpc_stop(false),
+          m_rpc_seed(0x9e3779b97f4a7c15ull),
+          m_rpc_trace_index(0)
     {
         memset(&m_am_rx_params, 0, sizeof(m_am_rx_params));
 
         ucs_assert_always(m_max_outstanding > 0);
 
-        set_am_handler(am_data_handler, this, UCP_AM_FLAG_WHOLE_MSG);
+        if ((CMD == UCX_PERF_CMD_TAG) &&
+            (m_perf.params.flags & UCX_PERF_TEST_FLAG_PERSISTENT)) {
+            m_persist_reqs = (void**)ucs_calloc(m_max_outstanding,
+                                               sizeof(*m_persist_reqs),
+                                               "perf_persist_reqs");
+            ucs_assert_always(m_persist_reqs != NULL);
+        }
+
+        if (TYPE == UCX_PERF_TEST_TYPE_RPC) {
+            m_rpc_ops = (rpc_op_t*)ucs_calloc(m_max_outstanding,
+                                              sizeof(*m_rpc_ops),
+                                              "perf_rpc_ops");
+            m_rpc_ids = (unsigned*)ucs_calloc(m_max_outstanding,
+                                              sizeof(*m_rpc_ids),
+                                              "perf_rpc_ids");
+            ucs_assert_always((m_rpc_ops != NULL) && (m_rpc_ids != NULL));
+            for (unsigned i = 0; i < m_max_outstanding; ++i) {
+                m_rpc_ops[i].test = this;
+            }
+
+            set_am_handler(AM_ID, am_rpc_request_handler, this,
+                           UCP_AM_FLAG_WHOLE_MSG);
+            set_am_handler(AM_RPC_REPLY_ID, am_rpc_reply_handler, this,
+                           UCP_AM_FLAG_WHOLE_MSG);
+        } else {
+            set_am_handler(AM_ID, am_data_handler, this,
+                           UCP_AM_FLAG_WHOLE_MSG);
+        }
     }
 
     ~ucp_perf_test_runner()
     {
-        set_am_handler(NULL, this, 0);
+        /* All persistent requests are inactive after the test is done */
+        ucs_assert(m_persist_free == m_persist_count);
+        for (unsigned i = 0; i < m_persist_free; ++i) {
+            ucp_request_free(m_persist_reqs[i]);
+        }
+        ucs_free(m_persist_reqs);
+
+        set_am_handler(AM_ID, NULL, this, 0);
+        if (TYPE == UCX_PERF_TEST_TYPE_RPC) {
+            set_am_handler(AM_RPC_REPLY_ID, NULL, this, 0);
+        }
+
+        ucs_free(m_rpc_ids);
+        ucs_free(m_rpc_ops);
     }
 
-    void set_am_handler(ucp_am_recv_callback_t cb, void *arg, unsigned flags)
+    void set_am_handler(unsigned am_id, ucp_am_recv_callback_t cb, void *arg,
+                        unsigned flags)
     {
         if (CMD == UCX_PERF_CMD_AM) {
             ucp_am_handler_param_t param;
             param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
                                UCP_AM_HANDLER_PARAM_FIELD_CB |
                                UCP_AM_HANDLER_PARAM_FIELD_ARG;
-            param.id         = AM_ID;
+            param.id         = am_id;
             param.cb         = cb;
             param.arg        = arg;
 
@@ -230,6 +303,54 @@ public:
         send_cb(request, status);
     }
 
+    static void persist_send_cb(void *request, ucs_status_t status,
+                                void *user_data)
+    {
+        ucp_perf_test_runner *test = (ucp_perf_test_runner*)user_data;
+
+        test->op_completed();
+        test->m_persist_reqs[test->m_persist_free++] = request;
+    }
+
+    ucs_status_t UCS_F_ALWAYS_INLINE
+    send_persistent(ucp_ep_h ep, void *buffer, unsigned length,
+                    ucp_datatype_t datatype)
+    {
+        ucp_request_param_t param;
+        ucs_status_t status;
+        void *request;
+
+        /* Create a new persistent request only if all are in progress */
+        if (ucs_unlikely(m_persist_free == 0)) {
+            param.op_attr_mask = UCP_OP_ATTR_FIELD_DATATYPE |
+                                 UCP_OP_ATTR_FIELD_CALLBACK |
+                                 UCP_OP_ATTR_FIELD_USER_DATA;
+            param.datatype     = datatype;
+            param.cb.send      = persist_send_cb;
+            param.user_data    = this;
+            request            = ucp_tag_send_init_nbx(ep, buffer, length, m_tag,
+                                                       &param);
+            if (UCS_PTR_IS_ERR(request)) {
+                return UCS_PTR_STATUS(request);
+            }
+
+            ucs_assert(m_persist_count < m_max_outstanding);
+            ++m_persist_count;
+        } else {
+            request = m_persist_reqs[--m_persist_free];
+        }
+
+        /* The callback may be called from ucp_request_start() */
+        op_started();
+        status = ucp_request_start(request);
+        if (ucs_unlikely(status != UCS_OK)) {
+            op_completed();
+            m_persist_reqs[m_persist_free++] = request;
+        }
+
+        return status;
+    }
+
     static void tag_recv_cb(void *request, ucs_status_t status,
                             ucp_tag_recv_info_t *info)
     {
@@ -270,6 +391,240 @@ public:
         return UCS_OK;
     }
 
+    ucs_status_t rpc_rndv_recv(void *data, size_t length, rpc_op_t *op,
+                               ucp_am_recv_data_nbx_callback_t cb)
+    {
+        ucp_request_param_t param;
+        ucs_status_ptr_t sp;
+
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
+                             UCP_OP_ATTR_FIELD_USER_DATA |
+                             UCP_OP_ATTR_FIELD_DATATYPE |
+                             UCP_OP_ATTR_FLAG_NO_IMM_CMPL;
+        param.datatype     = ucp_dt_make_contig(1);
+        param.cb.recv_am   = cb;
+        param.user_data    = op;
+
+        sp = ucp_am_recv_data_nbx(m_perf.ucp.worker, data, m_perf.recv_buffer,
+                                  length, &param);
+        ucs_assert(UCS_PTR_IS_PTR(sp));
+        ucp_request_release(sp);
+
+        return UCS_INPROGRESS;
+    }
+
+    static void am_rpc_request_recv_cb(void *request, ucs_status_t status,
+                                       size_t length, void *user_data)
+    {
+        rpc_op_t *op = (rpc_op_t*)user_data;
+
+        op->ready = true;
+    }
+
+    /* Responder side: queue the request, it is replied from the test loop
+     * once its data has arrived */
+    static ucs_status_t
+    am_rpc_request_handler(void *arg, const void *header, size_t header_length,
+                           void *data, size_t length,
+                           const ucp_am_recv_param_t *param)
+    {
+        ucp_perf_test_runner *test = (ucp_perf_test_runner*)arg;
+        const rpc_hdr_t *hdr       = (const rpc_hdr_t*)header;
+        rpc_op_t *op;
+        unsigned tail;
+
+        ucs_assert(header_length == sizeof(*hdr));
+        if (hdr->flags & RPC_FLAG_STOP) {
+            test->m_rpc_stop = true;
+            return UCS_OK;
+        }
+
+        ucs_assert(param->recv_attr & UCP_AM_RECV_ATTR_FIELD_REPLY_EP);
+        ucs_assert(hdr->id < test->m_max_outstanding);
+        ucs_assert(test->m_rpc_ids_count < test->m_max_outstanding);
+
+        op           = &test->m_rpc_ops[hdr->id];
+        op->hdr      = *hdr;
+        op->reply_ep = param->reply_ep;
+        op->ready    = !(param->recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV);
+
+        tail = (test->m_rpc_ids_head + test->m_rpc_ids_count) %
+               test->m_max_outstanding;
+        test->m_rpc_ids[tail] = hdr->id;
+        ++test->m_rpc_ids_count;
+
+        if (!op->ready) {
+            return test->rpc_rndv_recv(data, length, op,
+                                       am_rpc_request_recv_cb);
+        }
+
+        return UCS_OK;
+    }
+
+    static void am_rpc_reply_recv_cb(void *request, ucs_status_t status,
+                                     size_t length, void *user_data)
+    {
+        rpc_op_t *op = (rpc_op_t*)user_data;
+
+        op->test->rpc_completed(op);
+    }
+
+    /* Requester side: the response of a request has arrived */
+    static ucs_status_t
+    am_rpc_reply_handler(void *arg, const void *header, size_t header_length,
+                         void *data, size_t length,
+                         const ucp_am_recv_param_t *param)
+    {
+        ucp_perf_test_runner *test = (ucp_perf_test_runner*)arg;
+        const rpc_hdr_t *hdr       = (const rpc_hdr_t*)header;
+        rpc_op_t *op;
+
+        ucs_assert(header_length == sizeof(*hdr));
+        ucs_assert(hdr->id < test->m_max_outstanding);
+
+        op = &test->m_rpc_ops[hdr->id];
+        if (param->recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV) {
+            return test->rpc_rndv_recv(data, length, op,
+                                       am_rpc_reply_recv_cb);
+        }
+
+        test->rpc_completed(op);
+        return UCS_OK;
+    }
+
+    void rpc_completed(rpc_op_t *op)
+    {
+        ucx_perf_update_latency(&m_perf, 1,
+                                m_rpc_req_length + op->hdr.resp_size,
+                                op->start_time);
+        ucx_perf_size_class_update(&m_perf, op->hdr.resp_size,
+                                   m_perf.current.time - op->start_time);
+
+        m_rpc_ids[m_rpc_ids_count++] = op - m_rpc_ops;
+        op_completed();
+    }
+
+    /* xorshift64*, with a constant seed so every run uses the same sizes */
+    uint64_t rpc_rand()
+    {
+        m_rpc_seed ^= m_rpc_seed >> 12;
+        m_rpc_seed ^= m_rpc_seed << 25;
+        m_rpc_seed ^= m_rpc_seed >> 27;
+        return m_rpc_seed * 0x2545f4914f6cdd1dull;
+    }
+
+    /* Uniform in (0, 1] */
+    double rpc_rand_double()
+    {
+        return ((rpc_rand() >> 11) + 1) / (double)UCS_BIT(53);
+    }
+
+    /* Standard normal, by Box-Muller transform */
+    double rpc_rand_normal()
+    {
+        double u1 = rpc_rand_double();
+        double u2 = rpc_rand_double();
+
+        return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+    }
+
+    size_t rpc_response_size()
+    {
+        const ucx_perf_params_t *params = &m_perf.params;
+        size_t min_size                 = params->ucp.rpc.min_size;
+        size_t max_size                 = params->ucp.rpc.max_size;
+        size_t trace_size;
+        double size;
+
+        switch (params->ucp.rpc.size_dist) {
+        case UCX_PERF_SIZE_DIST_UNIFORM:
+            return min_size + (rpc_rand() % (max_size - min_size + 1));
+        case UCX_PERF_SIZE_DIST_LOGNORMAL:
+            size = exp(params->ucp.rpc.mu +
+                       (params->ucp.rpc.sigma * rpc_rand_normal()));
+            return ucs_min(ucs_max(size, (double)min_size), (double)max_size);
+        case UCX_PERF_SIZE_DIST_TRACE:
+            ucs_assert(params->ucp.rpc.trace_length > 0);
+            trace_size = params->ucp.rpc.trace[m_rpc_trace_index];
+            if (++m_rpc_trace_index == params->ucp.rpc.trace_length) {
+                m_rpc_trace_index = 0;
+            }
+            return ucs_min(trace_size, max_size);
+        case UCX_PERF_SIZE_DIST_FIXED:
+        default:
+            return max_size;
+        }
+    }
+
+    /* The header must be valid until the send is completed */
+    ucs_status_t UCS_F_ALWAYS_INLINE
+    rpc_send(ucp_ep_h ep, unsigned am_id, uint32_t flags, const rpc_hdr_t *hdr,
+             void *buffer, size_t length)
+    {
+        ucp_request_param_t param;
+        void *request;
+
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_DATATYPE |
+                             UCP_OP_ATTR_FIELD_FLAGS;
+        param.datatype     = ucp_dt_make_contig(1);
+        param.flags        = flags;
+        request            = ucp_am_send_nbx(ep, am_id, hdr, sizeof(*hdr),
+                                             buffer, length, &param);
+        if (ucs_likely(!UCS_PTR_IS_PTR(request))) {
+            return UCS_PTR_STATUS(request);
+        }
+
+        /* completion is tracked by the response, or by the final flush */
+        ucp_request_free(request);
+        return UCS_OK;
+    }
+
+    ucs_status_t UCS_F_ALWAYS_INLINE rpc_request(ucp_ep_h ep, void *buffer)
+    {
+        rpc_op_t *op = &m_rpc_ops[m_rpc_ids[--m_rpc_ids_count]];
+        ucs_status_t status;
+
+        op->hdr.id        = op - m_rpc_ops;
+        op->hdr.flags     = 0;
+        op->hdr.resp_size = rpc_response_size();
+        op->start_time    = ucs_get_time();
+
+        status = rpc_send(ep, AM_ID, UCP_AM_SEND_FLAG_REPLY, &op->hdr, buffer,
+                          m_rpc_req_length);
+        if (ucs_unlikely(status != UCS_OK)) {
+            m_rpc_ids[m_rpc_ids_count++] = op->hdr.id;
+            return status;
+        }
+
+        op_started();
+        return UCS_OK;
+    }
+
+    ucs_status_t UCS_F_ALWAYS_INLINE rpc_send_replies(void *buffer)
+    {
+        ucs_status_t status;
+        rpc_op_t *op;
+
+        while ((m_rpc_ids_count > 0) &&
+               m_rpc_ops[m_rpc_ids[m_rpc_ids_head]].ready) {
+            op     = &m_rpc_ops[m_rpc_ids[m_rpc_ids_head]];
+            status = rpc_send(op->reply_ep, AM_RPC_REPLY_ID, 0, &op->hdr,
+                              buffer, op->hdr.resp_size);
+            if (ucs_unlikely(status != UCS_OK)) {
+                return status;
+            }
+
+            m_rpc_ids_head = (m_rpc_ids_head + 1) % m_max_outstanding;
+            --m_rpc_ids_count;
+
+            m_perf.current.time = ucs_get_time();
+            ucx_perf_update_counters(&m_perf, 1,
+                                     m_rpc_req_length + op->hdr.resp_size);
+        }
+
+        return UCS_OK;
+    }
+
     void UCS_F_ALWAYS_INLINE wait_window(unsigned n, bool is_requestor)
     {
         while (m_outstanding >= (m_max_outstanding - n + 1)) {
@@ -281,6 +636,76 @@ public:
         }
     }
 
+    ucs_status_t UCS_F_ALWAYS_INLINE
+    rma_op(ucp_ep_h ep, void *buffer, unsigned length, uint64_t remote_addr,
+           ucp_rkey_h rkey)
+    {
+        if (CMD == UCX_PERF_CMD_PUT) {
+            return ucp_put(ep, buffer, length, remote_addr, rkey);
+        } else {
+            return ucp_get(ep, buffer, length, remote_addr, rkey);
+        }
+    }
+
+    /* The operations are blocking, so a remote key which is unpacked for a
+     * single operation can be released as soon as it returns */
+    ucs_status_t UCS_F_ALWAYS_INLINE
+    rma(ucp_ep_h ep, void *buffer, unsigned length, uint64_t remote_addr,
+        ucp_rkey_h rkey)
+    {
+        ucs_status_t status;
+
+        if (!(m_perf.params.flags & UCX_PERF_TEST_FLAG_RKEY_UNPACK)) {
+            return rma_op(ep, buffer, length, remote_addr, rkey);
+        }
+
+        status = ucp_ep_rkey_unpack(ep, m_perf.ucp.rkey_buffer, &rkey);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        status = rma_op(ep, buffer, length, remote_addr, rkey);
+        ucp_rkey_destroy(rkey);
+        return status;
+    }
+
+    /* Up to max_outstanding fetching atomics are in flight at once, which
+     * allows measuring contended operations on the same remote location */
+    ucs_status_t UCS_F_ALWAYS_INLINE
+    amo_fetch(ucp_ep_h ep, ucp_atomic_op_t op, void *buffer, unsigned length,
+              uint64_t remote_addr, ucp_rkey_h rkey)
+    {
+        uint64_t value = 0;
+        ucp_request_param_t param;
+        void *request;
+
+        if ((length != sizeof(uint32_t)) && (length != sizeof(uint64_t))) {
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        wait_window(1, true);
+        if (op == UCP_ATOMIC_OP_CSWAP) {
+            /* reply buffer holds the compare value */
+            memset(buffer, 0, length);
+        }
+
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_DATATYPE |
+                             UCP_OP_ATTR_FIELD_CALLBACK |
+                             UCP_OP_ATTR_FIELD_REPLY_BUFFER;
+        param.cb.send      = send_nbx_cb;
+        param.datatype     = ucp_dt_make_contig(length);
+        param.reply_buffer = buffer;
+        request            = ucp_atomic_op_nbx(ep, op, &value, 1, remote_addr,
+                                               rkey, &param);
+        if (ucs_likely(!UCS_PTR_IS_PTR(request))) {
+            return UCS_PTR_STATUS(request);
+        }
+
+        reinterpret_cast<ucp_perf_request_t*>(request)->context = this;
+        op_started();
+        return UCS_OK;
+    }
+
     ucs_status_t UCS_F_ALWAYS_INLINE
     send(ucp_ep_h ep, void *buffer, unsigned length, ucp_datatype_t datatype,
          uint8_t sn, uint64_t remote_addr, ucp_rkey_h rkey)
@@ -298,11 +723,14 @@ public:
             /* coverity[switch_selector_expr_is_constant] */
             switch (CMD) {
             case UCX_PERF_CMD_TAG:
-                request = ucp_tag_send_nb(ep, buffer, length, datatype, TAG,
+                if (m_perf.params.flags & UCX_PERF_TEST_FLAG_PERSISTENT) {
+                    return send_persistent(ep, buffer, length, datatype);
+                }
+                request = ucp_tag_send_nb(ep, buffer, length, datatype, m_tag,
                                           send_cb);
                 break;
             case UCX_PERF_CMD_TAG_SYNC:
-                request = ucp_tag_send_sync_nb(ep, buffer, length, datatype, TAG,
+                request = ucp_tag_send_sync_nb(ep, buffer, length, datatype, m_tag,
                                                send_cb);
                 break;
             case UCX_PERF_CMD_STREAM:
@@ -342,9 +770,9 @@ public:
             default:
                 return UCS_ERR_INVALID_PARAM;
             }
-            return ucp_put(ep, buffer, length, remote_addr, rkey);
+            return rma(ep, buffer, length, remote_addr, rkey);
         case UCX_PERF_CMD_GET:
-            return ucp_get(ep, buffer, length, remote_addr, rkey);
+            return rma(ep, buffer, length, remote_addr, rkey);
         case UCX_PERF_CMD_ADD:
             if (length == sizeof(uint32_t)) {
                 return ucp_atomic_add32(ep, 1, remote_addr, rkey);
@@ -354,29 +782,14 @@ public:
                 return UCS_ERR_INVALID_PARAM;
             }
         case UCX_PERF_CMD_FADD:
-            if (length == sizeof(uint32_t)) {
-                return ucp_atomic_fadd32(ep, 0, remote_addr, rkey, (uint32_t*)buffer);
-            } else if (length == sizeof(uint64_t)) {
-                return ucp_atomic_fadd64(ep, 0, remote_addr, rkey, (uint64_t*)buffer);
-            } else {
-                return UCS_ERR_INVALID_PARAM;
-            }
+            return amo_fetch(ep, UCP_ATOMIC_OP_ADD, buffer, length,
+                             remote_addr, rkey);
         case UCX_PERF_CMD_SWAP:
-            if (length == sizeof(uint32_t)) {
-                return ucp_atomic_swap32(ep, 0, remote_addr, rkey, (uint32_t*)buffer);
-            } else if (length == sizeof(uint64_t)) {
-                return ucp_atomic_swap64(ep, 0, remote_addr, rkey, (uint64_t*)buffer);
-            } else {
-                return UCS_ERR_INVALID_PARAM;
-            }
+            return amo_fetch(ep, UCP_ATOMIC_OP_SWAP, buffer, length,
+                             remote_addr, rkey);
         case UCX_PERF_CMD_CSWAP:
-            if (length == sizeof(uint32_t)) {
-                return ucp_atomic_cswap32(ep, 0, 0, remote_addr, rkey, (uint32_t*)buffer);
-            } else if (length == sizeof(uint64_t)) {
-                return ucp_atomic_cswap64(ep, 0, 0, remote_addr, rkey, (uint64_t*)buffer);
-            } else {
-                return UCS_ERR_INVALID_PARAM;
-            }
+            return amo_fetch(ep, UCP_ATOMIC_OP_CSWAP, buffer, length,
+                             remote_addr, rkey);
         default:
             return UCS_ERR_INVALID_PARAM;
         }
@@ -396,11 +809,11 @@ public:
             wait_window(1, false);
             if (FLAGS & UCX_PERF_TEST_FLAG_TAG_UNEXP_PROBE) {
                 ucp_tag_recv_info_t tag_info;
-                while (ucp_tag_probe_nb(worker, TAG, TAG_MASK, 0, &tag_info) == NULL) {
+                while (ucp_tag_probe_nb(worker, m_tag, TAG_MASK, 0, &tag_info) == NULL) {
                     progress_responder();
                 }
             }
-            request = ucp_tag_recv_nb(worker, buffer, length, datatype, TAG, TAG_MASK,
+            request = ucp_tag_recv_nb(worker, buffer, length, datatype, m_tag, TAG_MASK,
                                       tag_recv_cb);
             if (ucs_likely(!UCS_PTR_IS_PTR(request))) {
                 return UCS_PTR_STATUS(request);
@@ -484,7 +897,13 @@ public:
     {
         if ((CMD == UCX_PERF_CMD_PUT) &&
             (TYPE == UCX_PERF_TEST_TYPE_STREAM_UNI)) {
-            fence();
+            if (m_perf.params.ucp.ep_count > 1) {
+                /* previous operations could be issued on other endpoints,
+                 * which may use different connections */
+                flush();
+            } else {
+                fence();
+            }
             *(uint8_t*)buffer = UCP_PERF_LAST_ITER_SN;
             return ucp_put(ep, buffer, sizeof(uint8_t), remote_addr, rkey);
         } else {
@@ -495,7 +914,9 @@ public:
     void flush()
     {
         if (m_perf.params.flags & UCX_PERF_TEST_FLAG_FLUSH_EP) {
-            ucp_ep_flush(m_perf.ucp.ep);
+            for (unsigned i = 0; i < m_perf.params.ucp.ep_count; ++i) {
+                ucp_ep_flush(m_perf.ucp.eps[i].ep);
+            }
         } else {
             ucp_worker_flush(m_perf.ucp.worker);
         }
@@ -506,10 +927,27 @@ public:
         ucp_worker_fence(m_perf.ucp.worker);
     }
 
+    /* Move to the next endpoint, both sides go over the endpoints in the same
+     * order so stream tests receive from the endpoint the data was sent to */
+    void UCS_F_ALWAYS_INLINE next_ep(unsigned &ep_index, ucp_ep_h &ep,
+                                     ucp_rkey_h &rkey)
+    {
+        if (ucs_likely(m_perf.params.ucp.ep_count == 1)) {
+            return;
+        }
+
+        if (++ep_index == m_perf.params.ucp.ep_count) {
+            ep_index = 0;
+        }
+
+        ep   = m_perf.ucp.eps[ep_index].ep;
+        rkey = m_perf.ucp.eps[ep_index].rkey;
+    }
+
     ucs_status_t run_pingpong()
     {
         const psn_t unknown_psn = std::numeric_limits<psn_t>::max();
-        unsigned my_index;
+        unsigned my_index, ep_index;
         ucp_worker_h worker;
         ucp_ep_h ep;
         void *send_buffer, *recv_buffer;
@@ -525,6 +963,7 @@ public:
         ep          = m_perf.ucp.ep;
         remote_addr = m_perf.ucp.remote_addr;
         rkey        = m_perf.ucp.rkey;
+        ep_index    = 0;
         sn          = 0;
 
         ucp_perf_init_common_params(&length, &send_length, &send_datatype,
@@ -551,6 +990,7 @@ public:
                 send(ep, send_buffer, send_length, send_datatype, sn, remote_addr, rkey);
                 recv(worker, ep, recv_buffer, recv_length, recv_datatype, sn);
                 ucx_perf_update(&m_perf, 1, length);
+                next_ep(ep_index, ep, rkey);
                 ++sn;
             }
         } else if (my_index == 1) {
@@ -558,6 +998,7 @@ public:
                 recv(worker, ep, recv_buffer, recv_length, recv_datatype, sn);
                 send(ep, send_buffer, send_length, send_datatype, sn, remote_addr, rkey);
                 ucx_perf_update(&m_perf, 1, length);
+                next_ep(ep_index, ep, rkey);
                 ++sn;
             }
         }
@@ -574,7 +1015,7 @@ public:
 
     ucs_status_t run_stream_uni()
     {
-        unsigned my_index;
+        unsigned my_index, ep_index;
         ucp_worker_h worker;
         ucp_ep_h ep;
         void *send_buffer, *recv_buffer;
@@ -590,6 +1031,7 @@ public:
         ep          = m_perf.ucp.ep;
         remote_addr = m_perf.ucp.remote_addr;
         rkey        = m_perf.ucp.rkey;
+        ep_index    = 0;
         sn          = 0;
 
         ucp_perf_init_common_params(&length, &send_length, &send_datatype,
@@ -608,6 +1050,7 @@ public:
             UCX_PERF_TEST_FOREACH(&m_perf) {
                 recv(worker, ep, recv_buffer, recv_length, recv_datatype, sn);
                 ucx_perf_update(&m_perf, 1, length);
+                next_ep(ep_index, ep, rkey);
                 ++sn;
             }
 
@@ -617,6 +1060,7 @@ public:
                 send(ep, send_buffer, send_length, send_datatype, sn,
                      remote_addr, rkey);
                 ucx_perf_update(&m_perf, 1, length);
+                next_ep(ep_index, ep, rkey);
                 ++sn;
             }
 
@@ -634,6 +1078,74 @@ public:
         return UCS_OK;
     }
 
+    /* The requester keeps up to max_outstanding requests in flight, and
+     * measures the latency of every request until its response arrives */
+    ucs_status_t run_rpc()
+    {
+        ucs_status_t status = UCS_OK;
+        ucx_perf_counter_t issued;
+        unsigned my_index;
+        void *send_buffer;
+        ucp_ep_h ep;
+        rpc_op_t *op;
+
+        send_buffer      = m_perf.send_buffer;
+        ep               = m_perf.ucp.ep;
+        issued           = 0;
+        m_rpc_req_length = ucx_perf_get_message_size(&m_perf.params);
+
+        ucp_perf_barrier(&m_perf);
+
+        my_index = rte_call(&m_perf, group_index);
+
+        ucx_perf_test_start_clock(&m_perf);
+
+        ucx_perf_omp_barrier(&m_perf);
+
+        if (my_index == 1) {
+            for (m_rpc_ids_count = 0; m_rpc_ids_count < m_max_outstanding;
+                 ++m_rpc_ids_count) {
+                m_rpc_ids[m_rpc_ids_count] = m_rpc_ids_count;
+            }
+
+            UCX_PERF_TEST_FOREACH(&m_perf) {
+                if ((m_rpc_ids_count > 0) && (issued < m_perf.max_iter)) {
+                    status = rpc_request(ep, send_buffer);
+                    if (status != UCS_OK) {
+                        break;
+                    }
+                    ++issued;
+                } else {
+                    progress_requestor();
+                }
+            }
+
+            wait_window(m_max_outstanding, true);
+
+            op            = &m_rpc_ops[0];
+            op->hdr.id    = 0;
+            op->hdr.flags = RPC_FLAG_STOP;
+            rpc_send(ep, AM_ID, 0, &op->hdr, send_buffer, 0);
+        } else if (my_index == 0) {
+            while (!m_rpc_stop) {
+                progress_responder();
+                status = rpc_send_replies(send_buffer);
+                if (status != UCS_OK) {
+                    break;
+                }
+            }
+        }
+
+        flush();
+
+        ucx_perf_omp_barrier(&m_perf);
+
+        ucx_perf_get_time(&m_perf);
+
+        ucp_perf_barrier(&m_perf);
+        return status;
+    }
+
     ucs_status_t run()
     {
         /* coverity[switch_selector_expr_is_constant] */
@@ -643,6 +1155,8 @@ public:
             return run_pingpong();
         case UCX_PERF_TEST_TYPE_STREAM_UNI:
             return run_stream_uni();
+        case UCX_PERF_TEST_TYPE_RPC:
+            return run_rpc();
         case UCX_PERF_TEST_TYPE_STREAM_BI:
         default:
             return UCS_ERR_INVALID_PARAM;
@@ -711,6 +1225,9 @@ private:
     ucx_perf_context_t  &m_perf;
     unsigned            m_outstanding;
     const unsigned      m_max_outstanding;
+    const ucp_tag_t     m_tag;             /* Per-thread tag, to not match
+                                              messages of other threads when
+                                              the worker is shared */
     /*
      * These fields are used by UCP AM flow only, because receive operation is
      * initiated from the data receive callback.
@@ -718,6 +1235,25 @@ private:
     void                *m_am_rx_buffer;
     size_t              m_am_rx_length;
     ucp_request_param_t m_am_rx_params;
+    /*
+     * Persistent send requests, used by UCP TAG flow when
+     * UCX_PERF_TEST_FLAG_PERSISTENT is set.
+     */
+    void                **m_persist_reqs;  /* Stack of inactive requests */
+    unsigned            m_persist_count;   /* Number of created requests */
+    unsigned            m_persist_free;    /* Number of inactive requests */
+    /*
+     * RPC test state. m_rpc_ids is a stack of free request slots on the
+     * requester, and a queue of received requests on the responder.
+     */
+    rpc_op_t            *m_rpc_ops;
+    unsigned            *m_rpc_ids;
+    unsigned            m_rpc_ids_head;
+    unsigned            m_rpc_ids_count;
+    size_t              m_rpc_req_length;  /* Request size */
+    volatile bool       m_rpc_stop;        /* Responder: requester is done */
+    uint64_t            m_rpc_seed;        /* Response size generator state */
+    size_t              m_rpc_trace_index; /* Next entry of the size trace */
 };
 
 
@@ -788,7 +1324,8 @@ ucs_status_t ucp_perf_test_dispatch(ucx_perf_context_t *perf)
 
     UCS_PP_FOREACH(TEST_CASE_ALL_AM, perf,
         (UCX_PERF_CMD_AM,       UCX_PERF_TEST_TYPE_PINGPONG),
-        (UCX_PERF_CMD_AM,       UCX_PERF_TEST_TYPE_STREAM_UNI)
+        (UCX_PERF_CMD_AM,       UCX_PERF_TEST_TYPE_STREAM_UNI),
+        (UCX_PERF_CMD_AM,       UCX_PERF_TEST_TYPE_RPC)
         );
 
     ucs_error("Invalid test case: %d/%d/0x%x",
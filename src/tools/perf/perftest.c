@@ -31,6 +31,8 @@
 #include <sys/types.h>
 #include <sys/poll.h>
 #include <locale.h>
+#include <ctype.h>
+#include <math.h>
 #if defined (HAVE_MPI)
 #  include <mpi.h>
 #elif defined (HAVE_RTE)
@@ -40,8 +42,11 @@
 #define MAX_BATCH_FILES         32
 #define MAX_CPUS                1024
 #define TL_RESOURCE_NAME_NONE   "<none>"
-#define TEST_PARAMS_ARGS        "t:n:s:W:O:w:D:i:H:oSCIqM:r:E:T:d:x:A:BUm:"
+#define MAX_CONFIG_SWEEP        256
+#define TEST_PARAMS_ARGS        "t:n:s:W:O:w:D:i:H:oSCIqM:r:E:T:d:x:A:BUm:RKe:uz:y:Z:X:"
 #define TEST_ID_UNDEFINED       -1
+#define BASELINE_MIN_WINDOWS    5     /* Minimal number of windows to compare */
+#define BASELINE_P_VALUE        0.01  /* Significance level of a regression */
 
 enum {
     TEST_FLAG_PRINT_RESULTS = UCS_BIT(0),
@@ -49,9 +54,12 @@ enum {
     TEST_FLAG_SET_AFFINITY  = UCS_BIT(8),
     TEST_FLAG_NUMERIC_FMT   = UCS_BIT(9),
     TEST_FLAG_PRINT_FINAL   = UCS_BIT(10),
-    TEST_FLAG_PRINT_CSV     = UCS_BIT(11)
+    TEST_FLAG_PRINT_CSV     = UCS_BIT(11),
+    TEST_FLAG_SWEEP         = UCS_BIT(12)
 };
 
+extern char **environ;
+
 typedef struct sock_rte_group {
     int                          is_server;
     int                          connfd;
@@ -72,9 +80,28 @@ typedef struct test_type {
 typedef struct perftest_params {
     ucx_perf_params_t            super;
     int                          test_id;
+    char                         config_sweep[MAX_CONFIG_SWEEP]; /* UCP config
+                                                  variable and list of values
+                                                  to run the test with */
 } perftest_params_t;
 
 
+/* Results of a single report interval */
+typedef struct perftest_window {
+    double                       elapsed_time;
+    ucx_perf_counter_t           iters;
+    double                       latency;
+    double                       bandwidth;
+    double                       msgrate;
+} perftest_window_t;
+
+
+typedef struct perftest_sample {
+    double                       value;
+    int                          is_current;
+} perftest_sample_t;
+
+
 struct perftest_context {
     perftest_params_t            params;
     const char                   *server_addr;
@@ -82,16 +109,40 @@ struct perftest_context {
     int                          mpi;
     unsigned                     num_cpus;
     unsigned                     cpus[MAX_CPUS];
+    unsigned                     num_thread_cpus;
+    unsigned                     thread_cpus[MAX_CPUS];
     unsigned                     flags;
 
     unsigned                     num_batch_files;
     char                         *batch_files[MAX_BATCH_FILES];
     char                         *test_names[MAX_BATCH_FILES];
 
+    const char                   *hist_file;  /* Latency histogram output file */
+    FILE                         *hist_stream;
+    const char                   *json_file;  /* JSON results output file */
+    FILE                         *json_stream;
+    const char                   *baseline_file; /* JSON results to compare to */
+    unsigned                     num_regressions;
+
+    /* Parameters and report windows of the running test */
+    const perftest_params_t      *run_params;
+    perftest_window_t            *windows;
+    unsigned                     num_windows;
+    unsigned                     max_windows;
+    ucx_perf_counter_t           window_iters; /* Iterations before the window */
+
     sock_rte_group_t             sock_rte_group;
 };
 
 
+static const char *percentile_names[] = {
+    [UCX_PERF_PERCENTILE_50]   = "50",
+    [UCX_PERF_PERCENTILE_90]   = "90",
+    [UCX_PERF_PERCENTILE_99]   = "99",
+    [UCX_PERF_PERCENTILE_99_9] = "99.9"
+};
+
+
 test_type_t tests[] = {
     {"am_lat", UCX_PERF_API_UCT, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_PINGPONG,
      "active message latency", "latency", 1},
@@ -168,6 +219,9 @@ test_type_t tests[] = {
     {"ucp_am_bw", UCX_PERF_API_UCP, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_STREAM_UNI,
      "am bandwidth / message rate", "overhead", 32},
 
+    {"ucp_am_rpc", UCX_PERF_API_UCP, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_RPC,
+     "am request/response latency / rate", "latency", 1},
+
     {NULL}
 };
 
@@ -222,39 +276,18 @@ static int safe_recv(int sock, void *data, size_t size,
     return sock_io(sock, recv, POLLIN, data, size, progress, arg, "recv");
 }
 
-static void print_progress(char **test_names, unsigned num_names,
-                           const ucx_perf_result_t *result, unsigned flags,
-                           int final, int is_server, int is_multi_thread)
+static void print_result_row(const ucx_perf_result_t *result, unsigned flags,
+                             int is_total)
 {
     static const char *fmt_csv;
     static const char *fmt_numeric;
     static const char *fmt_plain;
-    unsigned i;
+    ucx_perf_percentile_t p;
 
-    if (!(flags & TEST_FLAG_PRINT_RESULTS) ||
-        (!final && (flags & TEST_FLAG_PRINT_FINAL)))
-    {
-        return;
-    }
-
-    if (flags & TEST_FLAG_PRINT_CSV) {
-        for (i = 0; i < num_names; ++i) {
-            printf("%s,", test_names[i]);
-        }
-    }
-
-#if _OPENMP
-    if (!final) {
-        printf("[thread %d]", omp_get_thread_num());
-    } else if (flags & TEST_FLAG_PRINT_RESULTS) {
-        printf("Final:    ");
-    }
-#endif
-
-    if (is_multi_thread && final) {
-        fmt_csv     = "%4.0f,%.3f,%.2f,%.0f\n";
-        fmt_numeric = "%'18.0f %29.3f %22.2f %'24.0f\n";
-        fmt_plain   = "%18.0f %29.3f %22.2f %23.0f\n";
+    if (is_total) {
+        fmt_csv     = "%4.0f,%.3f,%.2f,%.0f";
+        fmt_numeric = "%'18.0f %29.3f %22.2f %'24.0f";
+        fmt_plain   = "%18.0f %29.3f %22.2f %23.0f";
 
         printf((flags & TEST_FLAG_PRINT_CSV)   ? fmt_csv :
                (flags & TEST_FLAG_NUMERIC_FMT) ? fmt_numeric :
@@ -264,9 +297,9 @@ static void print_progress(char **test_names, unsigned num_names,
                result->bandwidth.total_average / (1024.0 * 1024.0),
                result->msgrate.total_average);
     } else {
-        fmt_csv     = "%4.0f,%.3f,%.3f,%.3f,%.2f,%.2f,%.0f,%.0f\n";
-        fmt_numeric = "%'18.0f %9.3f %9.3f %9.3f %11.2f %10.2f %'11.0f %'11.0f\n";
-        fmt_plain   = "%18.0f %9.3f %9.3f %9.3f %11.2f %10.2f %11.0f %11.0f\n";
+        fmt_csv     = "%4.0f,%.3f,%.3f,%.3f,%.2f,%.2f,%.0f,%.0f";
+        fmt_numeric = "%'18.0f %9.3f %9.3f %9.3f %11.2f %10.2f %'11.0f %'11.0f";
+        fmt_plain   = "%18.0f %9.3f %9.3f %9.3f %11.2f %10.2f %11.0f %11.0f";
 
         printf((flags & TEST_FLAG_PRINT_CSV)   ? fmt_csv :
                (flags & TEST_FLAG_NUMERIC_FMT) ? fmt_numeric :
@@ -281,19 +314,791 @@ static void print_progress(char **test_names, unsigned num_names,
                result->msgrate.total_average);
     }
 
+    if (flags & TEST_FLAG_PRINT_CSV) {
+        for (p = 0; p < UCX_PERF_PERCENTILE_LAST; ++p) {
+            printf(",%.3f", result->latency_dist.percentile[p] * 1000000.0);
+        }
+        printf(",%.3f", result->latency_dist.max * 1000000.0);
+    }
+    printf("\n");
+}
+
+static void print_size_classes(const ucx_perf_result_t *result)
+{
+    const ucx_perf_size_class_result_t *size_class;
+    ucx_perf_percentile_t p;
+    char name[16];
+    unsigned i;
+
+    if (result->num_size_classes == 0) {
+        return;
+    }
+
+    printf("%33s %12s %10s %12s", "response size (bytes)", "requests", "MB/s",
+           "msg/s");
+    for (p = 0; p < UCX_PERF_PERCENTILE_LAST; ++p) {
+        ucs_snprintf_safe(name, sizeof(name), "p%s", percentile_names[p]);
+        printf(" %9s", name);
+    }
+    printf(" %9s  (usec)\n", "max");
+
+    for (i = 0; i < result->num_size_classes; ++i) {
+        size_class = &result->size_classes[i];
+        if (size_class->iters == 0) {
+            continue;
+        }
+
+        printf("%18zu..%-13zu %12"PRIu64" %10.2f %12.0f",
+               size_class->min_size, size_class->max_size, size_class->iters,
+               size_class->bandwidth / (1024.0 * 1024.0), size_class->msgrate);
+        for (p = 0; p < UCX_PERF_PERCENTILE_LAST; ++p) {
+            printf(" %9.3f", size_class->percentile[p] * 1000000.0);
+        }
+        printf(" %9.3f\n", size_class->max_latency * 1000000.0);
+    }
+}
+
+static void print_csv_prefix(const struct perftest_context *ctx,
+                             const ucx_perf_result_t *result)
+{
+    unsigned i;
+
+    for (i = 0; i < ctx->num_batch_files; ++i) {
+        printf("%s,", ctx->test_names[i]);
+    }
+
+    if (ctx->flags & TEST_FLAG_SWEEP) {
+        printf("%s%s%s,%zu,", ctx->run_params->super.ucp.config_name,
+               (ctx->run_params->super.ucp.config_name[0] == '\0') ? "" : "=",
+               ctx->run_params->super.ucp.config_value, result->msg_size);
+    }
+}
+
+static void print_progress(const struct perftest_context *ctx,
+                           const ucx_perf_result_t *result, int final,
+                           int is_multi_thread)
+{
+    unsigned flags = ctx->flags;
+    ucx_perf_percentile_t p;
+    unsigned j;
+
+    /* a sweep prints a single table with the final result of every step */
+    if (!(flags & TEST_FLAG_PRINT_RESULTS) ||
+        (!final && (flags & (TEST_FLAG_PRINT_FINAL | TEST_FLAG_SWEEP))))
+    {
+        return;
+    }
+
+    /* totals of every thread, followed by the aggregated result */
+    if (is_multi_thread && final) {
+        for (j = 0; j < result->num_threads; ++j) {
+            if (flags & TEST_FLAG_PRINT_CSV) {
+                print_csv_prefix(ctx, result);
+            }
+
+            printf("[thread %u]", j);
+            print_result_row(&result->thread_results[j], flags, 1);
+        }
+    }
+
+    if (flags & TEST_FLAG_PRINT_CSV) {
+        print_csv_prefix(ctx, result);
+    }
+
+    if (final && (flags & TEST_FLAG_SWEEP) && !(flags & TEST_FLAG_PRINT_CSV)) {
+        printf("%-10zu", result->msg_size);
+    } else {
+#if _OPENMP
+        if (!final) {
+            printf("[thread %d]", omp_get_thread_num());
+        } else if (flags & TEST_FLAG_PRINT_RESULTS) {
+            printf("Final:    ");
+        }
+#endif
+    }
+
+    print_result_row(result, flags, is_multi_thread && final);
+
+    if (final && !(flags & TEST_FLAG_PRINT_CSV) &&
+        (result->latency_dist.histogram != NULL) &&
+        (result->latency_dist.histogram->count != 0)) {
+        printf("%33s", "latency percentiles (usec):");
+        for (p = 0; p < UCX_PERF_PERCENTILE_LAST; ++p) {
+            printf("  p%s %.3f", percentile_names[p],
+                   result->latency_dist.percentile[p] * 1000000.0);
+        }
+        printf("  max %.3f\n", result->latency_dist.max * 1000000.0);
+    }
+
+    if (final && !(flags & TEST_FLAG_PRINT_CSV)) {
+        print_size_classes(result);
+    }
+
     fflush(stdout);
 }
 
+/* test name, or a path of names in batch mode, followed by the configuration
+ * and message size of a sweep step */
+static void get_test_name(const struct perftest_context *ctx,
+                          const ucx_perf_result_t *result, char *buf,
+                          size_t max)
+{
+    const ucx_perf_params_t *params;
+    unsigned i;
+
+    if (ctx->num_batch_files > 0) {
+        buf[0] = '\0';
+        for (i = 0; i < ctx->num_batch_files; ++i) {
+            ucs_snprintf_safe(buf + strlen(buf), max - strlen(buf), "%s%s",
+                              (i == 0) ? "" : "/", ctx->test_names[i]);
+        }
+    } else if (ctx->params.test_id != TEST_ID_UNDEFINED) {
+        ucs_strncpy_safe(buf, tests[ctx->params.test_id].name, max);
+    } else {
+        ucs_strncpy_safe(buf, "", max);
+    }
+
+    if (!(ctx->flags & TEST_FLAG_SWEEP)) {
+        return;
+    }
+
+    params = &ctx->run_params->super;
+    if (params->ucp.config_name[0] != '\0') {
+        ucs_snprintf_safe(buf + strlen(buf), max - strlen(buf), "/%s=%s",
+                          params->ucp.config_name, params->ucp.config_value);
+    }
+    ucs_snprintf_safe(buf + strlen(buf), max - strlen(buf), "/%zu",
+                      result->msg_size);
+}
+
+static void print_latency_hist_csv(FILE *stream, const char *test_name,
+                                   const ucx_perf_histogram_t *hist)
+{
+    ucx_perf_counter_t count;
+    uint64_t min, max;
+    unsigned i;
+
+    count = 0;
+    for (i = 0; i < UCX_PERF_HIST_NUM_BUCKETS; ++i) {
+        if (hist->buckets[i] == 0) {
+            continue;
+        }
+
+        count += hist->buckets[i];
+        ucx_perf_hist_bucket_range(i, &min, &max);
+        fprintf(stream, "%s,%.4f,%.4f,%"PRIu64",%.6f\n", test_name,
+                min * hist->unit * 1000000.0, max * hist->unit * 1000000.0,
+                hist->buckets[i], (double)count / hist->count);
+    }
+}
+
+static void print_json_string(FILE *stream, const char *str)
+{
+    fputc('"', stream);
+    for (; *str != '\0'; ++str) {
+        if ((*str == '"') || (*str == '\\')) {
+            fprintf(stream, "\\%c", *str);
+        } else if ((unsigned char)*str < ' ') {
+            fprintf(stream, "\\u%04x", (unsigned char)*str);
+        } else {
+            fputc(*str, stream);
+        }
+    }
+    fputc('"', stream);
+}
+
+static void print_latency_percentiles_json(FILE *stream,
+                                           const ucx_perf_result_t *result)
+{
+    ucx_perf_percentile_t p;
+
+    fprintf(stream, "\"max_usec\": %.4f, \"percentiles_usec\": {",
+            result->latency_dist.max * 1000000.0);
+    for (p = 0; p < UCX_PERF_PERCENTILE_LAST; ++p) {
+        fprintf(stream, "%s\"%s\": %.4f", (p == 0) ? "" : ", ",
+                percentile_names[p],
+                result->latency_dist.percentile[p] * 1000000.0);
+    }
+    fprintf(stream, "}");
+}
+
+static void print_latency_buckets_json(FILE *stream,
+                                       const ucx_perf_histogram_t *hist)
+{
+    const char *sep;
+    uint64_t min, max;
+    unsigned i;
+
+    fprintf(stream, "[");
+    sep = "";
+    for (i = 0; i < UCX_PERF_HIST_NUM_BUCKETS; ++i) {
+        if (hist->buckets[i] == 0) {
+            continue;
+        }
+
+        ucx_perf_hist_bucket_range(i, &min, &max);
+        fprintf(stream, "%s{\"min_usec\": %.4f, \"max_usec\": %.4f, "
+                "\"count\": %"PRIu64"}", sep,
+                min * hist->unit * 1000000.0, max * hist->unit * 1000000.0,
+                hist->buckets[i]);
+        sep = ", ";
+    }
+    fprintf(stream, "]");
+}
+
+static void print_latency_hist_json(FILE *stream, const char *test_name,
+                                    const ucx_perf_result_t *result)
+{
+    const ucx_perf_histogram_t *hist = result->latency_dist.histogram;
+
+    fprintf(stream, "{\"test\": ");
+    print_json_string(stream, test_name);
+    fprintf(stream, ", \"count\": %"PRIu64", ", hist->count);
+    print_latency_percentiles_json(stream, result);
+    fprintf(stream, ", \"buckets\": ");
+    print_latency_buckets_json(stream, hist);
+    fprintf(stream, "}\n");
+}
+
+static void print_latency_hist(struct perftest_context *ctx,
+                               const ucx_perf_result_t *result)
+{
+    const ucx_perf_histogram_t *hist = result->latency_dist.histogram;
+    char test_name[200];
+    size_t len;
+    int json;
+
+    if (!(ctx->flags & TEST_FLAG_PRINT_RESULTS) || (ctx->hist_file == NULL) ||
+        (hist == NULL)) {
+        return;
+    }
+
+    len  = strlen(ctx->hist_file);
+    json = (len >= 5) && !strcmp(ctx->hist_file + len - 5, ".json");
+
+    if (ctx->hist_stream == NULL) {
+        ctx->hist_stream = fopen(ctx->hist_file, "w");
+        if (ctx->hist_stream == NULL) {
+            ucs_error("failed to open latency histogram file '%s': %m",
+                      ctx->hist_file);
+            ctx->hist_file = NULL;
+            return;
+        }
+
+        if (!json) {
+            fprintf(ctx->hist_stream,
+                    "test,min_lat,max_lat,count,cumulative_fraction\n");
+        }
+    }
+
+    get_test_name(ctx, result, test_name, sizeof(test_name));
+    if (json) {
+        print_latency_hist_json(ctx->hist_stream, test_name, result);
+    } else {
+        print_latency_hist_csv(ctx->hist_stream, test_name, hist);
+    }
+    fflush(ctx->hist_stream);
+}
+
+static void add_result_window(struct perftest_context *ctx,
+                              const ucx_perf_result_t *result)
+{
+    perftest_window_t *windows, *window;
+    unsigned max_windows;
+
+    /* Reports of a multi-threaded test arrive from all threads concurrently,
+     * so the time series is collected only for a single thread */
+    if (!(ctx->flags & TEST_FLAG_PRINT_RESULTS) || (ctx->run_params == NULL) ||
+        (ctx->run_params->super.thread_count > 1)) {
+        return;
+    }
+
+    if (ctx->num_windows == ctx->max_windows) {
+        max_windows = ucs_max(ctx->max_windows * 2, 64);
+        windows     = realloc(ctx->windows, max_windows * sizeof(*windows));
+        if (windows == NULL) {
+            return;
+        }
+
+        ctx->windows     = windows;
+        ctx->max_windows = max_windows;
+    }
+
+    window               = &ctx->windows[ctx->num_windows++];
+    window->elapsed_time = result->elapsed_time;
+    window->iters        = result->iters - ctx->window_iters;
+    window->latency      = result->latency.moment_average;
+    window->bandwidth    = result->bandwidth.moment_average;
+    window->msgrate      = result->msgrate.moment_average;
+    ctx->window_iters    = result->iters;
+}
+
+static void print_windows_json(FILE *stream, const struct perftest_context *ctx)
+{
+#define PRINT_WINDOWS_FIELD(_name, _fmt, _expr) \
+    fprintf(stream, "\"" _name "\": ["); \
+    for (i = 0; i < ctx->num_windows; ++i) { \
+        window = &ctx->windows[i]; \
+        fprintf(stream, "%s" _fmt, (i == 0) ? "" : ", ", _expr); \
+    } \
+    fprintf(stream, "]");
+
+    const perftest_window_t *window;
+    unsigned i;
+
+    fprintf(stream, "{");
+    PRINT_WINDOWS_FIELD("elapsed_sec", "%.6f", window->elapsed_time);
+    fprintf(stream, ", ");
+    PRINT_WINDOWS_FIELD("iterations", "%"PRIu64, window->iters);
+    fprintf(stream, ", ");
+    PRINT_WINDOWS_FIELD("latency_usec", "%.4f", window->latency * 1000000.0);
+    fprintf(stream, ", ");
+    PRINT_WINDOWS_FIELD("bandwidth_mbs", "%.4f",
+                        window->bandwidth / (1024.0 * 1024.0));
+    fprintf(stream, ", ");
+    PRINT_WINDOWS_FIELD("msgrate", "%.2f", window->msgrate);
+    fprintf(stream, "}");
+
+#undef PRINT_WINDOWS_FIELD
+}
+
+static void print_config_json(FILE *stream, const perftest_params_t *params)
+{
+    static const char *wait_mode_names[] = {
+        [UCX_PERF_WAIT_MODE_POLL]  = "poll",
+        [UCX_PERF_WAIT_MODE_SLEEP] = "sleep",
+        [UCX_PERF_WAIT_MODE_SPIN]  = "spin",
+        [UCX_PERF_WAIT_MODE_LAST]  = "auto"
+    };
+    unsigned i;
+
+    fprintf(stream, "{\"test_type\": ");
+    print_json_string(stream, (params->test_id == TEST_ID_UNDEFINED) ? "" :
+                              tests[params->test_id].name);
+    fprintf(stream, ", \"message_sizes\": [");
+    for (i = 0; i < params->super.msg_size_cnt; ++i) {
+        fprintf(stream, "%s%zu", (i == 0) ? "" : ", ",
+                params->super.msg_size_list[i]);
+    }
+    fprintf(stream, "], \"max_outstanding\": %u, \"warmup_iter\": %"PRIu64
+            ", \"max_iter\": %"PRIu64", \"max_time\": %.3f"
+            ", \"report_interval\": %.3f, \"thread_count\": %u"
+            ", \"wait_mode\": \"%s\", \"send_mem_type\": \"%s\""
+            ", \"recv_mem_type\": \"%s\", \"flags\": %u",
+            params->super.max_outstanding, params->super.warmup_iter,
+            params->super.max_iter, params->super.max_time,
+            params->super.report_interval, params->super.thread_count,
+            wait_mode_names[ucs_min(params->super.wait_mode,
+                                    UCX_PERF_WAIT_MODE_LAST)],
+            ucs_memory_type_names[params->super.send_mem_type],
+            ucs_memory_type_names[params->super.recv_mem_type],
+            params->super.flags);
+
+    if (params->super.api == UCX_PERF_API_UCT) {
+        fprintf(stream, ", \"uct\": {\"transport\": ");
+        print_json_string(stream, params->super.uct.tl_name);
+        fprintf(stream, ", \"device\": ");
+        print_json_string(stream, params->super.uct.dev_name);
+        fprintf(stream, ", \"fc_window\": %u, \"am_hdr_size\": %zu}",
+                params->super.uct.fc_window, params->super.uct.am_hdr_size);
+    } else {
+        fprintf(stream, ", \"ucp\": {\"ep_count\": %u, \"am_hdr_size\": %zu"
+                ", \"config\": {", params->super.ucp.ep_count,
+                params->super.ucp.am_hdr_size);
+        if (params->super.ucp.config_name[0] != '\0') {
+            print_json_string(stream, params->super.ucp.config_name);
+            fprintf(stream, ": ");
+            print_json_string(stream, params->super.ucp.config_value);
+        }
+        fprintf(stream, "}}");
+    }
+
+    if (params->super.sweep.max_size != 0) {
+        fprintf(stream, ", \"sweep\": {\"max_size\": %zu, \"step\": %zu"
+                ", \"factor\": %.3f}", params->super.sweep.max_size,
+                params->super.sweep.step, params->super.sweep.factor);
+    }
+    fprintf(stream, "}");
+}
+
+static void print_env_json(FILE *stream)
+{
+    static const char *prefix = "UCX_";
+    const char *sep, *value;
+    char name[128];
+    char **envp;
+
+    fprintf(stream, "{");
+    sep = "";
+    for (envp = environ; *envp != NULL; ++envp) {
+        value = strchr(*envp, '=');
+        if (strncmp(*envp, prefix, strlen(prefix)) || (value == NULL)) {
+            continue;
+        }
+
+        ucs_strncpy_safe(name, *envp,
+                         ucs_min(sizeof(name), value - *envp + 1));
+        fprintf(stream, "%s", sep);
+        print_json_string(stream, name);
+        fprintf(stream, ": ");
+        print_json_string(stream, value + 1);
+        sep = ", ";
+    }
+    fprintf(stream, "}");
+}
+
+/*
+ * Write the final result as a single line of JSON, so results of several tests
+ * can be appended to the same file and used later as a baseline.
+ */
+static void print_json_result(struct perftest_context *ctx,
+                              const ucx_perf_result_t *result)
+{
+    const ucx_perf_histogram_t *hist = result->latency_dist.histogram;
+    FILE *stream;
+    char test_name[200];
+
+    if (!(ctx->flags & TEST_FLAG_PRINT_RESULTS) || (ctx->json_file == NULL) ||
+        (ctx->run_params == NULL)) {
+        return;
+    }
+
+    if (ctx->json_stream == NULL) {
+        ctx->json_stream = fopen(ctx->json_file, "w");
+        if (ctx->json_stream == NULL) {
+            ucs_error("failed to open JSON results file '%s': %m",
+                      ctx->json_file);
+            ctx->json_file = NULL;
+            return;
+        }
+    }
+
+    stream = ctx->json_stream;
+    get_test_name(ctx, result, test_name, sizeof(test_name));
+
+    fprintf(stream, "{\"test\": ");
+    print_json_string(stream, test_name);
+    fprintf(stream, ", \"ucx_version\": ");
+    print_json_string(stream, ucp_get_version_string());
+    fprintf(stream, ", \"config\": ");
+    print_config_json(stream, ctx->run_params);
+    fprintf(stream, ", \"env\": ");
+    print_env_json(stream);
+
+    fprintf(stream, ", \"result\": {\"msg_size\": %zu, \"iterations\": %"PRIu64
+            ", \"elapsed_sec\": %.6f, \"bytes\": %"PRIu64
+            ", \"latency_usec\": {\"typical\": %.4f, \"average\": %.4f}"
+            ", \"bandwidth_mbs\": %.4f, \"msgrate\": %.2f, ",
+            result->msg_size, result->iters, result->elapsed_time,
+            result->bytes, result->latency.typical * 1000000.0,
+            result->latency.total_average * 1000000.0,
+            result->bandwidth.total_average / (1024.0 * 1024.0),
+            result->msgrate.total_average);
+    print_latency_percentiles_json(stream, result);
+    fprintf(stream, "}, \"histogram\": ");
+    if (hist != NULL) {
+        print_latency_buckets_json(stream, hist);
+    } else {
+        fprintf(stream, "[]");
+    }
+    fprintf(stream, ", \"windows\": ");
+    print_windows_json(stream, ctx);
+    fprintf(stream, "}\n");
+    fflush(stream);
+}
+
+/* Return the string as a quoted JSON string, the caller should free it */
+static char *json_string_dup(const char *str)
+{
+    char *json_str = NULL;
+    size_t size;
+    FILE *stream;
+
+    stream = open_memstream(&json_str, &size);
+    if (stream == NULL) {
+        return NULL;
+    }
+
+    print_json_string(stream, str);
+    fclose(stream);
+    return json_str;
+}
+
+/*
+ * Find the result of the test named 'test_name' in a JSON results file and
+ * return the latencies of its report windows, in seconds.
+ */
+static ucs_status_t read_baseline_windows(const char *file_name,
+                                          const char *test_name,
+                                          double **latencies_p,
+                                          unsigned *count_p)
+{
+    static const char *test_key    = "{\"test\": ";
+    static const char *windows_key = "\"windows\": {";
+    static const char *latency_key = "\"latency_usec\": [";
+    double *latencies, *new_latencies;
+    char *line, *ptr, *end, *name;
+    ucs_status_t status;
+    size_t line_size;
+    unsigned count;
+    FILE *stream;
+    double value;
+
+    /* the test name is written by print_json_string(), so it is escaped in the
+     * same way */
+    name = json_string_dup(test_name);
+    if (name == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    stream = fopen(file_name, "r");
+    if (stream == NULL) {
+        ucs_error("failed to open baseline file '%s': %m", file_name);
+        status = UCS_ERR_IO_ERROR;
+        goto out_free_name;
+    }
+
+    line      = NULL;
+    line_size = 0;
+    latencies = NULL;
+    count     = 0;
+    status    = UCS_ERR_NO_ELEM;
+    while (getline(&line, &line_size, stream) != -1) {
+        if (strncmp(line, test_key, strlen(test_key)) ||
+            strncmp(line + strlen(test_key), name, strlen(name))) {
+            continue;
+        }
+
+        ptr = strstr(line, windows_key);
+        ptr = (ptr == NULL) ? NULL : strstr(ptr, latency_key);
+        if (ptr == NULL) {
+            ucs_error("baseline file '%s': no report windows for test '%s'",
+                      file_name, test_name);
+            status = UCS_ERR_INVALID_PARAM;
+            break;
+        }
+
+        for (ptr += strlen(latency_key);; ptr = end + strspn(end, ", ")) {
+            value = strtod(ptr, &end);
+            if (end == ptr) {
+                break;
+            }
+
+            /* grow the array when the count reaches a power of 2 */
+            if ((count & (count - 1)) == 0) {
+                new_latencies = realloc(latencies, ucs_max(count * 2, 1) *
+                                                   sizeof(*latencies));
+                if (new_latencies == NULL) {
+                    status = UCS_ERR_NO_MEMORY;
+                    goto out;
+                }
+                latencies = new_latencies;
+            }
+
+            latencies[count++] = value / 1000000.0;
+        }
+
+        status = UCS_OK;
+        break;
+    }
+
+out:
+    if (status == UCS_OK) {
+        *latencies_p = latencies;
+        *count_p     = count;
+    } else {
+        free(latencies);
+    }
+    free(line);
+    fclose(stream);
+out_free_name:
+    free(name);
+    return status;
+}
+
+static int compare_samples(const void *ptr1, const void *ptr2)
+{
+    const perftest_sample_t *sample1 = ptr1, *sample2 = ptr2;
+
+    return (sample1->value > sample2->value) -
+           (sample1->value < sample2->value);
+}
+
+/*
+ * One-sided Mann-Whitney U test: return the p-value of the hypothesis that
+ * 'current' samples are not stochastically greater than 'baseline' samples.
+ * Uses the normal approximation with tie and continuity corrections.
+ */
+static double mann_whitney_p_value(const double *baseline, unsigned n1,
+                                   const double *current, unsigned n2)
+{
+    unsigned n = n1 + n2;
+    perftest_sample_t *samples;
+    double rank_sum, ties, mean, var, u, z, t;
+    unsigned i, j, k;
+
+    samples = malloc(n * sizeof(*samples));
+    if (samples == NULL) {
+        return 1.0;
+    }
+
+    for (i = 0; i < n1; ++i) {
+        samples[i].value      = baseline[i];
+        samples[i].is_current = 0;
+    }
+    for (i = 0; i < n2; ++i) {
+        samples[n1 + i].value      = current[i];
+        samples[n1 + i].is_current = 1;
+    }
+
+    qsort(samples, n, sizeof(*samples), compare_samples);
+
+    /* equal values get the average of their ranks */
+    rank_sum = 0;
+    ties     = 0;
+    for (i = 0; i < n; i = j) {
+        for (j = i + 1; (j < n) && (samples[j].value == samples[i].value);
+             ++j);
+        t = j - i;
+        for (k = i; k < j; ++k) {
+            if (samples[k].is_current) {
+                rank_sum += (i + j + 1) / 2.0;
+            }
+        }
+        ties += (t * t * t) - t;
+    }
+    free(samples);
+
+    u    = rank_sum - (n2 * (n2 + 1.0)) / 2.0;
+    mean = (n1 * (double)n2) / 2.0;
+    var  = ((n1 * (double)n2) / 12.0) *
+           ((n + 1.0) - (ties / (n * (n - 1.0))));
+    if (var <= 0) {
+        return 1.0;
+    }
+
+    z = (u - mean - 0.5) / sqrt(var);
+    return 0.5 * erfc(z / sqrt(2.0));
+}
+
+static int compare_doubles(const void *ptr1, const void *ptr2)
+{
+    double value1 = *(const double*)ptr1, value2 = *(const double*)ptr2;
+
+    return (value1 > value2) - (value1 < value2);
+}
+
+/* Sorts the values */
+static double median(double *values, unsigned count)
+{
+    qsort(values, count, sizeof(*values), compare_doubles);
+    return (count % 2) ? values[count / 2] :
+           (values[(count / 2) - 1] + values[count / 2]) / 2;
+}
+
+/*
+ * Compare the per-window latencies of the test with the same test in the
+ * baseline file, and count a regression if they are significantly higher.
+ */
+static void compare_baseline(struct perftest_context *ctx,
+                             const ucx_perf_result_t *result)
+{
+    FILE *stream = (ctx->flags & TEST_FLAG_PRINT_CSV) ? stderr : stdout;
+    double base_median, cur_median, p_value;
+    double *baseline, *current;
+    char test_name[200];
+    unsigned i, count;
+    ucs_status_t status;
+    int regression;
+
+    if (!(ctx->flags & TEST_FLAG_PRINT_RESULTS) ||
+        (ctx->baseline_file == NULL)) {
+        return;
+    }
+
+    get_test_name(ctx, result, test_name, sizeof(test_name));
+
+    status = read_baseline_windows(ctx->baseline_file, test_name, &baseline,
+                                   &count);
+    if (status == UCS_ERR_NO_ELEM) {
+        fprintf(stream, "baseline: test '%s' not found in '%s'\n", test_name,
+                ctx->baseline_file);
+        return;
+    } else if (status != UCS_OK) {
+        return;
+    }
+
+    if ((count < BASELINE_MIN_WINDOWS) ||
+        (ctx->num_windows < BASELINE_MIN_WINDOWS)) {
+        fprintf(stream, "baseline: not enough report windows to compare "
+                "(baseline: %u, current: %u, need: %d), increase the run "
+                "time or decrease the report interval (-y)\n", count,
+                ctx->num_windows, BASELINE_MIN_WINDOWS);
+        goto out;
+    }
+
+    current = malloc(ctx->num_windows * sizeof(*current));
+    if (current == NULL) {
+        goto out;
+    }
+
+    for (i = 0; i < ctx->num_windows; ++i) {
+        current[i] = ctx->windows[i].latency;
+    }
+
+    p_value     = mann_whitney_p_value(baseline, count, current,
+                                       ctx->num_windows);
+    base_median = median(baseline, count);
+    cur_median  = median(current, ctx->num_windows);
+    regression  = p_value < BASELINE_P_VALUE;
+    free(current);
+
+    fprintf(stream, "baseline: median latency %.3f -> %.3f usec (%+.2f%%), "
+            "p-value %.4f: %s\n", base_median * 1000000.0,
+            cur_median * 1000000.0,
+            (base_median > 0) ?
+            ((cur_median - base_median) * 100.0 / base_median) : 0.0,
+            p_value, regression ? "REGRESSION" : "no significant regression");
+    if (regression) {
+        ++ctx->num_regressions;
+    }
+
+out:
+    free(baseline);
+}
+
+static void report_result(struct perftest_context *ctx,
+                          const ucx_perf_result_t *result, int is_final,
+                          int is_multi_thread)
+{
+    print_progress(ctx, result, is_final, is_multi_thread);
+    if (is_final) {
+        print_latency_hist(ctx, result);
+        print_json_result(ctx, result);
+        compare_baseline(ctx, result);
+
+        /* the next step of a sweep starts a new time series */
+        ctx->num_windows  = 0;
+        ctx->window_iters = 0;
+    } else {
+        add_result_window(ctx, result);
+    }
+}
+
 static void print_header(struct perftest_context *ctx)
 {
     const char *overhead_lat_str;
     const char *test_data_str;
     const char *test_api_str;
+    ucx_perf_percentile_t p;
     test_type_t *test;
     unsigned i;
+    int sweep;
 
-    test = (ctx->params.test_id == TEST_ID_UNDEFINED) ? NULL :
-           &tests[ctx->params.test_id];
+    test  = (ctx->params.test_id == TEST_ID_UNDEFINED) ? NULL :
+            &tests[ctx->params.test_id];
+    sweep = (ctx->params.super.sweep.max_size != 0) ||
+            (ctx->params.config_sweep[0] != '\0');
 
     if ((ctx->flags & TEST_FLAG_PRINT_TEST) && (test != NULL)) {
         if (test->api == UCX_PERF_API_UCT) {
@@ -341,7 +1146,14 @@ static void print_header(struct perftest_context *ctx)
             for (i = 0; i < ctx->num_batch_files; ++i) {
                 printf("%s,", ucs_basename(ctx->batch_files[i]));
             }
-            printf("iterations,typical_lat,avg_lat,overall_lat,avg_bw,overall_bw,avg_mr,overall_mr\n");
+            if (sweep) {
+                printf("config,msg_size,");
+            }
+            printf("iterations,typical_lat,avg_lat,overall_lat,avg_bw,overall_bw,avg_mr,overall_mr");
+            for (p = 0; p < UCX_PERF_PERCENTILE_LAST; ++p) {
+                printf(",p%s_lat", percentile_names[p]);
+            }
+            printf(",max_lat\n");
         }
     } else {
         if (ctx->flags & TEST_FLAG_PRINT_RESULTS) {
@@ -350,7 +1162,8 @@ static void print_header(struct perftest_context *ctx)
             printf("+--------------+--------------+-----------------------------+---------------------+-----------------------+\n");
             printf("|              |              |      %8s (usec)        |   bandwidth (MB/s)  |  message rate (msg/s) |\n", overhead_lat_str);
             printf("+--------------+--------------+---------+---------+---------+----------+----------+-----------+-----------+\n");
-            printf("|    Stage     | # iterations | typical | average | overall |  average |  overall |  average  |  overall  |\n");
+            printf("| %-12s | # iterations | typical | average | overall |  average |  overall |  average  |  overall  |\n",
+                   sweep ? "  Msg size" : "   Stage");
             printf("+--------------+--------------+---------+---------+---------+----------+----------+-----------+-----------+\n");
         } else if (ctx->flags & TEST_FLAG_PRINT_TEST) {
             printf("+------------------------------------------------------------------------------------------+\n");
@@ -382,6 +1195,25 @@ static void print_test_name(struct perftest_context *ctx)
     }
 }
 
+static void print_config_name(const struct perftest_context *ctx,
+                              const perftest_params_t *params)
+{
+    char name[UCX_PERF_CONFIG_NAME_MAX + UCX_PERF_CONFIG_VALUE_MAX + 8];
+    char buf[200];
+
+    if ((ctx->flags & TEST_FLAG_PRINT_CSV) ||
+        !(ctx->flags & TEST_FLAG_PRINT_RESULTS)) {
+        return;
+    }
+
+    strcpy(buf, "+--------------+--------------+---------+---------+---------+----------+----------+-----------+-----------+");
+    ucs_snprintf_safe(name, sizeof(name), "UCX_%s=%s",
+                      params->super.ucp.config_name,
+                      params->super.ucp.config_value);
+    memcpy(&buf[1], name, ucs_min(strlen(name), strlen(buf) - 2));
+    printf("%s\n", buf);
+}
+
 static void print_memory_type_usage(void)
 {
     ucs_memory_type_t it;
@@ -436,11 +1268,20 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("     -w <iters>     number of warm-up iterations (%"PRIu64")\n",
                                 ctx->params.super.warmup_iter);
     printf("     -c <cpulist>   set affinity to this CPU list (separated by comma) (off)\n");
+    printf("     -a <cpulist>   bind every test thread to a single CPU from this list, in\n");
+    printf("                    round-robin order (off)\n");
     printf("     -O <count>     maximal number of uncompleted outstanding sends\n");
     printf("     -i <offset>    distance between consecutive scatter-gather entries (%zu)\n",
                                 ctx->params.super.iov_stride);
     printf("     -T <threads>   number of threads in the test (%d)\n",
                                 ctx->params.super.thread_count);
+    printf("     -y <seconds>   report interval (%.1f)\n",
+                                ctx->params.super.report_interval);
+    printf("     -Z <max>[:x<factor>|:+<step>]\n");
+    printf("                    sweep message sizes from the size given by -s up to\n");
+    printf("                    <max>, multiplying the size by <factor> (2) or adding\n");
+    printf("                    <step>; every size is warmed up and reported separately,\n");
+    printf("                    using the same connections (UCP, single thread only)\n");
     printf("     -o             do not progress the responder in one-sided tests\n");
     printf("     -B             register memory with NONBLOCK flag\n");
     printf("     -b <file>      read and execute tests from a batch file: every line in the\n");
@@ -456,6 +1297,18 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("     -N             use numeric formatting (thousands separator)\n");
     printf("     -f             print only final numbers\n");
     printf("     -v             print CSV-formatted output\n");
+    printf("     -g <file>      write the final latency histogram to <file>, in JSON format\n");
+    printf("                    if the file name ends with \".json\", otherwise in CSV format\n");
+    printf("     -j <file>      write the results to <file> in JSON format, one line per\n");
+    printf("                    test, with the test configuration, UCX_ environment\n");
+    printf("                    variables, latency histogram and the results of every\n");
+    printf("                    report interval\n");
+    printf("     -J <file>      compare the latencies of report intervals with the same\n");
+    printf("                    test in a file written by -j, using the Mann-Whitney U test,\n");
+    printf("                    and exit with status 1 if a test regressed significantly\n");
+    printf("                    (p < %.2f); report intervals are collected only for\n",
+                                BASELINE_P_VALUE);
+    printf("                    single-threaded tests\n");
     printf("\n");
     printf("  UCT only:\n");
     printf("     -d <device>    device to use for testing\n");
@@ -480,12 +1333,20 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("                        single     - only the master thread can access\n");
     printf("                        serialized - one thread can access at a time\n");
     printf("                        multi      - multiple threads can access\n");
+    printf("     -e <count>     number of endpoints of every thread, used in round-robin\n");
+    printf("                    order (%u)\n", ctx->params.super.ucp.ep_count);
+    printf("     -u             use a single worker for all threads, with thread support\n");
+    printf("                    level \"multi\" (by default every thread has its own worker)\n");
     printf("     -D <layout>[,<layout>]\n");
     printf("                    data layout for sender and receiver side (contig)\n");
     printf("                        contig - Continuous datatype\n");
     printf("                        iov    - Scatter-gather list\n");
     printf("     -C             use wild-card tag for tag tests\n");
     printf("     -U             force unexpected flow by using tag probe\n");
+    printf("     -R             send with persistent requests in tag tests, which are\n");
+    printf("                    created once and restarted for every message\n");
+    printf("     -K             unpack the remote key for every operation in put and get\n");
+    printf("                    tests, to measure the remote key unpack overhead\n");
     printf("     -r <mode>      receive mode for stream tests (recv)\n");
     printf("                        recv       : Use ucp_stream_recv_nb\n");
     printf("                        recv_data  : Use ucp_stream_recv_data_nb\n");
@@ -495,6 +1356,20 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("                        sleep      : go to sleep after posting requests\n");
     printf("     -H <size>      active message header size (%zu), not included in message size\n",
                                 ctx->params.super.ucp.am_hdr_size);
+    printf("     -X <var>=<value>[,<value>...]\n");
+    printf("                    run the test for every value of UCP configuration\n");
+    printf("                    variable <var>, for example \"-X RNDV_THRESH=1k,8k,64k\";\n");
+    printf("                    every value needs new UCP context and connections\n");
+    printf("     -z <dist>      response size distribution of RPC tests (fixed:%zu)\n",
+                                ctx->params.super.ucp.rpc.max_size);
+    printf("                        fixed:<size>          - always <size>\n");
+    printf("                        uniform:<min>:<max>   - uniform in [<min>,<max>]\n");
+    printf("                        lognormal:<median>:<sigma>:<max>\n");
+    printf("                                              - log-normal, capped at <max>\n");
+    printf("                        trace:<file>          - sizes from <file>, one per line,\n");
+    printf("                                                replayed in order\n");
+    printf("                    the request size is given by -s, and -O sets the number of\n");
+    printf("                    outstanding requests\n");
     printf("\n");
     printf("   NOTE: When running UCP tests, transport and device should be specified by\n");
     printf("         environment variables: UCX_TLS and UCX_[SELF|SHM|NET]_DEVICES.\n");
@@ -598,6 +1473,180 @@ static ucs_status_t parse_message_sizes_params(const char *opt_arg,
     return UCS_OK;
 }
 
+static ucs_status_t read_size_trace(const char *file_name,
+                                    ucx_perf_params_t *params)
+{
+    size_t capacity, size, *trace;
+    ucs_status_t status;
+    char line[128];
+    char *ptr, *end;
+    int line_num;
+    FILE *file;
+
+    file = fopen(file_name, "r");
+    if (file == NULL) {
+        ucs_error("failed to open size trace file '%s': %m", file_name);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    capacity = 0;
+    line_num = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        ++line_num;
+        ptr = line + strspn(line, " \t");
+        if ((*ptr == '#') || (*ptr == '\n') || (*ptr == '\0')) {
+            continue;
+        }
+
+        errno = 0;
+        size  = strtoul(ptr, &end, 10);
+        if ((errno != 0) || (end == ptr) ||
+            ((*end != '\0') && !isspace(*end))) {
+            ucs_error("%s:%d: invalid size", file_name, line_num);
+            status = UCS_ERR_INVALID_PARAM;
+            goto err;
+        }
+
+        if (params->ucp.rpc.trace_length == capacity) {
+            capacity = ucs_max(capacity * 2, 1024);
+            trace    = realloc(params->ucp.rpc.trace,
+                               sizeof(*trace) * capacity);
+            if (trace == NULL) {
+                status = UCS_ERR_NO_MEMORY;
+                goto err;
+            }
+
+            params->ucp.rpc.trace = trace;
+        }
+
+        params->ucp.rpc.trace[params->ucp.rpc.trace_length++] = size;
+        params->ucp.rpc.max_size = ucs_max(params->ucp.rpc.max_size, size);
+    }
+
+    if (params->ucp.rpc.trace_length == 0) {
+        ucs_error("size trace file '%s' is empty", file_name);
+        status = UCS_ERR_INVALID_PARAM;
+        goto err;
+    }
+
+    fclose(file);
+    return UCS_OK;
+
+err:
+    free(params->ucp.rpc.trace);
+    params->ucp.rpc.trace        = NULL;
+    params->ucp.rpc.trace_length = 0;
+    fclose(file);
+    return status;
+}
+
+static ucs_status_t parse_size_dist_params(const char *opt_arg,
+                                           ucx_perf_params_t *params)
+{
+    const char *trace_prefix = "trace:";
+    size_t min_size, max_size;
+    double median, sigma;
+    char dummy;
+
+    free(params->ucp.rpc.trace);
+    params->ucp.rpc.trace        = NULL;
+    params->ucp.rpc.trace_length = 0;
+    params->ucp.rpc.min_size     = 0;
+    params->ucp.rpc.max_size     = 0;
+
+    if (sscanf(opt_arg, "fixed:%zu%c", &max_size, &dummy) == 1) {
+        params->ucp.rpc.size_dist = UCX_PERF_SIZE_DIST_FIXED;
+        params->ucp.rpc.min_size  = max_size;
+        params->ucp.rpc.max_size  = max_size;
+    } else if ((sscanf(opt_arg, "uniform:%zu:%zu%c", &min_size, &max_size,
+                       &dummy) == 2) && (min_size <= max_size)) {
+        params->ucp.rpc.size_dist = UCX_PERF_SIZE_DIST_UNIFORM;
+        params->ucp.rpc.min_size  = min_size;
+        params->ucp.rpc.max_size  = max_size;
+    } else if ((sscanf(opt_arg, "lognormal:%lf:%lf:%zu%c", &median, &sigma,
+                       &max_size, &dummy) == 3) &&
+               (median > 0) && (sigma >= 0)) {
+        params->ucp.rpc.size_dist = UCX_PERF_SIZE_DIST_LOGNORMAL;
+        params->ucp.rpc.mu        = log(median);
+        params->ucp.rpc.sigma     = sigma;
+        params->ucp.rpc.max_size  = max_size;
+    } else if (!strncmp(opt_arg, trace_prefix, strlen(trace_prefix))) {
+        params->ucp.rpc.size_dist = UCX_PERF_SIZE_DIST_TRACE;
+        return read_size_trace(opt_arg + strlen(trace_prefix), params);
+    } else {
+        ucs_error("Invalid option argument for -z");
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    return UCS_OK;
+}
+
+static ucs_status_t parse_sweep_params(const char *opt_arg,
+                                       ucx_perf_params_t *params)
+{
+    size_t max_size, step;
+    double factor;
+    char dummy;
+
+    step   = 0;
+    factor = 2.0;
+    if ((sscanf(opt_arg, "%zu%c", &max_size, &dummy) != 1) &&
+        ((sscanf(opt_arg, "%zu:x%lf%c", &max_size, &factor, &dummy) != 2) ||
+         (factor <= 1.0)) &&
+        ((sscanf(opt_arg, "%zu:+%zu%c", &max_size, &step, &dummy) != 2) ||
+         (step == 0))) {
+        ucs_error("Invalid option argument for -Z");
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    if (max_size == 0) {
+        ucs_error("Invalid option argument for -Z: the largest size must be "
+                  "positive");
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    params->sweep.max_size = max_size;
+    params->sweep.step     = step;
+    params->sweep.factor   = factor;
+    return UCS_OK;
+}
+
+static ucs_status_t parse_config_sweep_params(const char *opt_arg,
+                                              perftest_params_t *params)
+{
+    static const char *prefix = "UCX_";
+    const char *value, *end;
+    size_t length;
+
+    if (!strncmp(opt_arg, prefix, strlen(prefix))) {
+        opt_arg += strlen(prefix);
+    }
+
+    value = strchr(opt_arg, '=');
+    if ((value == NULL) || (value == opt_arg) ||
+        ((value - opt_arg) >= UCX_PERF_CONFIG_NAME_MAX) ||
+        (strlen(opt_arg) >= sizeof(params->config_sweep))) {
+        ucs_error("Invalid option argument for -X: %s", opt_arg);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    /* every value must be non-empty and fit in config_value */
+    do {
+        ++value;
+        end    = strchr(value, ',');
+        length = (end == NULL) ? strlen(value) : (end - value);
+        if ((length == 0) || (length >= UCX_PERF_CONFIG_VALUE_MAX)) {
+            ucs_error("Invalid option argument for -X: %s", opt_arg);
+            return UCS_ERR_INVALID_PARAM;
+        }
+        value = end;
+    } while (value != NULL);
+
+    ucs_strncpy_safe(params->config_sweep, opt_arg,
+                     sizeof(params->config_sweep));
+    return UCS_OK;
+}
+
 static ucs_status_t init_test_params(perftest_params_t *params)
 {
     memset(params, 0, sizeof(*params));
@@ -614,6 +1663,7 @@ static ucs_status_t init_test_params(perftest_params_t *params)
     params->super.max_iter          = 1000000l;
     params->super.max_time          = 0.0;
     params->super.report_interval   = 1.0;
+    params->super.sweep.factor      = 2.0;
     params->super.flags             = UCX_PERF_TEST_FLAG_VERBOSE;
     params->super.uct.fc_window     = UCT_PERF_TEST_MAX_FC_WINDOW;
     params->super.uct.data_layout   = UCT_PERF_DATA_LAYOUT_SHORT;
@@ -625,6 +1675,10 @@ static ucs_status_t init_test_params(perftest_params_t *params)
     params->super.ucp.send_datatype = UCP_PERF_DATATYPE_CONTIG;
     params->super.ucp.recv_datatype = UCP_PERF_DATATYPE_CONTIG;
     params->super.ucp.am_hdr_size   = 0;
+    params->super.ucp.ep_count      = 1;
+    params->super.ucp.rpc.size_dist = UCX_PERF_SIZE_DIST_FIXED;
+    params->super.ucp.rpc.min_size  = 8;
+    params->super.ucp.rpc.max_size  = 8;
     strcpy(params->super.uct.dev_name, TL_RESOURCE_NAME_NONE);
     strcpy(params->super.uct.tl_name,  TL_RESOURCE_NAME_NONE);
 
@@ -743,6 +1797,12 @@ static ucs_status_t parse_test_params(perftest_params_t *params, char opt,
     case 'U':
         params->super.flags |= UCX_PERF_TEST_FLAG_TAG_UNEXP_PROBE;
         return UCS_OK;
+    case 'R':
+        params->super.flags |= UCX_PERF_TEST_FLAG_PERSISTENT;
+        return UCS_OK;
+    case 'K':
+        params->super.flags |= UCX_PERF_TEST_FLAG_RKEY_UNPACK;
+        return UCS_OK;
     case 'I':
         params->super.flags |= UCX_PERF_TEST_FLAG_WAKEUP;
         return UCS_OK;
@@ -763,6 +1823,29 @@ static ucs_status_t parse_test_params(perftest_params_t *params, char opt,
     case 'T':
         params->super.thread_count = atoi(opt_arg);
         return UCS_OK;
+    case 'e':
+        if (atoi(opt_arg) < 1) {
+            ucs_error("Invalid option argument for -e");
+            return UCS_ERR_INVALID_PARAM;
+        }
+        params->super.ucp.ep_count = atoi(opt_arg);
+        return UCS_OK;
+    case 'u':
+        params->super.flags |= UCX_PERF_TEST_FLAG_SHARED_WORKER;
+        return UCS_OK;
+    case 'z':
+        return parse_size_dist_params(opt_arg, &params->super);
+    case 'Z':
+        return parse_sweep_params(opt_arg, &params->super);
+    case 'X':
+        return parse_config_sweep_params(opt_arg, params);
+    case 'y':
+        params->super.report_interval = atof(opt_arg);
+        if (params->super.report_interval <= 0) {
+            ucs_error("Invalid option argument for -y: %s", opt_arg);
+            return UCS_ERR_INVALID_PARAM;
+        }
+        return UCS_OK;
     case 'A':
         if (!strcmp(opt_arg, "thread") || !strcmp(opt_arg, "thread_spinlock")) {
             params->super.async_mode = UCS_ASYNC_MODE_THREAD_SPINLOCK;
@@ -868,21 +1951,22 @@ static ucs_status_t read_batch_file(FILE *batch_file, const char *file_name,
     return UCS_OK;
 }
 
-static ucs_status_t parse_cpus(char *opt_arg, struct perftest_context *ctx)
+static ucs_status_t parse_cpus(char *opt_arg, unsigned *cpus,
+                               unsigned *num_cpus)
 {
     char *endptr, *cpu_list = opt_arg;
     int cpu;
 
-    ctx->num_cpus = 0;
-    cpu           = strtol(cpu_list, &endptr, 10);
+    *num_cpus = 0;
+    cpu       = strtol(cpu_list, &endptr, 10);
 
-    while (((*endptr == ',') || (*endptr == '\0')) && (ctx->num_cpus < MAX_CPUS)) {
+    while (((*endptr == ',') || (*endptr == '\0')) && (*num_cpus < MAX_CPUS)) {
         if (cpu < 0) {
             ucs_error("invalid cpu number detected: (%d)", cpu);
             return UCS_ERR_INVALID_PARAM;
         }
 
-        ctx->cpus[ctx->num_cpus++] = cpu;
+        cpus[(*num_cpus)++] = cpu;
 
         if (*endptr == '\0') {
             break;
@@ -921,9 +2005,21 @@ static ucs_status_t parse_opts(struct perftest_context *ctx, int mpi_initialized
     ctx->port                   = 13337;
     ctx->flags                  = 0;
     ctx->mpi                    = mpi_initialized;
+    ctx->hist_file              = NULL;
+    ctx->num_thread_cpus        = 0;
+    ctx->hist_stream            = NULL;
+    ctx->json_file              = NULL;
+    ctx->json_stream            = NULL;
+    ctx->baseline_file          = NULL;
+    ctx->num_regressions        = 0;
+    ctx->run_params             = NULL;
+    ctx->windows                = NULL;
+    ctx->num_windows            = 0;
+    ctx->max_windows            = 0;
+    ctx->window_iters           = 0;
 
     optind = 1;
-    while ((c = getopt (argc, argv, "p:b:Nfvc:P:h" TEST_PARAMS_ARGS)) != -1) {
+    while ((c = getopt (argc, argv, "p:b:Nfvg:j:J:c:a:P:h" TEST_PARAMS_ARGS)) != -1) {
         switch (c) {
         case 'p':
             ctx->port = atoi(optarg);
@@ -942,13 +2038,31 @@ static ucs_status_t parse_opts(struct perftest_context *ctx, int mpi_initialized
         case 'v':
             ctx->flags |= TEST_FLAG_PRINT_CSV;
             break;
+        case 'g':
+            ctx->hist_file = optarg;
+            break;
+        case 'j':
+            ctx->json_file = optarg;
+            break;
+        case 'J':
+            ctx->baseline_file = optarg;
+            break;
         case 'c':
             ctx->flags |= TEST_FLAG_SET_AFFINITY;
-            status = parse_cpus(optarg, ctx);
+            status = parse_cpus(optarg, ctx->cpus, &ctx->num_cpus);
             if (status != UCS_OK) {
                 return status;
             }
             break;
+        case 'a':
+            status = parse_cpus(optarg, ctx->thread_cpus, &ctx->num_thread_cpus);
+            if (status != UCS_OK) {
+                return status;
+            }
+
+            ctx->params.super.thread_cpus      = ctx->thread_cpus;
+            ctx->params.super.thread_cpu_count = ctx->num_thread_cpus;
+            break;
         case 'P':
 #ifdef HAVE_MPI
             ctx->mpi = atoi(optarg) && mpi_initialized;
@@ -1048,8 +2162,7 @@ static void sock_rte_report(void *rte_group, const ucx_perf_result_t *result,
                             void *arg, int is_final, int is_multi_thread)
 {
     struct perftest_context *ctx = arg;
-    print_progress(ctx->test_names, ctx->num_batch_files, result, ctx->flags,
-                   is_final, ctx->server_addr == NULL, is_multi_thread);
+    report_result(ctx, result, is_final, is_multi_thread);
 }
 
 static ucx_perf_rte_t sock_rte = {
@@ -1120,6 +2233,8 @@ static ucs_status_t setup_sock_rte(struct perftest_context *ctx)
          * during the initialization of the default testing parameters */
         free(ctx->params.super.msg_size_list);
         ctx->params.super.msg_size_list = NULL;
+        free(ctx->params.super.ucp.rpc.trace);
+        ctx->params.super.ucp.rpc.trace = NULL;
 
         ret = safe_recv(connfd, &ctx->params, sizeof(ctx->params), NULL, NULL);
         if (ret) {
@@ -1127,6 +2242,14 @@ static ucs_status_t setup_sock_rte(struct perftest_context *ctx)
             goto err_close_connfd;
         }
 
+        /* the size trace is used only by the client, which sends requests */
+        ctx->params.super.ucp.rpc.trace        = NULL;
+        ctx->params.super.ucp.rpc.trace_length = 0;
+
+        /* thread pinning is a local setting, not taken from the client */
+        ctx->params.super.thread_cpus      = ctx->thread_cpus;
+        ctx->params.super.thread_cpu_count = ctx->num_thread_cpus;
+
         if (ctx->params.super.msg_size_cnt != 0) {
             ctx->params.super.msg_size_list =
                     calloc(ctx->params.super.msg_size_cnt,
@@ -1341,8 +2464,7 @@ static void mpi_rte_report(void *rte_group, const ucx_perf_result_t *result,
                            void *arg, int is_final, int is_multi_thread)
 {
     struct perftest_context *ctx = arg;
-    print_progress(ctx->test_names, ctx->num_batch_files, result, ctx->flags,
-                   is_final, ctx->server_addr == NULL, is_multi_thread);
+    report_result(ctx, result, is_final, is_multi_thread);
 }
 #elif defined (HAVE_RTE)
 static unsigned ext_rte_group_size(void *rte_group)
@@ -1452,8 +2574,7 @@ static void ext_rte_report(void *rte_group, const ucx_perf_result_t *result,
                            void *arg, int is_final, int is_multi_thread)
 {
     struct perftest_context *ctx = arg;
-    print_progress(ctx->test_names, ctx->num_batch_files, result, ctx->flags,
-                   is_final, ctx->server_addr == NULL, is_multi_thread);
+    report_result(ctx, result, is_final, is_multi_thread);
 }
 
 static ucx_perf_rte_t ext_rte = {
@@ -1541,6 +2662,14 @@ static ucs_status_t check_system(struct perftest_context *ctx)
     }
     nr_cpus = ret;
 
+    for (i = 0; i < ctx->num_thread_cpus; i++) {
+        if (ctx->thread_cpus[i] >= nr_cpus) {
+            ucs_error("thread cpu (%u) out of range (0..%u)",
+                      ctx->thread_cpus[i], nr_cpus - 1);
+            return UCS_ERR_INVALID_PARAM;
+        }
+    }
+
     memset(&cpuset, 0, sizeof(cpuset));
     if (ctx->flags & TEST_FLAG_SET_AFFINITY) {
         for (i = 0; i < ctx->num_cpus; i++) {
@@ -1584,9 +2713,22 @@ static ucs_status_t check_system(struct perftest_context *ctx)
 static ucs_status_t clone_params(perftest_params_t *dest,
                                  const perftest_params_t *src)
 {
-    size_t msg_size_list_size;
+    size_t msg_size_list_size, trace_size;
 
     *dest                     = *src;
+    trace_size                = dest->super.ucp.rpc.trace_length *
+                                sizeof(*dest->super.ucp.rpc.trace);
+    dest->super.ucp.rpc.trace = NULL;
+    if (src->super.ucp.rpc.trace != NULL) {
+        dest->super.ucp.rpc.trace = malloc(trace_size);
+        if (dest->super.ucp.rpc.trace == NULL) {
+            return UCS_ERR_NO_MEMORY;
+        }
+
+        memcpy(dest->super.ucp.rpc.trace, src->super.ucp.rpc.trace,
+               trace_size);
+    }
+
     msg_size_list_size        = dest->super.msg_size_cnt *
                                 sizeof(*dest->super.msg_size_list);
     dest->super.msg_size_list = malloc(msg_size_list_size);
@@ -1599,12 +2741,73 @@ static ucs_status_t clone_params(perftest_params_t *dest,
     return UCS_OK;
 }
 
+static ucs_status_t run_single_config(struct perftest_context *ctx,
+                                      const perftest_params_t *params)
+{
+    ucx_perf_result_t result;
+    ucs_status_t status;
+
+    if ((params->super.sweep.max_size != 0) ||
+        (params->config_sweep[0] != '\0')) {
+        ctx->flags |= TEST_FLAG_SWEEP;
+    } else {
+        ctx->flags &= ~TEST_FLAG_SWEEP;
+    }
+
+    ctx->run_params   = params;
+    ctx->num_windows  = 0;
+    ctx->window_iters = 0;
+    status            = ucx_perf_run(&params->super, &result);
+    ctx->run_params   = NULL;
+    return status;
+}
+
+/* Run the test once for every value of the configuration sweep, every run
+ * creates new UCP context and connections with the modified configuration */
+static ucs_status_t run_config_sweep(struct perftest_context *ctx,
+                                     const perftest_params_t *params)
+{
+    perftest_params_t run_params = *params;
+    char config_sweep[MAX_CONFIG_SWEEP];
+    char *value, *saveptr;
+    ucs_status_t status;
+
+    if (params->config_sweep[0] == '\0') {
+        return run_single_config(ctx, &run_params);
+    }
+
+    if (params->super.api != UCX_PERF_API_UCP) {
+        ucs_error("configuration sweep is supported only for UCP tests");
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    /* "<name>=<value>[,<value>...]", validated by parse_config_sweep_params() */
+    ucs_strncpy_safe(config_sweep, params->config_sweep, sizeof(config_sweep));
+    value    = strchr(config_sweep, '=');
+    *value++ = '\0';
+    ucs_strncpy_safe(run_params.super.ucp.config_name, config_sweep,
+                     sizeof(run_params.super.ucp.config_name));
+
+    for (value = strtok_r(value, ",", &saveptr); value != NULL;
+         value = strtok_r(NULL, ",", &saveptr)) {
+        ucs_strncpy_safe(run_params.super.ucp.config_value, value,
+                         sizeof(run_params.super.ucp.config_value));
+        print_config_name(ctx, &run_params);
+
+        status = run_single_config(ctx, &run_params);
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
+
+    return UCS_OK;
+}
+
 static ucs_status_t run_test_recurs(struct perftest_context *ctx,
                                     const perftest_params_t *parent_params,
                                     unsigned depth)
 {
     perftest_params_t params;
-    ucx_perf_result_t result;
     ucs_status_t status;
     FILE *batch_file;
     int line_num;
@@ -1624,7 +2827,7 @@ static ucs_status_t run_test_recurs(struct perftest_context *ctx,
 
     if (depth >= ctx->num_batch_files) {
         print_test_name(ctx);
-        return ucx_perf_run(&parent_params->super, &result);
+        return run_config_sweep(ctx, parent_params);
     }
 
     batch_file = fopen(ctx->batch_files[depth], "r");
@@ -1651,6 +2854,8 @@ static ucs_status_t run_test_recurs(struct perftest_context *ctx,
 
         free(params.super.msg_size_list);
         params.super.msg_size_list = NULL;
+        free(params.super.ucp.rpc.trace);
+        params.super.ucp.rpc.trace = NULL;
     } while (status == UCS_OK);
 
     if (status == UCS_ERR_NO_ELEM) {
@@ -1765,11 +2970,20 @@ int main(int argc, char **argv)
         goto out_cleanup_rte;
     }
 
-    ret = 0;
+    /* let scripts gate on performance regressions */
+    ret = (ctx.num_regressions > 0) ? 1 : 0;
 
 out_cleanup_rte:
+    if (ctx.hist_stream != NULL) {
+        fclose(ctx.hist_stream);
+    }
+    if (ctx.json_stream != NULL) {
+        fclose(ctx.json_stream);
+    }
+    free(ctx.windows);
     (mpi_rte) ? cleanup_mpi_rte(&ctx) : cleanup_sock_rte(&ctx);
 out_msg_size_list:
+    free(ctx.params.super.ucp.rpc.trace);
     free(ctx.params.super.msg_size_list);
 #if HAVE_MPI
 out:
@@ -62,9 +62,17 @@ typedef enum {
 } time_units_t;
 
 
+typedef enum {
+    OUTPUT_FORMAT_TEXT,
+    OUTPUT_FORMAT_CHROME_TRACE,
+    OUTPUT_FORMAT_LAST
+} output_format_t;
+
+
 typedef struct options {
     const char                   *filename;
     int                          raw;
+    output_format_t              format;
     time_units_t                 time_units;
     int                          thread_list[MAX_THREADS + 1];
 } options_t;
@@ -93,6 +101,12 @@ typedef struct {
 } profile_sorted_location_t;
 
 
+typedef struct {
+    const ucs_profile_record_t   *rec;
+    int                          thread_idx;
+} profile_request_record_t;
+
+
 /* Used to redirect output to a "less" command */
 static int output_pipefds[2] = {-1, -1};
 
@@ -592,6 +606,273 @@ static void show_profile_data_log(profile_data_t *data, options_t *opts,
     free(scope_ends);
 }
 
+static void print_json_string(const char *str)
+{
+    putchar('"');
+    for (; *str != '\0'; ++str) {
+        if ((*str == '"') || (*str == '\\')) {
+            printf("\\%c", *str);
+        } else if ((unsigned char)*str < ' ') {
+            printf("\\u%04x", *str);
+        } else {
+            putchar(*str);
+        }
+    }
+    putchar('"');
+}
+
+static double trace_timestamp(const profile_data_t *data, uint64_t base_time,
+                              uint64_t time)
+{
+    /* Chrome trace timestamps are in microseconds */
+    return (time - base_time) * 1e6 / data->header->one_second;
+}
+
+static void trace_event_begin(int *first, const char *phase,
+                              const ucs_profile_location_t *loc,
+                              const char *name, const char *category,
+                              uint32_t pid, uint32_t tid, double ts)
+{
+    printf("%s\n    {\"ph\": \"%s\", \"pid\": %u, \"tid\": %u, "
+           "\"ts\": %.3f, \"cat\": \"%s\", \"name\": ", *first ? "" : ",",
+           phase, pid, tid, ts, category);
+    print_json_string(name);
+    if (loc != NULL) {
+        printf(", \"args\": {\"location\": \"%s:%d\", \"function\": ",
+               loc->file, loc->line);
+        print_json_string(loc->function);
+        printf("}");
+    }
+    *first = 0;
+}
+
+static void trace_thread_scopes(const profile_data_t *data, int thread_idx,
+                                uint64_t base_time, int *first)
+{
+    const profile_thread_data_t *thread = &data->threads[thread_idx];
+    size_t num_records                  = thread->header->num_records;
+    const ucs_profile_record_t **stack, *rec, *begin;
+    const ucs_profile_location_t *loc;
+    char name[sizeof(loc->name) + 8];
+    size_t stack_top;
+    double ts;
+
+    stack = calloc(num_records + 1, sizeof(*stack));
+    if (stack == NULL) {
+        print_error("failed to allocate scope stack");
+        return;
+    }
+
+    /* Scope names are stored in the end location, so emit a complete event
+     * when the scope ends. Scopes which were cut by the log wraparound, or did
+     * not finish yet, are not displayed.
+     */
+    stack_top = 0;
+    for (rec = thread->records; rec < thread->records + num_records; ++rec) {
+        loc = &data->locations[rec->location];
+        ts  = trace_timestamp(data, base_time, rec->timestamp);
+        switch (loc->type) {
+        case UCS_PROFILE_TYPE_SCOPE_BEGIN:
+            stack[stack_top++] = rec;
+            break;
+        case UCS_PROFILE_TYPE_SCOPE_END:
+            if (stack_top == 0) {
+                break;
+            }
+
+            begin = stack[--stack_top];
+            trace_event_begin(first, "X", loc, loc->name, "scope",
+                              data->header->pid, thread->header->tid,
+                              trace_timestamp(data, base_time,
+                                              begin->timestamp));
+            printf(", \"dur\": %.3f}", ts - trace_timestamp(data, base_time,
+                                                             begin->timestamp));
+            break;
+        case UCS_PROFILE_TYPE_SAMPLE:
+            trace_event_begin(first, "i", loc, loc->name, "sample",
+                              data->header->pid, thread->header->tid, ts);
+            printf(", \"s\": \"t\"}");
+            break;
+        case UCS_PROFILE_TYPE_REQUEST_NEW:
+        case UCS_PROFILE_TYPE_REQUEST_EVENT:
+        case UCS_PROFILE_TYPE_REQUEST_FREE:
+            snprintf(name, sizeof(name), "%s%s",
+                     (loc->type == UCS_PROFILE_TYPE_REQUEST_NEW)  ? "NEW " :
+                     (loc->type == UCS_PROFILE_TYPE_REQUEST_FREE) ? "FREE " :
+                     "", loc->name);
+            trace_event_begin(first, "i", loc, name, "request",
+                              data->header->pid, thread->header->tid, ts);
+            printf(", \"s\": \"t\"}");
+            break;
+        default:
+            break;
+        }
+    }
+
+    free(stack);
+}
+
+static int compare_request_records(const void *r1, const void *r2)
+{
+    const profile_request_record_t *req1 = r1;
+    const profile_request_record_t *req2 = r2;
+
+    return (req1->rec->timestamp < req2->rec->timestamp) ? -1 :
+           (req1->rec->timestamp > req2->rec->timestamp) ? +1 :
+           0;
+}
+
+static int trace_request_flows(const profile_data_t *data, options_t *opts,
+                               uint64_t base_time, int *first)
+{
+    profile_request_record_t *requests = NULL;
+    size_t num_requests                = 0;
+    size_t reqid_ctr                   = 1;
+    const profile_thread_data_t *thread;
+    const ucs_profile_location_t *loc;
+    const ucs_profile_record_t *rec;
+    profile_request_record_t *req;
+    khash_t(request_ids) reqids;
+    size_t max_requests, reqid;
+    const char *phase;
+    khiter_t hash_it;
+    int hash_status;
+    int *t;
+
+    max_requests = 0;
+    for (t = opts->thread_list; *t != -1; ++t) {
+        max_requests += data->threads[*t - 1].header->num_records;
+    }
+
+    requests = calloc(max_requests + 1, sizeof(*requests));
+    if (requests == NULL) {
+        print_error("failed to allocate request records");
+        return -ENOMEM;
+    }
+
+    /* Requests may be created and released on different threads, so collect
+     * the request records of all threads and link them in time order.
+     */
+    for (t = opts->thread_list; *t != -1; ++t) {
+        thread = &data->threads[*t - 1];
+        for (rec = thread->records;
+             rec < thread->records + thread->header->num_records; ++rec) {
+            loc = &data->locations[rec->location];
+            if ((loc->type == UCS_PROFILE_TYPE_REQUEST_NEW) ||
+                (loc->type == UCS_PROFILE_TYPE_REQUEST_EVENT) ||
+                (loc->type == UCS_PROFILE_TYPE_REQUEST_FREE)) {
+                requests[num_requests].rec        = rec;
+                requests[num_requests].thread_idx = *t - 1;
+                ++num_requests;
+            }
+        }
+    }
+
+    qsort(requests, num_requests, sizeof(*requests), compare_request_records);
+
+    kh_init_inplace(request_ids, &reqids);
+
+    for (req = requests; req < requests + num_requests; ++req) {
+        rec     = req->rec;
+        loc     = &data->locations[rec->location];
+        hash_it = kh_get(request_ids, &reqids, rec->param64);
+        if ((loc->type == UCS_PROFILE_TYPE_REQUEST_NEW) ||
+            (hash_it == kh_end(&reqids))) {
+            /* Start a new flow. A request which was not released, or was
+             * created before the log wraparound, gets a new identifier.
+             */
+            hash_it = kh_put(request_ids, &reqids, rec->param64, &hash_status);
+            if (hash_it == kh_end(&reqids)) {
+                print_error("failed to add request to hash");
+                continue;
+            }
+
+            reqid                      = reqid_ctr++;
+            kh_value(&reqids, hash_it) = reqid;
+            phase                      = "s";
+        } else {
+            reqid = kh_value(&reqids, hash_it);
+            phase = "t";
+        }
+
+        if (loc->type == UCS_PROFILE_TYPE_REQUEST_FREE) {
+            kh_del(request_ids, &reqids, hash_it);
+            if (!strcmp(phase, "t")) {
+                phase = "f";
+            }
+        }
+
+        /* Flow events are bound to the enclosing scope event of the thread */
+        thread = &data->threads[req->thread_idx];
+        trace_event_begin(first, phase, NULL, "request", "request",
+                          data->header->pid, thread->header->tid,
+                          trace_timestamp(data, base_time, rec->timestamp));
+        printf(", \"id\": %zu, \"bp\": \"e\"}", reqid);
+    }
+
+    kh_destroy_inplace(request_ids, &reqids);
+    free(requests);
+    return 0;
+}
+
+/*
+ * Export log records in Chrome trace event format, which can be loaded by
+ * chrome://tracing and https://ui.perfetto.dev
+ */
+static int export_chrome_trace(profile_data_t *data, options_t *opts)
+{
+    uint64_t base_time = UINT64_MAX;
+    const profile_thread_data_t *thread;
+    char thread_name[64];
+    int first = 1;
+    int ret;
+    int *t;
+
+    if (!(data->header->mode & UCS_BIT(UCS_PROFILE_MODE_LOG))) {
+        print_error("chrome trace export requires profiling data collected "
+                    "in 'log' mode");
+        return -EINVAL;
+    }
+
+    for (t = opts->thread_list; *t != -1; ++t) {
+        thread = &data->threads[*t - 1];
+        if (thread->header->num_records > 0) {
+            base_time = ucs_min(base_time, thread->records[0].timestamp);
+        }
+        base_time = ucs_min(base_time, thread->header->start_time);
+    }
+
+    printf("{\n  \"displayTimeUnit\": \"ns\",\n");
+    printf("  \"otherData\": {\"host\": ");
+    print_json_string(data->header->hostname);
+    printf(", \"command\": ");
+    print_json_string(data->header->cmdline);
+    printf(", \"ucs_lib\": ");
+    print_json_string(data->header->ucs_path);
+    printf("},\n  \"traceEvents\": [");
+
+    printf("\n    {\"ph\": \"M\", \"pid\": %u, \"name\": \"process_name\", "
+           "\"args\": {\"name\": ", data->header->pid);
+    print_json_string(data->header->cmdline);
+    printf("}}");
+    first = 0;
+
+    for (t = opts->thread_list; *t != -1; ++t) {
+        thread = &data->threads[*t - 1];
+        snprintf(thread_name, sizeof(thread_name), "thread %d%s", *t,
+                 (thread->header->tid == data->header->pid) ? " (main)" : "");
+        printf(",\n    {\"ph\": \"M\", \"pid\": %u, \"tid\": %u, "
+               "\"name\": \"thread_name\", \"args\": {\"name\": \"%s\"}}",
+               data->header->pid, thread->header->tid, thread_name);
+        trace_thread_scopes(data, *t - 1, base_time, &first);
+    }
+
+    ret = trace_request_flows(data, opts, base_time, &first);
+
+    printf("\n  ]\n}\n");
+    return ret;
+}
+
 static void close_pipes()
 {
     close(output_pipefds[0]);
@@ -752,6 +1033,10 @@ static int show_profile_data(profile_data_t *data, options_t *opts)
         }
     }
 
+    if (opts->format == OUTPUT_FORMAT_CHROME_TRACE) {
+        return export_chrome_trace(data, opts);
+    }
+
     /* redirect output if needed */
     if (!opts->raw) {
         ret = redirect_output(data, opts);
@@ -782,6 +1067,10 @@ static void usage()
     printf("Usage: ucx_read_profile [options] [profile-file]\n");
     printf("Options are:\n");
     printf("  -r              Show raw output\n");
+    printf("  -c              Export log records in Chrome trace event (JSON) "
+           "format,\n");
+    printf("                  which can be loaded by chrome://tracing or "
+           "Perfetto UI\n");
     printf("  -T <threads>    Comma-separated list of threads to show, "
            "e.g. \"1,2,3\", or \"all\" to show all threads\n");
     printf("  -t <units>      Select time units to use:\n");
@@ -797,17 +1086,21 @@ static int parse_args(int argc, char **argv, options_t *opts)
     int ret, c;
 
     opts->raw         = !isatty(fileno(stdout));
+    opts->format      = OUTPUT_FORMAT_TEXT;
     opts->time_units  = TIME_UNITS_USEC;
     ret = parse_thread_list(opts->thread_list, "all");
     if (ret < 0) {
         return ret;
     }
 
-    while ( (c = getopt(argc, argv, "rT:t:h")) != -1 ) {
+    while ( (c = getopt(argc, argv, "rcT:t:h")) != -1 ) {
         switch (c) {
         case 'r':
             opts->raw = 1;
             break;
+        case 'c':
+            opts->format = OUTPUT_FORMAT_CHROME_TRACE;
+            break;
         case 'T':
             ret = parse_thread_list(opts->thread_list, optarg);
             if (ret < 0) {
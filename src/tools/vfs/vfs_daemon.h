@@ -18,6 +18,8 @@
 
 #define VFS_DEFAULT_MOUNTPOINT_DIR "/tmp/ucx"
 #define VFS_FUSE_MOUNT_PROG        "fusermount3"
+#define VFS_DEFAULT_METRICS_ADDR   "127.0.0.1"
+#define VFS_DEFAULT_METRICS_TTL_MS 1000
 
 
 enum {
@@ -46,6 +48,9 @@ typedef struct {
     const char *mountpoint_dir;
     const char *mount_opts;
     const char *sock_path;
+    int        metrics_port;
+    const char *metrics_addr;
+    int        metrics_ttl_ms;
 } vfs_opts_t;
 
 
@@ -58,4 +63,14 @@ int vfs_unmount(int pid);
 
 int vfs_server_loop(int listen_fd);
 
+void vfs_get_mountpoint(pid_t pid, char *mountpoint, size_t max_length);
+
+const char *vfs_get_process_name(int pid, char *buf, size_t max_length);
+
+int vfs_metrics_listen();
+
+void vfs_metrics_serve(int connfd, const pid_t *pids, int num_pids);
+
+void vfs_metrics_cleanup();
+
 #endif
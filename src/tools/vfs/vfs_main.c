@@ -23,7 +23,10 @@ vfs_opts_t g_opts = {
     .verbose        = 0,
     .mountpoint_dir = VFS_DEFAULT_MOUNTPOINT_DIR,
     .mount_opts     = "",
-    .sock_path      = NULL
+    .sock_path      = NULL,
+    .metrics_port   = 0,
+    .metrics_addr   = VFS_DEFAULT_METRICS_ADDR,
+    .metrics_ttl_ms = VFS_DEFAULT_METRICS_TTL_MS
 };
 
 const char *vfs_action_names[] = {
@@ -105,12 +108,12 @@ static int vfs_run_fusermount(char **extra_argv)
     return 0;
 }
 
-static void vfs_get_mountpoint(pid_t pid, char *mountpoint, size_t max_length)
+void vfs_get_mountpoint(pid_t pid, char *mountpoint, size_t max_length)
 {
     snprintf(mountpoint, max_length, "%s/%d", g_opts.mountpoint_dir, pid);
 }
 
-static const char *vfs_get_process_name(int pid, char *buf, size_t max_length)
+const char *vfs_get_process_name(int pid, char *buf, size_t max_length)
 {
     char procfs_comm[NAME_MAX];
     size_t length;
@@ -379,6 +382,12 @@ static void vfs_usage()
     printf("  -v         Enable verbose logging (requires -f)\n");
     printf("  -l <path>  Set listening unix socket path (default: %s)\n",
            sock_addr.sun_path);
+    printf("  -p <port>  Serve metrics of attached processes in OpenMetrics\n");
+    printf("             format over HTTP on this port (default: disabled)\n");
+    printf("  -b <addr>  Set metrics listening address (default: %s)\n",
+           g_opts.metrics_addr);
+    printf("  -t <msec>  Set metrics cache lifetime (default: %d)\n",
+           g_opts.metrics_ttl_ms);
     printf("\n");
     printf("Actions:\n");
     printf("   start     Run the daemon and listen for connection from UCX\n");
@@ -393,7 +402,7 @@ static int vfs_parse_args(int argc, char **argv)
     const char *action_str;
     int c, i;
 
-    while ((c = getopt(argc, argv, "d:o:vfl:h")) != -1) {
+    while ((c = getopt(argc, argv, "d:o:vfl:p:b:t:h")) != -1) {
         switch (c) {
         case 'd':
             g_opts.mountpoint_dir = optarg;
@@ -410,6 +419,19 @@ static int vfs_parse_args(int argc, char **argv)
         case 'l':
             g_opts.sock_path = optarg;
             break;
+        case 'p':
+            g_opts.metrics_port = atoi(optarg);
+            if ((g_opts.metrics_port <= 0) || (g_opts.metrics_port > 65535)) {
+                vfs_error("invalid metrics port '%s'", optarg);
+                return -1;
+            }
+            break;
+        case 'b':
+            g_opts.metrics_addr = optarg;
+            break;
+        case 't':
+            g_opts.metrics_ttl_ms = atoi(optarg);
+            break;
         case 'h':
         default:
             vfs_usage();
@@ -0,0 +1,515 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "vfs_daemon.h"
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/stat.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+#define VFS_METRICS_HTTP_PATH       "/metrics"
+#define VFS_METRICS_CONTENT_TYPE    "application/openmetrics-text; " \
+                                    "version=1.0.0; charset=utf-8"
+#define VFS_METRICS_PREFIX          "ucx_"
+#define VFS_METRICS_MAX_DEPTH       16
+#define VFS_METRICS_MAX_REQUEST     4096
+#define VFS_METRICS_RECV_TIMEOUT_MS 1000
+
+
+typedef enum {
+    VFS_METRIC_TYPE_COUNTER,
+    VFS_METRIC_TYPE_GAUGE
+} vfs_metric_type_t;
+
+
+/* Metric files which UCX objects publish, and the type of their values */
+static const struct {
+    const char        *file_name;
+    vfs_metric_type_t type;
+} vfs_metric_files[] = {
+    {"counters", VFS_METRIC_TYPE_COUNTER},
+    {"gauges",   VFS_METRIC_TYPE_GAUGE}
+};
+
+static const char *vfs_metric_type_names[] = {
+    [VFS_METRIC_TYPE_COUNTER] = "counter",
+    [VFS_METRIC_TYPE_GAUGE]   = "gauge"
+};
+
+
+typedef struct {
+    char              *family; /* Metric family name */
+    vfs_metric_type_t type;    /* Metric type */
+    char              *labels; /* Formatted label set, without braces */
+    long long         value;   /* Sample value */
+    unsigned          seq;     /* Collection order, to keep the sort stable */
+} vfs_metric_sample_t;
+
+
+typedef struct {
+    vfs_metric_sample_t *samples;
+    unsigned            count;
+    unsigned            capacity;
+} vfs_metric_samples_t;
+
+
+/* Last rendered response body, reused until it is older than the TTL */
+static struct {
+    char   *body;
+    size_t length;
+    double timestamp;
+} vfs_metrics_cache = {NULL, 0, 0};
+
+
+static double vfs_metrics_get_time()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + (ts.tv_nsec * 1e-9);
+}
+
+static void vfs_metrics_sanitize_name(char *name)
+{
+    char *p;
+
+    for (p = name; *p != '\0'; ++p) {
+        if (!isalnum(*p) && (*p != '_') && (*p != ':')) {
+            *p = '_';
+        }
+    }
+}
+
+static void vfs_metrics_print_label(FILE *stream, const char *name,
+                                    const char *value)
+{
+    const char *p;
+
+    fprintf(stream, "%s=\"", name);
+    for (p = value; *p != '\0'; ++p) {
+        if ((*p == '\\') || (*p == '"')) {
+            fprintf(stream, "\\%c", *p);
+        } else if (*p == '\n') {
+            fprintf(stream, "\\n");
+        } else {
+            fputc(*p, stream);
+        }
+    }
+    fputc('"', stream);
+}
+
+static char *vfs_metrics_format_labels(int pid, const char *process,
+                                       const char *object)
+{
+    size_t size;
+    FILE *stream;
+    char *labels;
+
+    stream = open_memstream(&labels, &size);
+    if (stream == NULL) {
+        return NULL;
+    }
+
+    fprintf(stream, "pid=\"%d\",", pid);
+    vfs_metrics_print_label(stream, "process", process);
+    fputc(',', stream);
+    vfs_metrics_print_label(stream, "object", object);
+    fclose(stream);
+    return labels;
+}
+
+static int vfs_metrics_add_sample(vfs_metric_samples_t *samples,
+                                  const char *name, vfs_metric_type_t type,
+                                  const char *labels, long long value)
+{
+    vfs_metric_sample_t *sample;
+    unsigned capacity;
+    size_t length;
+
+    if (samples->count == samples->capacity) {
+        capacity = (samples->capacity == 0) ? 64 : (samples->capacity * 2);
+        sample   = realloc(samples->samples, capacity * sizeof(*sample));
+        if (sample == NULL) {
+            return -ENOMEM;
+        }
+
+        samples->samples  = sample;
+        samples->capacity = capacity;
+    }
+
+    length         = strlen(VFS_METRICS_PREFIX) + strlen(name) + 1;
+    sample         = &samples->samples[samples->count];
+    sample->family = malloc(length);
+    sample->labels = strdup(labels);
+    if ((sample->family == NULL) || (sample->labels == NULL)) {
+        free(sample->family);
+        free(sample->labels);
+        return -ENOMEM;
+    }
+
+    snprintf(sample->family, length, "%s%s", VFS_METRICS_PREFIX, name);
+    vfs_metrics_sanitize_name(sample->family);
+    sample->type  = type;
+    sample->value = value;
+    sample->seq   = samples->count++;
+    return 0;
+}
+
+static void vfs_metrics_free_samples(vfs_metric_samples_t *samples)
+{
+    unsigned i;
+
+    for (i = 0; i < samples->count; ++i) {
+        free(samples->samples[i].family);
+        free(samples->samples[i].labels);
+    }
+    free(samples->samples);
+}
+
+static int vfs_metrics_sample_compare(const void *elem1, const void *elem2)
+{
+    const vfs_metric_sample_t *sample1 = elem1;
+    const vfs_metric_sample_t *sample2 = elem2;
+    int ret;
+
+    ret = strcmp(sample1->family, sample2->family);
+    if (ret != 0) {
+        return ret;
+    }
+
+    return (sample1->seq < sample2->seq) ? -1 : 1;
+}
+
+/* Parse "<name> <value>" lines of a metric file */
+static void vfs_metrics_read_file(vfs_metric_samples_t *samples,
+                                  const char *path, vfs_metric_type_t type,
+                                  const char *labels)
+{
+    char line[256], name[128];
+    long long value;
+    FILE *file;
+
+    file = fopen(path, "r");
+    if (file == NULL) {
+        vfs_log("failed to open '%s': %m", path);
+        return;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (sscanf(line, "%127s %lld", name, &value) != 2) {
+            continue;
+        }
+
+        if (vfs_metrics_add_sample(samples, name, type, labels, value) < 0) {
+            break;
+        }
+    }
+
+    fclose(file);
+}
+
+static void vfs_metrics_walk_dir(vfs_metric_samples_t *samples,
+                                 const char *root, const char *rel_path,
+                                 int pid, const char *process, int depth)
+{
+    char path[PATH_MAX], child_rel_path[PATH_MAX];
+    struct dirent *entry;
+    struct stat st;
+    char *labels;
+    DIR *dir;
+    int i;
+
+    if (depth > VFS_METRICS_MAX_DEPTH) {
+        return;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s", root, rel_path);
+    dir = opendir(path);
+    if (dir == NULL) {
+        vfs_log("failed to open directory '%s': %m", path);
+        return;
+    }
+
+    while ((entry = readdir(dir)) != NULL) {
+        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "%s/%s%s%s", root, rel_path,
+                 (strlen(rel_path) > 0) ? "/" : "", entry->d_name);
+        if (stat(path, &st) < 0) {
+            continue;
+        }
+
+        if (S_ISDIR(st.st_mode)) {
+            snprintf(child_rel_path, sizeof(child_rel_path), "%s%s%s",
+                     rel_path, (strlen(rel_path) > 0) ? "/" : "",
+                     entry->d_name);
+            vfs_metrics_walk_dir(samples, root, child_rel_path, pid, process,
+                                 depth + 1);
+            continue;
+        }
+
+        for (i = 0; i < ucs_static_array_size(vfs_metric_files); ++i) {
+            if (strcmp(entry->d_name, vfs_metric_files[i].file_name)) {
+                continue;
+            }
+
+            labels = vfs_metrics_format_labels(pid, process, rel_path);
+            if (labels != NULL) {
+                vfs_metrics_read_file(samples, path, vfs_metric_files[i].type,
+                                      labels);
+                free(labels);
+            }
+        }
+    }
+
+    closedir(dir);
+}
+
+static void vfs_metrics_print_samples(FILE *stream,
+                                      vfs_metric_samples_t *samples)
+{
+    const char *family = NULL;
+    vfs_metric_type_t type = VFS_METRIC_TYPE_GAUGE;
+    vfs_metric_sample_t *sample;
+    unsigned i;
+
+    /* OpenMetrics requires the samples of a family to be consecutive */
+    qsort(samples->samples, samples->count, sizeof(*samples->samples),
+          vfs_metrics_sample_compare);
+
+    for (i = 0; i < samples->count; ++i) {
+        sample = &samples->samples[i];
+        if ((family == NULL) || strcmp(family, sample->family)) {
+            family = sample->family;
+            type   = sample->type;
+            fprintf(stream, "# TYPE %s %s\n", family,
+                    vfs_metric_type_names[type]);
+        } else if (sample->type != type) {
+            vfs_log("dropping %s sample of %s family '%s'",
+                    vfs_metric_type_names[sample->type],
+                    vfs_metric_type_names[type], family);
+            continue;
+        }
+
+        fprintf(stream, "%s%s{%s} %lld\n", sample->family,
+                (type == VFS_METRIC_TYPE_COUNTER) ? "_total" : "",
+                sample->labels, sample->value);
+    }
+}
+
+static int vfs_metrics_render(const pid_t *pids, int num_pids)
+{
+    vfs_metric_samples_t samples = {NULL, 0, 0};
+    char mountpoint[PATH_MAX];
+    char process[NAME_MAX];
+    double start_time;
+    size_t length;
+    FILE *stream;
+    char *body;
+    int i;
+
+    start_time = vfs_metrics_get_time();
+    for (i = 0; i < num_pids; ++i) {
+        vfs_get_mountpoint(pids[i], mountpoint, sizeof(mountpoint));
+        vfs_get_process_name(pids[i], process, sizeof(process));
+        vfs_metrics_walk_dir(&samples, mountpoint, "", pids[i], process, 0);
+    }
+
+    stream = open_memstream(&body, &length);
+    if (stream == NULL) {
+        vfs_metrics_free_samples(&samples);
+        return -ENOMEM;
+    }
+
+    vfs_metrics_print_samples(stream, &samples);
+    fprintf(stream, "# TYPE %svfs_processes gauge\n", VFS_METRICS_PREFIX);
+    fprintf(stream, "%svfs_processes %d\n", VFS_METRICS_PREFIX, num_pids);
+    fprintf(stream, "# TYPE %svfs_scrape_duration_seconds gauge\n",
+            VFS_METRICS_PREFIX);
+    fprintf(stream, "%svfs_scrape_duration_seconds %.6f\n", VFS_METRICS_PREFIX,
+            vfs_metrics_get_time() - start_time);
+    fprintf(stream, "# EOF\n");
+    fclose(stream);
+
+    vfs_metrics_free_samples(&samples);
+
+    free(vfs_metrics_cache.body);
+    vfs_metrics_cache.body      = body;
+    vfs_metrics_cache.length    = length;
+    vfs_metrics_cache.timestamp = vfs_metrics_get_time();
+    return 0;
+}
+
+static void vfs_metrics_send(int connfd, const char *status,
+                             const char *content_type, const char *body,
+                             size_t length)
+{
+    char header[256];
+    ssize_t ret;
+    size_t sent;
+
+    snprintf(header, sizeof(header),
+             "HTTP/1.1 %s\r\n"
+             "Content-Type: %s\r\n"
+             "Content-Length: %zu\r\n"
+             "Connection: close\r\n"
+             "\r\n", status, content_type, length);
+
+    ret = send(connfd, header, strlen(header), MSG_NOSIGNAL);
+    if (ret < 0) {
+        vfs_log("failed to send metrics response header: %m");
+        return;
+    }
+
+    for (sent = 0; sent < length; sent += ret) {
+        ret = send(connfd, body + sent, length - sent, MSG_NOSIGNAL);
+        if (ret < 0) {
+            vfs_log("failed to send metrics response body: %m");
+            return;
+        }
+    }
+}
+
+static void vfs_metrics_send_error(int connfd, const char *status)
+{
+    vfs_metrics_send(connfd, status, "text/plain", status, strlen(status));
+}
+
+/* Receive the request header and return 1 if it is a valid metrics request.
+ * Otherwise, send an error response and return 0. */
+static int vfs_metrics_recv_request(int connfd)
+{
+    char request[VFS_METRICS_MAX_REQUEST];
+    char method[16], path[256];
+    struct timeval tv;
+    size_t length;
+    ssize_t ret;
+
+    tv.tv_sec  = VFS_METRICS_RECV_TIMEOUT_MS / 1000;
+    tv.tv_usec = (VFS_METRICS_RECV_TIMEOUT_MS % 1000) * 1000;
+    setsockopt(connfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    length = 0;
+    do {
+        ret = recv(connfd, request + length, sizeof(request) - length - 1, 0);
+        if (ret <= 0) {
+            vfs_log("failed to receive metrics request: %m");
+            return 0;
+        }
+
+        length         += ret;
+        request[length] = '\0';
+    } while ((strstr(request, "\r\n\r\n") == NULL) &&
+             (length < (sizeof(request) - 1)));
+
+    if (sscanf(request, "%15s %255s", method, path) != 2) {
+        vfs_metrics_send_error(connfd, "400 Bad Request");
+        return 0;
+    }
+
+    vfs_log("metrics request '%s %s'", method, path);
+
+    if (strcmp(method, "GET")) {
+        vfs_metrics_send_error(connfd, "405 Method Not Allowed");
+        return 0;
+    }
+
+    /* Ignore query parameters */
+    path[strcspn(path, "?")] = '\0';
+    if (strcmp(path, VFS_METRICS_HTTP_PATH)) {
+        vfs_metrics_send_error(connfd, "404 Not Found");
+        return 0;
+    }
+
+    return 1;
+}
+
+void vfs_metrics_serve(int connfd, const pid_t *pids, int num_pids)
+{
+    if (!vfs_metrics_recv_request(connfd)) {
+        return;
+    }
+
+    if ((vfs_metrics_cache.body == NULL) ||
+        ((vfs_metrics_get_time() - vfs_metrics_cache.timestamp) * 1000.0 >=
+         g_opts.metrics_ttl_ms)) {
+        if (vfs_metrics_render(pids, num_pids) < 0) {
+            vfs_metrics_send_error(connfd, "500 Internal Server Error");
+            return;
+        }
+    }
+
+    vfs_metrics_send(connfd, "200 OK", VFS_METRICS_CONTENT_TYPE,
+                     vfs_metrics_cache.body, vfs_metrics_cache.length);
+}
+
+/* return listening socket fd, or the (negative) value of errno */
+int vfs_metrics_listen()
+{
+    struct sockaddr_in addr;
+    int listen_fd, ret;
+    int optval = 1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons(g_opts.metrics_port);
+    if (inet_pton(AF_INET, g_opts.metrics_addr, &addr.sin_addr) != 1) {
+        vfs_error("invalid metrics listen address '%s'", g_opts.metrics_addr);
+        return -EINVAL;
+    }
+
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        ret = -errno;
+        vfs_error("failed to create metrics socket: %m");
+        return ret;
+    }
+
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+
+    ret = bind(listen_fd, (const struct sockaddr*)&addr, sizeof(addr));
+    if (ret < 0) {
+        ret = -errno;
+        vfs_error("bind(%s:%d) failed: %m", g_opts.metrics_addr,
+                  g_opts.metrics_port);
+        goto err_close;
+    }
+
+    ret = listen(listen_fd, 16);
+    if (ret < 0) {
+        ret = -errno;
+        vfs_error("listen() on metrics socket failed: %m");
+        goto err_close;
+    }
+
+    vfs_log("serving metrics on http://%s:%d%s", g_opts.metrics_addr,
+            g_opts.metrics_port, VFS_METRICS_HTTP_PATH);
+    return listen_fd;
+
+err_close:
+    close(listen_fd);
+    return ret;
+}
+
+void vfs_metrics_cleanup()
+{
+    free(vfs_metrics_cache.body);
+    vfs_metrics_cache.body   = NULL;
+    vfs_metrics_cache.length = 0;
+}
@@ -22,7 +22,8 @@ typedef enum {
     VFS_FD_STATE_ACCEPTED,
     VFS_FD_STATE_MOUNTED,
     VFS_FD_STATE_FD_SENT,
-    VFS_FD_STATE_CLOSED
+    VFS_FD_STATE_CLOSED,
+    VFS_FD_STATE_HTTP_LISTENING
 } vfs_socket_state_t;
 
 typedef struct {
@@ -41,11 +42,12 @@ typedef struct {
 static vfs_server_context_t vfs_server_context;
 
 static const char *vfs_server_fd_state_names[] = {
-    [VFS_FD_STATE_LISTENING] = "LISTENING",
-    [VFS_FD_STATE_ACCEPTED]  = "ACCEPTED",
-    [VFS_FD_STATE_MOUNTED]   = "MOUNTED",
-    [VFS_FD_STATE_FD_SENT]   = "FD_SENT",
-    [VFS_FD_STATE_CLOSED]    = "CLOSED"
+    [VFS_FD_STATE_LISTENING]      = "LISTENING",
+    [VFS_FD_STATE_ACCEPTED]       = "ACCEPTED",
+    [VFS_FD_STATE_MOUNTED]        = "MOUNTED",
+    [VFS_FD_STATE_FD_SENT]        = "FD_SENT",
+    [VFS_FD_STATE_CLOSED]         = "CLOSED",
+    [VFS_FD_STATE_HTTP_LISTENING] = "HTTP_LISTENING"
 };
 
 static void vfs_server_log_context(int events)
@@ -159,6 +161,7 @@ static void vfs_server_remove_fd(int idx)
         vfs_unmount(vfs_server_context.fd_state[idx].pid);
         /* Fall through */
     case VFS_FD_STATE_ACCEPTED:
+    case VFS_FD_STATE_HTTP_LISTENING:
         vfs_server_close_fd(vfs_server_context.poll_fds[idx].fd);
         /* Fall through */
     default:
@@ -199,6 +202,29 @@ static void vfs_server_accept(int listen_fd)
     vfs_server_add_fd(connfd, VFS_FD_STATE_ACCEPTED);
 }
 
+static void vfs_server_serve_metrics(int listen_fd)
+{
+    pid_t pids[VFS_MAX_FDS];
+    int idx, connfd, num_pids;
+
+    connfd = accept(listen_fd, NULL, NULL);
+    if (connfd < 0) {
+        vfs_error("accept(listen_fd=%d) failed: %m", listen_fd);
+        return;
+    }
+
+    /* Only processes which received the fuse fd have their mount populated */
+    num_pids = 0;
+    for (idx = 0; idx < vfs_server_context.nfds; ++idx) {
+        if (vfs_server_context.fd_state[idx].state == VFS_FD_STATE_FD_SENT) {
+            pids[num_pids++] = vfs_server_context.fd_state[idx].pid;
+        }
+    }
+
+    vfs_metrics_serve(connfd, pids, num_pids);
+    vfs_server_close_fd(connfd);
+}
+
 static void vfs_server_mount(int idx, pid_t pid)
 {
     int fuse_fd;
@@ -267,6 +293,9 @@ static void vfs_server_handle_pollin(int idx)
     case VFS_FD_STATE_FD_SENT:
         vfs_server_remove_fd(idx);
         break;
+    case VFS_FD_STATE_HTTP_LISTENING:
+        vfs_server_serve_metrics(vfs_server_context.poll_fds[idx].fd);
+        break;
     default:
         vfs_server_log_fd(idx, "unexpected POLLIN event on");
         vfs_server_remove_fd(idx);
@@ -331,6 +360,7 @@ static void vfs_server_set_sighandler()
 int vfs_server_loop(int listen_fd)
 {
     int idx, valid_idx;
+    int metrics_fd;
     int ret;
 
     vfs_server_context.nfds = 0;
@@ -340,6 +370,16 @@ int vfs_server_loop(int listen_fd)
 
     vfs_server_add_fd(listen_fd, VFS_FD_STATE_LISTENING);
 
+    if (g_opts.metrics_port != 0) {
+        metrics_fd = vfs_metrics_listen();
+        if (metrics_fd < 0) {
+            vfs_server_remove_all_fds();
+            return metrics_fd;
+        }
+
+        vfs_server_add_fd(metrics_fd, VFS_FD_STATE_HTTP_LISTENING);
+    }
+
     while (!vfs_server_context.stop) {
         ret = vfs_server_poll_events();
         if (ret < 0) {
@@ -373,6 +413,7 @@ int vfs_server_loop(int listen_fd)
     }
 
     vfs_server_remove_all_fds();
+    vfs_metrics_cleanup();
 
     return 0;
 }
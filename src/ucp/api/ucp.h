@@ -222,7 +222,16 @@ typedef enum {
     /**< Pack addresses of network devices only. Using such shortened addresses
      *   for the remote node peers will reduce the amount of wireup data being
      *   exchanged during connection establishment phase. */
-    UCP_WORKER_ADDRESS_FLAG_NET_ONLY = UCS_BIT(0)
+    UCP_WORKER_ADDRESS_FLAG_NET_ONLY = UCS_BIT(0),
+
+    /**< Pack a compact address, which carries only the fields which differ
+     *   between workers on similar nodes, such as device and interface
+     *   addresses. Transport attributes are replaced by a key of the worker's
+     *   system profile, so the address can be used only by peers with the
+     *   same transports, devices and configuration - typically, processes
+     *   of a job running on homogeneous nodes. Other peers fail to connect
+     *   with @ref UCS_ERR_UNREACHABLE. */
+    UCP_WORKER_ADDRESS_FLAG_COMPACT  = UCS_BIT(1)
 } ucp_worker_address_flags_t;
 
 
@@ -646,6 +655,7 @@ typedef enum {
     UCP_OP_ATTR_FIELD_REPLY_BUFFER  = UCS_BIT(5),  /**< reply_buffer field */
     UCP_OP_ATTR_FIELD_MEMORY_TYPE   = UCS_BIT(6),  /**< memory type field */
     UCP_OP_ATTR_FIELD_RECV_INFO     = UCS_BIT(7),  /**< recv_info field */
+    UCP_OP_ATTR_FIELD_COUNTER       = UCS_BIT(8),  /**< counter field */
 
     UCP_OP_ATTR_FLAG_NO_IMM_CMPL    = UCS_BIT(16), /**< deny immediate completion */
     UCP_OP_ATTR_FLAG_FAST_CMPL      = UCS_BIT(17), /**< expedite local completion,
@@ -1559,6 +1569,20 @@ typedef struct {
                                           Relevant for @a ucp_tag_recv_nbx
                                           function. */
     } recv_info;
+
+    /**
+     * Completion counter, which is incremented by one when the operation is
+     * completed. Supported by @ref ucp_put_nbx, @ref ucp_get_nbx and
+     * @ref ucp_atomic_op_nbx. If this field is set, the operation does not
+     * return a request handle: NULL means the operation was started, and it
+     * is completed when the counter is incremented, either before the function
+     * returns or during @ref ucp_worker_progress. This allows tracking many
+     * outstanding operations by waiting for the counter to reach the number
+     * of issued operations. Cannot be used together with the request and the
+     * callback fields. The counter is incremented regardless of the completion
+     * status, and failures are reported by the endpoint error handler.
+     */
+    uint64_t          *counter;
 } ucp_request_param_t;
 
 
@@ -3307,6 +3331,46 @@ ucs_status_ptr_t ucp_tag_send_nbx(ucp_ep_h ep, const void *buffer, size_t count,
                                   ucp_tag_t tag, const ucp_request_param_t *param);
 
 
+/**
+ * @ingroup UCP_COMM
+ * @brief Create a persistent tagged-send request.
+ *
+ * This routine creates a request which describes a tagged-send operation of
+ * the local @a buffer, size @a count, to the destination endpoint @a ep, with
+ * the message @a tag. The operation is not started by this routine; it is
+ * started every time @ref ucp_request_start is called on the returned request,
+ * which allows sending the same buffer repeatedly without resolving the
+ * message length, memory type and send protocol again.
+ *
+ * The request is created in inactive state: @ref ucp_request_check_status
+ * returns UCS_OK for it. While a started operation is in progress the request
+ * is active and @ref ucp_request_check_status returns UCS_INPROGRESS. When the
+ * operation completes, the request becomes inactive again and the call-back
+ * from @a param, if any, is invoked with the request handle and the completion
+ * status. The call-back may be invoked before @ref ucp_request_start returns.
+ *
+ * The supported fields of @a param are the datatype, memory type, call-back,
+ * user data, request handle and @ref UCP_OP_ATTR_FLAG_FAST_CMPL.
+ *
+ * @note The contents of @a buffer may be modified between operations, but not
+ *       while an operation is in progress.
+ * @note The request must be released with @ref ucp_request_free, unless it
+ *       was allocated by the user, before the endpoint @a ep is closed.
+ *
+ * @param [in]  ep          Destination endpoint handle.
+ * @param [in]  buffer      Pointer to the message buffer (payload).
+ * @param [in]  count       Number of elements to send
+ * @param [in]  tag         Message tag.
+ * @param [in]  param       Operation parameters, see @ref ucp_request_param_t
+ *
+ * @return UCS_PTR_IS_ERR(_ptr) - The request could not be created.
+ * @return otherwise            - Persistent request handle.
+ */
+ucs_status_ptr_t ucp_tag_send_init_nbx(ucp_ep_h ep, const void *buffer,
+                                       size_t count, ucp_tag_t tag,
+                                       const ucp_request_param_t *param);
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Non-blocking synchronous tagged-send operation.
@@ -4122,6 +4186,26 @@ ucp_atomic_op_nbx(ucp_ep_h ep, ucp_atomic_op_t opcode, const void *buffer,
 ucs_status_t ucp_request_check_status(void *request);
 
 
+/**
+ * @ingroup UCP_COMM
+ * @brief Start the operation of a persistent request.
+ *
+ * This routine starts the operation described by a persistent request, which
+ * was created by @ref ucp_tag_send_init_nbx. The request must be inactive,
+ * i.e. its previous operation, if any, has completed. The completion of the
+ * operation is reported by the request call-back and by
+ * @ref ucp_request_check_status.
+ *
+ * @param [in]  request     Persistent request to start.
+ *
+ * @return UCS_OK           - The operation was started, or already completed.
+ * @return UCS_ERR_BUSY     - The previous operation of the request is still in
+ *                            progress.
+ * @return Other            - The operation could not be started.
+ */
+ucs_status_t ucp_request_start(void *request);
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Check the status and currently available state of non-blocking request
@@ -4253,6 +4337,35 @@ ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *contex
                                    ucp_datatype_t *datatype_p);
 
 
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Create a strided datatype.
+ *
+ * This routine creates a datatype which describes an MPI-style vector: every
+ * element consists of @a block_count blocks of @a block_length bytes, and the
+ * start addresses of consecutive blocks are @a stride bytes apart. Consecutive
+ * elements follow each other, so the element at index i starts at
+ * i * ((block_count - 1) * stride + block_length) bytes from the buffer
+ * start. The data is packed and unpacked by UCP, without calling user
+ * routines. If the blocks are adjacent, a contiguous datatype is returned, so
+ * zero-copy protocols may be used to send it.
+ *
+ * The application is responsible for releasing the @a datatype_p object using
+ * @ref ucp_dt_destroy "ucp_dt_destroy()" routine.
+ *
+ * @param [in]  block_count  Number of blocks in an element.
+ * @param [in]  block_length Size of every block, in bytes.
+ * @param [in]  stride       Distance between the start addresses of
+ *                           consecutive blocks, in bytes. Must not be less
+ *                           than @a block_length.
+ * @param [out] datatype_p   A pointer to datatype object.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_dt_create_strided(size_t block_count, size_t block_length,
+                                   size_t stride, ucp_datatype_t *datatype_p);
+
+
 /**
  * @ingroup UCP_DATATYPE
  * @brief Destroy a datatype and release its resources.
@@ -4260,7 +4373,8 @@ ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *contex
  * This routine destroys the @a datatype object and
  * releases any resources that are associated with the object.
  * The @a datatype object must be allocated using @ref ucp_dt_create_generic
- * "ucp_dt_create_generic()" routine.
+ * "ucp_dt_create_generic()" or @ref ucp_dt_create_strided
+ * "ucp_dt_create_strided()" routines.
  *
  * @warning
  * @li Once the @a datatype object is released an access to this object may
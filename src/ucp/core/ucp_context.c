@@ -13,6 +13,7 @@
 #include "ucp_context.h"
 #include "ucp_request.h"
 
+#include <ucp/proto/proto_trace.h>
 #include <ucs/config/parser.h>
 #include <ucs/algorithm/crc.h>
 #include <ucs/datastruct/mpool.inl>
@@ -182,6 +183,15 @@ static ucs_config_field_t ucp_config_table[] = {
    "Segment size that is used to perform data transfer when doing RKEY PTR progress",
    ucs_offsetof(ucp_config_t, ctx.rkey_ptr_seg_size), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"RKEY_CACHE_SIZE", "0",
+   "Maximal number of unpacked remote keys to keep in a per-worker cache. Remote\n"
+   "keys unpacked from identical buffers on endpoints with the same configuration\n"
+   "share one handle, and the least recently used keys are evicted when the cache\n"
+   "is full. Cached keys are not released when the remote memory is unmapped, so\n"
+   "the cache should be enabled only if packed keys are not reused by the peer\n"
+   "for a different memory region. 0 disables the cache.",
+   ucs_offsetof(ucp_config_t, ctx.rkey_cache_size), UCS_CONFIG_TYPE_UINT},
+
   {"ZCOPY_THRESH", "auto",
    "Threshold for switching from buffer copy to zero copy protocol",
    ucs_offsetof(ucp_config_t, ctx.zcopy_thresh), UCS_CONFIG_TYPE_MEMUNITS},
@@ -201,6 +211,15 @@ static ucs_config_field_t ucp_config_table[] = {
    "          Otherwise the CPU mode is selected.",
    ucs_offsetof(ucp_config_t, ctx.atomic_mode), UCS_CONFIG_TYPE_ENUM(ucp_atomic_modes)},
 
+  {"AMO_SW_BATCH", "16",
+   "Maximal number of software atomic operations to the same endpoint which are\n"
+   "aggregated into one active message. Operations are aggregated only while the\n"
+   "peer did not complete previous operations on the endpoint, or the transport\n"
+   "has no resources to send them, so an idle endpoint does not add latency.\n"
+   "The fetch results of a batch are returned in a single reply.\n"
+   "1 disables the aggregation.",
+   ucs_offsetof(ucp_config_t, ctx.amo_sw_batch), UCS_CONFIG_TYPE_UINT},
+
   {"ADDRESS_DEBUG_INFO",
 #if ENABLE_DEBUG_DATA
    "y",
@@ -281,6 +300,13 @@ static ucs_config_field_t ucp_config_table[] = {
    "RNDV size threshold to enable sender side pipeline for mem type\n",
    ucs_offsetof(ucp_config_t, ctx.rndv_pipeline_send_thresh), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"RNDV_PIPELINE_DEPTH", "inf",
+   "Maximal number of RNDV pipeline fragments which are in flight at the same\n"
+   "time for a single request. Further fragments are issued as the previous\n"
+   "ones complete, so the staging memory used by a request is bounded by\n"
+   "RNDV_PIPELINE_DEPTH * RNDV_FRAG_SIZE. \"inf\" issues all fragments at once.",
+   ucs_offsetof(ucp_config_t, ctx.rndv_pipeline_depth), UCS_CONFIG_TYPE_ULUNITS},
+
   {"MEMTYPE_CACHE", "y",
    "Enable memory type (cuda/rocm) cache \n",
    ucs_offsetof(ucp_config_t, ctx.enable_memtype_cache), UCS_CONFIG_TYPE_BOOL},
@@ -291,6 +317,22 @@ static ucs_config_field_t ucp_config_table[] = {
    "another thread, or incoming active messages, but consumes more resources.",
    ucs_offsetof(ucp_config_t, ctx.flush_worker_eps), UCS_CONFIG_TYPE_BOOL},
 
+  {"STREAM_RECV_COALESCE", "n",
+   "When a stream receive request without the WAITALL flag is partially\n"
+   "filled, complete it only at the end of the current progress call rather\n"
+   "than right away. Data of further messages which arrive in the meantime\n"
+   "is placed directly to the user buffer, instead of being queued and copied\n"
+   "by the next receive operation.",
+   ucs_offsetof(ucp_config_t, ctx.stream_recv_coalesce), UCS_CONFIG_TYPE_BOOL},
+
+  {"EP_LAZY_CONNECT", "n",
+   "Defer the connection of endpoints created to a remote worker address until\n"
+   "the first operation is posted on them, or until the peer connects. Endpoint\n"
+   "creation only keeps a copy of the remote address, while lanes selection and\n"
+   "transport endpoints creation are done on demand. This reduces the startup\n"
+   "time and memory footprint of jobs where most of the peers never communicate.",
+   ucs_offsetof(ucp_config_t, ctx.ep_lazy_connect), UCS_CONFIG_TYPE_BOOL},
+
   {"UNIFIED_MODE", "n",
    "Enable various optimizations intended for homogeneous environment.\n"
    "Enabling this mode implies that the local transport resources/devices\n"
@@ -313,16 +355,64 @@ static ucs_config_field_t ucp_config_table[] = {
    "Experimental: enable new protocol selection logic",
    ucs_offsetof(ucp_config_t, ctx.proto_enable), UCS_CONFIG_TYPE_BOOL},
 
+  {"PROTO_ADAPTIVE", "n",
+   "Experimental: refine the thresholds between protocols chosen by the new\n"
+   "protocol selection logic according to the latency observed for sampled\n"
+   "operations. Thresholds which were set explicitly by the user are not\n"
+   "changed. Requires PROTO_ENABLE=y.",
+   ucs_offsetof(ucp_config_t, ctx.proto_adaptive), UCS_CONFIG_TYPE_BOOL},
+
+  {"PROTO_ADAPTIVE_INTERVAL", "16",
+   "When PROTO_ADAPTIVE is enabled, sample one of every N operations whose\n"
+   "size is close to a protocol threshold. Must be greater than 0.",
+   ucs_offsetof(ucp_config_t, ctx.proto_adaptive_interval),
+   UCS_CONFIG_TYPE_UINT},
+
+  {"PROTO_ADAPTIVE_SAMPLES", "32",
+   "When PROTO_ADAPTIVE is enabled, the number of samples for each protocol\n"
+   "and message size range which is required to move a protocol threshold.",
+   ucs_offsetof(ucp_config_t, ctx.proto_adaptive_samples),
+   UCS_CONFIG_TYPE_UINT},
+
+  {"PROTO_TRACE", "n",
+   "Record the protocol, lanes, message size and memory type selected for\n"
+   "sampled send operations, and the time until their first send and their\n"
+   "completion, in a per-worker ring buffer. Tracing can also be enabled at\n"
+   "runtime by writing to the \"proto_trace/enable\" VFS file of the worker,\n"
+   "and the records are read from \"proto_trace/records\".\n"
+   "Requires PROTO_ENABLE=y.",
+   ucs_offsetof(ucp_config_t, ctx.proto_trace), UCS_CONFIG_TYPE_BOOL},
+
+  {"PROTO_TRACE_RATE", "64",
+   "Trace one of every N send operations. Must be greater than 0.",
+   ucs_offsetof(ucp_config_t, ctx.proto_trace_rate), UCS_CONFIG_TYPE_UINT},
+
+  {"PROTO_TRACE_SIZE", "1024",
+   "Number of records in the protocol trace ring buffer of each worker.\n"
+   "Older records are overwritten. Must be between 1 and 65536.",
+   ucs_offsetof(ucp_config_t, ctx.proto_trace_size), UCS_CONFIG_TYPE_UINT},
+
   /* TODO: set for keepalive more reasonable values */
   {"KEEPALIVE_INTERVAL", "60s",
-   "Time interval between keepalive rounds (0 - disabled).",
+   "Time interval between keepalive checks of an endpoint (0 - disabled).\n"
+   "An endpoint which received a message from its peer during the interval\n"
+   "is not checked.",
    ucs_offsetof(ucp_config_t, ctx.keepalive_interval), UCS_CONFIG_TYPE_TIME},
 
   {"KEEPALIVE_NUM_EPS", "128",
-   "Maximal number of endpoints to check on every keepalive round\n"
-   "(inf - check all endpoints on every round, must be greater than 0)",
+   "Maximal number of endpoints to check on every progress call, when the\n"
+   "keepalive deadline of many endpoints expires at once\n"
+   "(inf - check all due endpoints, must be greater than 0)",
    ucs_offsetof(ucp_config_t, ctx.keepalive_num_eps), UCS_CONFIG_TYPE_UINT},
 
+  {"TX_SCHED_QUANTUM", "inf",
+   "Quantum, in bytes, of the deficit round-robin scheduling between endpoints\n"
+   "which send multi-fragment messages from transport pending queues. An endpoint\n"
+   "which exceeded its share yields its turn to other endpoints of the worker\n"
+   "which have fragmented sends pending. Useful when endpoints send fragments of\n"
+   "different sizes over the same transport (inf - disable the scheduling).",
+   ucs_offsetof(ucp_config_t, ctx.tx_sched_quantum), UCS_CONFIG_TYPE_MEMUNITS},
+
   {"PROTO_INDIRECT_ID", "auto",
    "Enable indirect IDs to object pointers (endpoint, request) in wire protocols.\n"
    "A value of 'auto' means to enable only if error handling is enabled on the\n"
@@ -1483,6 +1573,32 @@ static ucs_status_t ucp_fill_config(ucp_context_h context,
         goto err_free_alloc_methods;
     }
 
+    if (context->config.ext.rndv_pipeline_depth == 0) {
+        ucs_error("UCX_RNDV_PIPELINE_DEPTH value must be greater than 0");
+        status = UCS_ERR_INVALID_PARAM;
+        goto err_free_alloc_methods;
+    }
+
+    if (context->config.ext.proto_adaptive_interval == 0) {
+        ucs_error("UCX_PROTO_ADAPTIVE_INTERVAL value must be greater than 0");
+        status = UCS_ERR_INVALID_PARAM;
+        goto err_free_alloc_methods;
+    }
+
+    if (context->config.ext.proto_trace_rate == 0) {
+        ucs_error("UCX_PROTO_TRACE_RATE value must be greater than 0");
+        status = UCS_ERR_INVALID_PARAM;
+        goto err_free_alloc_methods;
+    }
+
+    if ((context->config.ext.proto_trace_size == 0) ||
+        (context->config.ext.proto_trace_size > UCP_PROTO_TRACE_MAX_SIZE)) {
+        ucs_error("UCX_PROTO_TRACE_SIZE value must be between 1 and %lu",
+                  UCP_PROTO_TRACE_MAX_SIZE);
+        status = UCS_ERR_INVALID_PARAM;
+        goto err_free_alloc_methods;
+    }
+
     context->config.keepalive_interval = ucs_time_from_sec(context->config.ext.keepalive_interval);
     return UCS_OK;
 
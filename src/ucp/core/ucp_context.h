@@ -57,6 +57,8 @@ typedef struct ucp_context_config {
     ucp_rndv_mode_t                        rndv_mode;
     /** RKEY PTR segment size */
     size_t                                 rkey_ptr_seg_size;
+    /** Maximal number of cached unpacked remote keys per worker */
+    unsigned                               rkey_cache_size;
     /** Estimation of bcopy bandwidth */
     double                                 bcopy_bw;
     /** Segment size in the worker pre-registered memory pool */
@@ -65,6 +67,8 @@ typedef struct ucp_context_config {
     size_t                                 rndv_frag_size;
     /** RNDV pipline send threshold */
     size_t                                 rndv_pipeline_send_thresh;
+    /** Maximal number of RNDV pipeline fragments in flight per request */
+    size_t                                 rndv_pipeline_depth;
     /** Threshold for using tag matching offload capabilities. Smaller buffers
      *  will not be posted to the transport. */
     size_t                                 tm_thresh;
@@ -81,6 +85,8 @@ typedef struct ucp_context_config {
     unsigned                               max_worker_address_name;
     /** Atomic mode */
     ucp_atomic_mode_t                      atomic_mode;
+    /** Maximal number of aggregated software atomic operations */
+    unsigned                               amo_sw_batch;
     /** If use mutex for MT support or not */
     int                                    use_mt_mutex;
     /** On-demand progress */
@@ -97,6 +103,10 @@ typedef struct ucp_context_config {
     int                                    enable_memtype_cache;
     /** Enable flushing endpoints while flushing a worker */
     int                                    flush_worker_eps;
+    /** Defer completion of partially filled stream receive requests */
+    int                                    stream_recv_coalesce;
+    /** Connect endpoints to a worker address on the first operation */
+    int                                    ep_lazy_connect;
     /** Enable optimizations suitable for homogeneous systems */
     int                                    unified_mode;
     /** Enable cm wireup message exchange to select the best transports
@@ -106,11 +116,26 @@ typedef struct ucp_context_config {
     size_t                                 listener_backlog;
     /** Enable new protocol selection logic */
     int                                    proto_enable;
-    /** Time period between keepalive rounds (0 - disabled) */
+    /** Adjust protocol thresholds according to observed latency */
+    int                                    proto_adaptive;
+    /** Sample one of every N operations near a protocol threshold */
+    unsigned                               proto_adaptive_interval;
+    /** Number of samples per protocol required to move a threshold */
+    unsigned                               proto_adaptive_samples;
+    /** Record protocol selection of sampled send operations */
+    int                                    proto_trace;
+    /** Trace one of every N send operations */
+    unsigned                               proto_trace_rate;
+    /** Number of records in the protocol trace ring of each worker */
+    unsigned                               proto_trace_size;
+    /** Time period between keepalive checks of an endpoint (0 - disabled) */
     double                                 keepalive_interval;
-    /** Maximal number of endpoints to check on every keepalive round
-     * (0 - disabled, inf - check all endpoints on every round) */
+    /** Maximal number of endpoints to check on every progress call
+     * (inf - check all due endpoints) */
     unsigned                               keepalive_num_eps;
+    /** Deficit round-robin quantum of pending multi-fragment sends
+     * (inf - disabled) */
+    size_t                                 tx_sched_quantum;
     /** Enable indirect IDs to object pointers in wire protocols */
     ucs_on_off_auto_value_t                proto_indirect_id;
 } ucp_context_config_t;
@@ -250,7 +275,7 @@ typedef struct ucp_context {
         /* Config environment prefix used to create the context */
         char                      *env_prefix;
 
-        /* Time period between keepalive rounds */
+        /* Time period between keepalive checks of an endpoint */
         ucs_time_t                keepalive_interval;
 
         /* MD to compare for transport selection scores */
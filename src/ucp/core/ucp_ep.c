@@ -23,6 +23,7 @@
 #include <ucp/tag/offload.h>
 #include <ucp/proto/proto_select.h>
 #include <ucp/rndv/rndv.h>
+#include <ucp/rma/rma.h>
 #include <ucp/stream/stream.h>
 #include <ucp/core/ucp_listener.h>
 #include <ucs/datastruct/queue.h>
@@ -53,7 +54,9 @@ static ucs_stats_class_t ucp_ep_stats_class = {
     .counter_names  = {
         [UCP_EP_STAT_TAG_TX_EAGER]      = "tx_eager",
         [UCP_EP_STAT_TAG_TX_EAGER_SYNC] = "tx_eager_sync",
-        [UCP_EP_STAT_TAG_TX_RNDV]       = "tx_rndv"
+        [UCP_EP_STAT_TAG_TX_RNDV]       = "tx_rndv",
+        [UCP_EP_STAT_TX_PENDING]        = "tx_pending",
+        [UCP_EP_STAT_TX_SCHED_YIELD]    = "tx_sched_yield"
     }
 };
 #endif
@@ -166,8 +169,15 @@ ucs_status_t ucp_ep_create_base(ucp_worker_h worker, const char *peer_name,
     ucp_ep_ext_gen(ep)->user_data        = NULL;
     ucp_ep_ext_control(ep)->cm_idx       = UCP_NULL_RESOURCE;
     ucp_ep_ext_control(ep)->err_cb       = NULL;
+    ucp_ep_ext_control(ep)->lazy_conn    = NULL;
     ucp_ep_ext_control(ep)->local_ep_id  =
     ucp_ep_ext_control(ep)->remote_ep_id = UCP_EP_ID_INVALID;
+    ucp_ep_ext_control(ep)->amo.batch    = NULL;
+    ucp_ep_ext_control(ep)->keepalive.ep = ep;
+    ucp_ep_ext_control(ep)->tx_sched.deficit  = 0;
+    ucp_ep_ext_control(ep)->tx_sched.num_reqs = 0;
+    ucs_list_head_init(&ucp_ep_ext_control(ep)->keepalive.list);
+    ucs_list_head_init(&ucp_ep_ext_gen(ep)->dirty_list);
 
     UCS_STATIC_ASSERT(sizeof(ucp_ep_ext_gen(ep)->ep_match) >=
                       sizeof(ucp_ep_ext_gen(ep)->flush_state));
@@ -260,6 +270,11 @@ static void ucp_ep_destroy_base(ucp_ep_h ep)
     ucs_assert(ep->discard_refcount == 0);
 
     ucp_ep_remove_progress_callbacks(ep);
+    if (ucp_ep_ext_control(ep)->tx_sched.num_reqs != 0) {
+        /* fragmented sends were purged without leaving the pending queue */
+        ucs_assert(ep->worker->tx_sched.num_eps > 0);
+        --ep->worker->tx_sched.num_eps;
+    }
     UCS_STATS_NODE_FREE(ep->stats);
     ucs_free(ucp_ep_ext_control(ep));
     ucs_strided_alloc_put(&ep->worker->ep_alloc, ep);
@@ -331,6 +346,7 @@ static void ucp_ep_delete(ucp_ep_h ep)
     if (!(ep->flags & UCP_EP_FLAG_INTERNAL)) {
         ucp_worker_keepalive_remove_ep(ep);
         ucs_list_del(&ucp_ep_ext_gen(ep)->ep_list);
+        ucs_list_del(&ucp_ep_ext_gen(ep)->dirty_list);
     }
 
     if (!(ep->flags & UCP_EP_FLAG_FAILED)) {
@@ -370,7 +386,9 @@ ucp_ep_adjust_params(ucp_ep_h ep, const ucp_ep_params_t *params)
 {
     /* handle a case where the existing endpoint is incomplete */
 
-    if (params->field_mask & UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE) {
+    /* error handling mode of a lazy endpoint was taken from the same params */
+    if ((params->field_mask & UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE) &&
+        !(ep->flags & UCP_EP_FLAG_LAZY_CONNECT)) {
         if (ucp_ep_config(ep)->key.err_mode != params->err_mode) {
             ucs_error("asymmetric endpoint configuration is not supported, "
                       "error handling level mismatch");
@@ -685,6 +703,102 @@ ucp_ep_create_api_conn_request(ucp_worker_h worker,
     return status;
 }
 
+static ucs_status_t
+ucp_ep_create_lazy(ucp_worker_h worker, const void *address,
+                   const ucp_unpacked_address_t *remote_address,
+                   unsigned ep_init_flags, ucp_ep_h *ep_p)
+{
+    ucp_ep_lazy_conn_t *lazy_conn;
+    ucs_status_t status;
+    ucp_ep_h ep;
+
+    lazy_conn = ucs_malloc(sizeof(*lazy_conn) + remote_address->packed_size,
+                           "ucp_ep_lazy_conn");
+    if (lazy_conn == NULL) {
+        ucs_error("failed to allocate lazy connection context");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    status = ucp_worker_create_ep(worker, ep_init_flags, remote_address->name,
+                                  "lazy from api call", &ep);
+    if (status != UCS_OK) {
+        ucs_free(lazy_conn);
+        return status;
+    }
+
+    lazy_conn->ep_init_flags = ep_init_flags;
+    memcpy(lazy_conn->address, address, remote_address->packed_size);
+    ucp_ep_ext_control(ep)->lazy_conn = lazy_conn;
+    ucp_ep_update_flags(ep, UCP_EP_FLAG_LAZY_CONNECT, 0);
+
+    *ep_p = ep;
+    return UCS_OK;
+}
+
+unsigned ucp_ep_lazy_conn_release(ucp_ep_h ep)
+{
+    ucp_ep_lazy_conn_t *lazy_conn = ucp_ep_ext_control(ep)->lazy_conn;
+    unsigned ep_init_flags;
+
+    ucs_assert(ep->flags & UCP_EP_FLAG_LAZY_CONNECT);
+
+    ep_init_flags                     = lazy_conn->ep_init_flags;
+    ucp_ep_ext_control(ep)->lazy_conn = NULL;
+    ucp_ep_update_flags(ep, 0, UCP_EP_FLAG_LAZY_CONNECT);
+    ucs_free(lazy_conn);
+
+    return ep_init_flags;
+}
+
+ucs_status_t ucp_ep_connect_lazy(ucp_ep_h ep)
+{
+    ucp_worker_h worker = ep->worker;
+    unsigned addr_indices[UCP_MAX_LANES];
+    ucp_unpacked_address_t remote_address;
+    ucp_ep_lazy_conn_t *lazy_conn;
+    ucs_status_t status;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    if (!(ep->flags & UCP_EP_FLAG_LAZY_CONNECT)) {
+        /* the peer has connected to the endpoint in the meantime */
+        status = UCS_OK;
+        goto out;
+    }
+
+    lazy_conn = ucp_ep_ext_control(ep)->lazy_conn;
+    status    = ucp_address_unpack(worker, lazy_conn->address,
+                                   UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT,
+                                   &remote_address);
+    if (status != UCS_OK) {
+        goto out;
+    }
+
+    ucs_debug("ep %p: connecting to %s on first operation", ep,
+              ucp_ep_peer_name(ep));
+
+    status = ucp_wireup_init_lanes(ep, lazy_conn->ep_init_flags,
+                                   &ucp_tl_bitmap_max, &remote_address,
+                                   addr_indices);
+    if (status != UCS_OK) {
+        goto out_free_address;
+    }
+
+    ucp_ep_lazy_conn_release(ep);
+
+    /* operations are queued on wireup endpoints until the peer replies */
+    if (!(ep->flags & UCP_EP_FLAG_LOCAL_CONNECTED)) {
+        ucs_assert(!(ep->flags & UCP_EP_FLAG_CONNECT_REQ_QUEUED));
+        status = ucp_wireup_send_request(ep);
+    }
+
+out_free_address:
+    ucs_free(remote_address.address_list);
+out:
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return status;
+}
+
 static ucs_status_t
 ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
                                  const ucp_ep_params_t *params, ucp_ep_h *ep_p)
@@ -737,10 +851,18 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
         goto out_free_address;
     }
 
-    status = ucp_ep_create_to_worker_addr(worker, &ucp_tl_bitmap_max,
-                                          &remote_address,
-                                          ucp_ep_init_flags(worker, params),
-                                          "from api call", &ep);
+    /* Loopback endpoints are connected right away, since there is no peer
+     * which could initiate the connection */
+    if (worker->context->config.ext.ep_lazy_connect &&
+        (remote_address.uuid != worker->uuid)) {
+        status = ucp_ep_create_lazy(worker, params->address, &remote_address,
+                                    ucp_ep_init_flags(worker, params), &ep);
+    } else {
+        status = ucp_ep_create_to_worker_addr(worker, &ucp_tl_bitmap_max,
+                                              &remote_address,
+                                              ucp_ep_init_flags(worker, params),
+                                              "from api call", &ep);
+    }
     if (status != UCS_OK) {
         goto out_free_address;
     }
@@ -770,7 +892,8 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
     }
 
     /* if needed, send initial wireup message */
-    if (!(ep->flags & UCP_EP_FLAG_LOCAL_CONNECTED)) {
+    if (!(ep->flags & (UCP_EP_FLAG_LOCAL_CONNECTED |
+                       UCP_EP_FLAG_LAZY_CONNECT))) {
         ucs_assert(!(ep->flags & UCP_EP_FLAG_CONNECT_REQ_QUEUED));
         status = ucp_wireup_send_request(ep);
         if (status != UCS_OK) {
@@ -859,6 +982,10 @@ ucp_ep_purge_lanes(ucp_ep_h ep, uct_pending_purge_callback_t purge_cb,
     ucp_lane_index_t lane;
     uct_ep_h uct_ep;
 
+    if (ep->cfg_index == UCP_WORKER_CFG_INDEX_NULL) {
+        return;
+    }
+
     for (lane = 0; lane < ucp_ep_num_lanes(ep); ++lane) {
         uct_ep = ep->uct_eps[lane];
         if ((lane == ucp_ep_get_cm_lane(ep)) || (uct_ep == NULL)) {
@@ -868,12 +995,20 @@ ucp_ep_purge_lanes(ucp_ep_h ep, uct_pending_purge_callback_t purge_cb,
         ucs_debug("ep %p: purge uct_ep[%d]=%p", ep, lane, uct_ep);
         uct_ep_pending_purge(uct_ep, purge_cb, purge_arg);
     }
+
+    ucp_amo_sw_batch_purge(ep, UCS_ERR_CANCELED);
 }
 
 void ucp_ep_destroy_internal(ucp_ep_h ep)
 {
     ucs_debug("ep %p: destroy", ep);
-    ucp_ep_cleanup_lanes(ep);
+    if (ep->flags & UCP_EP_FLAG_LAZY_CONNECT) {
+        ucp_ep_lazy_conn_release(ep);
+    }
+
+    if (ep->cfg_index != UCP_WORKER_CFG_INDEX_NULL) {
+        ucp_ep_cleanup_lanes(ep);
+    }
     ucp_ep_delete(ep);
 }
 
@@ -1098,6 +1233,8 @@ void ucp_ep_discard_lanes(ucp_ep_h ep, ucs_status_t status)
                                   (ucp_send_nbx_callback_t)ucs_empty_function,
                                   NULL);
     }
+
+    ucp_amo_sw_batch_purge(ep, status);
 }
 
 ucs_status_ptr_t ucp_ep_close_nbx(ucp_ep_h ep, const ucp_request_param_t *param)
@@ -1107,6 +1244,7 @@ ucs_status_ptr_t ucp_ep_close_nbx(ucp_ep_h ep, const ucp_request_param_t *param)
     ucp_request_t *close_req;
 
     if ((ucp_request_param_flags(param) & UCP_EP_CLOSE_FLAG_FORCE) &&
+        !(ep->flags & UCP_EP_FLAG_LAZY_CONNECT) &&
         (ucp_ep_config(ep)->key.err_mode != UCP_ERR_HANDLING_MODE_PEER)) {
         return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM);
     }
@@ -1124,7 +1262,10 @@ ucs_status_ptr_t ucp_ep_close_nbx(ucp_ep_h ep, const ucp_request_param_t *param)
 
     ucp_ep_update_flags(ep, UCP_EP_FLAG_CLOSED, 0);
 
-    if (ucp_request_param_flags(param) & UCP_EP_CLOSE_FLAG_FORCE) {
+    if (ep->flags & UCP_EP_FLAG_LAZY_CONNECT) {
+        /* no operations were posted and no transport endpoints exist */
+        ucp_ep_disconnected(ep, 1);
+    } else if (ucp_request_param_flags(param) & UCP_EP_CLOSE_FLAG_FORCE) {
         /* FIXME: there is a potential issue with flush completion after an EP
          * was forcibly closed from a user's error handling callback after
          * disconnect event was received, but some EP flush operation still
@@ -1197,6 +1338,10 @@ ucp_lane_index_t ucp_ep_lookup_lane(ucp_ep_h ucp_ep, uct_ep_h uct_ep)
 {
     ucp_lane_index_t lane;
 
+    if (ucp_ep->cfg_index == UCP_WORKER_CFG_INDEX_NULL) {
+        return UCP_NULL_LANE;
+    }
+
     for (lane = 0; lane < ucp_ep_num_lanes(ucp_ep); ++lane) {
         if ((uct_ep == ucp_ep->uct_eps[lane]) ||
             ucp_wireup_ep_is_owner(ucp_ep->uct_eps[lane], uct_ep)) {
@@ -1319,6 +1464,62 @@ int ucp_ep_config_is_equal(const ucp_ep_config_key_t *key1,
     return 1;
 }
 
+static UCS_F_ALWAYS_INLINE uint64_t
+ucp_ep_config_key_hash_add(uint64_t hash, uint64_t value)
+{
+    /* FNV-1a style mixing of 64-bit words */
+    return (hash ^ value) * 0x100000001b3ul;
+}
+
+static uint64_t ucp_ep_config_key_hash_lanes(uint64_t hash,
+                                             const ucp_lane_index_t *lanes)
+{
+    uint64_t value = 0;
+
+    UCS_STATIC_ASSERT(UCP_MAX_LANES <= sizeof(value));
+    memcpy(&value, lanes, UCP_MAX_LANES * sizeof(*lanes));
+    return ucp_ep_config_key_hash_add(hash, value);
+}
+
+/* Hash the fields which are compared by ucp_ep_config_is_equal() */
+uint32_t ucp_ep_config_key_hash(const ucp_ep_config_key_t *key)
+{
+    uint64_t hash = 0xcbf29ce484222325ul;
+    const ucp_ep_config_key_lane_t *config_lane;
+    ucp_lane_index_t lane;
+    int i;
+
+    hash = ucp_ep_config_key_hash_add(hash, key->num_lanes |
+                                            (key->am_lane << 8) |
+                                            (key->tag_lane << 16) |
+                                            (key->wireup_msg_lane << 24) |
+                                            ((uint64_t)key->cm_lane << 32) |
+                                            ((uint64_t)key->rkey_ptr_lane << 40) |
+                                            ((uint64_t)key->err_mode << 48));
+    hash = ucp_ep_config_key_hash_add(hash, key->rma_bw_md_map);
+    hash = ucp_ep_config_key_hash_add(hash, key->reachable_md_map);
+    hash = ucp_ep_config_key_hash_add(hash, key->ep_check_map);
+    hash = ucp_ep_config_key_hash_lanes(hash, key->rma_lanes);
+    hash = ucp_ep_config_key_hash_lanes(hash, key->am_bw_lanes);
+    hash = ucp_ep_config_key_hash_lanes(hash, key->rma_bw_lanes);
+    hash = ucp_ep_config_key_hash_lanes(hash, key->amo_lanes);
+
+    for (lane = 0; lane < key->num_lanes; ++lane) {
+        config_lane = &key->lanes[lane];
+        hash        = ucp_ep_config_key_hash_add(
+                              hash, config_lane->rsc_index |
+                                    (config_lane->dst_md_index << 8) |
+                                    (config_lane->path_index << 16) |
+                                    ((uint64_t)config_lane->lane_types << 32));
+    }
+
+    for (i = 0; i < ucs_popcount(key->reachable_md_map); ++i) {
+        hash = ucp_ep_config_key_hash_add(hash, key->dst_md_cmpts[i]);
+    }
+
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
 static void ucp_ep_config_calc_params(ucp_worker_h worker,
                                       const ucp_ep_config_t *config,
                                       const ucp_lane_index_t *lanes,
@@ -1756,6 +1957,94 @@ ucp_ep_config_init_attrs(ucp_worker_t *worker, ucp_rsc_index_t rsc_index,
     }
 }
 
+static void ucp_ep_config_init_am_bw_stripe(ucp_worker_h worker,
+                                            ucp_ep_config_t *config)
+{
+    ucp_context_h context  = worker->context;
+    const double min_scale = 1. / context->config.ext.multi_lane_max_ratio;
+    double bw[UCP_MAX_LANES], rate[UCP_MAX_LANES];
+    int weight[UCP_MAX_LANES], credit[UCP_MAX_LANES];
+    int total_weight, gcd, a, b;
+    double max_bw, max_rate;
+    ucp_lane_index_t lanes[UCP_MAX_LANES];
+    ucp_lane_index_t i, num_lanes, max_i;
+    const uct_iface_attr_t *iface_attr;
+    ucp_rsc_index_t rsc_index;
+
+    config->am_bw_stripe.length = 0;
+
+    /* Collect bandwidth and fragment rate of AM BW lanes */
+    max_bw    = 0;
+    num_lanes = 0;
+    for (i = 0; (i < UCP_MAX_LANES) &&
+                (config->key.am_bw_lanes[i] != UCP_NULL_LANE); ++i) {
+        rsc_index = config->key.lanes[config->key.am_bw_lanes[i]].rsc_index;
+        if (rsc_index == UCP_NULL_RESOURCE) {
+            continue;
+        }
+
+        iface_attr       = ucp_worker_iface_get_attr(worker, rsc_index);
+        lanes[num_lanes] = config->key.am_bw_lanes[i];
+        bw[num_lanes]    = ucp_tl_iface_bandwidth(context,
+                                                  &iface_attr->bandwidth);
+        rate[num_lanes]  = bw[num_lanes] /
+                           ucs_max(iface_attr->cap.am.max_bcopy, 1);
+        max_bw           = ucs_max(max_bw, bw[num_lanes]);
+        ++num_lanes;
+    }
+
+    if (num_lanes <= 1) {
+        config->am_bw_stripe.lanes[0] = (num_lanes == 1) ? lanes[0] :
+                                        config->key.am_bw_lanes[0];
+        config->am_bw_stripe.length   = 1;
+        return;
+    }
+
+    /* Skip lanes which are too slow compared to the fastest one */
+    max_rate = 0;
+    for (i = 0; i < num_lanes; ++i) {
+        if ((bw[i] / max_bw) < min_scale) {
+            rate[i] = 0;
+        }
+        max_rate = ucs_max(max_rate, rate[i]);
+    }
+
+    /* Integer weight of each lane, reduced by the greatest common divisor to
+     * keep the stripe short when the lanes are similar */
+    gcd = 0;
+    for (i = 0; i < num_lanes; ++i) {
+        weight[i] = (rate[i] == 0) ? 0 :
+                    ucs_max(1, (int)(UCP_EP_AM_BW_STRIPE_WEIGHT * rate[i] /
+                                     max_rate + 0.5));
+        for (a = weight[i], b = gcd; b != 0; a = b, b = gcd) {
+            gcd = a % b;
+        }
+        gcd = a;
+    }
+
+    total_weight = 0;
+    for (i = 0; i < num_lanes; ++i) {
+        weight[i]     /= gcd;
+        credit[i]      = 0;
+        total_weight  += weight[i];
+    }
+
+    /* Smooth weighted round-robin, to interleave the lanes evenly */
+    while (config->am_bw_stripe.length < total_weight) {
+        max_i = 0;
+        for (i = 0; i < num_lanes; ++i) {
+            credit[i] += weight[i];
+            if (credit[i] > credit[max_i]) {
+                max_i = i;
+            }
+        }
+
+        credit[max_i] -= total_weight;
+        config->am_bw_stripe.lanes[config->am_bw_stripe.length++] =
+                lanes[max_i];
+    }
+}
+
 static ucs_status_t ucp_ep_config_key_copy(ucp_ep_config_key_t *dst,
                                            const ucp_ep_config_key_t *src)
 {
@@ -1803,6 +2092,8 @@ ucs_status_t ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config,
         goto err;
     }
 
+    config->rkey_cfg_cache.cfg_index = UCP_WORKER_CFG_INDEX_NULL;
+
     /* Default settings */
     for (it = 0; it < UCP_MAX_IOV; ++it) {
         config->am.zcopy_thresh[it]              = SIZE_MAX;
@@ -1927,6 +2218,9 @@ ucs_status_t ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config,
     ucp_ep_config_rndv_zcopy_commit(put_zcopy_lane_count,
                                     &config->rndv.put_zcopy);
 
+    /* Multi-fragment active messages */
+    ucp_ep_config_init_am_bw_stripe(worker, config);
+
     /* Rkey ptr */
     if (key->rkey_ptr_lane != UCP_NULL_LANE) {
         lane      = key->rkey_ptr_lane;
@@ -2356,7 +2650,7 @@ static void ucp_ep_config_print(FILE *stream, ucp_worker_h worker,
     ucp_context_h context   = worker->context;
     ucp_ep_config_t *config = ucp_ep_config(ep);
     ucp_md_index_t md_index;
-    ucp_lane_index_t lane;
+    ucp_lane_index_t lane, i;
     ucp_rsc_index_t cm_idx;
 
     for (lane = 0; lane < config->key.num_lanes; ++lane) {
@@ -2401,6 +2695,15 @@ static void ucp_ep_config_print(FILE *stream, ucp_worker_h worker,
                                   config->rndv.am_thresh.remote);
     }
 
+    if ((context->config.features & (UCP_FEATURE_TAG | UCP_FEATURE_AM)) &&
+        (config->am_bw_stripe.length > 1)) {
+        fprintf(stream, "# %23s: lanes", "am_bw_stripe");
+        for (i = 0; i < config->am_bw_stripe.length; ++i) {
+            fprintf(stream, " %d", config->am_bw_stripe.lanes[i]);
+        }
+        fprintf(stream, "\n");
+    }
+
     if (context->config.features & UCP_FEATURE_RMA) {
         for (lane = 0; lane < config->key.num_lanes; ++lane) {
             if (ucp_ep_config_get_multi_lane_prio(config->key.rma_lanes,
@@ -2431,8 +2734,8 @@ static void ucp_ep_config_print(FILE *stream, ucp_worker_h worker,
 
 void ucp_ep_print_info(ucp_ep_h ep, FILE *stream)
 {
-    ucp_worker_h worker     = ep->worker;
-    ucp_ep_config_t *config = ucp_ep_config(ep);
+    ucp_worker_h worker = ep->worker;
+    ucp_ep_config_t *config;
     ucp_rsc_index_t aux_rsc_index;
     ucp_lane_index_t wireup_msg_lane;
     ucs_string_buffer_t strb;
@@ -2445,6 +2748,14 @@ void ucp_ep_print_info(ucp_ep_h ep, FILE *stream)
     fprintf(stream, "#\n");
     fprintf(stream, "#               peer: %s\n", ucp_ep_peer_name(ep));
 
+    if (ep->flags & UCP_EP_FLAG_LAZY_CONNECT) {
+        fprintf(stream, "#   connection deferred to the first operation\n");
+        fprintf(stream, "#\n");
+        goto out;
+    }
+
+    config = ucp_ep_config(ep);
+
     /* if there is a wireup lane, set aux_rsc_index to the stub ep resource */
     aux_rsc_index   = UCP_NULL_RESOURCE;
     wireup_msg_lane = config->key.wireup_msg_lane;
@@ -2466,6 +2777,7 @@ void ucp_ep_print_info(ucp_ep_h ep, FILE *stream)
         ucs_string_buffer_cleanup(&strb);
     }
 
+out:
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
 }
 
@@ -2643,7 +2955,7 @@ void ucp_ep_do_keepalive(ucp_ep_h ep, ucp_lane_map_t *lane_map)
     ucs_status_t status;
     ucp_rsc_index_t rsc_index;
 
-    if (ep->flags & UCP_EP_FLAG_FAILED) {
+    if (ep->flags & (UCP_EP_FLAG_FAILED | UCP_EP_FLAG_LAZY_CONNECT)) {
         *lane_map = 0;
         return;
     }
@@ -20,6 +20,7 @@
 #include <ucs/datastruct/strided_alloc.h>
 #include <ucs/debug/assert.h>
 #include <ucs/stats/stats.h>
+#include <ucs/time/timer_wheel.h>
 
 
 #define UCP_MAX_IOV                16UL
@@ -27,6 +28,8 @@
 
 /* Used as invalidated value */
 #define UCP_EP_ID_INVALID          UINTPTR_MAX
+#define UCP_EP_AM_BW_STRIPE_WEIGHT 8 /* Maximal weight of a lane in AM BW stripe */
+#define UCP_EP_AM_BW_STRIPE_MAX    (UCP_MAX_LANES * UCP_EP_AM_BW_STRIPE_WEIGHT)
 
 
 /* Endpoint flags type */
@@ -70,6 +73,9 @@ enum {
     UCP_EP_FLAG_STREAM_HAS_DATA        = UCS_BIT(5), /* EP has data in the ext.stream.match_q */
     UCP_EP_FLAG_ON_MATCH_CTX           = UCS_BIT(6), /* EP is on match queue */
     UCP_EP_FLAG_REMOTE_ID              = UCS_BIT(7), /* remote ID is valid */
+    UCP_EP_FLAG_LAZY_CONNECT           = UCS_BIT(8), /* EP lanes are not initialized yet,
+                                                        connection is deferred to the
+                                                        first operation */
     UCP_EP_FLAG_CONNECT_PRE_REQ_QUEUED = UCS_BIT(9), /* Pre-Connection request was queued */
     UCP_EP_FLAG_CLOSED                 = UCS_BIT(10),/* EP was closed */
     UCP_EP_FLAG_CLOSE_REQ_VALID        = UCS_BIT(11),/* close protocol is started and
@@ -81,6 +87,8 @@ enum {
     UCP_EP_FLAG_INDIRECT_ID            = UCS_BIT(14),/* protocols on this endpoint will send
                                                         indirect endpoint id instead of pointer,
                                                         can be replaced with looking at local ID */
+    UCP_EP_FLAG_RMA_DIRTY              = UCS_BIT(15),/* RMA/AMO operations were issued after
+                                                        the EP was flushed by worker flush */
 
     /* DEBUG bits */
     UCP_EP_FLAG_CONNECT_REQ_SENT       = UCS_BIT(16),/* DEBUG: Connection request was sent */
@@ -104,6 +112,8 @@ enum {
     UCP_EP_STAT_TAG_TX_EAGER,
     UCP_EP_STAT_TAG_TX_EAGER_SYNC,
     UCP_EP_STAT_TAG_TX_RNDV,
+    UCP_EP_STAT_TX_PENDING,
+    UCP_EP_STAT_TX_SCHED_YIELD,
     UCP_EP_STAT_LAST
 };
 
@@ -125,8 +135,12 @@ enum {
 };
 
 
-#define UCP_EP_STAT_TAG_OP(_ep, _op) \
-    UCS_STATS_UPDATE_COUNTER((_ep)->stats, UCP_EP_STAT_TAG_TX_##_op, 1);
+#define UCP_EP_STAT_TAG_OP(_ep, _op, _length) \
+    { \
+        UCS_STATS_UPDATE_COUNTER((_ep)->stats, UCP_EP_STAT_TAG_TX_##_op, 1); \
+        UCP_WORKER_COUNTER_ADD((_ep)->worker, TAG_TX_##_op, 1); \
+        UCP_WORKER_COUNTER_ADD((_ep)->worker, TAG_TX_##_op##_BYTES, _length); \
+    }
 
 
 typedef struct ucp_ep_config_key_lane {
@@ -289,6 +303,14 @@ struct ucp_ep_config {
     /* Configuration for AM lane */
     ucp_ep_msg_config_t     am;
 
+    /* Order of lanes for the fragments of multi-fragment active messages. Each
+     * high-bw AM lane appears in proportion to the rate of fragments it can
+     * send, according to its bandwidth and maximal fragment size */
+    struct {
+        ucp_lane_index_t    lanes[UCP_EP_AM_BW_STRIPE_MAX];
+        ucp_lane_index_t    length;
+    } am_bw_stripe;
+
     /* MD index of each lane */
     ucp_md_index_t          md_index[UCP_MAX_LANES];
 
@@ -362,6 +384,15 @@ struct ucp_ep_config {
 
     /* Protocol selection data */
     ucp_proto_select_t            proto_select;
+
+    /* Last remote key configuration resolved for this configuration, to
+     * avoid the hash lookup when remote keys with the same md_map are
+     * unpacked repeatedly */
+    struct {
+        ucp_md_map_t              md_map;
+        ucs_memory_type_t         mem_type;
+        ucp_worker_cfg_index_t    cfg_index;
+    } rkey_cfg_cache;
 };
 
 
@@ -419,6 +450,15 @@ typedef struct {
 } ucp_ep_close_proto_req_t;
 
 
+/**
+ * Deferred connection of an endpoint created with lazy connect mode
+ */
+typedef struct {
+    unsigned                 ep_init_flags; /* Flags to initialize lanes with */
+    uint8_t                  address[0];    /* Copy of packed remote address */
+} ucp_ep_lazy_conn_t;
+
+
 /**
  * Endpoint extension for control data path
  */
@@ -428,6 +468,27 @@ typedef struct {
     ucs_ptr_map_key_t        remote_ep_id; /* Remote EP ID */
     ucp_err_handler_cb_t     err_cb; /* Error handler */
     ucp_ep_close_proto_req_t close_req; /* Close protocol request */
+    ucp_ep_lazy_conn_t       *lazy_conn; /* Deferred connection, valid if
+                                            UCP_EP_FLAG_LAZY_CONNECT is set */
+    struct {
+        ucp_request_t        *batch; /* Software AMO batch which is waiting
+                                        for send resources */
+        ucp_request_t        *batch_tail; /* Last operation in the batch */
+    } amo;
+    struct {
+        ucp_ep_h             ep; /* Endpoint which owns the timer */
+        ucs_wtimer_t         timer; /* Deadline of the next keepalive check */
+        ucs_list_link_t      list; /* Entry in worker's list of EPs which are
+                                      due for a keepalive check */
+        ucs_time_t           rx_time; /* Last time a message was received
+                                         from the peer */
+    } keepalive;
+    struct {
+        ssize_t              deficit; /* Bytes the endpoint may send from
+                                         pending queues before yielding */
+        unsigned             num_reqs; /* Fragmented sends which are
+                                          waiting in pending queues */
+    } tx_sched;
 } ucp_ep_ext_control_t;
 
 
@@ -446,6 +507,9 @@ typedef struct {
         ucp_ep_flush_state_t      flush_state;   /* Remote completion status */
     };
     ucp_ep_ext_control_t          *control_ext;  /* Control data path extension */
+    ucs_list_link_t               dirty_list;    /* List entry in worker's list of
+                                                    eps with RMA/AMO operations
+                                                    since the last worker flush */
 } ucp_ep_ext_gen_t;
 
 
@@ -573,6 +637,10 @@ void ucp_ep_destroy_internal(ucp_ep_h ep);
 
 void ucp_ep_cleanup_lanes(ucp_ep_h ep);
 
+ucs_status_t ucp_ep_connect_lazy(ucp_ep_h ep);
+
+unsigned ucp_ep_lazy_conn_release(ucp_ep_h ep);
+
 ucs_status_t ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config,
                                 const ucp_ep_config_key_t *key);
 
@@ -592,6 +660,8 @@ void ucp_ep_config_lanes_intersect(const ucp_ep_config_key_t *key1,
 int ucp_ep_config_is_equal(const ucp_ep_config_key_t *key1,
                            const ucp_ep_config_key_t *key2);
 
+uint32_t ucp_ep_config_key_hash(const ucp_ep_config_key_t *key);
+
 int ucp_ep_config_get_multi_lane_prio(const ucp_lane_index_t *lanes,
                                       ucp_lane_index_t lane);
 
@@ -156,6 +156,15 @@ static UCS_F_ALWAYS_INLINE ucp_ep_ext_control_t* ucp_ep_ext_control(ucp_ep_h ep)
     return ucp_ep_ext_gen(ep)->control_ext;
 }
 
+/* A message from the peer was received, so a keepalive check of the endpoint
+ * can be postponed */
+static UCS_F_ALWAYS_INLINE void
+ucp_ep_keepalive_rx(ucp_worker_h worker, ucp_ep_h ep)
+{
+    ucp_ep_ext_control(ep)->keepalive.rx_time =
+            ucs_twheel_get_time(&worker->keepalive.wheel);
+}
+
 static UCS_F_ALWAYS_INLINE void ucp_ep_update_flags(
         ucp_ep_h ep, uint32_t flags_add, uint32_t flags_remove)
 {
@@ -290,4 +299,23 @@ static UCS_F_ALWAYS_INLINE int ucp_ep_use_indirect_id(ucp_ep_h ep)
     return ep->flags & UCP_EP_FLAG_INDIRECT_ID;
 }
 
+/* Establish the connection of a lazy endpoint before posting an operation */
+static UCS_F_ALWAYS_INLINE ucs_status_t ucp_ep_resolve_lazy(ucp_ep_h ep)
+{
+    if (ucs_likely(!(ep->flags & UCP_EP_FLAG_LAZY_CONNECT))) {
+        return UCS_OK;
+    }
+
+    return ucp_ep_connect_lazy(ep);
+}
+
+#define UCP_EP_RESOLVE_LAZY(_ep, _ret, _action) \
+    { \
+        ucs_status_t _lazy_status = ucp_ep_resolve_lazy(_ep); \
+        if (ucs_unlikely(_lazy_status != UCS_OK)) { \
+            _ret = UCS_STATUS_PTR(_lazy_status); \
+            _action; \
+        } \
+    }
+
 #endif
@@ -187,6 +187,12 @@ int ucp_request_pending_add(ucp_request_t *req, unsigned pending_flags)
     if (status == UCS_OK) {
         ucs_trace_data("ep %p: added pending uct request %p to lane[%d]=%p",
                        req->send.ep, req, req->send.lane, uct_ep);
+        UCS_STATS_UPDATE_COUNTER(req->send.ep->stats, UCP_EP_STAT_TX_PENDING,
+                                 1);
+        UCP_WORKER_COUNTER_ADD(req->send.ep->worker, TX_PENDING, 1);
+        if (ucs_unlikely(req->flags & UCP_REQUEST_FLAG_PROTO_TRACE)) {
+            ucp_proto_trace_pending(req);
+        }
         req->send.pending_lane = req->send.lane;
         return 1;
     } else if (status == UCS_ERR_BUSY) {
@@ -416,6 +422,8 @@ void ucp_request_send_state_ff(ucp_request_t *req, ucs_status_t status)
      */
     ucp_trace_req(req, "fast-forward with status %s", ucs_status_string(status));
 
+    ucp_request_tx_sched_update(req, 0, 1);
+
     if (req->send.state.uct_comp.func == ucp_ep_flush_completion) {
         ucp_ep_flush_request_ff(req, status);
     } else if (req->send.state.uct_comp.func) {
@@ -39,12 +39,14 @@
 enum {
     UCP_REQUEST_FLAG_COMPLETED            = UCS_BIT(0),
     UCP_REQUEST_FLAG_RELEASED             = UCS_BIT(1),
+    UCP_REQUEST_FLAG_RNDV_PPLN_ISSUE      = UCS_BIT(2),
     UCP_REQUEST_FLAG_EXPECTED             = UCS_BIT(3),
     UCP_REQUEST_FLAG_LOCAL_COMPLETED      = UCS_BIT(4),
     UCP_REQUEST_FLAG_REMOTE_COMPLETED     = UCS_BIT(5),
     UCP_REQUEST_FLAG_CALLBACK             = UCS_BIT(6),
     UCP_REQUEST_FLAG_PROTO_INITIALIZED    = UCS_BIT(7),
     UCP_REQUEST_FLAG_SYNC                 = UCS_BIT(8),
+    UCP_REQUEST_FLAG_PROTO_SAMPLE         = UCS_BIT(9),
     UCP_REQUEST_FLAG_OFFLOADED            = UCS_BIT(10),
     UCP_REQUEST_FLAG_BLOCK_OFFLOAD        = UCS_BIT(11),
     UCP_REQUEST_FLAG_STREAM_RECV_WAITALL  = UCS_BIT(12),
@@ -53,6 +55,9 @@ enum {
     UCP_REQUEST_FLAG_RNDV_FRAG            = UCS_BIT(15),
     UCP_REQUEST_FLAG_RECV_AM              = UCS_BIT(16),
     UCP_REQUEST_FLAG_RECV_TAG             = UCS_BIT(17),
+    UCP_REQUEST_FLAG_PERSISTENT           = UCS_BIT(20),
+    UCP_REQUEST_FLAG_TX_SCHED             = UCS_BIT(21),
+    UCP_REQUEST_FLAG_PROTO_TRACE          = UCS_BIT(22),
 #if UCS_ENABLE_ASSERT
     UCP_REQUEST_FLAG_STREAM_RECV          = UCS_BIT(18),
     UCP_REQUEST_DEBUG_FLAG_EXTERNAL       = UCS_BIT(19)
@@ -182,6 +187,13 @@ struct ucp_request {
                     ucp_rkey_h rkey; /* Remote memory key */
                 } rma;
 
+                struct {
+                    ucp_tag_t  tag;          /* Tag of every started send */
+                    size_t     count;        /* Number of datatype elements */
+                    uint32_t   op_attr_mask; /* Operation attributes which
+                                                affect protocol selection */
+                } persistent;
+
                 struct {
                     /* Remote request ID received from a peer */
                     ucs_ptr_map_key_t      remote_req_id;
@@ -264,6 +276,12 @@ struct ucp_request {
                     ucp_rkey_h            rkey;        /* Remote memory key */
                     uint64_t              value;       /* Atomic argument */
                     uct_atomic_op_t       uct_op;      /* Requested UCT AMO */
+                    uint16_t              fence_sn;    /* Worker fence number when
+                                                          the operation was posted */
+                    uint8_t               batch_count; /* Number of operations in a
+                                                          software AMO batch */
+                    uint8_t               batch_flags; /* Software AMO batch
+                                                          flags */
                 } amo;
 
                 struct {
@@ -296,8 +314,14 @@ struct ucp_request {
                                                     * to pending state */
             ucp_lane_index_t      lane;            /* Lane on which this request is being sent */
             ucp_lane_index_t      multi_lane_idx;  /* Index of the lane with multi-send */
+            uint16_t              proto_trace_index; /* Protocol trace record
+                                                        of a sampled request */
             uct_pending_req_t     uct;             /* UCT pending request */
-            ucp_mem_desc_t        *mdesc;
+            union {
+                ucp_mem_desc_t    *mdesc;
+                ucp_request_t     *amo_batch_next; /* Next operation in a
+                                                      software AMO batch */
+            };
         } send;
 
         /* "receive" part - used for tag_recv, am_recv and stream_recv operations */
@@ -346,6 +370,9 @@ struct ucp_request {
                     ucp_stream_recv_nbx_callback_t cb;     /* Completion callback */
                     size_t                         offset; /* Receive data offset */
                     size_t                         length; /* Completion info to fill */
+                    ucp_ep_h                       ep;     /* Receiving endpoint */
+                    uct_worker_cb_id_t             prog_id;/* Deferred completion
+                                                              progress callback */
                 } stream;
 
                  struct {
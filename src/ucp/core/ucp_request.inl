@@ -14,6 +14,7 @@
 
 #include <ucp/core/ucp_worker.h>
 #include <ucp/dt/dt.h>
+#include <ucp/proto/proto_select.h>
 #include <ucs/profile/profile.h>
 #include <ucs/datastruct/mpool.inl>
 #include <ucs/datastruct/ptr_map.inl>
@@ -192,6 +193,12 @@ ucp_request_complete_send(ucp_request_t *req, ucs_status_t status)
                   req, req + 1, UCP_REQUEST_FLAGS_ARG(req->flags),
                   ucs_status_string(status));
     UCS_PROFILE_REQUEST_EVENT(req, "complete_send", status);
+    if (ucs_unlikely(req->flags & UCP_REQUEST_FLAG_PROTO_SAMPLE)) {
+        ucp_proto_select_tune_complete(req, status);
+    }
+    if (ucs_unlikely(req->flags & UCP_REQUEST_FLAG_PROTO_TRACE)) {
+        ucp_proto_trace_complete(req, status);
+    }
     ucp_request_complete(req, send.cb, status, req->user_data);
 }
 
@@ -273,6 +280,9 @@ ucp_request_try_send(ucp_request_t *req, unsigned pending_flags)
         return 1;
     } else if (status == UCS_INPROGRESS) {
         /* Not completed, but made progress */
+        if (ucs_unlikely(req->flags & UCP_REQUEST_FLAG_PROTO_TRACE)) {
+            ucp_proto_trace_send(req);
+        }
         return 0;
     } else if (status == UCS_ERR_NO_RESOURCE) {
         /* No send resources, try to add to pending queue */
@@ -739,10 +749,15 @@ ucp_request_process_recv_data(ucp_request_t *req, const void *data,
 static UCS_F_ALWAYS_INLINE ucp_lane_index_t
 ucp_send_request_get_am_bw_lane(ucp_request_t *req)
 {
+    ucp_ep_config_t *config = ucp_ep_config(req->send.ep);
     ucp_lane_index_t lane;
 
-    lane = ucp_ep_config(req->send.ep)->
-           key.am_bw_lanes[req->send.am_bw_index];
+    if (ucs_unlikely(req->send.am_bw_index >= config->am_bw_stripe.length)) {
+        /* the endpoint was reconfigured with fewer lanes */
+        req->send.am_bw_index = 0;
+    }
+
+    lane = config->am_bw_stripe.lanes[req->send.am_bw_index];
     ucs_assertv(lane != UCP_NULL_LANE, "req->send.am_bw_index=%d",
                 req->send.am_bw_index);
     return lane;
@@ -754,12 +769,86 @@ ucp_send_request_next_am_bw_lane(ucp_request_t *req)
     ucp_lane_index_t am_bw_index = ++req->send.am_bw_index;
     ucp_ep_config_t *config      = ucp_ep_config(req->send.ep);
 
-    if ((am_bw_index >= UCP_MAX_LANES) ||
-        (config->key.am_bw_lanes[am_bw_index] == UCP_NULL_LANE)) {
+    if (am_bw_index >= config->am_bw_stripe.length) {
         req->send.am_bw_index = 0;
     }
 }
 
+/**
+ * Deficit round-robin between endpoints which send fragmented messages from
+ * transport pending queues. Called before sending the next fragment of a
+ * request.
+ *
+ * @return Nonzero if the request should yield its turn by returning
+ *         UCS_INPROGRESS without sending, since its endpoint has exhausted its
+ *         quantum while other endpoints of the worker are waiting.
+ */
+static UCS_F_ALWAYS_INLINE int ucp_request_tx_sched_yield(ucp_request_t *req)
+{
+    ucp_ep_h ep         = req->send.ep;
+    ucp_worker_h worker = ep->worker;
+    ucp_ep_ext_control_t *ext;
+
+    if (ucs_likely(req->send.pending_lane == UCP_NULL_LANE) ||
+        (worker->tx_sched.quantum == UCS_MEMUNITS_INF)) {
+        return 0;
+    }
+
+    ext = ucp_ep_ext_control(ep);
+    if (!(req->flags & UCP_REQUEST_FLAG_TX_SCHED)) {
+        req->flags |= UCP_REQUEST_FLAG_TX_SCHED;
+        if (ext->tx_sched.num_reqs++ == 0) {
+            ++worker->tx_sched.num_eps;
+            ext->tx_sched.deficit = worker->tx_sched.quantum;
+        }
+    }
+
+    if (ext->tx_sched.deficit > 0) {
+        return 0;
+    }
+
+    ext->tx_sched.deficit += worker->tx_sched.quantum;
+    if (worker->tx_sched.num_eps <= 1) {
+        /* no other endpoint is waiting */
+        return 0;
+    }
+
+    UCS_STATS_UPDATE_COUNTER(ep->stats, UCP_EP_STAT_TX_SCHED_YIELD, 1);
+    return 1;
+}
+
+/**
+ * Charge the endpoint of a request scheduled by @ref ucp_request_tx_sched_yield
+ * for the sent fragment.
+ *
+ * @param [in]  req     Send request.
+ * @param [in]  length  Size of the sent fragment.
+ * @param [in]  last    Whether the request is leaving the pending queue.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucp_request_tx_sched_update(ucp_request_t *req, size_t length, int last)
+{
+    ucp_ep_h ep = req->send.ep;
+    ucp_ep_ext_control_t *ext;
+
+    if (ucs_likely(!(req->flags & UCP_REQUEST_FLAG_TX_SCHED))) {
+        return;
+    }
+
+    ext                    = ucp_ep_ext_control(ep);
+    ext->tx_sched.deficit -= length;
+    if (!last) {
+        return;
+    }
+
+    req->flags &= ~UCP_REQUEST_FLAG_TX_SCHED;
+    ucs_assert(ext->tx_sched.num_reqs > 0);
+    if (--ext->tx_sched.num_reqs == 0) {
+        ucs_assert(ep->worker->tx_sched.num_eps > 0);
+        --ep->worker->tx_sched.num_eps;
+    }
+}
+
 static UCS_F_ALWAYS_INLINE ucs_ptr_map_key_t
 ucp_send_request_get_ep_remote_id(ucp_request_t *req)
 {
@@ -25,6 +25,40 @@ static struct {
 } UCS_S_PACKED ucp_mem_dummy_buffer = {0, UCS_MEMORY_TYPE_HOST};
 
 
+/* FNV-1a style hash of the packed buffer, mixing 64-bit words */
+static UCS_F_ALWAYS_INLINE khint_t
+ucp_rkey_cache_entry_hash(const ucp_rkey_cache_entry_t *entry)
+{
+    uint64_t hash    = 0xcbf29ce484222325ul ^ entry->ep_cfg_index;
+    const uint8_t *p = entry->buffer;
+    size_t length    = entry->length;
+    uint64_t value;
+
+    for (; length >= sizeof(value); length -= sizeof(value)) {
+        memcpy(&value, p, sizeof(value));
+        hash = (hash ^ value) * 0x100000001b3ul;
+        p   += sizeof(value);
+    }
+
+    value = 0;
+    memcpy(&value, p, length);
+    hash  = (hash ^ value) * 0x100000001b3ul;
+    return hash ^ (hash >> 32);
+}
+
+static UCS_F_ALWAYS_INLINE int
+ucp_rkey_cache_entry_is_equal(const ucp_rkey_cache_entry_t *entry1,
+                              const ucp_rkey_cache_entry_t *entry2)
+{
+    return (entry1->ep_cfg_index == entry2->ep_cfg_index) &&
+           (entry1->length == entry2->length) &&
+           !memcmp(entry1->buffer, entry2->buffer, entry1->length);
+}
+
+KHASH_IMPL(ucp_worker_rkey_cache, ucp_rkey_cache_entry_t*, char, 0,
+           ucp_rkey_cache_entry_hash, ucp_rkey_cache_entry_is_equal);
+
+
 size_t ucp_rkey_packed_size(ucp_context_h context, ucp_md_map_t md_map)
 {
     size_t size, md_size;
@@ -167,6 +201,153 @@ void ucp_rkey_buffer_release(void *rkey_buffer)
     ucs_free(rkey_buffer);
 }
 
+/* Size of a packed remote key, as parsed from the buffer itself */
+static size_t ucp_rkey_packed_length(const void *rkey_buffer)
+{
+    const uint8_t *p = rkey_buffer;
+    ucp_md_map_t md_map;
+    unsigned md_index;
+
+    md_map = *(const ucp_md_map_t*)p;
+    p     += sizeof(ucp_md_map_t) + sizeof(uint8_t);
+    ucs_for_each_bit(md_index, md_map) {
+        p += sizeof(uint8_t) + *p;
+    }
+
+    return UCS_PTR_BYTE_DIFF(rkey_buffer, p);
+}
+
+void ucp_rkey_cache_init(ucp_worker_h worker)
+{
+    kh_init_inplace(ucp_worker_rkey_cache, &worker->rkey_cache.hash);
+    ucs_list_head_init(&worker->rkey_cache.lru);
+}
+
+static void
+ucp_rkey_cache_evict(ucp_worker_h worker, ucp_rkey_cache_entry_t *entry)
+{
+    khiter_t iter;
+
+    iter = kh_get(ucp_worker_rkey_cache, &worker->rkey_cache.hash, entry);
+    ucs_assert(iter != kh_end(&worker->rkey_cache.hash));
+    kh_del(ucp_worker_rkey_cache, &worker->rkey_cache.hash, iter);
+    ucs_list_del(&entry->list);
+
+    ucs_trace("worker %p: evicting cached rkey %p", worker, entry->rkey);
+
+    /* Release the reference held by the cache */
+    ucp_rkey_destroy(entry->rkey);
+    ucs_free(entry);
+}
+
+void ucp_rkey_cache_cleanup(ucp_worker_h worker)
+{
+    ucp_rkey_cache_entry_t *entry, *tmp;
+
+    ucs_list_for_each_safe(entry, tmp, &worker->rkey_cache.lru, list) {
+        ucp_rkey_cache_evict(worker, entry);
+    }
+
+    kh_destroy_inplace(ucp_worker_rkey_cache, &worker->rkey_cache.hash);
+}
+
+/*
+ * Find a remote key which was unpacked from an identical buffer on an endpoint
+ * with the same configuration, and take a reference to it. Must be called with
+ * the worker lock held.
+ */
+static ucp_rkey_h ucp_rkey_cache_get(ucp_ep_h ep, const void *rkey_buffer,
+                                     size_t length)
+{
+    ucp_worker_h worker          = ep->worker;
+    const ucp_ep_config_t *config = ucp_ep_config(ep);
+    ucp_rkey_cache_entry_t key, *entry;
+    ucp_rkey_h rkey;
+    khiter_t iter;
+
+    key.ep_cfg_index = ep->cfg_index;
+    key.length       = length;
+    key.buffer       = rkey_buffer;
+
+    iter = kh_get(ucp_worker_rkey_cache, &worker->rkey_cache.hash, &key);
+    if (iter == kh_end(&worker->rkey_cache.hash)) {
+        return NULL;
+    }
+
+    entry = kh_key(&worker->rkey_cache.hash, iter);
+    rkey  = entry->rkey;
+    if (rkey->refcount == UINT16_MAX) {
+        return NULL;
+    }
+
+    /* Software RMA and AMO of the old protocols expect the remote key unpack
+     * to resolve the remote id of the endpoint */
+    if (!worker->context->config.ext.proto_enable &&
+        (config->key.am_lane != UCP_NULL_LANE) &&
+        ((rkey->cache.rma_proto == &ucp_rma_sw_proto) ||
+         (rkey->cache.amo_proto == &ucp_amo_sw_proto)) &&
+        (ucp_ep_resolve_remote_id(ep, config->key.am_lane) != UCS_OK)) {
+        return NULL;
+    }
+
+    ucs_list_del(&entry->list);
+    ucs_list_add_head(&worker->rkey_cache.lru, &entry->list);
+    ++rkey->refcount;
+    return rkey;
+}
+
+/*
+ * Make a newly unpacked remote key shared by the cache, evicting the least
+ * recently used entry if the cache is full. Failure to add the key is not an
+ * error, since the caller still owns a valid private key.
+ */
+static void ucp_rkey_cache_add(ucp_ep_h ep, const void *rkey_buffer,
+                               size_t length, ucp_rkey_h rkey)
+{
+    ucp_worker_h worker = ep->worker;
+    ucp_rkey_cache_entry_t *entry;
+    int ret;
+
+    /* Only pool keys can find their worker when released */
+    if (!(rkey->flags & UCP_RKEY_DESC_FLAG_POOL)) {
+        return;
+    }
+
+    if (kh_size(&worker->rkey_cache.hash) >=
+        worker->context->config.ext.rkey_cache_size) {
+        ucp_rkey_cache_evict(worker,
+                             ucs_list_tail(&worker->rkey_cache.lru,
+                                           ucp_rkey_cache_entry_t, list));
+    }
+
+    entry = ucs_malloc(sizeof(*entry) + length, "ucp_rkey_cache_entry");
+    if (entry == NULL) {
+        ucs_debug("failed to allocate rkey cache entry");
+        return;
+    }
+
+    memcpy(entry + 1, rkey_buffer, length);
+    entry->rkey         = rkey;
+    entry->ep_cfg_index = ep->cfg_index;
+    entry->length       = length;
+    entry->buffer       = entry + 1;
+
+    kh_put(ucp_worker_rkey_cache, &worker->rkey_cache.hash, entry, &ret);
+    if ((ret == UCS_KH_PUT_FAILED) || (ret == UCS_KH_PUT_KEY_PRESENT)) {
+        /* Key is already cached but has too many users */
+        ucs_free(entry);
+        return;
+    }
+
+    ucs_list_add_head(&worker->rkey_cache.lru, &entry->list);
+    rkey->flags   |= UCP_RKEY_DESC_FLAG_CACHED;
+    rkey->refcount = 2; /* The cache and the caller */
+#if ENABLE_PARAMS_CHECK
+    /* Can be used on all endpoints with the same configuration */
+    rkey->ep       = NULL;
+#endif
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucp_ep_rkey_unpack, (ep, rkey_buffer, rkey_p),
                  ucp_ep_h ep, const void *rkey_buffer,
                  ucp_rkey_h *rkey_p)
@@ -186,9 +367,27 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_ep_rkey_unpack, (ep, rkey_buffer, rkey_p),
     uint8_t md_size;
     const uint8_t *p;
     uint8_t flags;
+    size_t length = 0;
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
+    /* rkey configuration depends on the endpoint lanes */
+    status = ucp_ep_resolve_lazy(ep);
+    if (status != UCS_OK) {
+        goto out_unlock;
+    }
+
+    if (worker->context->config.ext.rkey_cache_size > 0) {
+        length = ucp_rkey_packed_length(rkey_buffer);
+        rkey   = ucp_rkey_cache_get(ep, rkey_buffer, length);
+        if (rkey != NULL) {
+            ucs_trace("ep %p: found cached rkey %p", ep, rkey);
+            *rkey_p = rkey;
+            status  = UCS_OK;
+            goto out_unlock;
+        }
+    }
+
     ep_config = ucp_ep_config(ep);
 
     /* Count the number of remote MDs in the rkey buffer */
@@ -226,6 +425,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_ep_rkey_unpack, (ep, rkey_buffer, rkey_p),
     rkey->md_map   = md_map;
     rkey->mem_type = mem_type;
     rkey->flags    = flags;
+    rkey->refcount = 0;
 #if ENABLE_PARAMS_CHECK
     rkey->ep       = ep;
 #endif
@@ -298,6 +498,10 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_ep_rkey_unpack, (ep, rkey_buffer, rkey_p),
         ucp_rkey_resolve_inner(rkey, ep);
     }
 
+    if (worker->context->config.ext.rkey_cache_size > 0) {
+        ucp_rkey_cache_add(ep, rkey_buffer, length, rkey);
+    }
+
     ucs_trace("unpacked rkey %p with md_map 0x%lx type %s", rkey, rkey->md_map,
               ucs_memory_type_names[rkey->mem_type]);
     *rkey_p = rkey;
@@ -365,6 +569,19 @@ void ucp_rkey_destroy(ucp_rkey_h rkey)
 {
     unsigned remote_md_index, rkey_index;
     ucp_worker_h UCS_V_UNUSED worker;
+    int is_last;
+
+    if (rkey->flags & UCP_RKEY_DESC_FLAG_CACHED) {
+        worker = ucs_container_of(ucs_mpool_obj_owner(rkey), ucp_worker_t,
+                                  rkey_mp);
+        UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+        ucs_assert(rkey->refcount > 0);
+        is_last = (--rkey->refcount == 0);
+        UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+        if (!is_last) {
+            return;
+        }
+    }
 
     ucs_trace("destroying rkey %p", rkey);
 
@@ -33,11 +33,27 @@ typedef struct ucp_tl_rkey {
  * Rkey flags
  */
 enum {
-    UCP_RKEY_DESC_FLAG_POOL       = UCS_BIT(0)  /* Descriptor was allocated from pool
+    UCP_RKEY_DESC_FLAG_POOL       = UCS_BIT(0), /* Descriptor was allocated from pool
                                                    and must be retuned to pool, not free */
+    UCP_RKEY_DESC_FLAG_CACHED     = UCS_BIT(1)  /* Descriptor is shared by the worker
+                                                   rkey cache, and released when its
+                                                   reference count drops to zero */
 };
 
 
+/**
+ * Worker rkey cache entry, which holds a copy of the packed buffer the remote
+ * key was unpacked from. Lookup keys point to the user buffer instead.
+ */
+typedef struct ucp_rkey_cache_entry {
+    ucs_list_link_t               list;         /* Entry in the LRU list */
+    ucp_rkey_h                    rkey;         /* Shared remote key */
+    ucp_worker_cfg_index_t        ep_cfg_index; /* Endpoint configuration */
+    size_t                        length;       /* Packed buffer length */
+    const void                    *buffer;      /* Packed remote key */
+} ucp_rkey_cache_entry_t;
+
+
 /**
  * Rkey configuration key
  */
@@ -80,6 +96,7 @@ typedef struct ucp_rkey {
     ucs_memory_type_t             mem_type;     /* Memory type of remote key memory */
     uint8_t                       flags;        /* Rkey flags */
     ucp_worker_cfg_index_t        cfg_index;    /* Rkey configuration index */
+    uint16_t                      refcount;     /* Number of users of a cached rkey */
 #if ENABLE_PARAMS_CHECK
     ucp_ep_h                      ep;
 #endif
@@ -107,7 +124,7 @@ typedef struct ucp_rkey {
 #define UCP_RKEY_RESOLVE(_rkey, _ep, _op_type) \
     ({ \
         ucs_status_t _status; \
-        if ((_rkey)->ep != (_ep)) { \
+        if (((_rkey)->ep != NULL) && ((_rkey)->ep != (_ep))) { \
             ucs_error("cannot use a remote key on a different endpoint than it was unpacked on"); \
             _status = UCS_ERR_INVALID_PARAM; \
         } else { \
@@ -123,6 +140,12 @@ typedef struct ucp_rkey {
 void ucp_rkey_resolve_inner(ucp_rkey_h rkey, ucp_ep_h ep);
 
 
+void ucp_rkey_cache_init(ucp_worker_h worker);
+
+
+void ucp_rkey_cache_cleanup(ucp_worker_h worker);
+
+
 ucp_lane_index_t ucp_rkey_find_rma_lane(ucp_context_h context,
                                         const ucp_ep_config_t *config,
                                         ucs_memory_type_t mem_type,
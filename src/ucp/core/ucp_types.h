@@ -49,6 +49,7 @@ typedef struct ucp_recv_desc            ucp_recv_desc_t;
 typedef struct ucp_address_iface_attr   ucp_address_iface_attr_t;
 typedef struct ucp_address_entry        ucp_address_entry_t;
 typedef struct ucp_unpacked_address     ucp_unpacked_address_t;
+typedef struct ucp_address_profile      ucp_address_profile_t;
 typedef struct ucp_wireup_ep            ucp_wireup_ep_t;
 typedef struct ucp_request_send_proto   ucp_request_send_proto_t;
 typedef struct ucp_worker_iface         ucp_worker_iface_t;
@@ -153,6 +154,9 @@ typedef enum {
                                           defined AM */
     UCP_AM_ID_SINGLE_REPLY      =  26, /* Single fragment user defined AM
                                           carrying remote ep for reply */
+    UCP_AM_ID_ATOMIC_BATCH_REQ  =  27, /* Batch of remote memory atomics */
+    UCP_AM_ID_ATOMIC_BATCH_REP  =  28, /* Reply to a batch of remote memory
+                                          atomics */
     UCP_AM_ID_LAST
 } ucp_am_id_t;
 
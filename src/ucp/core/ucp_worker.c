@@ -27,12 +27,15 @@
 #include <ucs/type/cpu_set.h>
 #include <ucs/sys/string.h>
 #include <ucs/arch/atomic.h>
+#include <ucs/vfs/base/vfs_obj.h>
 #include <sys/poll.h>
 #include <sys/eventfd.h>
 #include <sys/epoll.h>
 
 
 #define UCP_WORKER_KEEPALIVE_ITER_SKIP 32
+#define UCP_WORKER_KEEPALIVE_WHEEL_RES 64 /* Number of keepalive timer wheel
+                                             ticks per keepalive interval */
 
 #define UCP_WORKER_HEADROOM_SIZE \
     (sizeof(ucp_recv_desc_t) + UCP_WORKER_HEADROOM_PRIV_SIZE)
@@ -80,6 +83,25 @@ static ucs_stats_class_t ucp_worker_stats_class = {
 };
 #endif
 
+static const ucs_counters_class_t ucp_worker_counters_class = {
+    .name           = "ucp_worker",
+    .num_counters   = UCP_WORKER_COUNTER_LAST,
+    .gauges         = UCS_BIT(UCP_WORKER_COUNTER_TAG_UNEXP_DEPTH),
+    .counter_names  = {
+        [UCP_WORKER_COUNTER_TAG_TX_EAGER]            = "tag_tx_eager",
+        [UCP_WORKER_COUNTER_TAG_TX_EAGER_SYNC]       = "tag_tx_eager_sync",
+        [UCP_WORKER_COUNTER_TAG_TX_RNDV]             = "tag_tx_rndv",
+        [UCP_WORKER_COUNTER_TAG_TX_EAGER_BYTES]      = "tag_tx_eager_bytes",
+        [UCP_WORKER_COUNTER_TAG_TX_EAGER_SYNC_BYTES] = "tag_tx_eager_sync_bytes",
+        [UCP_WORKER_COUNTER_TAG_TX_RNDV_BYTES]       = "tag_tx_rndv_bytes",
+        [UCP_WORKER_COUNTER_TAG_RX_EAGER]            = "tag_rx_eager",
+        [UCP_WORKER_COUNTER_TAG_RX_EAGER_SYNC]       = "tag_rx_eager_sync",
+        [UCP_WORKER_COUNTER_TAG_RX_RNDV]             = "tag_rx_rndv",
+        [UCP_WORKER_COUNTER_TX_PENDING]              = "tx_pending",
+        [UCP_WORKER_COUNTER_TAG_UNEXP_DEPTH]         = "tag_unexp_depth"
+    }
+};
+
 ucs_mpool_ops_t ucp_am_mpool_ops = {
     .chunk_alloc   = ucs_mpool_hugetlb_malloc,
     .chunk_release = ucs_mpool_hugetlb_free,
@@ -115,6 +137,10 @@ static ucs_mpool_ops_t ucp_rkey_mpool_ops = {
 KHASH_IMPL(ucp_worker_discard_uct_ep_hash, uct_ep_h, ucp_request_t*, 1,
            ucp_worker_discard_uct_ep_hash_key, kh_int64_hash_equal);
 
+KHASH_IMPL(ucp_worker_ep_config, const ucp_ep_config_key_t*,
+           ucp_worker_cfg_index_t, 1, ucp_ep_config_key_hash,
+           ucp_ep_config_is_equal);
+
 
 static ucs_status_t ucp_worker_wakeup_ctl_fd(ucp_worker_h worker,
                                              ucp_worker_event_fd_op_t op,
@@ -1826,13 +1852,14 @@ ucp_worker_get_ep_config(ucp_worker_h worker, const ucp_ep_config_key_t *key,
     ucp_memtype_thresh_t *max_eager_short;
     ucs_status_t status;
     char tl_info[256];
+    khiter_t khiter;
+    int khret;
 
-    /* Search for the given key in the ep_config array */
-    for (ep_cfg_index = 0; ep_cfg_index < worker->ep_config_count;
-         ++ep_cfg_index) {
-        if (ucp_ep_config_is_equal(&worker->ep_config[ep_cfg_index].key, key)) {
-            goto out;
-        }
+    /* Search for the given key in the ep_config hash */
+    khiter = kh_get(ucp_worker_ep_config, &worker->ep_config_hash, key);
+    if (ucs_likely(khiter != kh_end(&worker->ep_config_hash))) {
+        ep_cfg_index = kh_val(&worker->ep_config_hash, khiter);
+        goto out;
     }
 
     if (worker->ep_config_count >= UCP_WORKER_MAX_EP_CONFIG) {
@@ -1875,6 +1902,17 @@ ucp_worker_get_ep_config(ucp_worker_h worker, const ucp_ep_config_key_t *key,
         max_eager_short->memtype_on  = tag_short.max_length_host_mem;
     }
 
+    /* The hash refers to the key copy owned by the new configuration */
+    khiter = kh_put(ucp_worker_ep_config, &worker->ep_config_hash,
+                    &ep_config->key, &khret);
+    if (khret == UCS_KH_PUT_FAILED) {
+        ucp_ep_config_cleanup(worker, ep_config);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    ucs_assert_always(khret != UCS_KH_PUT_KEY_PRESENT);
+    kh_value(&worker->ep_config_hash, khiter) = ep_cfg_index;
+
     if (print_cfg) {
         ucs_info("%s", ucp_worker_print_used_tls(key, context, ep_cfg_index,
                                                  tl_info, sizeof(tl_info)));
@@ -1948,9 +1986,32 @@ err:
     return status;
 }
 
-static UCS_F_ALWAYS_INLINE void ucp_worker_keepalive_reset(ucp_worker_h worker)
+static ucs_status_t ucp_worker_keepalive_init(ucp_worker_h worker)
+{
+    ucs_time_t interval = worker->context->config.keepalive_interval;
+
+    worker->keepalive.cb_id      = UCS_CALLBACKQ_ID_NULL;
+    worker->keepalive.lane_map   = 0;
+    worker->keepalive.iter_count = 0;
+    ucs_list_head_init(&worker->keepalive.due_eps);
+
+    if (!ucp_worker_keepalive_is_enabled(worker)) {
+        return UCS_OK;
+    }
+
+    return ucs_twheel_init(&worker->keepalive.wheel,
+                           ucs_max(interval / UCP_WORKER_KEEPALIVE_WHEEL_RES, 1),
+                           ucs_get_time());
+}
+
+static void ucp_worker_keepalive_cleanup(ucp_worker_h worker)
 {
-    worker->keepalive.iter = &worker->all_eps;
+    if (!ucp_worker_keepalive_is_enabled(worker)) {
+        return;
+    }
+
+    ucs_assert(ucs_list_is_empty(&worker->keepalive.due_eps));
+    ucs_twheel_cleanup(&worker->keepalive.wheel);
 }
 
 static void ucp_worker_destroy_configs(ucp_worker_h worker)
@@ -1968,6 +2029,29 @@ static void ucp_worker_destroy_configs(ucp_worker_h worker)
     worker->rkey_config_count = 0;
 }
 
+static void ucp_worker_vfs_show_counters(void *obj, ucs_string_buffer_t *strb)
+{
+    ucp_worker_h worker = obj;
+
+    ucs_counters_print(&worker->counters, 0, strb);
+}
+
+static void ucp_worker_vfs_show_gauges(void *obj, ucs_string_buffer_t *strb)
+{
+    ucp_worker_h worker = obj;
+
+    ucs_counters_print(&worker->counters, 1, strb);
+}
+
+static void ucp_worker_vfs_init(ucp_worker_h worker)
+{
+    ucs_vfs_obj_add_dir(worker->context, worker, "worker/%s-%p",
+                        worker->address_name, worker);
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_counters, "counters");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_gauges, "gauges");
+    ucp_proto_trace_vfs_init(worker);
+}
+
 ucs_status_t ucp_worker_create(ucp_context_h context,
                                const ucp_worker_params_t *params,
                                ucp_worker_h *worker_p)
@@ -1985,6 +2069,8 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     worker->context              = context;
     worker->uuid                 = ucs_generate_uuid((uintptr_t)worker);
     worker->flush_ops_count      = 0;
+    worker->fence_sn             = 0;
+    worker->flush_worker_count   = 0;
     worker->inprogress           = 0;
     worker->rkey_config_count    = 0;
     worker->ep_config_count      = 0;
@@ -1992,18 +2078,19 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     worker->num_ifaces           = 0;
     worker->am_message_id        = ucs_generate_uuid(0);
     worker->rkey_ptr_cb_id       = UCS_CALLBACKQ_ID_NULL;
-    worker->keepalive.cb_id      = UCS_CALLBACKQ_ID_NULL;
-    worker->keepalive.last_round = 0;
-    worker->keepalive.lane_map   = 0;
-    worker->keepalive.ep_count   = 0;
-    worker->keepalive.iter_count = 0;
-    ucp_worker_keepalive_reset(worker);
+    worker->tx_sched.quantum     = context->config.ext.tx_sched_quantum;
+    worker->tx_sched.num_eps     = 0;
     ucs_queue_head_init(&worker->rkey_ptr_reqs);
     ucs_list_head_init(&worker->arm_ifaces);
     ucs_list_head_init(&worker->stream_ready_eps);
     ucs_list_head_init(&worker->all_eps);
+    ucs_list_head_init(&worker->dirty_eps);
+    ucs_list_head_init(&worker->proto_tune_samples);
+    kh_init_inplace(ucp_worker_ep_config, &worker->ep_config_hash);
     kh_init_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
     kh_init_inplace(ucp_worker_discard_uct_ep_hash, &worker->discard_uct_ep_hash);
+    ucp_address_profiles_init(worker);
+    ucp_rkey_cache_init(worker);
 
     /* Copy user flags, and mask-out unsupported flags for compatibility */
     worker->flags = UCP_PARAM_VALUE(WORKER, params, flags, FLAGS, 0) &
@@ -2060,11 +2147,16 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
         goto err_free;
     }
 
+    status = ucp_worker_keepalive_init(worker);
+    if (status != UCS_OK) {
+        goto err_destroy_ptr_map;
+    }
+
     /* Create statistics */
     status = UCS_STATS_NODE_ALLOC(&worker->stats, &ucp_worker_stats_class,
                                   ucs_stats_get_root(), "-%p", worker);
     if (status != UCS_OK) {
-        goto err_destroy_ptr_map;
+        goto err_keepalive_cleanup;
     }
 
     status = UCS_STATS_NODE_ALLOC(&worker->tm_offload_stats,
@@ -2074,12 +2166,22 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
         goto err_free_stats;
     }
 
+    status = ucs_counters_init(&worker->counters, &ucp_worker_counters_class);
+    if (status != UCS_OK) {
+        goto err_free_tm_offload_stats;
+    }
+
+    status = ucp_proto_trace_init(worker);
+    if (status != UCS_OK) {
+        goto err_cleanup_counters;
+    }
+
     status = ucs_async_context_init(&worker->async,
                                     context->config.ext.use_mt_mutex ?
                                     UCS_ASYNC_MODE_THREAD_MUTEX :
                                     UCS_ASYNC_THREAD_LOCK_TYPE);
     if (status != UCS_OK) {
-        goto err_free_tm_offload_stats;
+        goto err_cleanup_proto_trace;
     }
 
     /* Create the underlying UCT worker */
@@ -2148,6 +2250,8 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
      */
     ucs_config_parser_warn_unused_env_vars_once(context->config.env_prefix);
 
+    ucp_worker_vfs_init(worker);
+
     *worker_p = worker;
     return UCS_OK;
 
@@ -2168,17 +2272,26 @@ err_destroy_uct_worker:
     uct_worker_destroy(worker->uct);
 err_destroy_async:
     ucs_async_context_cleanup(&worker->async);
+err_cleanup_proto_trace:
+    ucp_proto_trace_cleanup(worker);
+err_cleanup_counters:
+    ucs_counters_cleanup(&worker->counters);
 err_free_tm_offload_stats:
     UCS_STATS_NODE_FREE(worker->tm_offload_stats);
 err_free_stats:
     UCS_STATS_NODE_FREE(worker->stats);
+err_keepalive_cleanup:
+    ucp_worker_keepalive_cleanup(worker);
 err_destroy_ptr_map:
     ucs_ptr_map_destroy(&worker->ptr_map);
 err_free:
     ucs_strided_alloc_cleanup(&worker->ep_alloc);
+    ucp_rkey_cache_cleanup(worker);
+    ucp_address_profiles_cleanup(worker);
     kh_destroy_inplace(ucp_worker_discard_uct_ep_hash,
                        &worker->discard_uct_ep_hash);
     kh_destroy_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
+    kh_destroy_inplace(ucp_worker_ep_config, &worker->ep_config_hash);
     ucp_worker_destroy_configs(worker);
     ucs_free(worker);
     return status;
@@ -2351,12 +2464,15 @@ void ucp_worker_destroy(ucp_worker_h worker)
 {
     ucs_debug("destroy worker %p", worker);
 
+    ucs_vfs_obj_remove(worker);
+
     UCS_ASYNC_BLOCK(&worker->async);
     uct_worker_progress_unregister_safe(worker->uct, &worker->keepalive.cb_id);
     ucp_worker_destroy_eps(worker);
     ucp_worker_remove_am_handlers(worker);
     ucp_am_cleanup(worker);
     ucp_worker_discarded_uct_eps_cleanup(worker);
+    ucp_rkey_cache_cleanup(worker);
 
     if (worker->flush_ops_count != 0) {
         ucs_warn("not all pending operations (%u) were flushed on worker %p "
@@ -2374,24 +2490,48 @@ void ucp_worker_destroy(ucp_worker_h worker)
     ucp_worker_wakeup_cleanup(worker);
     uct_worker_destroy(worker->uct);
     ucs_async_context_cleanup(&worker->async);
+    ucp_proto_trace_cleanup(worker);
+    ucs_counters_cleanup(&worker->counters);
     UCS_STATS_NODE_FREE(worker->tm_offload_stats);
     UCS_STATS_NODE_FREE(worker->stats);
+    ucp_worker_keepalive_cleanup(worker);
     ucs_ptr_map_destroy(&worker->ptr_map);
     ucs_strided_alloc_cleanup(&worker->ep_alloc);
+    ucp_address_profiles_cleanup(worker);
     kh_destroy_inplace(ucp_worker_discard_uct_ep_hash,
                        &worker->discard_uct_ep_hash);
     kh_destroy_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
+    kh_destroy_inplace(ucp_worker_ep_config, &worker->ep_config_hash);
     ucp_worker_destroy_configs(worker);
     ucs_free(worker);
 }
 
+void ucp_worker_address_tl_bitmap(ucp_worker_h worker, unsigned address_flags,
+                                  ucp_tl_bitmap_t *tl_bitmap)
+{
+    ucp_context_h context = worker->context;
+    ucp_rsc_index_t tl_id;
+
+    if (!(address_flags & UCP_WORKER_ADDRESS_FLAG_NET_ONLY)) {
+        UCS_BITMAP_SET_ALL(*tl_bitmap);
+        return;
+    }
+
+    UCS_BITMAP_CLEAR(tl_bitmap);
+    UCS_BITMAP_FOR_EACH_BIT(context->tl_bitmap, tl_id) {
+        if (context->tl_rscs[tl_id].tl_rsc.dev_type == UCT_DEVICE_TYPE_NET) {
+            UCS_BITMAP_SET(*tl_bitmap, tl_id);
+        }
+    }
+}
+
 ucs_status_t ucp_worker_query(ucp_worker_h worker,
                               ucp_worker_attr_t *attr)
 {
-    ucp_context_h context = worker->context;
     ucs_status_t status   = UCS_OK;
     ucp_tl_bitmap_t tl_bitmap;
-    ucp_rsc_index_t tl_id;
+    unsigned address_flags;
+    unsigned pack_flags;
 
     if (attr->field_mask & UCP_WORKER_ATTR_FIELD_THREAD_MODE) {
         if (worker->flags & UCP_WORKER_FLAG_THREAD_MULTI) {
@@ -2406,23 +2546,21 @@ ucs_status_t ucp_worker_query(ucp_worker_h worker,
     if (attr->field_mask & UCP_WORKER_ATTR_FIELD_ADDRESS) {
         /* If UCP_WORKER_ATTR_FIELD_ADDRESS_FLAGS is not set,
          * pack all tl addresses */
-        UCS_BITMAP_SET_ALL(tl_bitmap);
-
-        if (attr->field_mask & UCP_WORKER_ATTR_FIELD_ADDRESS_FLAGS) {
-            if (attr->address_flags & UCP_WORKER_ADDRESS_FLAG_NET_ONLY) {
-                UCS_BITMAP_CLEAR(&tl_bitmap);
-                UCS_BITMAP_FOR_EACH_BIT(context->tl_bitmap, tl_id) {
-                    if (context->tl_rscs[tl_id].tl_rsc.dev_type == UCT_DEVICE_TYPE_NET) {
-                        UCS_BITMAP_SET(tl_bitmap, tl_id);
-                    }
-                }
-            }
+        address_flags = (attr->field_mask &
+                         UCP_WORKER_ATTR_FIELD_ADDRESS_FLAGS) ?
+                        attr->address_flags : 0;
+        pack_flags    = UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT;
+        if (address_flags & UCP_WORKER_ADDRESS_FLAG_COMPACT) {
+            pack_flags |= UCP_ADDRESS_PACK_FLAG_PROFILE;
         }
 
-        status = ucp_address_pack(worker, NULL, &tl_bitmap,
-                                  UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT, NULL,
+        ucp_worker_address_tl_bitmap(worker, address_flags, &tl_bitmap);
+
+        UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+        status = ucp_address_pack(worker, NULL, &tl_bitmap, pack_flags, NULL,
                                   &attr->address_length,
                                   (void**)&attr->address);
+        UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
     }
 
     if (attr->field_mask & UCP_WORKER_ATTR_FIELD_MAX_AM_HEADER) {
@@ -2716,90 +2854,94 @@ void ucp_worker_print_info(ucp_worker_h worker, FILE *stream)
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
 }
 
-static UCS_F_ALWAYS_INLINE ucp_ep_h
-ucp_worker_keepalive_current_ep(ucp_worker_h worker)
+static void
+ucp_worker_keepalive_schedule(ucp_worker_h worker,
+                              ucp_ep_ext_control_t *ep_ext, ucs_time_t delta)
 {
-    ucp_ep_ext_gen_t *ep_ext = ucs_container_of(worker->keepalive.iter,
-                                                ucp_ep_ext_gen_t, ep_list);
-    return ucp_ep_from_ext_gen(ep_ext);
+    ucs_twheel_t *wheel = &worker->keepalive.wheel;
+
+    ucs_wtimer_add(wheel, &ep_ext->keepalive.timer, ucs_max(delta, wheel->res));
 }
 
-static UCS_F_ALWAYS_INLINE void
-ucp_worker_keepalive_next_ep(ucp_worker_h worker)
+static void ucp_worker_keepalive_timer_cb(ucs_wtimer_t *timer)
 {
-    ucp_ep_h ep;
+    ucp_ep_ext_control_t *ep_ext = ucs_container_of(timer,
+                                                    ucp_ep_ext_control_t,
+                                                    keepalive.timer);
+    ucp_worker_h worker          = ep_ext->keepalive.ep->worker;
+    ucs_time_t interval          = worker->context->config.keepalive_interval;
+    ucs_time_t idle;
 
-    worker->keepalive.iter = worker->keepalive.iter->next;
-    if (worker->keepalive.iter == &worker->all_eps) {
-        /* if next list item points to all_eps then step one more time */
-        worker->keepalive.iter = worker->keepalive.iter->next;
+    idle = ucs_twheel_get_time(&worker->keepalive.wheel) -
+           ep_ext->keepalive.rx_time;
+    if (idle < interval) {
+        /* the peer has sent something recently, so it is alive - postpone the
+         * check until the EP is idle for a whole interval */
+        ucp_worker_keepalive_schedule(worker, ep_ext, interval - idle);
+        return;
     }
 
-    ucs_assert(worker->keepalive.iter != &worker->all_eps);
-    ep                         = ucp_worker_keepalive_current_ep(worker);
-    worker->keepalive.lane_map = ((ep->cfg_index != UCP_WORKER_CFG_INDEX_NULL) &&
-                                  !(ep->flags & UCP_EP_FLAG_FAILED)) ?
-                                 ucp_ep_config(ep)->key.ep_check_map : 0;
+    ucs_list_add_tail(&worker->keepalive.due_eps, &ep_ext->keepalive.list);
+}
+
+static UCS_F_ALWAYS_INLINE ucp_lane_map_t
+ucp_worker_keepalive_ep_lane_map(ucp_ep_h ep)
+{
+    return ((ep->cfg_index != UCP_WORKER_CFG_INDEX_NULL) &&
+            !(ep->flags & UCP_EP_FLAG_FAILED)) ?
+           ucp_ep_config(ep)->key.ep_check_map : 0;
 }
 
 static UCS_F_NOINLINE unsigned
 ucp_worker_do_keepalive_progress(ucp_worker_h worker)
 {
-    ucs_time_t now;
-    ucs_list_link_t *iter_begin;
+    ucs_time_t interval = worker->context->config.keepalive_interval;
+    unsigned ep_count   = 0;
+    ucp_ep_ext_control_t *ep_ext;
     ucp_ep_h ep;
 
     ucs_assert(worker->context->config.ext.keepalive_num_eps != 0);
 
-    now = ucs_get_time();
-    if (ucs_likely((now - worker->keepalive.last_round) <
-                   worker->context->config.keepalive_interval)) {
-        return 0;
-    }
-
-    ucs_trace_func("worker %p: keepalive round", worker);
-
-    if (ucs_unlikely(ucs_list_is_empty(&worker->all_eps))) {
-        ucs_assert(worker->keepalive.iter == &worker->all_eps);
-        ucs_trace("worker %p: keepalive ep list is empty - disabling", worker);
-        uct_worker_progress_unregister_safe(worker->uct,
-                                            &worker->keepalive.cb_id);
-        return 0;
-    }
+    ucs_twheel_sweep(&worker->keepalive.wheel, ucs_get_time());
 
-    if (ucs_unlikely(worker->keepalive.iter == &worker->all_eps)) {
-        ucp_worker_keepalive_next_ep(worker);
-    }
+    while (!ucs_list_is_empty(&worker->keepalive.due_eps) &&
+           (ep_count < worker->context->config.ext.keepalive_num_eps)) {
+        ep_ext = ucs_list_head(&worker->keepalive.due_eps,
+                               ucp_ep_ext_control_t, keepalive.list);
+        ep     = ep_ext->keepalive.ep;
+        if (worker->keepalive.lane_map == 0) {
+            worker->keepalive.lane_map = ucp_worker_keepalive_ep_lane_map(ep);
+        }
 
-    iter_begin = worker->keepalive.iter;
-    /* use own loop for elements because standard for_each skips
-     * head element */
-    /* TODO: use more optimal algo to enumerate EPs to keepalive
-     * (linked list) */
-    do {
-        ep = ucp_worker_keepalive_current_ep(worker);
-        ucs_trace_func("worker %p: do keepalive on ep %p lane_map 0x%x", worker, ep,
-                        worker->keepalive.lane_map);
+        ucs_trace_func("worker %p: do keepalive on ep %p lane_map 0x%x", worker,
+                       ep, worker->keepalive.lane_map);
         ucp_ep_do_keepalive(ep, &worker->keepalive.lane_map);
+        if (ucs_unlikely(worker->keepalive.due_eps.next !=
+                         &ep_ext->keepalive.list)) {
+            /* EP was removed from the worker while doing keepalive */
+            worker->keepalive.lane_map = 0;
+            continue;
+        }
+
         if (worker->keepalive.lane_map != 0) {
             /* in case if EP has no resources to send keepalive message
-             * then just return without update of last_round timestamp,
-             * on next progress iteration we will continue from this point */
-            goto out_no_resources;
+             * then leave it at the head of the due list, on next progress
+             * iteration we will continue from this point */
+            break;
         }
 
-        worker->keepalive.ep_count++;
-        ucp_worker_keepalive_next_ep(worker);
-    } while ((iter_begin != worker->keepalive.iter) &&
-             (worker->keepalive.ep_count < worker->context->config.ext.keepalive_num_eps));
+        ucs_list_del(&ep_ext->keepalive.list);
+        ucs_list_head_init(&ep_ext->keepalive.list);
+        ucp_worker_keepalive_schedule(worker, ep_ext, interval);
+        ++ep_count;
+    }
 
-    ucs_trace("worker %p: sent keepalive on %u endpoints", worker,
-              worker->keepalive.ep_count);
-    worker->keepalive.last_round = now;
-    worker->keepalive.ep_count   = 0;
+    if (ep_count > 0) {
+        ucs_trace("worker %p: sent keepalive on %u endpoints", worker,
+                  ep_count);
+    }
 
-out_no_resources:
-    return worker->keepalive.ep_count;
+    return ep_count;
 }
 
 static unsigned ucp_worker_keepalive_progress(void *arg)
@@ -2815,7 +2957,8 @@ static unsigned ucp_worker_keepalive_progress(void *arg)
 
 void ucp_worker_keepalive_add_ep(ucp_ep_h ep)
 {
-    ucp_worker_h worker = ep->worker;
+    ucp_worker_h worker          = ep->worker;
+    ucp_ep_ext_control_t *ep_ext = ucp_ep_ext_control(ep);
 
     ucs_assert(ep->cfg_index != UCP_WORKER_CFG_INDEX_NULL);
 
@@ -2831,6 +2974,18 @@ void ucp_worker_keepalive_add_ep(ucp_ep_h ep)
 
     ucs_trace("ep %p flags 0x%x: adding to keepalive lane_map 0x%x", ep,
               ep->flags, ucp_ep_config(ep)->key.ep_check_map);
+
+    if (!ep_ext->keepalive.timer.is_active &&
+        ucs_list_is_empty(&ep_ext->keepalive.list)) {
+        /* bring the wheel time up to date, since it is advanced only from
+         * the progress callback */
+        ucs_twheel_sweep(&worker->keepalive.wheel, ucs_get_time());
+        ep_ext->keepalive.rx_time = ucs_twheel_get_time(&worker->keepalive.wheel);
+        ucs_wtimer_init(&ep_ext->keepalive.timer, ucp_worker_keepalive_timer_cb);
+        ucp_worker_keepalive_schedule(worker, ep_ext,
+                                      worker->context->config.keepalive_interval);
+    }
+
     uct_worker_progress_register_safe(worker->uct,
                                       ucp_worker_keepalive_progress, worker,
                                       UCS_CALLBACKQ_FLAG_FAST,
@@ -2840,24 +2995,34 @@ void ucp_worker_keepalive_add_ep(ucp_ep_h ep)
 /* EP is removed from worker */
 void ucp_worker_keepalive_remove_ep(ucp_ep_h ep)
 {
-    ucp_worker_h worker = ep->worker;
+    ucp_worker_h worker          = ep->worker;
+    ucp_ep_ext_control_t *ep_ext = ucp_ep_ext_control(ep);
 
     ucs_assert(!(ep->flags & UCP_EP_FLAG_INTERNAL));
 
     if (!ucp_worker_keepalive_is_enabled(worker)) {
-        ucs_assert(worker->keepalive.iter == &worker->all_eps);
+        ucs_assert(!ep_ext->keepalive.timer.is_active);
+        ucs_assert(ucs_list_is_empty(&ep_ext->keepalive.list));
         return;
     }
 
-    ucs_assert(!ucs_list_is_empty(&worker->all_eps));
+    ucs_wtimer_remove(&worker->keepalive.wheel, &ep_ext->keepalive.timer);
 
-    if (ucs_list_is_only(&worker->all_eps, &ucp_ep_ext_gen(ep)->ep_list)) {
-        /* this is the last EP in worker */
-        worker->keepalive.iter = &worker->all_eps;
-    } else if (worker->keepalive.iter == &ucp_ep_ext_gen(ep)->ep_list) {
-        /* if iterator points into EP to be removed - then
-         * step to next EP */
-        ucp_worker_keepalive_next_ep(worker);
+    if (!ucs_list_is_empty(&ep_ext->keepalive.list)) {
+        if (worker->keepalive.due_eps.next == &ep_ext->keepalive.list) {
+            /* the lane map belongs to the EP which is being removed */
+            worker->keepalive.lane_map = 0;
+        }
+
+        ucs_list_del(&ep_ext->keepalive.list);
+        ucs_list_head_init(&ep_ext->keepalive.list);
+    }
+
+    if (ucs_twheel_is_empty(&worker->keepalive.wheel) &&
+        ucs_list_is_empty(&worker->keepalive.due_eps)) {
+        ucs_trace("worker %p: keepalive ep list is empty - disabling", worker);
+        uct_worker_progress_unregister_safe(worker->uct,
+                                            &worker->keepalive.cb_id);
     }
 }
 
@@ -14,6 +14,7 @@
 #include "ucp_rkey.h"
 
 #include <ucp/core/ucp_am.h>
+#include <ucp/proto/proto_trace.h>
 #include <ucp/tag/tag_match.h>
 #include <ucs/datastruct/mpool.h>
 #include <ucs/datastruct/queue_types.h>
@@ -21,6 +22,7 @@
 #include <ucs/datastruct/conn_match.h>
 #include <ucs/datastruct/ptr_map.h>
 #include <ucs/arch/bitops.h>
+#include <ucs/stats/counters.h>
 
 
 /* The size of the private buffer in UCT descriptor headroom, which UCP may
@@ -159,11 +161,47 @@ enum {
 };
 
 
+/**
+ * UCP worker always-on counters, published as VFS files
+ */
+enum {
+    /* Tag send operations and bytes, by protocol */
+    UCP_WORKER_COUNTER_TAG_TX_EAGER,
+    UCP_WORKER_COUNTER_TAG_TX_EAGER_SYNC,
+    UCP_WORKER_COUNTER_TAG_TX_RNDV,
+    UCP_WORKER_COUNTER_TAG_TX_EAGER_BYTES,
+    UCP_WORKER_COUNTER_TAG_TX_EAGER_SYNC_BYTES,
+    UCP_WORKER_COUNTER_TAG_TX_RNDV_BYTES,
+
+    /* Tag receive messages, by protocol */
+    UCP_WORKER_COUNTER_TAG_RX_EAGER,
+    UCP_WORKER_COUNTER_TAG_RX_EAGER_SYNC,
+    UCP_WORKER_COUNTER_TAG_RX_RNDV,
+
+    /* Send requests added to a transport pending queue */
+    UCP_WORKER_COUNTER_TX_PENDING,
+
+    /* Gauge: current number of descriptors on the unexpected tag queue */
+    UCP_WORKER_COUNTER_TAG_UNEXP_DEPTH,
+
+    UCP_WORKER_COUNTER_LAST
+};
+
+
+#define UCP_WORKER_COUNTER_ADD(_worker, _name, _value) \
+    ucs_counters_add(&(_worker)->counters, UCP_WORKER_COUNTER_##_name, _value)
+
 #define UCP_WORKER_STAT_EAGER_MSG(_worker, _flags) \
-    UCS_STATS_UPDATE_COUNTER((_worker)->stats, \
-                             ((_flags) & UCP_RECV_DESC_FLAG_EAGER_SYNC) ? \
-                             UCP_WORKER_STAT_TAG_RX_EAGER_SYNC_MSG : \
-                             UCP_WORKER_STAT_TAG_RX_EAGER_MSG, 1);
+    { \
+        UCS_STATS_UPDATE_COUNTER((_worker)->stats, \
+                                 ((_flags) & UCP_RECV_DESC_FLAG_EAGER_SYNC) ? \
+                                 UCP_WORKER_STAT_TAG_RX_EAGER_SYNC_MSG : \
+                                 UCP_WORKER_STAT_TAG_RX_EAGER_MSG, 1); \
+        ucs_counters_add(&(_worker)->counters, \
+                         ((_flags) & UCP_RECV_DESC_FLAG_EAGER_SYNC) ? \
+                         UCP_WORKER_COUNTER_TAG_RX_EAGER_SYNC : \
+                         UCP_WORKER_COUNTER_TAG_RX_EAGER, 1); \
+    }
 
 #define UCP_WORKER_STAT_EAGER_CHUNK(_worker, _is_exp) \
     UCS_STATS_UPDATE_COUNTER((_worker)->stats, \
@@ -187,16 +225,33 @@ enum {
     })
 
 
+/* Hash map to find ep config index by ep config key, which points to the key
+ * stored in the ep config array */
+KHASH_TYPE(ucp_worker_ep_config, const ucp_ep_config_key_t*,
+           ucp_worker_cfg_index_t);
+typedef khash_t(ucp_worker_ep_config) ucp_worker_ep_config_hash_t;
+
+
 /* Hash map to find rkey config index by rkey config key, for fast rkey unpack */
 KHASH_TYPE(ucp_worker_rkey_config, ucp_rkey_config_key_t, ucp_worker_cfg_index_t);
 typedef khash_t(ucp_worker_rkey_config) ucp_worker_rkey_config_hash_t;
 
 
+/* Set of cached remote keys, by packed buffer and endpoint configuration */
+KHASH_TYPE(ucp_worker_rkey_cache, ucp_rkey_cache_entry_t*, char);
+typedef khash_t(ucp_worker_rkey_cache) ucp_worker_rkey_cache_hash_t;
+
+
 /* Hash map of UCT EPs that are being discarded on UCP Worker */
 KHASH_TYPE(ucp_worker_discard_uct_ep_hash, uct_ep_h, ucp_request_t*);
 typedef khash_t(ucp_worker_discard_uct_ep_hash) ucp_worker_discard_uct_ep_hash_t;
 
 
+/* Hash map of decoded worker address profiles, by profile key */
+KHASH_TYPE(ucp_worker_addr_profile, uint64_t, ucp_address_profile_t*);
+typedef khash_t(ucp_worker_addr_profile) ucp_worker_addr_profile_hash_t;
+
+
 /**
  * UCP worker iface, which encapsulates UCT iface, its attributes and
  * some auxiliary info needed for tag matching offloads.
@@ -247,6 +302,10 @@ typedef struct ucp_worker {
     char                             address_name[UCP_WORKER_ADDRESS_NAME_MAX];
 
     unsigned                         flush_ops_count;     /* Number of pending operations */
+    unsigned                         flush_worker_count;  /* Number of worker flush requests
+                                                             in progress */
+    uint16_t                         fence_sn;            /* Number of fences, operations
+                                                             are not aggregated across them */
 
     int                              event_fd;            /* Allocated (on-demand) event fd for wakeup */
     ucs_sys_event_set_t              *event_set;          /* Allocated UCS event set for wakeup */
@@ -258,6 +317,11 @@ typedef struct ucp_worker {
     ucs_strided_alloc_t              ep_alloc;            /* Endpoint allocator */
     ucs_list_link_t                  stream_ready_eps;    /* List of EPs with received stream data */
     ucs_list_link_t                  all_eps;             /* List of all endpoints */
+    ucs_list_link_t                  dirty_eps;           /* List of endpoints which may have
+                                                             RMA/AMO operations to flush */
+    ucs_list_link_t                  proto_tune_samples;  /* Protocol thresholds with an
+                                                             in-flight adaptive sample */
+    ucp_proto_trace_t                proto_trace;         /* Sampled protocol selections */
     ucs_conn_match_ctx_t             conn_match_ctx;      /* Endpoint-to-endpoint matching context */
     ucp_worker_iface_t               **ifaces;            /* Array of pointers to interfaces,
                                                              one for each resource */
@@ -278,12 +342,19 @@ typedef struct ucp_worker {
 
     UCS_STATS_NODE_DECLARE(stats)
     UCS_STATS_NODE_DECLARE(tm_offload_stats)
+    ucs_counters_t                   counters;            /* Always-on counters */
 
     ucs_cpu_set_t                    cpu_mask;            /* Save CPU mask for subsequent calls to
                                                              ucp_worker_listen */
 
+    ucp_worker_ep_config_hash_t      ep_config_hash;      /* EP config key -> index */
     ucp_worker_rkey_config_hash_t    rkey_config_hash;    /* RKEY config key -> index */
     ucp_worker_discard_uct_ep_hash_t discard_uct_ep_hash; /* Hash of discarded UCT EPs */
+    ucp_worker_addr_profile_hash_t   addr_profile_hash;   /* Decoded address profiles */
+    struct {
+        ucp_worker_rkey_cache_hash_t hash;                /* Cached remote keys */
+        ucs_list_link_t              lru;                 /* Most recently used first */
+    } rkey_cache;
     ucs_ptr_map_t                    ptr_map;             /* UCP objects key to ptr mapping */
 
     unsigned                         ep_config_count;     /* Current number of ep configurations */
@@ -294,13 +365,18 @@ typedef struct ucp_worker {
 
     struct {
         uct_worker_cb_id_t           cb_id;               /* Keepalive callback id */
-        ucs_time_t                   last_round;          /* Last round timespamp */
-        ucs_list_link_t              *iter;               /* Last EP processed keepalive */
+        ucs_twheel_t                 wheel;               /* Per-EP keepalive deadlines */
+        ucs_list_link_t              due_eps;             /* EPs whose deadline has expired */
         ucp_lane_map_t               lane_map;            /* Lane map used to retry after no-resources */
-        unsigned                     ep_count;            /* Number of EPs processed in current time slot */
         unsigned                     iter_count;          /* Number of progress iterations to skip,
                                                            * used to minimize call of ucs_get_time */
     } keepalive;
+
+    struct {
+        size_t                       quantum;             /* Deficit round-robin quantum */
+        unsigned                     num_eps;             /* EPs with fragmented sends
+                                                           * in pending queues */
+    } tx_sched;
 } ucp_worker_t;
 
 
@@ -321,6 +397,9 @@ ucs_status_t
 ucp_worker_add_rkey_config(ucp_worker_h worker, const ucp_rkey_config_key_t *key,
                            ucp_worker_cfg_index_t *cfg_index_p);
 
+void ucp_worker_address_tl_bitmap(ucp_worker_h worker, unsigned address_flags,
+                                  ucp_tl_bitmap_t *tl_bitmap);
+
 ucs_status_t ucp_worker_iface_open(ucp_worker_h worker, ucp_rsc_index_t tl_id,
                                    uct_iface_params_t *iface_params,
                                    ucp_worker_iface_t **wiface);
@@ -16,8 +16,9 @@
 static UCS_F_ALWAYS_INLINE khint_t
 ucp_worker_rkey_config_hash_func(ucp_rkey_config_key_t rkey_config_key)
 {
-    return (khint_t)rkey_config_key.md_map ^ rkey_config_key.ep_cfg_index ^
-           (rkey_config_key.mem_type << 16);
+    return kh_int64_hash_func(rkey_config_key.md_map ^
+                              ((uint64_t)rkey_config_key.ep_cfg_index << 40) ^
+                              ((uint64_t)rkey_config_key.mem_type << 48));
 }
 
 static UCS_F_ALWAYS_INLINE int
@@ -193,14 +194,37 @@ static UCS_F_ALWAYS_INLINE ucs_status_t
 ucp_worker_get_rkey_config(ucp_worker_h worker, const ucp_rkey_config_key_t *key,
                            ucp_worker_cfg_index_t *cfg_index_p)
 {
-    khiter_t khiter = kh_get(ucp_worker_rkey_config, &worker->rkey_config_hash,
-                             *key);
+    ucp_ep_config_t *ep_config = &worker->ep_config[key->ep_cfg_index];
+    ucs_status_t status;
+    khiter_t khiter;
+
+    /* Protocol selection may resolve rkey configurations while the ep
+     * configuration is created, before it is counted in ep_config_count */
+    ucs_assert(key->ep_cfg_index <= worker->ep_config_count);
+
+    /* Most remote keys unpacked on an endpoint configuration are the same */
+    if (ucs_likely((ep_config->rkey_cfg_cache.cfg_index !=
+                    UCP_WORKER_CFG_INDEX_NULL) &&
+                   (ep_config->rkey_cfg_cache.md_map == key->md_map) &&
+                   (ep_config->rkey_cfg_cache.mem_type == key->mem_type))) {
+        *cfg_index_p = ep_config->rkey_cfg_cache.cfg_index;
+        return UCS_OK;
+    }
+
+    khiter = kh_get(ucp_worker_rkey_config, &worker->rkey_config_hash, *key);
     if (ucs_likely(khiter != kh_end(&worker->rkey_config_hash))) {
         *cfg_index_p = kh_val(&worker->rkey_config_hash, khiter);
-        return UCS_OK;
+    } else {
+        status = ucp_worker_add_rkey_config(worker, key, cfg_index_p);
+        if (status != UCS_OK) {
+            return status;
+        }
     }
 
-    return ucp_worker_add_rkey_config(worker, key, cfg_index_p);
+    ep_config->rkey_cfg_cache.md_map    = key->md_map;
+    ep_config->rkey_cfg_cache.mem_type  = key->mem_type;
+    ep_config->rkey_cfg_cache.cfg_index = *cfg_index_p;
+    return UCS_OK;
 }
 
 #define UCP_WORKER_GET_EP_BY_ID(_ep_p, _worker, _ep_id, _action, _fmt_str, ...) \
@@ -213,6 +237,8 @@ ucp_worker_get_rkey_config(ucp_worker_h worker, const ucp_rkey_config_key_t *key
                            " was not found, drop" _fmt_str, \
                            _worker, _ep_id, ##__VA_ARGS__); \
             _action; \
+        } else { \
+            ucp_ep_keepalive_rx(_worker, *(_ep_p)); \
         } \
     }
 
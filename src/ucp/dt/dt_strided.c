@@ -0,0 +1,229 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "dt_generic.h"
+
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
+#include <ucs/sys/math.h>
+#include <string.h>
+
+
+/*
+ * Strided datatype, implemented as a generic datatype with built-in pack and
+ * unpack routines. The generic datatype descriptor must be the first field, so
+ * the datatype is released by ucp_dt_destroy() like any other generic one.
+ */
+typedef struct ucp_dt_strided {
+    ucp_dt_generic_t super;
+    size_t           block_count;  /* Number of blocks in an element */
+    size_t           block_length; /* Size of every block, in bytes */
+    size_t           stride;       /* Distance between block starts */
+    size_t           extent;       /* Distance between element starts */
+} ucp_dt_strided_t;
+
+
+typedef struct ucp_dt_strided_state {
+    const ucp_dt_strided_t *dt;
+    void                   *buffer;
+    size_t                 count;
+} ucp_dt_strided_state_t;
+
+
+/* Copy a single block; fixed sizes are expanded to direct vector moves */
+static UCS_F_ALWAYS_INLINE void
+ucp_dt_strided_copy_block(void *dst, const void *src, size_t length)
+{
+    switch (length) {
+    case 4:
+        memcpy(dst, src, 4);
+        break;
+    case 8:
+        memcpy(dst, src, 8);
+        break;
+    case 16:
+        memcpy(dst, src, 16);
+        break;
+    case 32:
+        memcpy(dst, src, 32);
+        break;
+    default:
+        memcpy(dst, src, length);
+        break;
+    }
+}
+
+/*
+ * Copy 'length' bytes starting at packed 'offset' between the strided buffer
+ * and a contiguous 'packed' buffer, in the direction given by 'is_pack'.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucp_dt_strided_copy(const ucp_dt_strided_state_t *state, size_t offset,
+                    void *packed, size_t length, int is_pack)
+{
+    const ucp_dt_strided_t *dt = state->dt;
+    size_t block_length        = dt->block_length;
+    size_t block_index         = offset / block_length;
+    size_t block_offset        = offset % block_length;
+    size_t elem_block          = block_index % dt->block_count;
+    size_t copy_length;
+    void *elem_ptr, *ptr;
+
+    elem_ptr = UCS_PTR_BYTE_OFFSET(state->buffer,
+                                   (block_index / dt->block_count) *
+                                   dt->extent);
+    ptr      = UCS_PTR_BYTE_OFFSET(elem_ptr, elem_block * dt->stride);
+
+    /* Partial first block */
+    if (block_offset != 0) {
+        copy_length = ucs_min(block_length - block_offset, length);
+        if (is_pack) {
+            memcpy(packed, UCS_PTR_BYTE_OFFSET(ptr, block_offset), copy_length);
+        } else {
+            memcpy(UCS_PTR_BYTE_OFFSET(ptr, block_offset), packed, copy_length);
+        }
+        packed  = UCS_PTR_BYTE_OFFSET(packed, copy_length);
+        length -= copy_length;
+        goto next_block;
+    }
+
+    while (length >= block_length) {
+        if (is_pack) {
+            ucp_dt_strided_copy_block(packed, ptr, block_length);
+        } else {
+            ucp_dt_strided_copy_block(ptr, packed, block_length);
+        }
+        packed  = UCS_PTR_BYTE_OFFSET(packed, block_length);
+        length -= block_length;
+next_block:
+        if (++elem_block == dt->block_count) {
+            elem_block = 0;
+            elem_ptr   = UCS_PTR_BYTE_OFFSET(elem_ptr, dt->extent);
+            ptr        = elem_ptr;
+        } else {
+            ptr        = UCS_PTR_BYTE_OFFSET(ptr, dt->stride);
+        }
+    }
+
+    /* Partial last block */
+    if (length > 0) {
+        if (is_pack) {
+            memcpy(packed, ptr, length);
+        } else {
+            memcpy(ptr, packed, length);
+        }
+    }
+}
+
+static void *ucp_dt_strided_start(void *context, void *buffer, size_t count)
+{
+    ucp_dt_strided_state_t *state;
+
+    state = ucs_malloc(sizeof(*state), "strided_dt_state");
+    if (state == NULL) {
+        ucs_error("failed to allocate strided datatype state");
+        return NULL;
+    }
+
+    state->dt     = context;
+    state->buffer = buffer;
+    state->count  = count;
+    return state;
+}
+
+static void *ucp_dt_strided_start_pack(void *context, const void *buffer,
+                                       size_t count)
+{
+    return ucp_dt_strided_start(context, (void*)buffer, count);
+}
+
+static void *ucp_dt_strided_start_unpack(void *context, void *buffer,
+                                         size_t count)
+{
+    return ucp_dt_strided_start(context, buffer, count);
+}
+
+static size_t ucp_dt_strided_packed_size(void *state)
+{
+    ucp_dt_strided_state_t *dt_state = state;
+
+    return dt_state->count * dt_state->dt->block_count *
+           dt_state->dt->block_length;
+}
+
+static size_t ucp_dt_strided_pack(void *state, size_t offset, void *dest,
+                                  size_t max_length)
+{
+    size_t length = ucs_min(ucp_dt_strided_packed_size(state) - offset,
+                            max_length);
+
+    ucp_dt_strided_copy(state, offset, dest, length, 1);
+    return length;
+}
+
+static ucs_status_t ucp_dt_strided_unpack(void *state, size_t offset,
+                                          const void *src, size_t length)
+{
+    if ((offset + length) > ucp_dt_strided_packed_size(state)) {
+        return UCS_ERR_MESSAGE_TRUNCATED;
+    }
+
+    ucp_dt_strided_copy(state, offset, (void*)src, length, 0);
+    return UCS_OK;
+}
+
+static void ucp_dt_strided_finish(void *state)
+{
+    ucs_free(state);
+}
+
+static const ucp_generic_dt_ops_t ucp_dt_strided_ops = {
+    .start_pack   = ucp_dt_strided_start_pack,
+    .start_unpack = ucp_dt_strided_start_unpack,
+    .packed_size  = ucp_dt_strided_packed_size,
+    .pack         = ucp_dt_strided_pack,
+    .unpack       = ucp_dt_strided_unpack,
+    .finish       = ucp_dt_strided_finish
+};
+
+ucs_status_t ucp_dt_create_strided(size_t block_count, size_t block_length,
+                                   size_t stride, ucp_datatype_t *datatype_p)
+{
+    ucp_dt_strided_t *dt;
+    int ret;
+
+    if ((block_count == 0) || (block_length == 0) || (stride < block_length)) {
+        ucs_error("invalid strided datatype: block_count %zu block_length %zu"
+                  " stride %zu", block_count, block_length, stride);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    /* Dense layout is contiguous, and can use zero-copy protocols */
+    if ((stride == block_length) || (block_count == 1)) {
+        *datatype_p = ucp_dt_make_contig(block_count * block_length);
+        return UCS_OK;
+    }
+
+    ret = ucs_posix_memalign((void**)&dt,
+                             ucs_max(sizeof(void*), UCS_BIT(UCP_DATATYPE_SHIFT)),
+                             sizeof(*dt), "strided_dt");
+    if (ret != 0) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    dt->super.ops     = ucp_dt_strided_ops;
+    dt->super.context = dt;
+    dt->block_count   = block_count;
+    dt->block_length  = block_length;
+    dt->stride        = stride;
+    dt->extent        = ((block_count - 1) * stride) + block_length;
+    *datatype_p       = ucp_dt_from_generic(&dt->super);
+    return UCS_OK;
+}
@@ -88,6 +88,7 @@ typedef struct {
     ucp_proto_select_param_t select_param; /* Copy of protocol selection parameters,
                                               used to re-select protocol for existing
                                               in-progress request */
+    ucp_lane_map_t           lane_map;     /* Lanes used by the protocol */
 } ucp_proto_config_t;
 
 
@@ -108,6 +109,8 @@ typedef struct {
     size_t                  cfg_thresh;   /* Configured protocol threshold */
     unsigned                cfg_priority; /* Priority of configuration */
     size_t                  min_length;   /* Minimal message size */
+    ucp_lane_map_t          lane_map;     /* Lanes used by the protocol, for
+                                             diagnostics */
     unsigned                num_ranges;   /* Number of entries in 'ranges' */
 
     /* Performance estimation function for different message sizes */
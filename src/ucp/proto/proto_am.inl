@@ -75,6 +75,10 @@ ucs_status_t ucp_do_am_bcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
     uct_ep_h uct_ep;
     int pending_add_res;
 
+    if (ucp_request_tx_sched_yield(req)) {
+        return UCS_INPROGRESS;
+    }
+
     req->send.lane = (!enable_am_bw || (state.offset == 0)) ? /* first part of message must be sent */
                      ucp_ep_get_am_lane(ep) :                 /* via AM lane */
                      ucp_send_request_get_am_bw_lane(req);
@@ -107,9 +111,11 @@ ucs_status_t ucp_do_am_bcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
                     continue;
                 }
                 return (ucs_status_t)UCP_STATUS_PENDING_SWITCH;
-            } else {
-                return (ucs_status_t)packed_len;
+            } else if (packed_len != UCS_ERR_NO_RESOURCE) {
+                ucp_request_tx_sched_update(req, 0, 1);
             }
+
+            return (ucs_status_t)packed_len;
         } else {
             ucs_assertv(/* The packed length has to be the same as maximum
                          * AM Bcopy for the first and middle segments */
@@ -129,6 +135,9 @@ ucs_status_t ucp_do_am_bcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
             if (enable_am_bw) {
                 ucp_send_request_next_am_bw_lane(req);
             }
+            ucp_request_tx_sched_update(req, packed_len,
+                                        req->send.state.dt.offset ==
+                                        req->send.length);
             return ((req->send.state.dt.offset < req->send.length) ?
                     UCS_INPROGRESS : UCS_OK);
         }
@@ -350,6 +359,10 @@ ucs_status_t ucp_do_am_zcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
     uct_ep_h uct_ep;
     int pending_add_res;
 
+    if (ucp_request_tx_sched_yield(req)) {
+        return UCS_INPROGRESS;
+    }
+
     if (enable_am_bw && (req->send.state.dt.offset != 0)) {
         req->send.lane = ucp_send_request_get_am_bw_lane(req);
     } else {
@@ -412,6 +425,7 @@ ucs_status_t ucp_do_am_zcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
                                          &req->send.state.uct_comp);
             } else if (state.offset == req->send.length) {
                 /* Empty IOVs on last stage */
+                ucp_request_tx_sched_update(req, 0, 1);
                 ucp_am_zcopy_complete_last_stage(req, &state, complete);
                 return UCS_OK;
             } else {
@@ -429,6 +443,7 @@ ucs_status_t ucp_do_am_zcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
             if (!flag_iov_mid && (offset + mid_len == req->send.length)) {
                 /* Last stage */
                 if (status == UCS_OK) {
+                    ucp_request_tx_sched_update(req, mid_len, 1);
                     ucp_am_zcopy_complete_last_stage(req, &state, complete);
                     return UCS_OK;
                 }
@@ -437,6 +452,7 @@ ucs_status_t ucp_do_am_zcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
                                                UCP_REQUEST_SEND_PROTO_ZCOPY_AM,
                                                status);
                 if (!UCS_STATUS_IS_ERR(status)) {
+                    ucp_request_tx_sched_update(req, mid_len, 1);
                     if (enable_am_bw) {
                         ucp_send_request_next_am_bw_lane(req);
                     }
@@ -463,11 +479,13 @@ ucs_status_t ucp_do_am_zcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
                                        UCP_REQUEST_SEND_PROTO_ZCOPY_AM,
                                        status);
         if (UCS_STATUS_IS_ERR(status)) {
+            ucp_request_tx_sched_update(req, 0, 1);
             if (req->send.state.uct_comp.count == 0) {
                complete(req, status);
             }
             return UCS_OK;
         } else {
+            ucp_request_tx_sched_update(req, state.offset - offset, 0);
             if (enable_am_bw) {
                 ucp_send_request_next_am_bw_lane(req);
             }
@@ -503,6 +503,7 @@ void ucp_proto_common_calc_perf(const ucp_proto_common_init_params_t *params,
     caps->cfg_priority = params->cfg_priority;
     caps->num_ranges   = 0;
     caps->min_length   = 0;
+    caps->lane_map     = perf_params->lane_map;
 
     /* Collect latency and overhead from all lanes */
     overhead = 0;
@@ -110,8 +110,16 @@ ucp_proto_request_set_proto(ucp_worker_h worker, ucp_ep_h ep,
     const ucp_proto_t *proto;
     ucs_string_buffer_t strb;
 
-    thresh_elem = ucp_proto_select_lookup(worker, proto_select, ep->cfg_index,
-                                          rkey_cfg_index, sel_param, msg_length);
+    if (ucs_unlikely(worker->context->config.ext.proto_adaptive)) {
+        thresh_elem = ucp_proto_select_tune_lookup(worker, proto_select,
+                                                   ep->cfg_index,
+                                                   rkey_cfg_index, sel_param,
+                                                   msg_length, req);
+    } else {
+        thresh_elem = ucp_proto_select_lookup(worker, proto_select,
+                                              ep->cfg_index, rkey_cfg_index,
+                                              sel_param, msg_length);
+    }
     if (UCS_ENABLE_ASSERT && (thresh_elem == NULL)) {
         /* We expect that a protocol will always be found, or we will fallback
            to 'reconfig' placeholder */
@@ -128,6 +136,14 @@ ucp_proto_request_set_proto(ucp_worker_h worker, ucp_ep_h ep,
     req->send.proto_config = &thresh_elem->proto_config;
     req->send.uct.func     = proto->progress;
 
+    /* A traced request keeps its original record if it switches to another
+     * protocol stage */
+    if (ucs_unlikely(worker->proto_trace.enable) &&
+        !(req->flags & UCP_REQUEST_FLAG_PROTO_TRACE) &&
+        (++worker->proto_trace.counter >= worker->proto_trace.rate)) {
+        ucp_proto_trace_sample(worker, req, msg_length);
+    }
+
     if (ucs_log_is_enabled(UCS_LOG_LEVEL_TRACE_REQ)) {
         ucs_string_buffer_init(&strb);
         ucp_proto_select_param_str(sel_param, &strb);
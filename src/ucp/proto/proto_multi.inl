@@ -24,6 +24,7 @@ static UCS_F_ALWAYS_INLINE void
 ucp_proto_multi_request_init(ucp_request_t *req)
 {
     req->send.multi_lane_idx = 0;
+    req->send.pending_lane   = UCP_NULL_LANE;
     ucp_proto_multi_set_send_lane(req);
 }
 
@@ -112,12 +113,17 @@ ucp_proto_multi_progress(ucp_request_t *req,
     ucp_datatype_iter_t next_iter;
     ucp_lane_index_t lane_idx;
     ucs_status_t status;
+    size_t length;
 
     ucs_assertv(req->send.multi_lane_idx < mpriv->num_lanes,
                 "lane_idx=%d num_lanes=%d", req->send.multi_lane_idx,
                 mpriv->num_lanes);
     ucs_assert(!ucp_datatype_iter_is_end(&req->send.state.dt_iter));
 
+    if (ucp_request_tx_sched_yield(req)) {
+        return UCS_INPROGRESS;
+    }
+
     lane_idx = req->send.multi_lane_idx;
     lpriv    = &mpriv->lanes[lane_idx];
 
@@ -132,17 +138,22 @@ ucp_proto_multi_progress(ucp_request_t *req,
         return ucp_proto_multi_no_resource(req, lpriv);
     } else {
         /* failed to send - call common error handler */
+        ucp_request_tx_sched_update(req, 0, 1);
         ucp_proto_request_abort(req, status);
         return UCS_OK;
     }
 
     /* advance position in send buffer */
+    length = next_iter.offset - req->send.state.dt_iter.offset;
     ucp_datatype_iter_copy_from_next(&req->send.state.dt_iter, &next_iter,
                                      dt_mask);
     if (ucp_datatype_iter_is_end(&req->send.state.dt_iter)) {
+        ucp_request_tx_sched_update(req, length, 1);
         return complete_func(req);
     }
 
+    ucp_request_tx_sched_update(req, length, 0);
+
     /* move to the next lane, in a round-robin fashion */
     lane_idx = req->send.multi_lane_idx + 1;
     if (lane_idx >= mpriv->num_lanes) {
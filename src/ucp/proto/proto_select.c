@@ -13,8 +13,10 @@
 #include "proto_single.h"
 
 #include <ucp/core/ucp_context.h>
+#include <ucp/core/ucp_request.h>
 #include <ucp/core/ucp_worker.h>
 #include <ucp/dt/dt.h>
+#include <ucs/time/time.h>
 #include <float.h>
 
 #include <ucs/datastruct/array.inl>
@@ -26,6 +28,19 @@
 #define UCP_PROTO_MSGLEN_EPSILON   0.5
 
 
+/* An adaptive threshold may move by up to this factor in either direction */
+#define UCP_PROTO_SELECT_TUNE_RANGE     4
+
+/* Drop an in-flight sample which did not complete in this time, in seconds */
+#define UCP_PROTO_SELECT_TUNE_TIMEOUT   1.0
+
+/* Protocols which are also used by the fast-path short send, bypassing the
+ * thresholds array */
+#define UCP_PROTO_SELECT_TUNE_SKIP_FLAGS \
+    (UCP_PROTO_FLAG_AM_SHORT | UCP_PROTO_FLAG_PUT_SHORT | \
+     UCP_PROTO_FLAG_TAG_SHORT | UCP_PROTO_FLAG_INVALID)
+
+
 /* Parameters structure for initializing protocols for a selection parameter */
 typedef struct {
     const ucp_proto_select_param_t *select_param; /* Protocol selection parameter */
@@ -396,6 +411,7 @@ ucp_proto_select_init_protocols(ucp_worker_h worker,
     offset = 0;
     for (proto_id = 0; proto_id < ucp_protocols_count; ++proto_id) {
         proto_caps            = &proto_init->caps[proto_id];
+        proto_caps->lane_map  = 0;
         init_params.priv      = UCS_PTR_BYTE_OFFSET(proto_init->priv_buf,
                                                           offset);
         init_params.priv_size  = &priv_size;
@@ -549,6 +565,7 @@ static ucs_status_t ucp_proto_select_elem_init_thresh(
         proto_config->proto          = ucp_protocols[proto_id];
         proto_config->priv           = UCS_PTR_BYTE_OFFSET(select_elem->priv_buf,
                                                            priv_offset);
+        proto_config->lane_map       = proto_init->caps[proto_id].lane_map;
         ++i;
     }
 
@@ -579,6 +596,168 @@ err:
     return status;
 }
 
+/*
+ * Check whether a protocol may be moved across a threshold, which was not
+ * placed there by user configuration
+ */
+static int
+ucp_proto_select_tune_is_adaptive(const ucp_proto_select_init_protocols_t *proto_init,
+                                  ucp_proto_id_t proto_id, size_t thresh)
+{
+    size_t cfg_thresh = proto_init->caps[proto_id].cfg_thresh;
+
+    return (cfg_thresh != UCS_MEMUNITS_INF) && (cfg_thresh != (thresh + 1)) &&
+           !(ucp_proto_id_field(proto_id, flags) &
+             UCP_PROTO_SELECT_TUNE_SKIP_FLAGS);
+}
+
+static size_t
+ucp_proto_select_tune_max_length(const ucp_proto_select_init_protocols_t *proto_init,
+                                 ucp_proto_id_t proto_id)
+{
+    const ucp_proto_caps_t *caps = &proto_init->caps[proto_id];
+
+    return caps->ranges[caps->num_ranges - 1].max_length;
+}
+
+static ucp_proto_id_t
+ucp_proto_select_tune_proto_id(const ucp_proto_threshold_elem_t *thresh_elem)
+{
+    ucp_proto_id_t proto_id;
+
+    for (proto_id = 0; proto_id < ucp_protocols_count; ++proto_id) {
+        if (ucp_protocols[proto_id] == thresh_elem->proto_config.proto) {
+            break;
+        }
+    }
+
+    return proto_id;
+}
+
+/*
+ * Find the message size window around the threshold between thresholds[index]
+ * and thresholds[index + 1], which both protocols can handle. The window does
+ * not overlap the windows of neighbor thresholds.
+ */
+static int
+ucp_proto_select_tune_window(const ucp_proto_select_init_protocols_t *proto_init,
+                             const ucp_proto_threshold_elem_t *thresholds,
+                             unsigned index, size_t *min_length_p,
+                             size_t *max_length_p)
+{
+    size_t thresh = thresholds[index].max_msg_length;
+    ucp_proto_id_t below_id, above_id;
+    size_t range_start, range_end;
+    size_t min_length, max_length;
+
+    below_id = ucp_proto_select_tune_proto_id(&thresholds[index]);
+    above_id = ucp_proto_select_tune_proto_id(&thresholds[index + 1]);
+    if ((below_id == ucp_protocols_count) ||
+        (above_id == ucp_protocols_count) ||
+        !ucp_proto_select_tune_is_adaptive(proto_init, below_id, thresh) ||
+        !ucp_proto_select_tune_is_adaptive(proto_init, above_id, thresh) ||
+        (thresh > (SIZE_MAX / UCP_PROTO_SELECT_TUNE_RANGE))) {
+        return 0;
+    }
+
+    range_start = (index == 0) ? 0 : (thresholds[index - 1].max_msg_length + 1);
+    range_end   = thresholds[index + 1].max_msg_length;
+
+    min_length  = ucs_max(thresh / UCP_PROTO_SELECT_TUNE_RANGE,
+                          range_start + ((thresh - range_start) / 2) + 1);
+    min_length  = ucs_max(min_length, proto_init->caps[above_id].min_length);
+    max_length  = ucs_min(thresh * UCP_PROTO_SELECT_TUNE_RANGE,
+                          thresh + ((range_end - thresh) / 2));
+    max_length  = ucs_min(max_length,
+                          ucp_proto_select_tune_max_length(proto_init,
+                                                           below_id));
+
+    if ((min_length > (thresh + 1)) || (max_length < thresh) ||
+        (min_length >= max_length)) {
+        return 0;
+    }
+
+    *min_length_p = min_length;
+    *max_length_p = max_length;
+    return 1;
+}
+
+static ucs_status_t
+ucp_proto_select_elem_init_tune(ucp_worker_h worker,
+                                ucp_proto_select_elem_t *select_elem,
+                                const ucp_proto_select_init_protocols_t *proto_init)
+{
+    const ucp_proto_threshold_elem_t *thresholds = select_elem->thresholds;
+    ucp_proto_select_tune_bound_t *bound;
+    size_t min_length, max_length;
+    ucp_proto_select_tune_t *tune;
+    unsigned i, num_thresholds;
+
+    select_elem->tune = NULL;
+    if (!worker->context->config.ext.proto_adaptive) {
+        return UCS_OK;
+    }
+
+    for (num_thresholds = 1;
+         thresholds[num_thresholds - 1].max_msg_length != SIZE_MAX;
+         ++num_thresholds);
+
+    tune = ucs_calloc(1, sizeof(*tune) +
+                         (sizeof(*tune->bounds) * num_thresholds),
+                      "ucp_proto_select_tune");
+    if (tune == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    tune->num_bounds = 0;
+    for (i = 0; (i + 1) < num_thresholds; ++i) {
+        if (!ucp_proto_select_tune_window(proto_init, thresholds, i,
+                                          &min_length, &max_length)) {
+            continue;
+        }
+
+        bound               = &tune->bounds[tune->num_bounds++];
+        bound->thresholds   = (ucp_proto_threshold_elem_t*)thresholds;
+        bound->thresh_index = i;
+        bound->min_length   = min_length;
+        bound->max_length   = max_length;
+        bound->num_buckets  = ucs_min(ucs_ilog2(max_length) -
+                                      ucs_ilog2(min_length) + 1,
+                                      UCP_PROTO_SELECT_TUNE_MAX_BUCKETS);
+        bound->sample_req   = NULL;
+        ucs_trace("adaptive threshold %zu between %s and %s, window %zu..%zu",
+                  thresholds[i].max_msg_length,
+                  thresholds[i].proto_config.proto->name,
+                  thresholds[i + 1].proto_config.proto->name, min_length,
+                  max_length);
+    }
+
+    if (tune->num_bounds == 0) {
+        ucs_free(tune);
+        return UCS_OK;
+    }
+
+    select_elem->tune = tune;
+    return UCS_OK;
+}
+
+static void ucp_proto_select_elem_cleanup_tune(ucp_proto_select_tune_t *tune)
+{
+    unsigned i;
+
+    if (tune == NULL) {
+        return;
+    }
+
+    for (i = 0; i < tune->num_bounds; ++i) {
+        if (tune->bounds[i].sample_req != NULL) {
+            ucs_list_del(&tune->bounds[i].list);
+        }
+    }
+
+    ucs_free(tune);
+}
+
 static ucs_status_t
 ucp_proto_select_elem_init(ucp_worker_h worker,
                            ucp_worker_cfg_index_t ep_cfg_index,
@@ -621,9 +800,17 @@ ucp_proto_select_elem_init(ucp_worker_h worker,
         goto err_cleanup_protocols;
     }
 
+    status = ucp_proto_select_elem_init_tune(worker, select_elem, proto_init);
+    if (status != UCS_OK) {
+        goto err_cleanup_thresh;
+    }
+
     status = UCS_OK;
     goto out_free_proto_init;
 
+err_cleanup_thresh:
+    ucs_free((void*)select_elem->perf_ranges);
+    ucs_free((void*)select_elem->thresholds);
 err_cleanup_protocols:
     ucs_free(proto_init->priv_buf);
 out_free_proto_init:
@@ -636,6 +823,7 @@ out:
 static void
 ucp_proto_select_elem_cleanup(ucp_proto_select_elem_t *select_elem)
 {
+    ucp_proto_select_elem_cleanup_tune(select_elem->tune);
     ucs_free((void*)select_elem->perf_ranges);
     ucs_free((void*)select_elem->thresholds);
     ucs_free(select_elem->priv_buf);
@@ -709,6 +897,188 @@ void ucp_proto_select_cleanup(ucp_proto_select_t *proto_select)
     kh_destroy_inplace(ucp_proto_select_hash, &proto_select->hash);
 }
 
+static ucp_proto_select_tune_bound_t *
+ucp_proto_select_tune_find(ucp_proto_select_tune_t *tune, size_t msg_length)
+{
+    ucp_proto_select_tune_bound_t *bound;
+
+    for (bound = tune->bounds; bound < (tune->bounds + tune->num_bounds);
+         ++bound) {
+        if ((msg_length >= bound->min_length) &&
+            (msg_length <= bound->max_length)) {
+            return bound;
+        }
+    }
+
+    return NULL;
+}
+
+static void
+ucp_proto_select_tune_sample_release(ucp_proto_select_tune_bound_t *bound)
+{
+    ucs_list_del(&bound->list);
+    bound->sample_req = NULL;
+}
+
+const ucp_proto_threshold_elem_t *
+ucp_proto_select_tune_lookup(ucp_worker_h worker,
+                             ucp_proto_select_t *proto_select,
+                             ucp_worker_cfg_index_t ep_cfg_index,
+                             ucp_worker_cfg_index_t rkey_cfg_index,
+                             const ucp_proto_select_param_t *select_param,
+                             size_t msg_length, ucp_request_t *req)
+{
+    ucp_context_h context = worker->context;
+    const ucp_proto_threshold_elem_t *thresh_elem;
+    ucp_proto_select_tune_bound_t *bound;
+    ucp_proto_select_tune_t *tune;
+    ucs_time_t now;
+
+    thresh_elem = ucp_proto_select_lookup(worker, proto_select, ep_cfg_index,
+                                          rkey_cfg_index, select_param,
+                                          msg_length);
+
+    /* A request which is already sampled keeps measuring its original
+     * selection, also if it switches to another protocol stage */
+    if ((thresh_elem == NULL) || (req->flags & UCP_REQUEST_FLAG_PROTO_SAMPLE)) {
+        return thresh_elem;
+    }
+
+    /* The lookup above always sets the cache to the selection element */
+    tune = proto_select->cache.value->tune;
+    if (tune == NULL) {
+        return thresh_elem;
+    }
+
+    bound = ucp_proto_select_tune_find(tune, msg_length);
+    if (bound == NULL) {
+        return thresh_elem;
+    }
+
+    now = ucs_get_time();
+    if (bound->sample_req != NULL) {
+        if (ucs_time_to_sec(now - bound->sample_start) <
+            UCP_PROTO_SELECT_TUNE_TIMEOUT) {
+            return thresh_elem;
+        }
+
+        /* Completion of the previous sample was not reported */
+        ucp_proto_select_tune_sample_release(bound);
+    }
+
+    if (++bound->counter < context->config.ext.proto_adaptive_interval) {
+        return thresh_elem;
+    }
+
+    bound->counter      = 0;
+    bound->sample_side  = bound->next_side;
+    bound->next_side   ^= 1;
+    bound->sample_req   = req;
+    bound->sample_start = now;
+    ucs_list_add_tail(&worker->proto_tune_samples, &bound->list);
+    req->flags         |= UCP_REQUEST_FLAG_PROTO_SAMPLE;
+
+    return &bound->thresholds[bound->thresh_index + bound->sample_side];
+}
+
+static void ucp_proto_select_tune_update(ucp_proto_select_tune_bound_t *bound,
+                                         unsigned num_samples)
+{
+    ucp_proto_threshold_elem_t *thresholds  = bound->thresholds;
+    ucp_proto_threshold_elem_t *thresh_elem = &thresholds[bound->thresh_index];
+    size_t max_msg_length                   = thresh_elem->max_msg_length;
+    size_t base                             = ucs_ilog2(bound->min_length);
+    ucp_proto_select_tune_bucket_t *bucket;
+    size_t bucket_start, bucket_end;
+    double latency[2];
+    unsigned i, side;
+
+    /* Move the threshold to the first size bucket where the protocol above it
+     * is faster, or past all buckets where the protocol below it is faster */
+    for (i = 0; i < bound->num_buckets; ++i) {
+        bucket = &bound->buckets[i];
+        if ((bucket->count[0] < num_samples) ||
+            (bucket->count[1] < num_samples)) {
+            continue;
+        }
+
+        for (side = 0; side < 2; ++side) {
+            latency[side] = bucket->total[side] / bucket->count[side];
+        }
+
+        bucket_start = ucs_max(UCS_BIT(base + i), bound->min_length);
+        bucket_end   = (i == (bound->num_buckets - 1)) ?
+                       bound->max_length :
+                       ucs_min(UCS_BIT(base + i + 1) - 1, bound->max_length);
+        if (latency[1] < latency[0]) {
+            max_msg_length = bucket_start - 1;
+            break;
+        }
+
+        max_msg_length = bucket_end;
+    }
+
+    if (max_msg_length != thresh_elem->max_msg_length) {
+        ucs_debug("adaptive threshold between %s and %s moved from %zu to %zu",
+                  thresh_elem->proto_config.proto->name,
+                  thresholds[bound->thresh_index + 1].proto_config.proto->name,
+                  thresh_elem->max_msg_length, max_msg_length);
+        thresh_elem->max_msg_length = max_msg_length;
+        ++bound->num_updates;
+    }
+
+    /* Let older samples fade out, to follow changes in system behavior */
+    for (i = 0; i < bound->num_buckets; ++i) {
+        for (side = 0; side < 2; ++side) {
+            bound->buckets[i].count[side] /= 2;
+            bound->buckets[i].total[side] /= 2;
+        }
+    }
+}
+
+void ucp_proto_select_tune_complete(ucp_request_t *req, ucs_status_t status)
+{
+    ucp_worker_h worker  = req->send.ep->worker;
+    unsigned num_samples = worker->context->config.ext.proto_adaptive_samples;
+    ucp_proto_select_tune_bound_t *bound;
+    ucp_proto_select_tune_bucket_t *bucket;
+    unsigned bucket_index;
+    size_t msg_length;
+    double latency;
+
+    req->flags &= ~UCP_REQUEST_FLAG_PROTO_SAMPLE;
+
+    ucs_list_for_each(bound, &worker->proto_tune_samples, list) {
+        if (bound->sample_req == req) {
+            goto found;
+        }
+    }
+
+    /* The sample was dropped after a timeout */
+    return;
+
+found:
+    latency = ucs_time_to_sec(ucs_get_time() - bound->sample_start);
+    ucp_proto_select_tune_sample_release(bound);
+    if (status != UCS_OK) {
+        return;
+    }
+
+    msg_length   = req->send.state.dt_iter.length;
+    bucket_index = ucs_ilog2(ucs_max(msg_length, bound->min_length)) -
+                   ucs_ilog2(bound->min_length);
+    bucket       = &bound->buckets[ucs_min(bucket_index,
+                                           bound->num_buckets - 1)];
+    ++bucket->count[bound->sample_side];
+    bucket->total[bound->sample_side] += latency;
+
+    if ((bucket->count[0] < num_samples) || (bucket->count[1] < num_samples)) {
+        return;
+    }
+
+    ucp_proto_select_tune_update(bound, num_samples);
+}
+
 static ucs_status_t
 ucp_proto_select_dump_all(ucp_worker_h worker,
                           ucp_worker_cfg_index_t ep_cfg_index,
@@ -862,6 +1232,36 @@ ucp_proto_select_dump_perf(const ucp_proto_select_elem_t *select_elem,
     } while (range_end != SIZE_MAX);
 }
 
+static void
+ucp_proto_select_dump_tune(const ucp_proto_select_elem_t *select_elem,
+                           ucs_string_buffer_t *strb)
+{
+    static const char *proto_info_fmt = "    %-18s %-12s %-8s %s\n";
+    const ucp_proto_select_tune_bound_t *bound;
+    const ucp_proto_threshold_elem_t *thresh_elem;
+    char range_str[128], thresh_str[64], updates_str[16], protos_str[64];
+    unsigned i;
+
+    ucs_string_buffer_appendf(strb, proto_info_fmt, "WINDOW", "THRESHOLD",
+                              "UPDATES", "PROTOCOLS");
+    for (i = 0; i < select_elem->tune->num_bounds; ++i) {
+        bound       = &select_elem->tune->bounds[i];
+        thresh_elem = &bound->thresholds[bound->thresh_index];
+
+        ucs_memunits_range_str(bound->min_length, bound->max_length,
+                               range_str, sizeof(range_str));
+        ucs_memunits_to_str(thresh_elem->max_msg_length, thresh_str,
+                            sizeof(thresh_str));
+        ucs_snprintf_safe(updates_str, sizeof(updates_str), "%u",
+                          bound->num_updates);
+        ucs_snprintf_safe(protos_str, sizeof(protos_str), "%s / %s",
+                          thresh_elem->proto_config.proto->name,
+                          thresh_elem[1].proto_config.proto->name);
+        ucs_string_buffer_appendf(strb, proto_info_fmt, range_str, thresh_str,
+                                  updates_str, protos_str);
+    }
+}
+
 static void
 ucp_proto_select_elem_dump(ucp_worker_h worker,
                            ucp_worker_cfg_index_t ep_cfg_index,
@@ -889,6 +1289,11 @@ ucp_proto_select_elem_dump(ucp_worker_h worker,
     ucs_string_buffer_appendf(strb, "\n  Performance estimation:\n");
     ucp_proto_select_dump_perf(select_elem, strb);
 
+    if (select_elem->tune != NULL) {
+        ucs_string_buffer_appendf(strb, "\n  Adaptive thresholds:\n");
+        ucp_proto_select_dump_tune(select_elem, strb);
+    }
+
     ucs_string_buffer_appendf(strb, "\n  Candidates:\n");
     status = ucp_proto_select_dump_all(worker, ep_cfg_index, rkey_cfg_index,
                                        select_param, strb);
@@ -10,6 +10,8 @@
 #include "proto.h"
 
 #include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/list.h>
+#include <ucs/time/time_def.h>
 
 
 /**
@@ -24,6 +26,10 @@
 #define UCP_PROTO_SELECT_PARAM_STR_MAX 128
 
 
+/** Maximal number of message size buckets around an adaptive threshold */
+#define UCP_PROTO_SELECT_TUNE_MAX_BUCKETS 8
+
+
 /**
  * Entry which defines which protocol should be used for a message size range.
  */
@@ -33,6 +39,51 @@ typedef struct {
 } ucp_proto_threshold_elem_t;
 
 
+/**
+ * Latency observed for the two protocols around a threshold, for a range of
+ * message sizes. Index 0 is the protocol below the threshold and index 1 is
+ * the protocol above it.
+ */
+typedef struct {
+    unsigned                    count[2];  /* Number of samples */
+    double                      total[2];  /* Total latency of samples, seconds */
+} ucp_proto_select_tune_bucket_t;
+
+
+/**
+ * Adaptive state of a threshold between two adjacent selected protocols.
+ * Messages in [min_length, max_length] may be sent by either of them, so
+ * sampled requests alternate between both to compare their latency.
+ */
+typedef struct {
+    ucs_list_link_t             list;          /* Entry in worker's in-flight
+                                                  samples list */
+    ucp_proto_threshold_elem_t  *thresholds;   /* Thresholds array to update */
+    unsigned                    thresh_index;  /* Index of the protocol below
+                                                  the threshold */
+    size_t                      min_length;    /* Lowest sampled message size */
+    size_t                      max_length;    /* Highest sampled message size */
+    unsigned                    num_buckets;   /* Number of log2 size buckets */
+    unsigned                    counter;       /* Requests since last sample */
+    unsigned                    num_updates;   /* How many times the threshold
+                                                  was moved */
+    uint8_t                     next_side;     /* Protocol to sample next */
+    uint8_t                     sample_side;   /* Protocol of in-flight sample */
+    ucp_request_t               *sample_req;   /* In-flight sample, or NULL */
+    ucs_time_t                  sample_start;  /* In-flight sample start time */
+    ucp_proto_select_tune_bucket_t buckets[UCP_PROTO_SELECT_TUNE_MAX_BUCKETS];
+} ucp_proto_select_tune_bound_t;
+
+
+/**
+ * Adaptive thresholds state of a protocol selection element
+ */
+typedef struct {
+    unsigned                      num_bounds;  /* Number of tunable thresholds */
+    ucp_proto_select_tune_bound_t bounds[0];
+} ucp_proto_select_tune_t;
+
+
 /**
  * Protocol selection per a particular buffer type and operation
  */
@@ -43,6 +94,8 @@ typedef struct {
                                                      the selected protocols */
     void                             *priv_buf;   /* Private configuration area
                                                      for the selected protocols */
+    ucp_proto_select_tune_t          *tune;       /* Adaptive thresholds state,
+                                                     NULL if disabled */
 } ucp_proto_select_elem_t;
 
 
@@ -107,6 +160,18 @@ ucp_proto_select_lookup_slow(ucp_worker_h worker,
                              const ucp_proto_select_param_t *select_param);
 
 
+const ucp_proto_threshold_elem_t *
+ucp_proto_select_tune_lookup(ucp_worker_h worker,
+                             ucp_proto_select_t *proto_select,
+                             ucp_worker_cfg_index_t ep_cfg_index,
+                             ucp_worker_cfg_index_t rkey_cfg_index,
+                             const ucp_proto_select_param_t *select_param,
+                             size_t msg_length, ucp_request_t *req);
+
+
+void ucp_proto_select_tune_complete(ucp_request_t *req, ucs_status_t status);
+
+
 const ucp_proto_threshold_elem_t*
 ucp_proto_thresholds_search_slow(const ucp_proto_threshold_elem_t *thresholds,
                                  size_t msg_length);
@@ -0,0 +1,326 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "proto_trace.h"
+#include "proto.h"
+
+#include <ucp/core/ucp_context.h>
+#include <ucp/core/ucp_request.h>
+#include <ucp/core/ucp_worker.h>
+#include <ucs/arch/cpu.h>
+#include <ucs/config/parser.h>
+#include <ucs/debug/memtrack.h>
+#include <ucs/sys/string.h>
+#include <ucs/time/time.h>
+#include <ucs/vfs/base/vfs_obj.h>
+
+
+static uint32_t ucp_proto_trace_elapsed_ns(ucp_proto_trace_record_t *record)
+{
+    double elapsed = ucs_time_to_nsec(ucs_get_time() - record->start_time);
+
+    return ucs_min(elapsed, (double)UINT32_MAX);
+}
+
+static ucp_proto_trace_record_t *ucp_proto_trace_record(ucp_request_t *req)
+{
+    ucp_proto_trace_t *trace = &req->send.ep->worker->proto_trace;
+    ucp_proto_trace_record_t *record;
+
+    /* The record could be reused by a newer request if the ring wrapped
+     * around while this request was in progress */
+    record = &trace->records[req->send.proto_trace_index];
+    return (record->req == req) ? record : NULL;
+}
+
+static ucs_status_t ucp_proto_trace_alloc(ucp_worker_h worker)
+{
+    ucp_proto_trace_t *trace = &worker->proto_trace;
+
+    if (trace->records != NULL) {
+        return UCS_OK;
+    }
+
+    trace->records = ucs_calloc(trace->size, sizeof(*trace->records),
+                                "ucp_proto_trace");
+    if (trace->records == NULL) {
+        ucs_error("failed to allocate %u protocol trace records", trace->size);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    return UCS_OK;
+}
+
+ucs_status_t ucp_proto_trace_init(ucp_worker_h worker)
+{
+    ucp_context_h context    = worker->context;
+    ucp_proto_trace_t *trace = &worker->proto_trace;
+    ucs_status_t status;
+
+    trace->enable  = 0;
+    trace->rate    = context->config.ext.proto_trace_rate;
+    trace->counter = 0;
+    trace->size    = context->config.ext.proto_trace_size;
+    trace->count   = 0;
+    trace->records = NULL;
+
+    /* Records are allocated when tracing is enabled for the first time */
+    if (!context->config.ext.proto_trace) {
+        return UCS_OK;
+    }
+
+    status = ucp_proto_trace_alloc(worker);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    trace->enable = 1;
+    return UCS_OK;
+}
+
+void ucp_proto_trace_cleanup(ucp_worker_h worker)
+{
+    ucs_free(worker->proto_trace.records);
+}
+
+void ucp_proto_trace_sample(ucp_worker_h worker, ucp_request_t *req,
+                            size_t msg_length)
+{
+    const ucp_proto_config_t *proto_config = req->send.proto_config;
+    ucp_proto_trace_t *trace               = &worker->proto_trace;
+    ucp_proto_trace_record_t *record;
+    ucp_proto_id_t proto_id;
+    unsigned index;
+
+    trace->counter = 0;
+
+    for (proto_id = 0; proto_id < ucp_protocols_count; ++proto_id) {
+        if (ucp_protocols[proto_id] == proto_config->proto) {
+            break;
+        }
+    }
+
+    index               = trace->count++ % trace->size;
+    record              = &trace->records[index];
+    record->req         = req;
+    record->start_time  = ucs_get_time();
+    record->send_ns     = 0;
+    record->complete_ns = 0;
+    record->proto_id    = proto_id;
+    record->op_id       = proto_config->select_param.op_id;
+    record->mem_type    = proto_config->select_param.mem_type;
+    record->size_bucket = (msg_length == 0) ? 0 : (ucs_ilog2(msg_length) + 1);
+    record->lane_map    = proto_config->lane_map;
+    record->flags       = 0;
+
+    req->send.proto_trace_index = index;
+    req->flags                 |= UCP_REQUEST_FLAG_PROTO_TRACE;
+}
+
+void ucp_proto_trace_send(ucp_request_t *req)
+{
+    ucp_proto_trace_record_t *record = ucp_proto_trace_record(req);
+
+    if ((record != NULL) && !(record->flags & UCP_PROTO_TRACE_FLAG_SENT)) {
+        record->send_ns = ucp_proto_trace_elapsed_ns(record);
+        record->flags  |= UCP_PROTO_TRACE_FLAG_SENT;
+    }
+}
+
+void ucp_proto_trace_pending(ucp_request_t *req)
+{
+    ucp_proto_trace_record_t *record = ucp_proto_trace_record(req);
+
+    if (record != NULL) {
+        record->flags |= UCP_PROTO_TRACE_FLAG_QUEUED;
+    }
+}
+
+void ucp_proto_trace_complete(ucp_request_t *req, ucs_status_t status)
+{
+    ucp_proto_trace_record_t *record = ucp_proto_trace_record(req);
+
+    req->flags &= ~UCP_REQUEST_FLAG_PROTO_TRACE;
+    if (record == NULL) {
+        return;
+    }
+
+    record->complete_ns = ucp_proto_trace_elapsed_ns(record);
+    if (!(record->flags & UCP_PROTO_TRACE_FLAG_SENT)) {
+        /* Completed by the same call which sent it, or sent by a transport
+         * pending queue dispatch */
+        record->send_ns = record->complete_ns;
+        record->flags  |= UCP_PROTO_TRACE_FLAG_SENT;
+    }
+
+    record->flags |= UCP_PROTO_TRACE_FLAG_COMPLETED;
+    if (status != UCS_OK) {
+        record->flags |= UCP_PROTO_TRACE_FLAG_ERROR;
+    }
+    record->req = NULL;
+}
+
+void ucp_proto_trace_dump(ucp_worker_h worker, ucs_string_buffer_t *strb)
+{
+    ucp_proto_trace_t *trace = &worker->proto_trace;
+    ucp_proto_trace_record_t record;
+    ucp_lane_index_t lane;
+    const char *status;
+    uint64_t count, i;
+
+    ucs_string_buffer_appendf(strb, "# proto op mem_type size lanes queued "
+                                    "status send_ns complete_ns\n");
+    if (trace->records == NULL) {
+        return;
+    }
+
+    /* The worker may update the records while they are printed, so a record
+     * which is being overwritten can be inconsistent */
+    count = trace->count;
+    for (i = (count > trace->size) ? (count - trace->size) : 0; i < count;
+         ++i) {
+        record = trace->records[i % trace->size];
+        if (record.proto_id >= ucp_protocols_count) {
+            continue;
+        }
+
+        ucs_string_buffer_appendf(strb, "%s %s %s %zu ",
+                                  ucp_proto_id_field(record.proto_id, name),
+                                  ucp_operation_names[record.op_id],
+                                  ucs_memory_type_names[record.mem_type],
+                                  (record.size_bucket == 0) ? 0 :
+                                  (size_t)UCS_BIT(record.size_bucket - 1));
+
+        if (record.lane_map == 0) {
+            ucs_string_buffer_appendf(strb, "-");
+        } else {
+            ucs_for_each_bit(lane, record.lane_map) {
+                ucs_string_buffer_appendf(strb, "%d,", lane);
+            }
+            ucs_string_buffer_rtrim(strb, ",");
+        }
+
+        if (!(record.flags & UCP_PROTO_TRACE_FLAG_COMPLETED)) {
+            status = "inflight";
+        } else if (record.flags & UCP_PROTO_TRACE_FLAG_ERROR) {
+            status = "error";
+        } else {
+            status = "ok";
+        }
+
+        ucs_string_buffer_appendf(strb, " %s %s ",
+                                  (record.flags & UCP_PROTO_TRACE_FLAG_QUEUED) ?
+                                  "yes" : "no", status);
+
+        if (record.flags & UCP_PROTO_TRACE_FLAG_SENT) {
+            ucs_string_buffer_appendf(strb, "%u ", record.send_ns);
+        } else {
+            ucs_string_buffer_appendf(strb, "- ");
+        }
+
+        if (record.flags & UCP_PROTO_TRACE_FLAG_COMPLETED) {
+            ucs_string_buffer_appendf(strb, "%u\n", record.complete_ns);
+        } else {
+            ucs_string_buffer_appendf(strb, "-\n");
+        }
+    }
+}
+
+static void ucp_proto_trace_vfs_read_value(const char *buffer, size_t size,
+                                           char *value_str, size_t max)
+{
+    size_t length = ucs_min(size, max - 1);
+
+    memcpy(value_str, buffer, length);
+    value_str[length] = '\0';
+    ucs_strtrim(value_str);
+}
+
+static void ucp_proto_trace_vfs_show_enable(void *obj,
+                                            ucs_string_buffer_t *strb)
+{
+    ucp_proto_trace_t *trace = obj;
+
+    ucs_string_buffer_appendf(strb, "%d\n", trace->enable);
+}
+
+static ucs_status_t
+ucp_proto_trace_vfs_write_enable(void *obj, const char *buffer, size_t size)
+{
+    ucp_proto_trace_t *trace = obj;
+    ucp_worker_h worker      = ucs_container_of(trace, ucp_worker_t,
+                                                proto_trace);
+    char value_str[16];
+    ucs_status_t status;
+    int value;
+
+    ucp_proto_trace_vfs_read_value(buffer, size, value_str, sizeof(value_str));
+    if (!ucs_config_sscanf_bool(value_str, &value, NULL)) {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    if (value) {
+        status = ucp_proto_trace_alloc(worker);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        /* Make the records visible before the worker starts using them */
+        ucs_memory_cpu_store_fence();
+    }
+
+    ucs_debug("worker %p: protocol trace %s", worker,
+              value ? "enabled" : "disabled");
+    trace->enable = value;
+    return UCS_OK;
+}
+
+static void ucp_proto_trace_vfs_show_rate(void *obj, ucs_string_buffer_t *strb)
+{
+    ucp_proto_trace_t *trace = obj;
+
+    ucs_string_buffer_appendf(strb, "%u\n", trace->rate);
+}
+
+static ucs_status_t
+ucp_proto_trace_vfs_write_rate(void *obj, const char *buffer, size_t size)
+{
+    ucp_proto_trace_t *trace = obj;
+    char value_str[16];
+    unsigned value;
+
+    ucp_proto_trace_vfs_read_value(buffer, size, value_str, sizeof(value_str));
+    if ((sscanf(value_str, "%u", &value) != 1) || (value == 0)) {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    trace->rate = value;
+    return UCS_OK;
+}
+
+static void ucp_proto_trace_vfs_show_records(void *obj,
+                                             ucs_string_buffer_t *strb)
+{
+    ucp_proto_trace_dump(ucs_container_of(obj, ucp_worker_t, proto_trace),
+                         strb);
+}
+
+void ucp_proto_trace_vfs_init(ucp_worker_h worker)
+{
+    ucp_proto_trace_t *trace = &worker->proto_trace;
+
+    ucs_vfs_obj_add_dir(worker, trace, "proto_trace");
+    ucs_vfs_obj_add_rw_file(trace, ucp_proto_trace_vfs_show_enable,
+                            ucp_proto_trace_vfs_write_enable, "enable");
+    ucs_vfs_obj_add_rw_file(trace, ucp_proto_trace_vfs_show_rate,
+                            ucp_proto_trace_vfs_write_rate, "rate");
+    ucs_vfs_obj_add_ro_file(trace, ucp_proto_trace_vfs_show_records,
+                            "records");
+}
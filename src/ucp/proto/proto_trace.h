@@ -0,0 +1,91 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_PROTO_TRACE_H_
+#define UCP_PROTO_TRACE_H_
+
+#include <ucp/core/ucp_types.h>
+#include <ucs/datastruct/string_buffer.h>
+#include <ucs/time/time_def.h>
+
+
+/* Maximal number of records in the protocol trace ring */
+#define UCP_PROTO_TRACE_MAX_SIZE UCS_BIT(16)
+
+
+/**
+ * Protocol trace record flags
+ */
+enum {
+    UCP_PROTO_TRACE_FLAG_QUEUED    = UCS_BIT(0), /* Added to a pending queue */
+    UCP_PROTO_TRACE_FLAG_SENT      = UCS_BIT(1), /* First send was posted */
+    UCP_PROTO_TRACE_FLAG_COMPLETED = UCS_BIT(2), /* Request was completed */
+    UCP_PROTO_TRACE_FLAG_ERROR     = UCS_BIT(3)  /* Completed with an error */
+};
+
+
+/**
+ * Protocol selection of a sampled send request, and its timing
+ */
+typedef struct {
+    ucp_request_t    *req;        /* Traced request, or NULL if completed */
+    ucs_time_t       start_time;  /* Protocol selection time */
+    uint32_t         send_ns;     /* Time from selection to first send */
+    uint32_t         complete_ns; /* Time from selection to completion */
+    uint8_t          proto_id;    /* Selected protocol */
+    uint8_t          op_id;       /* Operation, ucp_operation_id_t */
+    uint8_t          mem_type;    /* Memory type, ucs_memory_type_t */
+    uint8_t          size_bucket; /* 0 for empty message, otherwise
+                                     log2(length) + 1 */
+    ucp_lane_map_t   lane_map;    /* Lanes used by the protocol */
+    uint8_t          flags;       /* UCP_PROTO_TRACE_FLAG_xx */
+} ucp_proto_trace_record_t;
+
+
+/**
+ * Per-worker ring buffer of protocol trace records
+ */
+typedef struct {
+    volatile int             enable;  /* Whether new requests are sampled */
+    unsigned                 rate;    /* Sample one of every 'rate' requests */
+    unsigned                 counter; /* Requests since the last sample */
+    unsigned                 size;    /* Number of records in the ring */
+    uint64_t                 count;   /* Total number of sampled requests */
+    ucp_proto_trace_record_t *records;
+} ucp_proto_trace_t;
+
+
+ucs_status_t ucp_proto_trace_init(ucp_worker_h worker);
+
+
+void ucp_proto_trace_cleanup(ucp_worker_h worker);
+
+
+void ucp_proto_trace_vfs_init(ucp_worker_h worker);
+
+
+/* Add a record for a request whose protocol was just selected */
+void ucp_proto_trace_sample(ucp_worker_h worker, ucp_request_t *req,
+                            size_t msg_length);
+
+
+/* Called when a traced request made its first send */
+void ucp_proto_trace_send(ucp_request_t *req);
+
+
+/* Called when a traced request is added to a pending queue */
+void ucp_proto_trace_pending(ucp_request_t *req);
+
+
+/* Called when a traced request is completed */
+void ucp_proto_trace_complete(ucp_request_t *req, ucs_status_t status);
+
+
+/* Print the records, oldest first, as "proto op mem_type size lanes queued
+ * status send_ns complete_ns" lines */
+void ucp_proto_trace_dump(ucp_worker_h worker, ucs_string_buffer_t *strb);
+
+#endif
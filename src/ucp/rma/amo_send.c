@@ -102,6 +102,8 @@ ucp_amo_init_common(ucp_request_t *req, ucp_ep_h ep, uct_atomic_op_t op,
     req->send.amo.remote_addr = remote_addr;
     req->send.amo.rkey        = rkey;
     req->send.amo.value       = value;
+    req->send.amo.fence_sn    = ep->worker->fence_sn;
+    req->send.amo.batch_count = 0;
 #if UCS_ENABLE_ASSERT
     req->send.lane            = UCP_NULL_LANE;
 #endif
@@ -126,7 +128,8 @@ void ucp_amo_init_post(ucp_request_t *req, ucp_ep_h ep, uct_atomic_op_t op,
                        uint64_t value, const ucp_amo_proto_t *proto)
 {
     ucp_amo_init_common(req, ep, op, remote_addr, rkey, value, op_size);
-    req->send.uct.func = proto->progress_post;
+    req->send.state.uct_comp.func = NULL;
+    req->send.uct.func            = proto->progress_post;
 }
 
 ucs_status_ptr_t ucp_atomic_fetch_nb(ucp_ep_h ep, ucp_atomic_fetch_op_t opcode,
@@ -180,6 +183,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_atomic_op_nbx,
     UCP_AMO_CHECK_PARAM_NBX(ep->worker->context, remote_addr, op_size,
                             count, opcode, UCP_ATOMIC_OP_LAST,
                             return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM));
+    UCP_RMA_CHECK_COUNTER(param, return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM));
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
 
     ucs_trace_req("atomic_op_nbx opcode %d buffer %p result %p "
@@ -191,6 +195,9 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_atomic_op_nbx,
                   (param->op_attr_mask & UCP_OP_ATTR_FIELD_CALLBACK) ?
                   param->cb.send : NULL);
 
+    UCP_EP_RESOLVE_LAZY(ep, status_p, goto out);
+    ucp_ep_rma_mark_dirty(ep);
+
     status = UCP_RKEY_RESOLVE(rkey, ep, amo);
     if (status != UCS_OK) {
         status_p = UCS_STATUS_PTR(status);
@@ -218,6 +225,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_atomic_op_nbx,
     }
 
 out:
+    status_p = ucp_rma_counter_track(status_p, param);
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(ep->worker);
     return status_p;
 }
@@ -238,6 +246,12 @@ ucs_status_t ucp_atomic_post(ucp_ep_h ep, ucp_atomic_post_op_t opcode, uint64_t
                   opcode, value, op_size, remote_addr, rkey,
                   ucp_ep_peer_name(ep));
 
+    status = ucp_ep_resolve_lazy(ep);
+    if (status != UCS_OK) {
+        goto out;
+    }
+    ucp_ep_rma_mark_dirty(ep);
+
     status = UCP_RKEY_RESOLVE(rkey, ep, amo);
     if (status != UCS_OK) {
         goto out;
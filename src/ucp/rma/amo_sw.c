@@ -15,31 +15,55 @@
 #include <ucs/profile/profile.h>
 
 
+/* Software AMO batch flags */
+enum {
+    UCP_AMO_SW_BATCH_FLAG_FETCH = UCS_BIT(0), /* Batch needs a reply */
+    UCP_AMO_SW_BATCH_FLAG_HELD  = UCS_BIT(1)  /* Batch is not sent until a
+                                                 remote completion arrives */
+};
+
+
+/* Worst-case packed size of an operation in a batch */
+#define UCP_AMO_SW_BATCH_OP_MAX_SIZE \
+    (sizeof(ucp_atomic_batch_op_t) + (2 * sizeof(uint64_t)))
+
+
+static ucs_status_t ucp_amo_sw_progress_fetch(uct_pending_req_t *self);
+
+static UCS_F_ALWAYS_INLINE int ucp_amo_sw_is_fetch(const ucp_request_t *req)
+{
+    return req->send.uct.func == ucp_amo_sw_progress_fetch;
+}
+
+/* Pack the atomic arguments, and return their length */
+static size_t ucp_amo_sw_pack_args(void *dest, const ucp_request_t *req)
+{
+    size_t size = req->send.length;
+
+    memcpy(dest, &req->send.amo.value, size);
+    if (req->send.amo.uct_op == UCT_ATOMIC_OP_CSWAP) {
+        /* compare-swap has two arguments */
+        memcpy(UCS_PTR_BYTE_OFFSET(dest, size), req->send.buffer, size);
+        return 2 * size;
+    }
+
+    return size;
+}
+
 static size_t ucp_amo_sw_pack(void *dest, void *arg, uint8_t fetch)
 {
     ucp_request_t *req            = arg;
     ucp_atomic_req_hdr_t *atomich = dest;
     ucp_ep_t *ep                  = req->send.ep;
-    size_t size                   = req->send.length;
-    size_t length;
 
     atomich->address    = req->send.amo.remote_addr;
     atomich->req.ep_id  = ucp_ep_remote_id(ep);
     atomich->req.req_id = fetch ? ucp_request_get_id(req) :
                                   UCP_REQUEST_ID_INVALID;
-    atomich->length     = size;
+    atomich->length     = req->send.length;
     atomich->opcode     = req->send.amo.uct_op;
 
-    memcpy(atomich + 1, &req->send.amo.value, size);
-    length = sizeof(*atomich) + size;
-
-    if (req->send.amo.uct_op == UCT_ATOMIC_OP_CSWAP) {
-        /* compare-swap has two arguments */
-        memcpy(UCS_PTR_BYTE_OFFSET(atomich + 1, size), req->send.buffer, size);
-        length += size;
-    }
-
-    return length;
+    return sizeof(*atomich) + ucp_amo_sw_pack_args(atomich + 1, req);
 }
 
 static size_t ucp_amo_sw_post_pack_cb(void *dest, void *arg)
@@ -52,31 +76,255 @@ static size_t ucp_amo_sw_fetch_pack_cb(void *dest, void *arg)
     return ucp_amo_sw_pack(dest, arg, 1);
 }
 
+static size_t ucp_amo_sw_batch_pack_op(void *dest, const ucp_request_t *req)
+{
+    ucp_atomic_batch_op_t *op = dest;
+
+    op->address = req->send.amo.remote_addr;
+    op->length  = req->send.length;
+    op->opcode  = req->send.amo.uct_op;
+
+    return sizeof(*op) + ucp_amo_sw_pack_args(op + 1, req);
+}
+
+static size_t ucp_amo_sw_batch_pack_cb(void *dest, void *arg)
+{
+    ucp_request_t *req             = arg;
+    ucp_atomic_batch_hdr_t *batchh = dest;
+    void *p                        = batchh + 1;
+    ucp_request_t *op_req;
+
+    batchh->req.ep_id  = ucp_ep_remote_id(req->send.ep);
+    batchh->req.req_id = (req->send.amo.batch_flags &
+                          UCP_AMO_SW_BATCH_FLAG_FETCH) ?
+                         ucp_request_get_id(req) : UCP_REQUEST_ID_INVALID;
+    batchh->count      = req->send.amo.batch_count;
+
+    for (op_req = req; op_req != NULL; op_req = op_req->send.amo_batch_next) {
+        p = UCS_PTR_BYTE_OFFSET(p, ucp_amo_sw_batch_pack_op(p, op_req));
+    }
+
+    return UCS_PTR_BYTE_DIFF(dest, p);
+}
+
+/* Complete all operations of a batch. The batch request is completed last,
+ * since it may be released by the completion. */
+static void ucp_amo_sw_batch_complete(ucp_request_t *req, ucs_status_t status)
+{
+    ucp_request_t *op_req, *next;
+
+    for (op_req = req->send.amo_batch_next; op_req != NULL; op_req = next) {
+        next = op_req->send.amo_batch_next;
+        ucp_request_complete_send(op_req, status);
+    }
+
+    ucp_request_complete_send(req, status);
+}
+
+/* Called when a pending batch is purged */
+static void ucp_amo_sw_batch_completed(uct_completion_t *self)
+{
+    ucp_request_t *req           = ucs_container_of(self, ucp_request_t,
+                                                    send.state.uct_comp);
+    ucp_ep_ext_control_t *ep_ext = ucp_ep_ext_control(req->send.ep);
+
+    if (ep_ext->amo.batch == req) {
+        ep_ext->amo.batch = NULL;
+    }
+
+    ucp_amo_sw_batch_complete(req, self->status);
+}
+
+/* Start aggregating operations to a request */
+static void
+ucp_amo_sw_batch_open(ucp_request_t *req, int fetch, uint8_t flags)
+{
+    ucp_ep_ext_control_t *ep_ext = ucp_ep_ext_control(req->send.ep);
+
+    ucs_assert(ep_ext->amo.batch == NULL);
+
+    req->send.amo_batch_next        = NULL;
+    req->send.amo.batch_count       = 1;
+    req->send.amo.batch_flags       = flags |
+                                      (fetch ? UCP_AMO_SW_BATCH_FLAG_FETCH : 0);
+    req->send.state.uct_comp.func   = ucp_amo_sw_batch_completed;
+    req->send.state.uct_comp.count  = 1;
+    req->send.state.uct_comp.status = UCS_OK;
+    ep_ext->amo.batch               = req;
+    ep_ext->amo.batch_tail          = req;
+}
+
+/*
+ * Hold back an operation while the peer did not complete previous ones on the
+ * endpoint yet. Following operations are aggregated to it, and all of them are
+ * sent when the next remote completion arrives.
+ */
+static int ucp_amo_sw_batch_hold(ucp_request_t *req, int fetch)
+{
+    ucp_ep_h ep = req->send.ep;
+    ucp_ep_flush_state_t *flush_state;
+
+    if ((ep->worker->context->config.ext.amo_sw_batch <= 1) ||
+        !(ep->flags & UCP_EP_FLAG_FLUSH_STATE_VALID)) {
+        return 0;
+    }
+
+    flush_state = ucp_ep_flush_state(ep);
+    if (flush_state->send_sn == flush_state->cmpl_sn) {
+        return 0;
+    }
+
+    ucp_amo_sw_batch_open(req, fetch, UCP_AMO_SW_BATCH_FLAG_HELD);
+    return 1;
+}
+
+static int ucp_amo_sw_batch_add(ucp_request_t *batch, ucp_request_t *req,
+                                int fetch)
+{
+    ucp_ep_h ep                  = batch->send.ep;
+    ucp_ep_ext_control_t *ep_ext = ucp_ep_ext_control(ep);
+    unsigned max_count           = ucs_min(
+            ep->worker->context->config.ext.amo_sw_batch, UINT8_MAX);
+
+    /* Do not reorder operations across a fence */
+    if ((req->send.amo.fence_sn != batch->send.amo.fence_sn) ||
+        (batch->send.amo.batch_count >= max_count) ||
+        ((sizeof(ucp_atomic_batch_hdr_t) +
+          ((batch->send.amo.batch_count + 1) * UCP_AMO_SW_BATCH_OP_MAX_SIZE)) >
+         ucp_ep_config(ep)->am.max_bcopy)) {
+        return 0;
+    }
+
+    req->send.amo_batch_next                    = NULL;
+    ep_ext->amo.batch_tail->send.amo_batch_next = req;
+    ep_ext->amo.batch_tail                      = req;
+    ++batch->send.amo.batch_count;
+    if (fetch) {
+        batch->send.amo.batch_flags |= UCP_AMO_SW_BATCH_FLAG_FETCH;
+    }
+
+    return 1;
+}
+
+void ucp_amo_sw_batch_release(ucp_ep_h ep)
+{
+    ucp_request_t *batch = ucp_ep_ext_control(ep)->amo.batch;
+
+    if ((batch == NULL) ||
+        !(batch->send.amo.batch_flags & UCP_AMO_SW_BATCH_FLAG_HELD)) {
+        return;
+    }
+
+    batch->send.amo.batch_flags &= ~UCP_AMO_SW_BATCH_FLAG_HELD;
+    ucp_request_send(batch, 0);
+}
+
+void ucp_amo_sw_batch_purge(ucp_ep_h ep, ucs_status_t status)
+{
+    ucp_request_t *batch = ucp_ep_ext_control(ep)->amo.batch;
+
+    /* A batch which was released is purged from the pending queue */
+    if ((batch == NULL) ||
+        !(batch->send.amo.batch_flags & UCP_AMO_SW_BATCH_FLAG_HELD)) {
+        return;
+    }
+
+    ucp_ep_ext_control(ep)->amo.batch = NULL;
+    ucp_amo_sw_batch_complete(batch, status);
+}
+
+static ucs_status_t ucp_amo_sw_batch_progress(ucp_request_t *req)
+{
+    int fetch = req->send.amo.batch_flags & UCP_AMO_SW_BATCH_FLAG_FETCH;
+    ucs_status_t status;
+
+    if (fetch) {
+        ucp_request_id_alloc(req);
+    }
+
+    status = ucp_rma_sw_do_am_bcopy(req, UCP_AM_ID_ATOMIC_BATCH_REQ,
+                                    req->send.lane, ucp_amo_sw_batch_pack_cb,
+                                    req, NULL);
+    if (status == UCS_ERR_NO_RESOURCE) {
+        if (fetch) {
+            ucp_request_id_release(req);
+        }
+        return status;
+    }
+
+    ucp_ep_ext_control(req->send.ep)->amo.batch = NULL;
+
+    if ((status != UCS_OK) || !fetch) {
+        if (fetch) {
+            ucp_request_id_release(req);
+        }
+        ucp_amo_sw_batch_complete(req, status);
+    }
+
+    return status;
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_t
 ucp_amo_sw_progress(uct_pending_req_t *self, uct_pack_callback_t pack_cb,
                     int fetch)
 {
-    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucp_request_t *req           = ucs_container_of(self, ucp_request_t,
+                                                    send.uct);
+    ucp_ep_ext_control_t *ep_ext = ucp_ep_ext_control(req->send.ep);
+    ucp_request_t *batch         = ep_ext->amo.batch;
     ucs_status_t status;
 
     req->send.lane = ucp_ep_get_am_lane(req->send.ep);
+    if (ucs_unlikely(batch != NULL)) {
+        if (batch == req) {
+            if (req->send.amo.batch_count > 1) {
+                return ucp_amo_sw_batch_progress(req);
+            }
+        } else if (ucp_amo_sw_batch_add(batch, req, fetch)) {
+            return UCS_OK;
+        } else {
+            /* The batch is full, or was started before a fence */
+            ucp_amo_sw_batch_release(req->send.ep);
+            batch = ep_ext->amo.batch;
+        }
+    }
+
+    if ((batch == NULL) && ucp_amo_sw_batch_hold(req, fetch)) {
+        return UCS_OK;
+    }
+
     if (fetch) {
         ucp_request_id_alloc(req);
     }
 
     status = ucp_rma_sw_do_am_bcopy(req, UCP_AM_ID_ATOMIC_REQ,
                                     req->send.lane, pack_cb, req, NULL);
-    if ((status != UCS_OK) || ((status == UCS_OK) && !fetch)) {
+    if (status == UCS_ERR_NO_RESOURCE) {
         if (fetch) {
             ucp_request_id_release(req);
         }
 
-        if (status != UCS_ERR_NO_RESOURCE) {
-            /* completed with:
-             * - with error if a fetch operation
-             * - either with error or with success if a post operation */
-            ucp_request_complete_send(req, status);
+        /* Aggregate following operations while waiting for resources */
+        if ((batch == NULL) &&
+            (req->send.ep->worker->context->config.ext.amo_sw_batch > 1)) {
+            ucp_amo_sw_batch_open(req, fetch, 0);
+        }
+        return status;
+    }
+
+    if (batch == req) {
+        ep_ext->amo.batch = NULL;
+    }
+
+    if ((status != UCS_OK) || !fetch) {
+        if (fetch) {
+            ucp_request_id_release(req);
         }
+
+        /* completed with:
+         * - with error if a fetch operation
+         * - either with error or with success if a post operation */
+        ucp_request_complete_send(req, status);
     }
 
     return status;
@@ -139,12 +387,13 @@ static ucs_status_t ucp_progress_atomic_reply(uct_pending_req_t *self)
 }
 
 #define DEFINE_AMO_SW_OP(_bits) \
-    static void ucp_amo_sw_do_op##_bits(const ucp_atomic_req_hdr_t *atomicreqh) \
+    static void ucp_amo_sw_do_op##_bits(uint64_t address, uint8_t opcode, \
+                                        const void *arg_buf) \
     { \
-        uint##_bits##_t *ptr  = (void*)atomicreqh->address; \
-        uint##_bits##_t *args = (void*)(atomicreqh + 1); \
+        uint##_bits##_t *ptr        = (void*)address; \
+        const uint##_bits##_t *args = arg_buf; \
         \
-       switch (atomicreqh->opcode) { \
+        switch (opcode) { \
         case UCT_ATOMIC_OP_ADD: \
             ucs_atomic_add##_bits(ptr, args[0]); \
             break; \
@@ -158,18 +407,19 @@ static ucs_status_t ucp_progress_atomic_reply(uct_pending_req_t *self)
             ucs_atomic_xor##_bits(ptr, args[0]); \
             break; \
         default: \
-            ucs_fatal("invalid opcode: %d", atomicreqh->opcode); \
+            ucs_fatal("invalid opcode: %d", opcode); \
         } \
     }
 
 #define DEFINE_AMO_SW_FOP(_bits) \
-    static void ucp_amo_sw_do_fop##_bits(const ucp_atomic_req_hdr_t *atomicreqh, \
+    static void ucp_amo_sw_do_fop##_bits(uint64_t address, uint8_t opcode, \
+                                         const void *arg_buf, \
                                          ucp_atomic_reply_t *result) \
     { \
-        uint##_bits##_t *ptr  = (void*)atomicreqh->address; \
-        uint##_bits##_t *args = (void*)(atomicreqh + 1); \
+        uint##_bits##_t *ptr        = (void*)address; \
+        const uint##_bits##_t *args = arg_buf; \
         \
-        switch (atomicreqh->opcode) { \
+        switch (opcode) { \
         case UCT_ATOMIC_OP_ADD: \
             result->reply##_bits = ucs_atomic_fadd##_bits(ptr, args[0]); \
             break; \
@@ -189,7 +439,7 @@ static ucs_status_t ucp_progress_atomic_reply(uct_pending_req_t *self)
             result->reply##_bits = ucs_atomic_cswap##_bits(ptr, args[0], args[1]); \
             break; \
         default: \
-            ucs_fatal("invalid opcode: %d", atomicreqh->opcode); \
+            ucs_fatal("invalid opcode: %d", opcode); \
         } \
     }
 
@@ -228,10 +478,12 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_atomic_req_handler, (arg, data, length, am_fl
         /* atomic operation without result */
         switch (atomicreqh->length) {
         case sizeof(uint32_t):
-            ucp_amo_sw_do_op32(atomicreqh);
+            ucp_amo_sw_do_op32(atomicreqh->address, atomicreqh->opcode,
+                               atomicreqh + 1);
             break;
         case sizeof(uint64_t):
-            ucp_amo_sw_do_op64(atomicreqh);
+            ucp_amo_sw_do_op64(atomicreqh->address, atomicreqh->opcode,
+                               atomicreqh + 1);
             break;
         default:
             ucs_fatal("invalid atomic length: %u", atomicreqh->length);
@@ -247,10 +499,12 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_atomic_req_handler, (arg, data, length, am_fl
 
         switch (atomicreqh->length) {
         case sizeof(uint32_t):
-            ucp_amo_sw_do_fop32(atomicreqh, &req->send.atomic_reply.data);
+            ucp_amo_sw_do_fop32(atomicreqh->address, atomicreqh->opcode,
+                                atomicreqh + 1, &req->send.atomic_reply.data);
             break;
         case sizeof(uint64_t):
-            ucp_amo_sw_do_fop64(atomicreqh, &req->send.atomic_reply.data);
+            ucp_amo_sw_do_fop64(atomicreqh->address, atomicreqh->opcode,
+                                atomicreqh + 1, &req->send.atomic_reply.data);
             break;
         default:
             ucs_fatal("invalid atomic length: %u", atomicreqh->length);
@@ -267,6 +521,120 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_atomic_req_handler, (arg, data, length, am_fl
     return UCS_OK;
 }
 
+static size_t ucp_amo_sw_pack_batch_reply(void *dest, void *arg)
+{
+    ucp_rma_rep_hdr_t *hdr = dest;
+    ucp_request_t *req     = arg;
+
+    hdr->req_id = req->send.atomic_reply.remote_req_id;
+    memcpy(hdr + 1, req->send.buffer, req->send.length);
+    return sizeof(*hdr) + req->send.length;
+}
+
+static ucs_status_t ucp_progress_atomic_batch_reply(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucp_ep_t *ep       = req->send.ep;
+    ssize_t packed_len;
+
+    req->send.lane = ucp_ep_get_am_lane(ep);
+    packed_len     = uct_ep_am_bcopy(ep->uct_eps[req->send.lane],
+                                     UCP_AM_ID_ATOMIC_BATCH_REP,
+                                     ucp_amo_sw_pack_batch_reply, req, 0);
+    if (packed_len < 0) {
+        return (ucs_status_t)packed_len;
+    }
+
+    ucs_free(req->send.buffer);
+    ucp_request_put(req);
+    return UCS_OK;
+}
+
+/* Execute an operation of a batch, and return the next one */
+static const ucp_atomic_batch_op_t *
+ucp_amo_sw_batch_do_op(const ucp_atomic_batch_op_t *op,
+                       ucp_atomic_reply_t *result)
+{
+    switch (op->length) {
+    case sizeof(uint32_t):
+        if (result != NULL) {
+            ucp_amo_sw_do_fop32(op->address, op->opcode, op + 1, result);
+        } else {
+            ucp_amo_sw_do_op32(op->address, op->opcode, op + 1);
+        }
+        break;
+    case sizeof(uint64_t):
+        if (result != NULL) {
+            ucp_amo_sw_do_fop64(op->address, op->opcode, op + 1, result);
+        } else {
+            ucp_amo_sw_do_op64(op->address, op->opcode, op + 1);
+        }
+        break;
+    default:
+        ucs_fatal("invalid atomic length: %u", op->length);
+    }
+
+    return UCS_PTR_BYTE_OFFSET(op + 1, op->length *
+                               ((op->opcode == UCT_ATOMIC_OP_CSWAP) ? 2 : 1));
+}
+
+UCS_PROFILE_FUNC(ucs_status_t, ucp_atomic_batch_req_handler,
+                 (arg, data, length, am_flags), void *arg, void *data,
+                 size_t length, unsigned am_flags)
+{
+    ucp_atomic_batch_hdr_t *batchh = data;
+    ucp_worker_h worker            = arg;
+    const ucp_atomic_batch_op_t *op;
+    ucp_atomic_reply_t result;
+    ucp_request_t *req;
+    void *reply, *p;
+    uint8_t op_length;
+    unsigned i;
+    ucp_ep_h ep;
+
+    UCP_WORKER_GET_EP_BY_ID(&ep, worker, batchh->req.ep_id, return UCS_OK,
+                            "SW AMO batch request");
+
+    op = (const ucp_atomic_batch_op_t*)(batchh + 1);
+    if (batchh->req.req_id == UCP_REQUEST_ID_INVALID) {
+        for (i = 0; i < batchh->count; ++i) {
+            op = ucp_amo_sw_batch_do_op(op, NULL);
+        }
+
+        ucp_rma_sw_send_cmpl(ep);
+        return UCS_OK;
+    }
+
+    /* Results of all operations are returned in a single reply */
+    req   = ucp_request_get(worker);
+    reply = ucs_malloc(batchh->count * sizeof(uint64_t), "atomic_batch_reply");
+    if ((req == NULL) || (reply == NULL)) {
+        ucs_error("failed to allocate atomic batch reply");
+        ucs_free(reply);
+        if (req != NULL) {
+            ucp_request_put(req);
+        }
+        return UCS_OK;
+    }
+
+    p = reply;
+    for (i = 0; i < batchh->count; ++i) {
+        op_length = op->length;
+        op        = ucp_amo_sw_batch_do_op(op, &result);
+        memcpy(p, &result, op_length);
+        p         = UCS_PTR_BYTE_OFFSET(p, op_length);
+    }
+
+    req->flags                           = 0;
+    req->send.ep                         = ep;
+    req->send.atomic_reply.remote_req_id = batchh->req.req_id;
+    req->send.buffer                     = reply;
+    req->send.length                     = UCS_PTR_BYTE_DIFF(reply, p);
+    req->send.uct.func                   = ucp_progress_atomic_batch_reply;
+    ucp_request_send(req, 0);
+    return UCS_OK;
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucp_atomic_rep_handler, (arg, data, length, am_flags),
                  void *arg, void *data, size_t length, unsigned am_flags)
 {
@@ -285,11 +653,47 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_atomic_rep_handler, (arg, data, length, am_fl
     return UCS_OK;
 }
 
+static size_t ucp_amo_sw_batch_unpack_result(ucp_request_t *req,
+                                             const void *result)
+{
+    if (ucp_amo_sw_is_fetch(req)) {
+        memcpy(req->send.buffer, result, req->send.length);
+    }
+
+    return req->send.length;
+}
+
+UCS_PROFILE_FUNC(ucs_status_t, ucp_atomic_batch_rep_handler,
+                 (arg, data, length, am_flags), void *arg, void *data,
+                 size_t length, unsigned am_flags)
+{
+    ucp_worker_h worker    = arg;
+    ucp_rma_rep_hdr_t *hdr = data;
+    const void *result     = hdr + 1;
+    ucp_request_t *req, *op_req;
+    ucp_ep_h ep;
+
+    UCP_REQUEST_GET_BY_ID(&req, worker, hdr->req_id, 1, return UCS_OK,
+                          "ATOMIC_BATCH_REP %p", hdr);
+    ep = req->send.ep;
+    for (op_req = req; op_req != NULL; op_req = op_req->send.amo_batch_next) {
+        result = UCS_PTR_BYTE_OFFSET(result,
+                                     ucp_amo_sw_batch_unpack_result(op_req,
+                                                                    result));
+    }
+
+    ucs_assert(UCS_PTR_BYTE_DIFF(data, result) == length);
+    ucp_amo_sw_batch_complete(req, UCS_OK);
+    ucp_ep_rma_remote_request_completed(ep);
+    return UCS_OK;
+}
+
 static void ucp_amo_sw_dump_packet(ucp_worker_h worker, uct_am_trace_type_t type,
                                    uint8_t id, const void *data, size_t length,
                                    char *buffer, size_t max)
 {
     const ucp_atomic_req_hdr_t *atomich;
+    const ucp_atomic_batch_hdr_t *batchh;
     const ucp_rma_rep_hdr_t *reph;
     size_t header_len;
     char *p;
@@ -309,6 +713,20 @@ static void ucp_amo_sw_dump_packet(ucp_worker_h worker, uct_am_trace_type_t type
         snprintf(buffer, max, "ATOMIC_REP [req_id 0x%"PRIu64"]", reph->req_id);
         header_len = sizeof(*reph);
         break;
+    case UCP_AM_ID_ATOMIC_BATCH_REQ:
+        batchh = data;
+        snprintf(buffer, max,
+                 "ATOMIC_BATCH_REQ [count %u req_id 0x%"PRIu64
+                 " ep_id 0x%"PRIx64"]",
+                 batchh->count, batchh->req.req_id, batchh->req.ep_id);
+        header_len = sizeof(*batchh);
+        break;
+    case UCP_AM_ID_ATOMIC_BATCH_REP:
+        reph = data;
+        snprintf(buffer, max, "ATOMIC_BATCH_REP [req_id 0x%"PRIu64"]",
+                 reph->req_id);
+        header_len = sizeof(*reph);
+        break;
     default:
         return;
     }
@@ -324,4 +742,10 @@ UCP_DEFINE_AM(UCP_FEATURE_AMO, UCP_AM_ID_ATOMIC_REQ, ucp_atomic_req_handler,
 UCP_DEFINE_AM(UCP_FEATURE_AMO, UCP_AM_ID_ATOMIC_REP, ucp_atomic_rep_handler,
               ucp_amo_sw_dump_packet, 0);
 
+UCP_DEFINE_AM(UCP_FEATURE_AMO, UCP_AM_ID_ATOMIC_BATCH_REQ,
+              ucp_atomic_batch_req_handler, ucp_amo_sw_dump_packet, 0);
+UCP_DEFINE_AM(UCP_FEATURE_AMO, UCP_AM_ID_ATOMIC_BATCH_REP,
+              ucp_atomic_batch_rep_handler, ucp_amo_sw_dump_packet, 0);
+
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_ATOMIC_REQ);
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_ATOMIC_BATCH_REQ);
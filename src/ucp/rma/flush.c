@@ -320,6 +320,15 @@ ucs_status_ptr_t ucp_ep_flush_internal(ucp_ep_h ep, unsigned req_flags,
 
     ucs_debug("%s ep %p", debug_name, ep);
 
+    if (ep->flags & UCP_EP_FLAG_LAZY_CONNECT) {
+        /* nothing was sent on the endpoint yet */
+        return NULL;
+    }
+
+    if (ucp_ep_ext_control(ep)->amo.batch != NULL) {
+        ucp_amo_sw_batch_release(ep);
+    }
+
     req = ucp_request_get_param(ep->worker, param,
                                 {return UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);});
 
@@ -423,6 +432,47 @@ static ucs_status_t ucp_worker_flush_check(ucp_worker_h worker)
     return UCS_OK;
 }
 
+void ucp_ep_rma_add_dirty(ucp_ep_h ep)
+{
+    ucp_ep_ext_gen_t *ep_ext = ucp_ep_ext_gen(ep);
+
+    ucs_assert(!(ep->flags & UCP_EP_FLAG_INTERNAL));
+
+    UCS_ASYNC_BLOCK(&ep->worker->async);
+    ucp_ep_update_flags(ep, UCP_EP_FLAG_RMA_DIRTY, 0);
+    if (ucs_list_is_empty(&ep_ext->dirty_list)) {
+        ucs_list_add_tail(&ep->worker->dirty_eps, &ep_ext->dirty_list);
+    }
+    UCS_ASYNC_UNBLOCK(&ep->worker->async);
+}
+
+/*
+ * Remove endpoints which were flushed and did not issue new RMA/AMO operations
+ * since then from the worker's list, or all endpoints if the worker is known to
+ * be flushed. Not done while other worker flush requests are iterating the list.
+ */
+static void ucp_worker_flush_dirty_eps_cleanup(ucp_worker_h worker, int all)
+{
+    ucp_ep_ext_gen_t *ep_ext, *tmp;
+    ucp_ep_h ep;
+
+    if ((worker->flush_worker_count > 0) ||
+        ucs_list_is_empty(&worker->dirty_eps)) {
+        return;
+    }
+
+    UCS_ASYNC_BLOCK(&worker->async);
+    ucs_list_for_each_safe(ep_ext, tmp, &worker->dirty_eps, dirty_list) {
+        ep = ucp_ep_from_ext_gen(ep_ext);
+        if (all || !(ep->flags & UCP_EP_FLAG_RMA_DIRTY)) {
+            ucp_ep_update_flags(ep, 0, UCP_EP_FLAG_RMA_DIRTY);
+            ucs_list_del(&ep_ext->dirty_list);
+            ucs_list_head_init(&ep_ext->dirty_list);
+        }
+    }
+    UCS_ASYNC_UNBLOCK(&worker->async);
+}
+
 static UCS_F_ALWAYS_INLINE ucp_ep_h
 ucp_worker_flush_req_set_next_ep(ucp_request_t *req, int is_current_ep_valid,
                                  ucs_list_link_t *next_ep_iter)
@@ -430,14 +480,14 @@ ucp_worker_flush_req_set_next_ep(ucp_request_t *req, int is_current_ep_valid,
     ucp_worker_h worker              = req->flush_worker.worker;
     ucp_ep_ext_gen_t *next_ep_ext    = ucs_container_of(next_ep_iter,
                                                         ucp_ep_ext_gen_t,
-                                                        ep_list);
+                                                        dirty_list);
     ucp_ep_h next_ep                 = ucp_ep_from_ext_gen(next_ep_ext);
     ucp_ep_ext_gen_t *current_ep_ext = req->flush_worker.next_ep;
     ucp_ep_h current_ep;
 
     req->flush_worker.next_ep = next_ep_ext;
 
-    if (next_ep_iter != &worker->all_eps) {
+    if (next_ep_iter != &worker->dirty_eps) {
         /* Increment UCP EP reference counter to avoid destroying UCP EP while
          * it is being scheduled to be flushed */
         ucp_ep_add_ref(next_ep);
@@ -448,7 +498,7 @@ ucp_worker_flush_req_set_next_ep(ucp_request_t *req, int is_current_ep_valid,
         return NULL;
     }
 
-    ucs_assert(&current_ep_ext->ep_list != &worker->all_eps);
+    ucs_assert(&current_ep_ext->dirty_list != &worker->dirty_eps);
 
     current_ep = ucp_ep_from_ext_gen(current_ep_ext);
     UCP_EP_ASSERT_COUNTER_DEC(&current_ep->flush_iter_refcount);
@@ -473,9 +523,15 @@ static void ucp_worker_flush_complete_one(ucp_request_t *req, ucs_status_t statu
     if (complete) {
         ucs_assert(status != UCS_INPROGRESS);
 
-        if (&req->flush_worker.next_ep->ep_list != &worker->all_eps) {
+        if (&req->flush_worker.next_ep->dirty_list != &worker->dirty_eps) {
             /* Cleanup EP iterator */
-            ucp_worker_flush_req_set_next_ep(req, 1, &worker->all_eps);
+            ucp_worker_flush_req_set_next_ep(req, 1, &worker->dirty_eps);
+        }
+
+        ucs_assert(worker->flush_worker_count > 0);
+        --worker->flush_worker_count;
+        if (status == UCS_OK) {
+            ucp_worker_flush_dirty_eps_cleanup(worker, 0);
         }
 
         ucp_request_complete(req, flush_worker.cb, status, req->user_data);
@@ -500,7 +556,8 @@ static unsigned ucp_worker_flush_progress(void *arg)
     if (worker->flush_ops_count == 0) {
         /* all scheduled progress operations on worker were completed */
         status = ucp_worker_flush_check(worker);
-        if ((status == UCS_OK) || (&next_ep->ep_list == &worker->all_eps)) {
+        if ((status == UCS_OK) ||
+            (&next_ep->dirty_list == &worker->dirty_eps)) {
             /* If all ifaces are flushed, or we finished going over all
              * endpoints, no need to progress this request actively anymore
              * and we complete the flush operation with UCS_OK status. */
@@ -516,14 +573,19 @@ static unsigned ucp_worker_flush_progress(void *arg)
     }
 
     if (worker->context->config.ext.flush_worker_eps &&
-        (&next_ep->ep_list != &worker->all_eps)) {
+        (&next_ep->dirty_list != &worker->dirty_eps)) {
         /* Some endpoints are not flushed yet. Take the endpoint from the list
          * and start flush operation on it. */
-        ep = ucp_worker_flush_req_set_next_ep(req, 1, next_ep->ep_list.next);
+        ep = ucp_worker_flush_req_set_next_ep(req, 1, next_ep->dirty_list.next);
         if (ep == NULL) {
             goto out;
         }
 
+        /* Operations issued from now on are not covered by this flush */
+        UCS_ASYNC_BLOCK(&worker->async);
+        ucp_ep_update_flags(ep, 0, UCP_EP_FLAG_RMA_DIRTY);
+        UCS_ASYNC_UNBLOCK(&worker->async);
+
         ep_flush_request = ucp_ep_flush_internal(ep, UCP_REQUEST_FLAG_RELEASED,
                                                  &ucp_request_null_param, req,
                                                  ucp_worker_flush_ep_flushed_cb,
@@ -552,8 +614,12 @@ ucp_worker_flush_nbx_internal(ucp_worker_h worker,
 
     if (!worker->flush_ops_count) {
         status = ucp_worker_flush_check(worker);
-        if ((status != UCS_INPROGRESS) && (status != UCS_ERR_NO_RESOURCE)) {
-            /* UCS_OK is returned here as well */
+        if (status == UCS_OK) {
+            /* All RMA/AMO operations are completed */
+            ucp_worker_flush_dirty_eps_cleanup(worker, 1);
+            return UCS_STATUS_PTR(UCS_OK);
+        } else if ((status != UCS_INPROGRESS) &&
+                   (status != UCS_ERR_NO_RESOURCE)) {
             return UCS_STATUS_PTR(status);
         }
     }
@@ -568,7 +634,8 @@ ucp_worker_flush_nbx_internal(ucp_worker_h worker,
                                          when finished going over all endpoints */
     req->flush_worker.prog_id    = UCS_CALLBACKQ_ID_NULL;
 
-    ucp_worker_flush_req_set_next_ep(req, 0, worker->all_eps.next);
+    ++worker->flush_worker_count;
+    ucp_worker_flush_req_set_next_ep(req, 0, worker->dirty_eps.next);
     ucp_request_set_send_callback_param(param, req, flush_worker);
     uct_worker_progress_register_safe(worker->uct, ucp_worker_flush_progress,
                                       req, 0, &req->flush_worker.prog_id);
@@ -643,6 +710,8 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_worker_fence, (worker), ucp_worker_h worker)
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
+    ++worker->fence_sn;
+
     UCS_BITMAP_FOR_EACH_BIT(worker->context->tl_bitmap, rsc_index) {
         wiface = ucp_worker_iface(worker, rsc_index);
         if (wiface->iface == NULL) {
@@ -76,6 +76,25 @@ typedef struct {
 } UCS_S_PACKED ucp_atomic_req_hdr_t;
 
 
+/**
+ * Batch of software atomic operations, followed by the operations
+ */
+typedef struct {
+    ucp_request_hdr_t         req; /* invalid req_id if no reply */
+    uint8_t                   count;
+} UCS_S_PACKED ucp_atomic_batch_hdr_t;
+
+
+/**
+ * Atomic operation in a batch, followed by its arguments
+ */
+typedef struct {
+    uint64_t                  address;
+    uint8_t                   length;
+    uint8_t                   opcode;
+} UCS_S_PACKED ucp_atomic_batch_op_t;
+
+
 extern ucp_rma_proto_t ucp_rma_basic_proto;
 extern ucp_rma_proto_t ucp_rma_sw_proto;
 extern ucp_amo_proto_t ucp_amo_basic_proto;
@@ -90,6 +109,15 @@ void ucp_ep_flush_remote_completed(ucp_request_t *req);
 
 void ucp_rma_sw_send_cmpl(ucp_ep_h ep);
 
+void ucp_amo_sw_batch_release(ucp_ep_h ep);
+
+void ucp_amo_sw_batch_purge(ucp_ep_h ep, ucs_status_t status);
+
+void ucp_ep_rma_add_dirty(ucp_ep_h ep);
+
+void ucp_rma_request_counter_cb(void *request, ucs_status_t status,
+                                void *user_data);
+
 /*
  * Check RMA protocol requirements
  */
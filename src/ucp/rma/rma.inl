@@ -53,6 +53,57 @@ ucp_rma_send_request(ucp_request_t *req, const ucp_request_param_t *param)
     return req + 1;
 }
 
+#define UCP_RMA_CHECK_COUNTER(_param, _action) \
+    if (ENABLE_PARAMS_CHECK && \
+        ucs_unlikely(((_param)->op_attr_mask & UCP_OP_ATTR_FIELD_COUNTER) && \
+                     ((_param)->op_attr_mask & (UCP_OP_ATTR_FIELD_REQUEST | \
+                                                UCP_OP_ATTR_FIELD_CALLBACK)))) { \
+        ucs_error("completion counter cannot be used with a request or a " \
+                  "callback"); \
+        _action; \
+    }
+
+
+/*
+ * If the user asked for a completion counter, release the request of an
+ * operation which did not complete immediately, and increment the counter from
+ * its completion callback.
+ */
+static UCS_F_ALWAYS_INLINE ucs_status_ptr_t
+ucp_rma_counter_track(ucs_status_ptr_t status_p,
+                      const ucp_request_param_t *param)
+{
+    ucp_request_t *req;
+    ucs_status_t status;
+
+    if (ucs_likely(!(param->op_attr_mask & UCP_OP_ATTR_FIELD_COUNTER))) {
+        return status_p;
+    }
+
+    if (!UCS_PTR_IS_PTR(status_p)) {
+        if (status_p == UCS_STATUS_PTR(UCS_OK)) {
+            ++(*param->counter);
+        }
+        return status_p;
+    }
+
+    req = (ucp_request_t*)status_p - 1;
+    if (req->flags & UCP_REQUEST_FLAG_COMPLETED) {
+        /* Immediate completion was prohibited by the user */
+        status = req->status;
+        ucp_request_put(req);
+        if (status == UCS_OK) {
+            ++(*param->counter);
+        }
+        return UCS_STATUS_PTR(status);
+    }
+
+    ucp_request_set_callback(req, send.cb, ucp_rma_request_counter_cb,
+                             param->counter);
+    req->flags |= UCP_REQUEST_FLAG_RELEASED;
+    return UCS_STATUS_PTR(UCS_OK);
+}
+
 static inline ucs_status_t ucp_rma_wait(ucp_worker_h worker, void *user_req,
                                         const char *op_name)
 {
@@ -76,6 +127,17 @@ static inline ucs_status_t ucp_rma_wait(ucp_worker_h worker, void *user_req,
     }
 }
 
+/*
+ * Make the endpoint visible to worker flush, which goes over only the endpoints
+ * which issued RMA/AMO operations since it was flushed last time.
+ */
+static UCS_F_ALWAYS_INLINE void ucp_ep_rma_mark_dirty(ucp_ep_h ep)
+{
+    if (ucs_unlikely(!(ep->flags & UCP_EP_FLAG_RMA_DIRTY))) {
+        ucp_ep_rma_add_dirty(ep);
+    }
+}
+
 static inline void ucp_ep_rma_remote_request_sent(ucp_ep_t *ep)
 {
     ++ucp_ep_flush_state(ep)->send_sn;
@@ -86,6 +148,12 @@ static inline void ucp_ep_rma_remote_request_completed(ucp_ep_t *ep)
     ucp_ep_flush_state_t *flush_state = ucp_ep_flush_state(ep);
     ucp_request_t *req;
 
+    if (ucs_unlikely(ucp_ep_ext_control(ep)->amo.batch != NULL)) {
+        /* Send atomics which were held until the peer completes previous
+         * operations, before they are counted as completed */
+        ucp_amo_sw_batch_release(ep);
+    }
+
     ucp_worker_flush_ops_count_dec(ep->worker);
     ++flush_state->cmpl_sn;
 
@@ -44,11 +44,14 @@
     } while (0)
 
 
-#define UCP_RMA_CHECK_PTR(_context, _buffer, _length) \
+#define UCP_RMA_CHECK_PTR(_context, _buffer, _length, _param) \
     do { \
         UCP_CONTEXT_CHECK_FEATURE_FLAGS(_context, UCP_FEATURE_RMA, \
                                         return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM)); \
-        UCP_RMA_CHECK_ZERO_LENGTH(_length, return NULL); \
+        UCP_RMA_CHECK_COUNTER(_param, \
+                              return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM)); \
+        UCP_RMA_CHECK_ZERO_LENGTH(_length, \
+                                  return ucp_rma_counter_track(NULL, _param)); \
         UCP_RMA_CHECK_BUFFER(_buffer, \
                              return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM)); \
     } while (0)
@@ -131,6 +134,12 @@ static void ucp_rma_request_zcopy_completion(uct_completion_t *self)
     }
 }
 
+void ucp_rma_request_counter_cb(void *request, ucs_status_t status,
+                                void *user_data)
+{
+    ++(*(uint64_t*)user_data);
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_t
 ucp_rma_request_init(ucp_request_t *req, ucp_ep_h ep, const void *buffer,
                      size_t length, uint64_t remote_addr, ucp_rkey_h rkey,
@@ -247,7 +256,7 @@ ucs_status_ptr_t ucp_put_nbx(ucp_ep_h ep, const void *buffer, size_t count,
     ucp_request_t *req;
 
     UCP_RMA_CHECK_CONTIG1(param);
-    UCP_RMA_CHECK_PTR(worker->context, buffer, count);
+    UCP_RMA_CHECK_PTR(worker->context, buffer, count, param);
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
     ucs_trace_req("put_nbx buffer %p count %zu remote_addr %"PRIx64" rkey %p to %s cb %p",
@@ -255,6 +264,9 @@ ucs_status_ptr_t ucp_put_nbx(ucp_ep_h ep, const void *buffer, size_t count,
                    (param->op_attr_mask & UCP_OP_ATTR_FIELD_CALLBACK) ?
                    param->cb.send : NULL);
 
+    UCP_EP_RESOLVE_LAZY(ep, ret, goto out_unlock);
+    ucp_ep_rma_mark_dirty(ep);
+
     if (worker->context->config.ext.proto_enable) {
         status = ucp_put_send_short(ep, buffer, count, remote_addr, rkey, param);
         if (ucs_likely(status != UCS_ERR_NO_RESOURCE)) {
@@ -304,6 +316,7 @@ ucs_status_ptr_t ucp_put_nbx(ucp_ep_h ep, const void *buffer, size_t count,
     }
 
 out_unlock:
+    ret = ucp_rma_counter_track(ret, param);
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
     return ret;
 }
@@ -352,7 +365,7 @@ ucs_status_ptr_t ucp_get_nbx(ucp_ep_h ep, void *buffer, size_t count,
         return UCS_STATUS_PTR(UCS_ERR_NO_RESOURCE);
     }
 
-    UCP_RMA_CHECK_PTR(worker->context, buffer, count);
+    UCP_RMA_CHECK_PTR(worker->context, buffer, count, param);
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
     ucs_trace_req("get_nbx buffer %p count %zu remote_addr %"PRIx64" rkey %p from %s cb %p",
@@ -360,6 +373,9 @@ ucs_status_ptr_t ucp_get_nbx(ucp_ep_h ep, void *buffer, size_t count,
                    (param->op_attr_mask & UCP_OP_ATTR_FIELD_CALLBACK) ?
                    param->cb.send : NULL);
 
+    UCP_EP_RESOLVE_LAZY(ep, ret, goto out_unlock);
+    ucp_ep_rma_mark_dirty(ep);
+
     if (worker->context->config.ext.proto_enable) {
         req = ucp_request_get_param(worker, param,
                                     {ret = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
@@ -387,6 +403,7 @@ ucs_status_ptr_t ucp_get_nbx(ucp_ep_h ep, void *buffer, size_t count,
     }
 
 out_unlock:
+    ret = ucp_rma_counter_track(ret, param);
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
     return ret;
 }
@@ -175,6 +175,7 @@ ucp_proto_rndv_ctrl_init(const ucp_proto_rndv_ctrl_init_params_t *params)
     params->super.super.caps->cfg_thresh   = params->super.cfg_thresh;
     params->super.super.caps->cfg_priority = params->super.cfg_priority;
     params->super.super.caps->min_length   = 0;
+    params->super.super.caps->lane_map     = UCS_BIT(rpriv->lane);
     params->super.super.caps->num_ranges   = 0;
 
     /* Copy performance ranges from the remote protocol, and add overheads */
@@ -448,6 +448,10 @@ ucp_rndv_progress_rma_zcopy_common(ucp_request_t *req, ucp_lane_index_t lane,
     ucs_assert_always(req->send.lane != UCP_NULL_LANE);
     ucs_assert_always(req->send.rndv.lanes_count > 0);
 
+    if (ucp_request_tx_sched_yield(req)) {
+        return UCS_INPROGRESS;
+    }
+
     if (req->send.mdesc == NULL) {
         status = ucp_send_request_add_reg_lane(req, lane);
         ucs_assert_always(status == UCS_OK);
@@ -511,6 +515,7 @@ ucp_rndv_progress_rma_zcopy_common(ucp_request_t *req, ucp_lane_index_t lane,
 
         ucp_request_send_state_advance(req, &state, proto, status);
         if (req->send.state.dt.offset == req->send.length) {
+            ucp_request_tx_sched_update(req, length, 1);
             if (req->send.state.uct_comp.count == 0) {
                 uct_completion_update_status(&req->send.state.uct_comp, status);
                 req->send.state.uct_comp.func(&req->send.state.uct_comp);
@@ -518,6 +523,7 @@ ucp_rndv_progress_rma_zcopy_common(ucp_request_t *req, ucp_lane_index_t lane,
             return UCS_OK;
         } else if (!UCS_STATUS_IS_ERR(status)) {
             /* return in_progress status in case if not all chunks are transmitted */
+            ucp_request_tx_sched_update(req, length, 0);
             ucp_rndv_zcopy_next_lane(req);
             return UCS_INPROGRESS;
         } else {
@@ -820,55 +826,32 @@ static ucs_status_t ucp_rndv_req_send_rma_get(ucp_request_t *rndv_req,
     return UCS_OK;
 }
 
+static void ucp_rndv_recv_pipeline_progress(ucp_request_t *rndv_req);
+
 UCS_PROFILE_FUNC_VOID(ucp_rndv_recv_frag_put_completion, (self),
                       uct_completion_t *self)
 {
     ucp_request_t *freq     = ucs_container_of(self, ucp_request_t,
                                                send.state.uct_comp);
-    /* if the super request is a receive request, it means that's used RNDV
-     * scheme is PUT pipeline protocol, otherwise - GET pipeline protocol (where
-     * the super request is an intermidate RNDV request) */
-    int is_put_proto        = freq->super_req->flags &
-                              (UCP_REQUEST_FLAG_RECV_TAG |
-                               UCP_REQUEST_FLAG_RECV_AM);
-    ucp_request_t *rreq     = NULL;
-    ucp_request_t *rndv_req = NULL;
+    /* the super request is an intermediate RNDV request which drives either
+     * the GET or the PUT pipeline protocol */
+    ucp_request_t *rndv_req = freq->super_req;
+    ucp_request_t *rreq     = rndv_req->super_req;
+
+    ucs_trace_req("freq:%p: recv_frag_put done, rndv_req:%p rreq:%p", freq,
+                  rndv_req, rreq);
 
     /* release memory descriptor */
     ucs_mpool_put_inline((void*)freq->send.mdesc);
 
-    /* rndv_req is NULL in case of put protocol */
-    if (!is_put_proto) {
-        ucs_trace_req("freq:%p: recv_frag_put done, nrdv_req:%p rreq:%p ", freq,
-                      rndv_req, rreq);
-
-        rndv_req = freq->super_req;
-        rreq     = rndv_req->super_req;
-
-        /* pipeline recv get protocol */
-        rndv_req->send.state.dt.offset += freq->send.length;
-
-        /* send ATS for fragment get rndv completion */
-        if (rndv_req->send.length == rndv_req->send.state.dt.offset) {
-            ucp_rkey_destroy(rndv_req->send.rndv.rkey);
-            ucp_rndv_req_send_ack(rndv_req, rreq,
-                                  rndv_req->send.rndv.remote_req_id,
-                                  UCS_OK, UCP_AM_ID_RNDV_ATS, "send_ats");
-        }
-    } else {
-        ucs_trace_req("freq:%p: recv_frag_put done, rreq:%p ", freq, rreq);
-        rreq = freq->super_req;
-    }
-
     ucs_assertv(rreq->recv.remaining >= freq->send.length,
                 "rreq->recv.remaining %zu, freq->send.length %zu",
                 rreq->recv.remaining, freq->send.length);
     rreq->recv.remaining -= freq->send.length;
-    if (rreq->recv.remaining == 0) {
-        ucp_rndv_recv_req_complete(rreq, UCS_OK);
-    }
-
     ucp_request_put(freq);
+
+    /* issue the next fragments, or complete the receive request */
+    ucp_rndv_recv_pipeline_progress(rndv_req);
 }
 
 static UCS_F_ALWAYS_INLINE void
@@ -1038,75 +1021,56 @@ UCS_PROFILE_FUNC_VOID(ucp_rndv_recv_frag_get_completion, (self),
                                     freq->send.length, offset);
 }
 
-static ucs_status_t
-ucp_rndv_recv_start_get_pipeline(ucp_worker_h worker, ucp_request_t *rndv_req,
-                                 ucp_request_t *rreq,
-                                 ucs_ptr_map_key_t remote_req_id,
-                                 const void *rkey_buffer,
-                                 uint64_t remote_address, size_t size,
-                                 size_t base_offset)
+/*
+ * The RNDV request which drives a receive pipeline keeps the offset of the next
+ * fragment to issue in its send state, while the receive request keeps the
+ * amount of data which was not completed yet.
+ */
+static UCS_F_ALWAYS_INLINE int
+ucp_rndv_pipeline_can_issue(const ucp_request_t *rndv_req, size_t max_frag_size)
 {
-    ucp_ep_h ep             = rndv_req->send.ep;
-    ucp_ep_config_t *config = ucp_ep_config(ep);
-    ucp_context_h context   = worker->context;
-    ucs_status_t status;
-    size_t max_frag_size, offset, length;
-    size_t min_zcopy, max_zcopy;
-
-    min_zcopy                          = config->rndv.get_zcopy.min;
-    max_zcopy                          = config->rndv.get_zcopy.max;
-    max_frag_size                      = ucs_min(context->config.ext.rndv_frag_size,
-                                                 max_zcopy);
-    rndv_req->super_req                = rreq;
-    rndv_req->send.rndv.remote_req_id  = remote_req_id;
-    rndv_req->send.rndv.remote_address = remote_address - base_offset;
-    rndv_req->send.length              = size;
-    rndv_req->send.state.dt.offset     = 0;
-    rndv_req->send.mem_type            = rreq->recv.mem_type;
-    rndv_req->send.pending_lane        = UCP_NULL_LANE;
-
-    /* Protocol:
-     * Step 1: GET remote fragment into HOST fragment buffer
-     * Step 2: PUT from fragment buffer to MEM TYPE destination
-     * Step 3: Send ATS for RNDV request
-     */
-
-    status = ucp_ep_rkey_unpack(rndv_req->send.ep, rkey_buffer,
-                                &rndv_req->send.rndv.rkey);
-    if (ucs_unlikely(status != UCS_OK)) {
-        ucs_fatal("failed to unpack rendezvous remote key received from %s: %s",
-                  ucp_ep_peer_name(rndv_req->send.ep), ucs_status_string(status));
-    }
-
-    ucp_rndv_req_init_zcopy_lane_map(rndv_req, rndv_req->send.mem_type,
-                                     UCP_REQUEST_SEND_PROTO_RNDV_GET);
+    ucp_context_h context = rndv_req->send.ep->worker->context;
+    size_t inflight       = rndv_req->send.state.dt.offset -
+                            (rndv_req->send.length -
+                             rndv_req->super_req->recv.remaining);
+
+    return (rndv_req->send.state.dt.offset < rndv_req->send.length) &&
+           (ucs_div_round_up(inflight, max_frag_size) <
+            context->config.ext.rndv_pipeline_depth);
+}
 
-    offset = 0;
-    while (offset != size) {
+static void ucp_rndv_recv_get_pipeline_issue(ucp_request_t *rndv_req)
+{
+    ucp_ep_config_t *config = ucp_ep_config(rndv_req->send.ep);
+    ucp_context_h context   = rndv_req->send.ep->worker->context;
+    size_t min_zcopy        = config->rndv.get_zcopy.min;
+    size_t max_frag_size    = ucs_min(context->config.ext.rndv_frag_size,
+                                      config->rndv.get_zcopy.max);
+    size_t offset, length;
+
+    while (ucp_rndv_pipeline_can_issue(rndv_req, max_frag_size)) {
+        offset = rndv_req->send.state.dt.offset;
         length = ucp_rndv_adjust_zcopy_length(min_zcopy, max_frag_size, 0,
-                                              size, offset, size - offset);
+                                              rndv_req->send.length, offset,
+                                              rndv_req->send.length - offset);
+        rndv_req->send.state.dt.offset += length;
 
         /* GET remote fragment into HOST fragment buffer */
         ucp_rndv_send_frag_get_mem_type(rndv_req, length,
-                                        remote_address + offset,
+                                        rndv_req->send.rndv.remote_address +
+                                        offset,
                                         UCS_MEMORY_TYPE_HOST,
                                         rndv_req->send.rndv.rkey,
                                         rndv_req->send.rndv.rkey_index,
                                         rndv_req->send.rndv.lanes_map_all, 0,
                                         ucp_rndv_recv_frag_get_completion);
-
-        offset += length;
     }
-
-    return UCS_OK;
 }
 
-static void ucp_rndv_send_frag_rtr(ucp_worker_h worker, ucp_request_t *rndv_req,
-                                   ucp_request_t *rreq,
-                                   const ucp_rndv_rts_hdr_t *rndv_rts_hdr)
+static void ucp_rndv_send_frag_rtr_issue(ucp_request_t *rndv_req)
 {
+    ucp_worker_h worker  = rndv_req->send.ep->worker;
     size_t max_frag_size = worker->context->config.ext.rndv_frag_size;
-    int i, num_frags;
     size_t frag_size;
     size_t offset;
     ucp_mem_desc_t *mdesc;
@@ -1115,13 +1079,10 @@ static void ucp_rndv_send_frag_rtr(ucp_worker_h worker, ucp_request_t *rndv_req,
     unsigned md_index;
     unsigned memh_index;
 
-    ucp_trace_req(rreq, "using rndv pipeline protocol rndv_req %p", rndv_req);
-
-    offset    = 0;
-    num_frags = ucs_div_round_up(rndv_rts_hdr->size, max_frag_size);
-
-    for (i = 0; i < num_frags; i++) {
-        frag_size = ucs_min(max_frag_size, (rndv_rts_hdr->size - offset));
+    while (ucp_rndv_pipeline_can_issue(rndv_req, max_frag_size)) {
+        offset    = rndv_req->send.state.dt.offset;
+        frag_size = ucs_min(max_frag_size, rndv_req->send.length - offset);
+        rndv_req->send.state.dt.offset += frag_size;
 
         /* internal fragment recv request allocated on receiver side to receive
          *  put fragment from sender and to perform a put to recv buffer */
@@ -1148,7 +1109,7 @@ static void ucp_rndv_send_frag_rtr(ucp_worker_h worker, ucp_request_t *rndv_req,
         freq->recv.length                 = frag_size;
         freq->recv.state.dt.contig.md_map = 0;
         freq->recv.frag.offset            = offset;
-        freq->super_req                   = rreq;
+        freq->super_req                   = rndv_req;
         freq->flags                       = UCP_REQUEST_FLAG_RNDV_FRAG;
 
         memh_index = 0;
@@ -1164,13 +1125,110 @@ static void ucp_rndv_send_frag_rtr(ucp_worker_h worker, ucp_request_t *rndv_req,
         frndv_req->send.ep           = rndv_req->send.ep;
         frndv_req->send.pending_lane = UCP_NULL_LANE;
 
-        ucp_rndv_req_send_rtr(frndv_req, freq, rndv_rts_hdr->sreq.req_id,
+        ucp_rndv_req_send_rtr(frndv_req, freq,
+                              rndv_req->send.rndv.remote_req_id,
                               freq->recv.length, offset);
-        offset += frag_size;
     }
+}
+
+/*
+ * Issue more fragments of a receive pipeline protocol, or complete the receive
+ * request when all fragments were completed. The GET pipeline holds the remote
+ * key of the sender buffer, and sends ATS when all fragments are completed.
+ * The PUT pipeline sends RTR for every fragment, and the sender completes its
+ * request when all fragments were sent.
+ */
+static void ucp_rndv_recv_pipeline_progress(ucp_request_t *rndv_req)
+{
+    ucp_request_t *rreq = rndv_req->super_req;
+    int is_get_proto    = (rndv_req->send.rndv.rkey != NULL);
+
+    /* a fragment was completed while issuing the next fragments, the
+     * outer call will continue */
+    if (rndv_req->flags & UCP_REQUEST_FLAG_RNDV_PPLN_ISSUE) {
+        return;
+    }
+
+    rndv_req->flags |= UCP_REQUEST_FLAG_RNDV_PPLN_ISSUE;
+    if (is_get_proto) {
+        ucp_rndv_recv_get_pipeline_issue(rndv_req);
+    } else {
+        ucp_rndv_send_frag_rtr_issue(rndv_req);
+    }
+    rndv_req->flags &= ~UCP_REQUEST_FLAG_RNDV_PPLN_ISSUE;
+
+    if (rreq->recv.remaining != 0) {
+        return;
+    }
+
+    if (is_get_proto) {
+        /* send ATS for fragment get rndv completion */
+        ucp_rkey_destroy(rndv_req->send.rndv.rkey);
+        ucp_rndv_req_send_ack(rndv_req, rreq,
+                              rndv_req->send.rndv.remote_req_id, UCS_OK,
+                              UCP_AM_ID_RNDV_ATS, "send_ats");
+    } else {
+        /* release original rndv reply request */
+        ucp_request_put(rndv_req);
+    }
+
+    ucp_rndv_recv_req_complete(rreq, UCS_OK);
+}
+
+static void
+ucp_rndv_recv_start_get_pipeline(ucp_worker_h worker, ucp_request_t *rndv_req,
+                                 ucp_request_t *rreq,
+                                 ucs_ptr_map_key_t remote_req_id,
+                                 const void *rkey_buffer,
+                                 uint64_t remote_address, size_t size)
+{
+    ucs_status_t status;
+
+    rndv_req->super_req                = rreq;
+    rndv_req->send.rndv.remote_req_id  = remote_req_id;
+    rndv_req->send.rndv.remote_address = remote_address;
+    rndv_req->send.length              = size;
+    rndv_req->send.state.dt.offset     = 0;
+    rndv_req->send.mem_type            = rreq->recv.mem_type;
+    rndv_req->send.pending_lane        = UCP_NULL_LANE;
+
+    /* Protocol:
+     * Step 1: GET remote fragment into HOST fragment buffer
+     * Step 2: PUT from fragment buffer to MEM TYPE destination
+     * Step 3: Send ATS for RNDV request
+     *
+     * At most RNDV_PIPELINE_DEPTH fragments are in flight, the next ones are
+     * issued when the previous are completed.
+     */
+
+    status = ucp_ep_rkey_unpack(rndv_req->send.ep, rkey_buffer,
+                                &rndv_req->send.rndv.rkey);
+    if (ucs_unlikely(status != UCS_OK)) {
+        ucs_fatal("failed to unpack rendezvous remote key received from %s: %s",
+                  ucp_ep_peer_name(rndv_req->send.ep), ucs_status_string(status));
+    }
+
+    ucp_rndv_req_init_zcopy_lane_map(rndv_req, rndv_req->send.mem_type,
+                                     UCP_REQUEST_SEND_PROTO_RNDV_GET);
+
+    ucp_rndv_recv_pipeline_progress(rndv_req);
+}
+
+static void ucp_rndv_send_frag_rtr(ucp_worker_h worker, ucp_request_t *rndv_req,
+                                   ucp_request_t *rreq,
+                                   const ucp_rndv_rts_hdr_t *rndv_rts_hdr)
+{
+    ucp_trace_req(rreq, "using rndv pipeline protocol rndv_req %p", rndv_req);
+
+    /* the original rndv reply request tracks the fragments, and sends RTR for
+     * each of them; it does not hold a remote key */
+    rndv_req->super_req               = rreq;
+    rndv_req->send.rndv.remote_req_id = rndv_rts_hdr->sreq.req_id;
+    rndv_req->send.rndv.rkey          = NULL;
+    rndv_req->send.length             = rndv_rts_hdr->size;
+    rndv_req->send.state.dt.offset    = 0;
 
-    /* release original rndv reply request */
-    ucp_request_put(rndv_req);
+    ucp_rndv_recv_pipeline_progress(rndv_req);
 }
 
 static UCS_F_ALWAYS_INLINE int
@@ -1412,7 +1470,7 @@ UCS_PROFILE_FUNC_VOID(ucp_rndv_receive, (worker, rreq, rndv_rts_hdr, rkey_buf),
                                                      rndv_rts_hdr->sreq.req_id,
                                                      rkey_buf,
                                                      rndv_rts_hdr->address,
-                                                     rndv_rts_hdr->size, 0);
+                                                     rndv_rts_hdr->size);
                 }
                 goto out;
             }
@@ -1818,10 +1876,11 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_atp_handler,
     ucp_request_put(rtr_sreq);
 
     if (req->flags & UCP_REQUEST_FLAG_RNDV_FRAG) {
-        /* received ATP for frag RTR request */
+        /* received ATP for frag RTR request, the super request is the RNDV
+         * request which drives the pipeline */
         ucs_assert(req->super_req != NULL);
         UCS_PROFILE_REQUEST_EVENT(req, "rndv_frag_atp_recv", 0);
-        ucp_rndv_recv_frag_put_mem_type(req->super_req, req,
+        ucp_rndv_recv_frag_put_mem_type(req->super_req->super_req, req,
                                         (ucp_mem_desc_t*)req->recv.buffer - 1,
                                         req->recv.length,
                                         req->recv.frag.offset);
@@ -196,6 +196,58 @@ ucp_stream_rdesc_advance(ucp_recv_desc_t *rdesc, ssize_t offset,
     return UCS_OK;
 }
 
+static UCS_F_ALWAYS_INLINE void
+ucp_stream_recv_complete(ucp_request_t *req, ucp_ep_ext_proto_t *ep_ext,
+                         ucs_status_t status)
+{
+    uct_worker_progress_unregister_safe(req->recv.worker->uct,
+                                        &req->recv.stream.prog_id);
+    ucp_request_complete_stream_recv(req, ep_ext, status);
+}
+
+static unsigned ucp_stream_recv_deferred_progress(void *arg)
+{
+    ucp_request_t *req = arg;
+
+    ucs_trace_req("stream receive request %p: deferred completion with %zu "
+                  "bytes", req, req->recv.stream.offset);
+    ucp_stream_recv_complete(req, ucp_ep_ext_proto(req->recv.stream.ep),
+                             UCS_OK);
+    return 1;
+}
+
+/*
+ * Whether the completion of a stream receive request which may be completed
+ * should be deferred, to let more incoming messages fill it without an extra
+ * copy. Generic datatype state is finished by the first partial unpack, so it
+ * can't be continued.
+ */
+static UCS_F_ALWAYS_INLINE int
+ucp_stream_recv_is_deferred(ucp_request_t *req)
+{
+    return req->recv.worker->context->config.ext.stream_recv_coalesce &&
+           (req->recv.stream.offset < req->recv.length) &&
+           !UCP_DT_IS_GENERIC(req->recv.datatype);
+}
+
+/* Complete a stream receive request which got some data and may be completed */
+static UCS_F_ALWAYS_INLINE void
+ucp_stream_recv_complete_or_defer(ucp_request_t *req,
+                                  ucp_ep_ext_proto_t *ep_ext)
+{
+    ucp_worker_h worker = req->recv.worker;
+
+    if (!ucp_stream_recv_is_deferred(req)) {
+        ucp_stream_recv_complete(req, ep_ext, UCS_OK);
+        return;
+    }
+
+    uct_worker_progress_register_safe(worker->uct,
+                                      ucp_stream_recv_deferred_progress, req,
+                                      0, &req->recv.stream.prog_id);
+    ucp_worker_signal_internal(worker);
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_t ucp_stream_process_rdesc_inplace(
         ucp_recv_desc_t *rdesc, ucp_datatype_t dt, void *buffer, size_t count,
         size_t length, const ucp_request_param_t *param,
@@ -243,8 +295,10 @@ ucp_stream_recv_request_init(ucp_request_t *req, ucp_ep_h ep, void *buffer,
 #if UCS_ENABLE_ASSERT
     req->status             = UCS_OK; /* for ucp_request_recv_data_unpack() */
 #endif
-    req->recv.stream.length = 0;
-    req->recv.stream.offset = 0;
+    req->recv.stream.length  = 0;
+    req->recv.stream.offset  = 0;
+    req->recv.stream.ep      = ep;
+    req->recv.stream.prog_id = UCS_CALLBACKQ_ID_NULL;
 
     ucp_dt_recv_state_init(&req->recv.state, buffer, datatype, count);
 
@@ -380,11 +434,16 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_recv_nbx,
 
     ucs_assert(req->recv.stream.offset <= req->recv.length);
 
-    if (ucp_request_can_complete_stream_recv(req)) {
+    if (ucp_request_can_complete_stream_recv(req) &&
+        !ucp_stream_recv_is_deferred(req)) {
         *length = req->recv.stream.offset;
     } else {
         ucs_assert(!ucp_stream_ep_has_data(ep_ext));
         ucs_queue_push(&ep_ext->stream.match_q, &req->recv.queue);
+        if (ucp_request_can_complete_stream_recv(req)) {
+            /* Let more incoming data be placed to the request */
+            ucp_stream_recv_complete_or_defer(req, ep_ext);
+        }
         req += 1;
         goto out;
     }
@@ -428,14 +487,14 @@ ucp_stream_am_data_process(ucp_worker_t *worker, ucp_ep_ext_proto_t *ep_ext,
                           am_data, rdesc_tmp.payload_offset, req);
             } else if (unpacked == rdesc_tmp.length) {
                 if (ucp_request_can_complete_stream_recv(req)) {
-                    ucp_request_complete_stream_recv(req, ep_ext, UCS_OK);
+                    ucp_stream_recv_complete_or_defer(req, ep_ext);
                 }
                 return UCS_OK;
             }
             ucp_stream_rdesc_advance(&rdesc_tmp, unpacked, ep_ext);
             /* This request is full, try next one */
             ucs_assert(ucp_request_can_complete_stream_recv(req));
-            ucp_request_complete_stream_recv(req, ep_ext, UCS_OK);
+            ucp_stream_recv_complete(req, ep_ext, UCS_OK);
         }
     }
 
@@ -507,7 +566,7 @@ void ucp_stream_ep_cleanup(ucp_ep_h ep)
     while (!ucs_queue_is_empty(&ep_ext->stream.match_q)) {
         req = ucs_queue_head_elem_non_empty(&ep_ext->stream.match_q,
                                             ucp_request_t, recv.queue);
-        ucp_request_complete_stream_recv(req, ep_ext, UCS_ERR_CANCELED);
+        ucp_stream_recv_complete(req, ep_ext, UCS_ERR_CANCELED);
     }
 }
 
@@ -134,6 +134,8 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_send_nbx,
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
 
+    UCP_EP_RESOLVE_LAZY(ep, ret, goto out);
+
     flags = ucp_request_param_flags(param);
 
     ucs_trace_req("stream_send_nbx buffer %p count %zu to %s cb %p flags %u",
@@ -59,7 +59,7 @@ void ucp_tag_match_cleanup(ucp_tag_match_t *tm)
     ucs_list_for_each_safe(rdesc, tmp_rdesc, &tm->unexpected.all,
                            tag_list[UCP_RDESC_ALL_LIST]) {
         ucs_warn("unexpected tag-receive descriptor %p was not matched", rdesc);
-        ucp_tag_unexp_remove(rdesc);
+        ucp_tag_unexp_remove(tm, rdesc);
         ucp_recv_desc_release(rdesc);
     }
 
@@ -138,10 +138,19 @@ ucp_tag_unexp_get_list_for_tag(ucp_tag_match_t *tm, ucp_tag_t tag)
 }
 
 static UCS_F_ALWAYS_INLINE void
-ucp_tag_unexp_remove(ucp_recv_desc_t *rdesc)
+ucp_tag_unexp_depth_update(ucp_tag_match_t *tm, int64_t value)
+{
+    ucp_worker_h worker = ucs_container_of(tm, ucp_worker_t, tm);
+
+    UCP_WORKER_COUNTER_ADD(worker, TAG_UNEXP_DEPTH, value);
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_tag_unexp_remove(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc)
 {
     ucs_list_del(&rdesc->tag_list[UCP_RDESC_HASH_LIST]);
     ucs_list_del(&rdesc->tag_list[UCP_RDESC_ALL_LIST] );
+    ucp_tag_unexp_depth_update(tm, -1);
 }
 
 static UCS_F_ALWAYS_INLINE void
@@ -152,6 +161,7 @@ ucp_tag_unexp_recv(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc, ucp_tag_t tag)
     hash_list = ucp_tag_unexp_get_list_for_tag(tm, tag);
     ucs_list_add_tail(hash_list,           &rdesc->tag_list[UCP_RDESC_HASH_LIST]);
     ucs_list_add_tail(&tm->unexpected.all, &rdesc->tag_list[UCP_RDESC_ALL_LIST]);
+    ucp_tag_unexp_depth_update(tm, 1);
 
     ucs_trace_req("unexp "UCP_RECV_DESC_FMT" tag %"PRIx64,
                   UCP_RECV_DESC_ARG(rdesc), tag);
@@ -202,7 +212,7 @@ ucp_tag_unexp_search(ucp_tag_match_t *tm, ucp_tag_t tag, uint64_t tag_mask,
                           "%s tag %"PRIx64"/%"PRIx64, UCP_RECV_DESC_ARG(rdesc),
                           title, tag, tag_mask);
             if (rem) {
-                ucp_tag_unexp_remove(rdesc);
+                ucp_tag_unexp_remove(tm, rdesc);
             }
             return rdesc;
         }
@@ -52,6 +52,7 @@ ucs_status_t ucp_tag_rndv_process_rts(ucp_worker_h worker,
         ucp_tag_rndv_matched(worker, rreq, rts_hdr);
 
         UCP_WORKER_STAT_RNDV(worker, EXP, 1);
+        UCP_WORKER_COUNTER_ADD(worker, TAG_RX_RNDV, 1);
         return UCS_OK;
     }
 
@@ -46,11 +46,12 @@ ucp_tag_get_rndv_threshold(const ucp_request_t *req, size_t count,
     return SIZE_MAX;
 }
 
-static UCS_F_ALWAYS_INLINE ucs_status_ptr_t
-ucp_tag_send_req(ucp_request_t *req, size_t dt_count,
-                 const ucp_ep_msg_config_t* msg_config,
-                 const ucp_request_param_t *param,
-                 const ucp_request_send_proto_t *proto)
+/* Select the send protocol for the request, without sending anything yet */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_tag_send_req_select(ucp_request_t *req, size_t dt_count,
+                        const ucp_ep_msg_config_t* msg_config,
+                        const ucp_request_param_t *param,
+                        const ucp_request_send_proto_t *proto)
 {
     ssize_t max_short          = ucp_proto_get_short_max(req, msg_config);
     ucp_ep_config_t *ep_config = ucp_ep_config(req->send.ep);
@@ -90,20 +91,34 @@ ucp_tag_send_req(ucp_request_t *req, size_t dt_count,
         /* Eager send initialized successfuly */
         if (req->flags & UCP_REQUEST_FLAG_SYNC) {
             ucp_request_id_alloc(req);
-            UCP_EP_STAT_TAG_OP(req->send.ep, EAGER_SYNC);
+            UCP_EP_STAT_TAG_OP(req->send.ep, EAGER_SYNC, req->send.length);
         } else {
-            UCP_EP_STAT_TAG_OP(req->send.ep, EAGER);
+            UCP_EP_STAT_TAG_OP(req->send.ep, EAGER, req->send.length);
         }
     } else if (status == UCS_ERR_NO_PROGRESS) {
         /* RMA/AM rendezvous */
         ucs_assert(req->send.length >= rndv_thresh);
         status = ucp_tag_send_start_rndv(req);
         if (status != UCS_OK) {
-            return UCS_STATUS_PTR(status);
+            return status;
         }
 
-        UCP_EP_STAT_TAG_OP(req->send.ep, RNDV);
-    } else {
+        UCP_EP_STAT_TAG_OP(req->send.ep, RNDV, req->send.length);
+    }
+
+    return status;
+}
+
+static UCS_F_ALWAYS_INLINE ucs_status_ptr_t
+ucp_tag_send_req(ucp_request_t *req, size_t dt_count,
+                 const ucp_ep_msg_config_t* msg_config,
+                 const ucp_request_param_t *param,
+                 const ucp_request_send_proto_t *proto)
+{
+    ucs_status_t status;
+
+    status = ucp_tag_send_req_select(req, dt_count, msg_config, param, proto);
+    if (status != UCS_OK) {
         return UCS_STATUS_PTR(status);
     }
 
@@ -165,7 +180,7 @@ ucp_tag_send_inline(ucp_ep_h ep, const void *buffer, size_t length, ucp_tag_t ta
     }
 
     if (status != UCS_ERR_NO_RESOURCE) {
-        UCP_EP_STAT_TAG_OP(ep, EAGER);
+        UCP_EP_STAT_TAG_OP(ep, EAGER, length);
     }
 
     return status;
@@ -245,6 +260,8 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_nbx,
     ucs_trace_req("send_nbx buffer %p count %zu tag %"PRIx64" to %s",
                   buffer, count, tag, ucp_ep_peer_name(ep));
 
+    UCP_EP_RESOLVE_LAZY(ep, ret, goto out);
+
     attr_mask = param->op_attr_mask &
                 (UCP_OP_ATTR_FIELD_DATATYPE | UCP_OP_ATTR_FLAG_NO_IMM_CMPL);
 
@@ -314,6 +331,8 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_sync_nbx,
     ucs_trace_req("send_sync_nbx buffer %p count %zu tag %"PRIx64" to %s",
                   buffer, count, tag, ucp_ep_peer_name(ep));
 
+    UCP_EP_RESOLVE_LAZY(ep, ret, goto out);
+
     datatype = ucp_request_param_datatype(param);
     if (!ucp_ep_config_test_rndv_support(ucp_ep_config(ep))) {
         ret = UCS_STATUS_PTR(UCS_ERR_UNSUPPORTED);
@@ -349,3 +368,221 @@ out:
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
     return ret;
 }
+
+static void ucp_tag_send_persistent_completion(void *request,
+                                               ucs_status_t status,
+                                               void *user_data)
+{
+    ucp_request_t *preq = user_data;
+
+    ucs_trace_req("persistent request %p completed, status %s", preq,
+                  ucs_status_string(status));
+    ucp_request_complete_send(preq, status);
+}
+
+/*
+ * Initialize a new send request from the saved state of a persistent request.
+ * The message length, memory type and protocol selection of contiguous and
+ * IOV datatypes were resolved once by ucp_tag_send_init_nbx().
+ */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_tag_send_persistent_req_init(ucp_request_t *req, ucp_request_t *preq)
+{
+    ucp_ep_h ep                    = preq->send.ep;
+    ucp_worker_h worker            = ep->worker;
+    const ucp_proto_config_t *proto_config;
+    ucp_request_param_t param;
+    ucp_proto_select_param_t sel_param;
+    uint8_t sg_count;
+
+    param.op_attr_mask = preq->send.persistent.op_attr_mask;
+    param.memory_type  = UCS_MEMORY_TYPE_UNKNOWN;
+
+    if (worker->context->config.ext.proto_enable) {
+        req->flags              = 0;
+        req->send.ep            = ep;
+        req->send.msg_proto.tag = preq->send.persistent.tag;
+
+        proto_config = preq->send.proto_config;
+        if (ucs_likely((proto_config != NULL) &&
+                       (proto_config->ep_cfg_index == ep->cfg_index))) {
+            req->send.state.dt_iter = preq->send.state.dt_iter;
+            req->send.proto_config  = proto_config;
+            req->send.uct.func      = proto_config->proto->progress;
+            return UCS_OK;
+        }
+
+        ucp_datatype_iter_init(worker->context, preq->send.buffer,
+                               preq->send.persistent.count,
+                               preq->send.datatype, preq->send.length,
+                               &req->send.state.dt_iter, &sg_count);
+        ucp_proto_select_param_init(&sel_param, UCP_OP_ID_TAG_SEND,
+                                    param.op_attr_mask,
+                                    req->send.state.dt_iter.dt_class,
+                                    &req->send.state.dt_iter.mem_info,
+                                    sg_count);
+        return ucp_proto_request_set_proto(worker, ep, req,
+                                           &ucp_ep_config(ep)->proto_select,
+                                           UCP_WORKER_CFG_INDEX_NULL,
+                                           &sel_param,
+                                           req->send.state.dt_iter.length);
+    }
+
+    if (ucs_unlikely(UCP_DT_IS_GENERIC(preq->send.datatype))) {
+        /* Generic datatype state must be created for every operation */
+        ucp_tag_send_req_init(req, ep, preq->send.buffer, preq->send.datatype,
+                              preq->send.persistent.count,
+                              preq->send.persistent.tag, 0, &param);
+    } else {
+        req->flags              = UCP_REQUEST_FLAG_SEND_TAG;
+        req->send.ep            = ep;
+        req->send.buffer        = preq->send.buffer;
+        req->send.datatype      = preq->send.datatype;
+        req->send.msg_proto.tag = preq->send.persistent.tag;
+        req->send.length        = preq->send.length;
+        req->send.mem_type      = preq->send.mem_type;
+        req->send.lane          = preq->send.lane;
+        req->send.pending_lane  = UCP_NULL_LANE;
+        ucp_request_send_state_init(req, preq->send.datatype,
+                                    preq->send.persistent.count);
+    }
+
+    return ucp_tag_send_req_select(req, preq->send.persistent.count,
+                                   &ucp_ep_config(ep)->tag.eager, &param,
+                                   ucp_ep_config(ep)->tag.proto);
+}
+
+UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_init_nbx,
+                 (ep, buffer, count, tag, param),
+                 ucp_ep_h ep, const void *buffer, size_t count,
+                 ucp_tag_t tag, const ucp_request_param_t *param)
+{
+    ucp_worker_h worker = ep->worker;
+    const ucp_proto_threshold_elem_t *thresh_elem;
+    ucp_proto_select_param_t sel_param;
+    ucp_request_t *req;
+    ucs_status_ptr_t ret;
+    uint8_t sg_count;
+
+    UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_TAG,
+                                    return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM));
+    UCP_REQUEST_CHECK_PARAM(param);
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    ucs_trace_req("send_init_nbx buffer %p count %zu tag %"PRIx64" to %s",
+                  buffer, count, tag, ucp_ep_peer_name(ep));
+
+    UCP_EP_RESOLVE_LAZY(ep, ret, goto out);
+
+    req = ucp_request_get_param(worker, param, {
+        ret = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
+        goto out;
+    });
+
+    /* An inactive persistent request is reported as completed */
+    req->flags                        = UCP_REQUEST_FLAG_PERSISTENT |
+                                        UCP_REQUEST_FLAG_SEND_TAG |
+                                        UCP_REQUEST_FLAG_COMPLETED;
+    req->status                       = UCS_OK;
+    req->send.ep                      = ep;
+    req->send.buffer                  = (void*)buffer;
+    req->send.datatype                = ucp_request_param_datatype(param);
+    req->send.proto_config            = NULL;
+    req->send.persistent.tag          = tag;
+    req->send.persistent.count        = count;
+    req->send.persistent.op_attr_mask = param->op_attr_mask &
+                                        UCP_OP_ATTR_FLAG_FAST_CMPL;
+
+    if (worker->context->config.ext.proto_enable) {
+        if (UCP_DT_IS_CONTIG(req->send.datatype)) {
+            req->send.length = ucp_contig_dt_length(req->send.datatype, count);
+            ucp_datatype_iter_init(worker->context, req->send.buffer, count,
+                                   req->send.datatype, req->send.length,
+                                   &req->send.state.dt_iter, &sg_count);
+            ucp_proto_select_param_init(&sel_param, UCP_OP_ID_TAG_SEND,
+                                        param->op_attr_mask,
+                                        req->send.state.dt_iter.dt_class,
+                                        &req->send.state.dt_iter.mem_info,
+                                        sg_count);
+            thresh_elem = ucp_proto_select_lookup(worker,
+                                                  &ucp_ep_config(ep)->proto_select,
+                                                  ep->cfg_index,
+                                                  UCP_WORKER_CFG_INDEX_NULL,
+                                                  &sel_param, req->send.length);
+            if (thresh_elem == NULL) {
+                ucp_request_put_param(param, req);
+                ret = UCS_STATUS_PTR(UCS_ERR_UNREACHABLE);
+                goto out;
+            }
+
+            req->send.proto_config = &thresh_elem->proto_config;
+        } else {
+            req->send.length = 0;
+        }
+    } else if (!UCP_DT_IS_GENERIC(req->send.datatype)) {
+        req->send.length   = ucp_dt_length(req->send.datatype, count,
+                                           req->send.buffer, NULL);
+        req->send.mem_type = ucp_request_get_memory_type(worker->context,
+                                                         req->send.buffer,
+                                                         req->send.length,
+                                                         param);
+        req->send.lane     = ucp_ep_config(ep)->tag.lane;
+    }
+
+    ucp_request_set_send_callback_param(param, req, send);
+    ucs_trace_req("returning persistent send request %p", req);
+    ret = req + 1;
+
+out:
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+    return ret;
+}
+
+UCS_PROFILE_FUNC(ucs_status_t, ucp_request_start, (request), void *request)
+{
+    ucp_request_t *preq = (ucp_request_t*)request - 1;
+    ucp_worker_h worker = preq->send.ep->worker;
+    ucs_status_t status;
+    ucp_request_t *req;
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    if (ucs_unlikely(!(preq->flags & UCP_REQUEST_FLAG_PERSISTENT))) {
+        ucs_error("request %p is not a persistent request", preq);
+        status = UCS_ERR_INVALID_PARAM;
+        goto out;
+    }
+
+    if (ucs_unlikely(!(preq->flags & UCP_REQUEST_FLAG_COMPLETED))) {
+        status = UCS_ERR_BUSY;
+        goto out;
+    }
+
+    req = ucp_request_get(worker);
+    if (ucs_unlikely(req == NULL)) {
+        status = UCS_ERR_NO_MEMORY;
+        goto out;
+    }
+
+    status = ucp_tag_send_persistent_req_init(req, preq);
+    if (ucs_unlikely(status != UCS_OK)) {
+        ucp_request_put(req);
+        goto out;
+    }
+
+    ucs_trace_req("starting persistent request %p with send request %p", preq,
+                  req);
+
+    /* The send request is released after it completes the persistent one */
+    preq->flags &= ~UCP_REQUEST_FLAG_COMPLETED;
+    preq->status = UCS_INPROGRESS;
+    req->flags  |= UCP_REQUEST_FLAG_RELEASED;
+    ucp_request_set_callback(req, send.cb, ucp_tag_send_persistent_completion,
+                             preq);
+    ucp_request_send(req, 0);
+
+out:
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+    return status;
+}
@@ -13,6 +13,7 @@
 
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_ep.inl>
+#include <ucs/algorithm/crc.h>
 #include <ucs/arch/bitops.h>
 #include <ucs/debug/log.h>
 #include <inttypes.h>
@@ -44,6 +45,26 @@
  *     UCP_ADDRESS_FLAG_LAST. For unified mode, there could not be more than one
  *     ep address.
  *   * For any mode, ep address is followed by a lane index.
+ *
+ *
+ * Compact (profile) address layout:
+ *
+ * [ header(8bit) | uuid(64bit) | worker_name(string) | profile_key(64bit) ]
+ * [ device1_address(var) | tl1_iface_address(var) | tl2_iface_address(var) ... ]
+ * [ device2_address(var) | ... ]
+ *
+ *   * The header has UCP_ADDRESS_HEADER_FLAG_PROFILE set.
+ *   * All the other fields - md index and flags, address lengths, number of
+ *     paths, transport name checksums and iface attributes - are packed in a
+ *     separate "profile" buffer, which is identical for all workers on similar
+ *     nodes, and only its key is sent:
+ *     [ device1_md_index | device1_address_length | device1_num_paths ]
+ *        [ tl1_name_csum | tl1_info | tl1_iface_address_length ]
+ *        ...
+ *     The LAST flags are set in device address length and iface address length.
+ *   * The receiver resolves the key to a profile it has decoded before, from
+ *     its own addresses, and takes from the packed address only the device
+ *     and iface addresses. Endpoint addresses are never packed in this format.
  */
 
 
@@ -89,6 +110,24 @@ typedef struct {
 } ucp_address_unified_iface_attr_t;
 
 
+/* Device of a decoded address profile */
+typedef struct {
+    uint8_t          dev_addr_len; /* Length of device address */
+    uint8_t          num_tls;      /* Number of address entries on the device */
+} ucp_address_profile_dev_t;
+
+
+/* Decoded address profile: the address entries without device and iface
+ * addresses, which are taken from every compact address which refers to it */
+struct ucp_address_profile {
+    unsigned                  num_devices;
+    unsigned                  address_count;
+    ucp_address_profile_dev_t devices[UCP_MAX_RESOURCES];
+    uint8_t                   iface_addr_len[UCP_MAX_RESOURCES];
+    ucp_address_entry_t       address_list[0];
+};
+
+
 #define UCP_ADDRESS_FLAG_ATOMIC32     UCS_BIT(30) /* 32bit atomic operations */
 #define UCP_ADDRESS_FLAG_ATOMIC64     UCS_BIT(31) /* 64bit atomic operations */
 
@@ -116,6 +155,8 @@ typedef struct {
 
 #define UCP_ADDRESS_HEADER_VERSION_MASK     UCS_MASK(4) /* Version - 4 bits */
 #define UCP_ADDRESS_HEADER_FLAG_DEBUG_INFO  UCS_BIT(4)  /* Address has debug info */
+#define UCP_ADDRESS_HEADER_FLAG_PROFILE     UCS_BIT(5)  /* Address refers to a
+                                                           system profile */
 
 /* Enumeration of UCP address versions.
  * Every release which changes the address binary format must bump this number.
@@ -127,6 +168,10 @@ enum {
 };
 
 
+KHASH_IMPL(ucp_worker_addr_profile, uint64_t, ucp_address_profile_t*, 1,
+           kh_int64_hash_func, kh_int64_hash_equal);
+
+
 static size_t ucp_address_iface_attr_size(ucp_worker_t *worker,
                                           uint64_t flags)
 {
@@ -270,16 +315,10 @@ ucp_address_gather_devices(ucp_worker_h worker, ucp_ep_h ep,
     return UCS_OK;
 }
 
-static size_t ucp_address_packed_size(ucp_worker_h worker,
-                                      const ucp_address_packed_device_t *devices,
-                                      ucp_rsc_index_t num_devices,
-                                      uint64_t pack_flags)
+static size_t ucp_address_header_size(ucp_worker_h worker, uint64_t pack_flags)
 {
-    size_t size = 0;
-    const ucp_address_packed_device_t *dev;
-
     /* header: version and flags */
-    size += 1;
+    size_t size = 1;
 
     if (pack_flags & UCP_ADDRESS_PACK_FLAG_WORKER_UUID) {
         size += sizeof(uint64_t);
@@ -290,6 +329,17 @@ static size_t ucp_address_packed_size(ucp_worker_h worker,
         size += strlen(ucp_worker_get_address_name(worker)) + 1;
     }
 
+    return size;
+}
+
+static size_t ucp_address_packed_size(ucp_worker_h worker,
+                                      const ucp_address_packed_device_t *devices,
+                                      ucp_rsc_index_t num_devices,
+                                      uint64_t pack_flags)
+{
+    size_t size = ucp_address_header_size(worker, pack_flags);
+    const ucp_address_packed_device_t *dev;
+
     if (num_devices == 0) {
         size += 1;                      /* NULL md_index */
     } else {
@@ -599,6 +649,67 @@ ucp_address_unpack_length(ucp_worker_h worker, const void* flags_ptr, const void
     return UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
 }
 
+/* Pack the md index byte of a device, and return the packed md flags */
+static uint64_t
+ucp_address_pack_md_index(ucp_context_h context,
+                          const ucp_address_packed_device_t *dev, int empty_dev,
+                          uint8_t *md_byte_p)
+{
+    uint64_t md_flags_pack_mask = (UCT_MD_FLAG_REG | UCT_MD_FLAG_ALLOC);
+    ucp_md_index_t md_index;
+    uint64_t md_flags;
+
+    md_index = context->tl_rscs[dev->rsc_index].md_index;
+    md_flags = context->tl_mds[md_index].attr.cap.flags & md_flags_pack_mask;
+    ucs_assertv_always(md_index <= UCP_ADDRESS_FLAG_MD_MASK,
+                       "md_index=%d", md_index);
+
+    *md_byte_p = md_index;
+
+    if (empty_dev) {
+        *md_byte_p |= UCP_ADDRESS_FLAG_MD_EMPTY_DEV;
+    }
+
+    if (md_flags & UCT_MD_FLAG_ALLOC) {
+        *md_byte_p |= UCP_ADDRESS_FLAG_MD_ALLOC;
+    }
+
+    if (md_flags & UCT_MD_FLAG_REG) {
+        *md_byte_p |= UCP_ADDRESS_FLAG_MD_REG;
+    }
+
+    return md_flags;
+}
+
+/* Pack address header, and return a pointer to the storage right after it */
+static void *
+ucp_address_pack_header(ucp_worker_h worker, void *buffer, unsigned pack_flags)
+{
+    uint8_t *address_header_p = buffer;
+    void *ptr;
+
+    *address_header_p = UCP_ADDRESS_VERSION_CURRENT;
+    ptr               = UCS_PTR_TYPE_OFFSET(buffer, uint8_t);
+
+    if (pack_flags & UCP_ADDRESS_PACK_FLAG_WORKER_UUID) {
+        *(uint64_t*)ptr = worker->uuid;
+        ptr             = UCS_PTR_TYPE_OFFSET(ptr, worker->uuid);
+    }
+
+    if (worker->context->config.ext.address_debug_info) {
+        /* Add debug information to the packed address, and set the corresponding
+         * flag in address header.
+         */
+        *address_header_p |= UCP_ADDRESS_HEADER_FLAG_DEBUG_INFO;
+
+        if (pack_flags & UCP_ADDRESS_PACK_FLAG_WORKER_NAME) {
+            ptr            = ucp_address_pack_worker_address_name(worker, ptr);
+        }
+    }
+
+    return ptr;
+}
+
 static ucs_status_t
 ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
                     unsigned pack_flags, const ucp_lane_index_t *lanes2remote,
@@ -606,11 +717,8 @@ ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
                     ucp_rsc_index_t num_devices)
 {
     ucp_context_h context       = worker->context;
-    uint64_t md_flags_pack_mask = (UCT_MD_FLAG_REG | UCT_MD_FLAG_ALLOC);
     const ucp_address_packed_device_t *dev;
-    uint8_t *address_header_p;
     uct_iface_attr_t *iface_attr;
-    ucp_md_index_t md_index;
     ucp_worker_iface_t *wiface;
     ucp_rsc_index_t rsc_index;
     ucp_lane_index_t lane, remote_lane;
@@ -627,27 +735,8 @@ ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
     void *ptr;
     int enable_amo;
 
-    ptr               = buffer;
-    addr_index        = 0;
-    address_header_p  = ptr;
-    *address_header_p = UCP_ADDRESS_VERSION_CURRENT;
-    ptr               = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
-
-    if (pack_flags & UCP_ADDRESS_PACK_FLAG_WORKER_UUID) {
-        *(uint64_t*)ptr = worker->uuid;
-        ptr             = UCS_PTR_TYPE_OFFSET(ptr, worker->uuid);
-    }
-
-    if (worker->context->config.ext.address_debug_info) {
-        /* Add debug information to the packed address, and set the corresponding
-         * flag in address header.
-         */
-        *address_header_p |= UCP_ADDRESS_HEADER_FLAG_DEBUG_INFO;
-
-        if (pack_flags & UCP_ADDRESS_PACK_FLAG_WORKER_NAME) {
-            ptr            = ucp_address_pack_worker_address_name(worker, ptr);
-        }
-    }
+    addr_index = 0;
+    ptr        = ucp_address_pack_header(worker, buffer, pack_flags);
 
     if (num_devices == 0) {
         *((uint8_t*)ptr) = UCP_NULL_RESOURCE;
@@ -660,26 +749,9 @@ ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
         UCS_BITMAP_AND_INPLACE(&dev_tl_bitmap, dev->tl_bitmap);
 
         /* MD index */
-        md_index       = context->tl_rscs[dev->rsc_index].md_index;
-        md_flags       = context->tl_mds[md_index].attr.cap.flags & md_flags_pack_mask;
-        ucs_assertv_always(md_index <= UCP_ADDRESS_FLAG_MD_MASK,
-                           "md_index=%d", md_index);
-
-        *(uint8_t*)ptr = md_index;
-
-        if (UCS_BITMAP_IS_ZERO_INPLACE(&dev_tl_bitmap)) {
-            *(uint8_t*)ptr |= UCP_ADDRESS_FLAG_MD_EMPTY_DEV;
-        }
-
-        if (md_flags & UCT_MD_FLAG_ALLOC) {
-            *(uint8_t*)ptr |= UCP_ADDRESS_FLAG_MD_ALLOC;
-        }
-
-        if (md_flags & UCT_MD_FLAG_REG) {
-            *(uint8_t*)ptr |= UCP_ADDRESS_FLAG_MD_REG;
-        }
-
-        ptr = UCS_PTR_TYPE_OFFSET(ptr, md_index);
+        md_flags = ucp_address_pack_md_index(
+                context, dev, UCS_BITMAP_IS_ZERO_INPLACE(&dev_tl_bitmap), ptr);
+        ptr      = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
 
         /* Device address length */
         *(uint8_t*)ptr = (dev == (devices + num_devices - 1)) ?
@@ -862,6 +934,314 @@ out:
     return UCS_OK;
 }
 
+static uint64_t ucp_address_profile_key(const void *profile, size_t size)
+{
+    return ((uint64_t)ucs_crc32(0, profile, size) << 32) | size;
+}
+
+static ucs_status_t
+ucp_address_profile_decode(ucp_worker_h worker, const void *profile,
+                           unsigned unpack_flags,
+                           ucp_address_profile_t **profile_p)
+{
+    ucp_address_profile_dev_t *dev;
+    ucp_address_profile_t *decoded;
+    ucp_address_entry_t *address;
+    int last_dev, last_tl, empty_dev;
+    ucs_status_t status;
+    uint64_t md_flags;
+    unsigned num_paths;
+    size_t attr_len;
+    uint8_t md_byte;
+    const void *ptr;
+
+    decoded = ucs_calloc(1, sizeof(*decoded) +
+                            (UCP_MAX_RESOURCES * sizeof(*address)),
+                         "ucp_address_profile");
+    if (decoded == NULL) {
+        ucs_error("failed to allocate address profile");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    ptr     = profile;
+    address = decoded->address_list;
+    if (*(uint8_t*)ptr == UCP_NULL_RESOURCE) {
+        goto out;
+    }
+
+    do {
+        if (decoded->num_devices >= UCP_MAX_RESOURCES) {
+            status = UCS_ERR_INVALID_PARAM;
+            goto err_free;
+        }
+
+        dev          = &decoded->devices[decoded->num_devices];
+        md_byte      = *(uint8_t*)ptr;
+        md_flags     = (md_byte & UCP_ADDRESS_FLAG_MD_ALLOC) ? UCT_MD_FLAG_ALLOC : 0;
+        md_flags    |= (md_byte & UCP_ADDRESS_FLAG_MD_REG)   ? UCT_MD_FLAG_REG   : 0;
+        empty_dev    = md_byte & UCP_ADDRESS_FLAG_MD_EMPTY_DEV;
+        ptr          = UCS_PTR_TYPE_OFFSET(ptr, md_byte);
+
+        dev->dev_addr_len = *(uint8_t*)ptr & UCP_ADDRESS_FLAG_LEN_MASK;
+        last_dev          = *(uint8_t*)ptr & UCP_ADDRESS_FLAG_LAST;
+        if (*(uint8_t*)ptr & UCP_ADDRESS_FLAG_HAVE_PATHS) {
+            ptr       = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
+            num_paths = *(uint8_t*)ptr;
+        } else {
+            num_paths = 1;
+        }
+        ptr = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
+
+        last_tl = empty_dev;
+        while (!last_tl) {
+            if (address >= &decoded->address_list[UCP_MAX_RESOURCES]) {
+                status = UCS_ERR_INVALID_PARAM;
+                goto err_free;
+            }
+
+            address->tl_name_csum  = *(uint16_t*)ptr;
+            ptr                    = UCS_PTR_TYPE_OFFSET(ptr,
+                                                         address->tl_name_csum);
+            address->md_index      = md_byte & UCP_ADDRESS_FLAG_MD_MASK;
+            address->dev_index     = decoded->num_devices;
+            address->md_flags      = md_flags;
+            address->dev_num_paths = num_paths;
+
+            status = ucp_address_unpack_iface_attr(worker, &address->iface_attr,
+                                                   ptr, unpack_flags, &attr_len);
+            if (status != UCS_OK) {
+                goto err_free;
+            }
+
+            ptr     = UCS_PTR_BYTE_OFFSET(ptr, attr_len);
+            last_tl = *(uint8_t*)ptr & UCP_ADDRESS_FLAG_LAST;
+            decoded->iface_addr_len[address - decoded->address_list] =
+                    *(uint8_t*)ptr & UCP_ADDRESS_FLAG_LEN_MASK;
+            ptr     = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
+
+            ++dev->num_tls;
+            ++address;
+        }
+
+        ++decoded->num_devices;
+    } while (!last_dev);
+
+out:
+    decoded->address_count = address - decoded->address_list;
+    *profile_p = ucs_realloc(decoded, sizeof(*decoded) +
+                                      (decoded->address_count * sizeof(*address)),
+                             "ucp_address_profile");
+    if (*profile_p == NULL) {
+        *profile_p = decoded;
+    }
+    return UCS_OK;
+
+err_free:
+    ucs_free(decoded);
+    return status;
+}
+
+static ucs_status_t
+ucp_address_profile_add(ucp_worker_h worker, uint64_t key, const void *profile,
+                        unsigned pack_flags)
+{
+    ucp_address_profile_t *decoded;
+    ucs_status_t status;
+    khiter_t iter;
+    int ret;
+
+    iter = kh_get(ucp_worker_addr_profile, &worker->addr_profile_hash, key);
+    if (iter != kh_end(&worker->addr_profile_hash)) {
+        return UCS_OK;
+    }
+
+    status = ucp_address_profile_decode(worker, profile, pack_flags, &decoded);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    iter = kh_put(ucp_worker_addr_profile, &worker->addr_profile_hash, key,
+                  &ret);
+    if (ret == UCS_KH_PUT_FAILED) {
+        ucs_free(decoded);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    kh_value(&worker->addr_profile_hash, iter) = decoded;
+    ucs_debug("worker %p: added address profile 0x%"PRIx64" with %u entries",
+              worker, key, decoded->address_count);
+    return UCS_OK;
+}
+
+static ucs_status_t
+ucp_address_pack_compact(ucp_worker_h worker, unsigned pack_flags,
+                         const ucp_address_packed_device_t *devices,
+                         ucp_rsc_index_t num_devices, size_t *size_p,
+                         void **buffer_p)
+{
+    ucp_context_h context = worker->context;
+    size_t profile_size   = 0;
+    size_t size           = 0;
+    const ucp_address_packed_device_t *dev;
+    ucp_tl_bitmap_t dev_tl_bitmap;
+    ucp_worker_iface_t *wiface;
+    ucp_rsc_index_t rsc_index;
+    void *profile, *buffer, *key_ptr;
+    void *ptr, *sptr, *flags_ptr;
+    ucs_status_t status;
+    uint64_t key;
+    int attr_len;
+
+    /* Calculate the sizes of the profile and of the address */
+    if (num_devices == 0) {
+        profile_size = 1; /* NULL md_index */
+    }
+
+    for (dev = devices; dev < (devices + num_devices); ++dev) {
+        dev_tl_bitmap = context->tl_bitmap;
+        UCS_BITMAP_AND_INPLACE(&dev_tl_bitmap, dev->tl_bitmap);
+
+        profile_size += 2 + (dev->num_paths > 1);
+        size         += dev->dev_addr_len;
+        UCS_BITMAP_FOR_EACH_BIT(dev_tl_bitmap, rsc_index) {
+            profile_size += sizeof(uint16_t) +
+                            ucp_address_iface_attr_size(worker, pack_flags) +
+                            sizeof(uint8_t);
+            if (pack_flags & UCP_ADDRESS_PACK_FLAG_IFACE_ADDR) {
+                size += ucp_worker_iface(worker, rsc_index)->attr.iface_addr_len;
+            }
+        }
+    }
+
+    size += ucp_address_header_size(worker, pack_flags) + sizeof(key);
+
+    profile = ucs_calloc(1, profile_size, "ucp_address_profile_buf");
+    if (profile == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    buffer = ucs_calloc(1, size, "ucp_address");
+    if (buffer == NULL) {
+        status = UCS_ERR_NO_MEMORY;
+        goto out_free_profile;
+    }
+
+    key_ptr            = ucp_address_pack_header(worker, buffer, pack_flags);
+    *(uint8_t*)buffer |= UCP_ADDRESS_HEADER_FLAG_PROFILE;
+    ptr                = UCS_PTR_TYPE_OFFSET(key_ptr, key);
+    sptr               = profile;
+
+    if (num_devices == 0) {
+        *(uint8_t*)sptr = UCP_NULL_RESOURCE;
+        sptr            = UCS_PTR_TYPE_OFFSET(sptr, uint8_t);
+    }
+
+    for (dev = devices; dev < (devices + num_devices); ++dev) {
+        dev_tl_bitmap = context->tl_bitmap;
+        UCS_BITMAP_AND_INPLACE(&dev_tl_bitmap, dev->tl_bitmap);
+
+        ucp_address_pack_md_index(context, dev,
+                                  UCS_BITMAP_IS_ZERO_INPLACE(&dev_tl_bitmap),
+                                  sptr);
+        sptr = UCS_PTR_TYPE_OFFSET(sptr, uint8_t);
+
+        /* Device address length, flags and number of paths */
+        ucs_assert(dev->dev_addr_len <= UCP_ADDRESS_FLAG_LEN_MASK);
+        *(uint8_t*)sptr = dev->dev_addr_len;
+        if (dev == (devices + num_devices - 1)) {
+            *(uint8_t*)sptr |= UCP_ADDRESS_FLAG_LAST;
+        }
+
+        if (dev->num_paths > 1) {
+            *(uint8_t*)sptr |= UCP_ADDRESS_FLAG_HAVE_PATHS;
+            sptr             = UCS_PTR_TYPE_OFFSET(sptr, uint8_t);
+            *(uint8_t*)sptr  = dev->num_paths;
+        }
+        sptr = UCS_PTR_TYPE_OFFSET(sptr, uint8_t);
+
+        /* Device address */
+        if (dev->dev_addr_len > 0) {
+            wiface = ucp_worker_iface(worker, dev->rsc_index);
+            status = uct_iface_get_device_address(wiface->iface,
+                                                  (uct_device_addr_t*)ptr);
+            if (status != UCS_OK) {
+                goto err_free_buffer;
+            }
+
+            ucp_address_memcheck(context, ptr, dev->dev_addr_len,
+                                 dev->rsc_index);
+            ptr = UCS_PTR_BYTE_OFFSET(ptr, dev->dev_addr_len);
+        }
+
+        flags_ptr = NULL;
+        UCS_BITMAP_FOR_EACH_BIT(dev_tl_bitmap, rsc_index) {
+            wiface = ucp_worker_iface(worker, rsc_index);
+
+            *(uint16_t*)sptr = context->tl_rscs[rsc_index].tl_name_csum;
+            sptr             = UCS_PTR_TYPE_OFFSET(sptr, uint16_t);
+
+            attr_len = ucp_address_pack_iface_attr(
+                    worker, sptr, rsc_index, &wiface->attr, pack_flags,
+                    UCS_BITMAP_GET(worker->atomic_tls, rsc_index));
+            if (attr_len < 0) {
+                status = UCS_ERR_INVALID_ADDR;
+                goto err_free_buffer;
+            }
+
+            sptr      = UCS_PTR_BYTE_OFFSET(sptr, attr_len);
+            flags_ptr = sptr;
+            if (pack_flags & UCP_ADDRESS_PACK_FLAG_IFACE_ADDR) {
+                ucs_assert(wiface->attr.iface_addr_len <=
+                           UCP_ADDRESS_FLAG_LEN_MASK);
+                *(uint8_t*)sptr = wiface->attr.iface_addr_len;
+                status          = uct_iface_get_address(wiface->iface,
+                                                        (uct_iface_addr_t*)ptr);
+                if (status != UCS_OK) {
+                    goto err_free_buffer;
+                }
+
+                ucp_address_memcheck(context, ptr, wiface->attr.iface_addr_len,
+                                     rsc_index);
+                ptr = UCS_PTR_BYTE_OFFSET(ptr, wiface->attr.iface_addr_len);
+            }
+            sptr = UCS_PTR_TYPE_OFFSET(sptr, uint8_t);
+        }
+
+        if (flags_ptr != NULL) {
+            *(uint8_t*)flags_ptr |= UCP_ADDRESS_FLAG_LAST;
+        }
+    }
+
+    ucs_assertv(UCS_PTR_BYTE_OFFSET(buffer, size) == ptr,
+                "buffer=%p size=%zu ptr-buffer=%zd", buffer, size,
+                UCS_PTR_BYTE_DIFF(buffer, ptr));
+    ucs_assertv(UCS_PTR_BYTE_OFFSET(profile, profile_size) == sptr,
+                "profile=%p size=%zu sptr-profile=%zd", profile, profile_size,
+                UCS_PTR_BYTE_DIFF(profile, sptr));
+
+    /* Keep the decoded profile, so addresses of similar workers can be
+     * unpacked by this worker */
+    key    = ucp_address_profile_key(profile, profile_size);
+    status = ucp_address_profile_add(worker, key, profile, pack_flags);
+    if (status != UCS_OK) {
+        goto err_free_buffer;
+    }
+
+    *(uint64_t*)key_ptr = key;
+
+    VALGRIND_CHECK_MEM_IS_DEFINED(buffer, size);
+
+    *size_p   = size;
+    *buffer_p = buffer;
+    goto out_free_profile;
+
+err_free_buffer:
+    ucs_free(buffer);
+out_free_profile:
+    ucs_free(profile);
+    return status;
+}
+
 ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
                               const ucp_tl_bitmap_t *tl_bitmap,
                               unsigned pack_flags,
@@ -885,6 +1265,14 @@ ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
         goto out;
     }
 
+    if (pack_flags & UCP_ADDRESS_PACK_FLAG_PROFILE) {
+        /* Endpoint addresses are not supported by the compact format */
+        ucs_assert(!(pack_flags & UCP_ADDRESS_PACK_FLAG_EP_ADDR));
+        status = ucp_address_pack_compact(worker, pack_flags, devices,
+                                          num_devices, size_p, buffer_p);
+        goto out_free_devices;
+    }
+
     /* Calculate packed size */
     size = ucp_address_packed_size(worker, devices, num_devices, pack_flags);
 
@@ -917,6 +1305,114 @@ out:
     return status;
 }
 
+static ucp_address_profile_t *
+ucp_address_profile_lookup(ucp_worker_h worker, uint64_t key)
+{
+    khiter_t iter;
+
+    iter = kh_get(ucp_worker_addr_profile, &worker->addr_profile_hash, key);
+    if (iter == kh_end(&worker->addr_profile_hash)) {
+        return NULL;
+    }
+
+    return kh_value(&worker->addr_profile_hash, iter);
+}
+
+static ucp_address_profile_t *
+ucp_address_profile_get(ucp_worker_h worker, uint64_t key,
+                        unsigned unpack_flags)
+{
+    static const unsigned address_flags[] = {
+        0, UCP_WORKER_ADDRESS_FLAG_NET_ONLY
+    };
+    ucp_address_profile_t *profile;
+    ucp_tl_bitmap_t tl_bitmap;
+    ucs_status_t status;
+    unsigned i, pack_flags;
+    size_t size;
+    void *buffer;
+
+    profile = ucp_address_profile_lookup(worker, key);
+    if (profile != NULL) {
+        return profile;
+    }
+
+    /* A peer with the same system profile as this worker packs the same
+     * profile this worker would, so add the local profiles and look again */
+    pack_flags = (unpack_flags & UCP_ADDRESS_PACK_FLAGS_ALL &
+                  ~UCP_ADDRESS_PACK_FLAG_EP_ADDR) |
+                 UCP_ADDRESS_PACK_FLAG_PROFILE | UCP_ADDRESS_PACK_FLAG_NO_TRACE;
+    for (i = 0; i < ucs_static_array_size(address_flags); ++i) {
+        ucp_worker_address_tl_bitmap(worker, address_flags[i], &tl_bitmap);
+        status = ucp_address_pack(worker, NULL, &tl_bitmap, pack_flags, NULL,
+                                  &size, &buffer);
+        if (status == UCS_OK) {
+            ucs_free(buffer);
+        }
+    }
+
+    return ucp_address_profile_lookup(worker, key);
+}
+
+static ucs_status_t
+ucp_address_unpack_compact(ucp_worker_t *worker, const void *buffer,
+                           const void *ptr, unsigned unpack_flags,
+                           ucp_unpacked_address_t *unpacked_address)
+{
+    const ucp_address_profile_dev_t *dev;
+    const uct_device_addr_t *dev_addr;
+    ucp_address_profile_t *profile;
+    ucp_address_entry_t *address;
+    uint8_t iface_addr_len;
+    uint64_t key;
+    unsigned i;
+
+    key     = *(const uint64_t*)ptr;
+    ptr     = UCS_PTR_TYPE_OFFSET(ptr, key);
+    profile = ucp_address_profile_get(worker, key, unpack_flags);
+    if (profile == NULL) {
+        if (!(unpack_flags & UCP_ADDRESS_PACK_FLAG_NO_TRACE)) {
+            ucs_error("failed to unpack address: system profile 0x%"PRIx64
+                      " of remote worker %s is different from local one",
+                      key, unpacked_address->name);
+        }
+        return UCS_ERR_UNREACHABLE;
+    }
+
+    if (profile->address_count > 0) {
+        unpacked_address->address_list =
+                ucs_malloc(profile->address_count * sizeof(*address),
+                           "ucp_address_list");
+        if (unpacked_address->address_list == NULL) {
+            ucs_error("failed to allocate address list");
+            return UCS_ERR_NO_MEMORY;
+        }
+
+        memcpy(unpacked_address->address_list, profile->address_list,
+               profile->address_count * sizeof(*address));
+    }
+
+    /* Fill device and iface addresses, which follow the profile key */
+    address = unpacked_address->address_list;
+    for (dev = profile->devices;
+         dev < (profile->devices + profile->num_devices); ++dev) {
+        dev_addr = (dev->dev_addr_len > 0) ? ptr : NULL;
+        ptr      = UCS_PTR_BYTE_OFFSET(ptr, dev->dev_addr_len);
+
+        for (i = 0; i < dev->num_tls; ++i, ++address) {
+            iface_addr_len      = profile->iface_addr_len[
+                    address - unpacked_address->address_list];
+            address->dev_addr   = dev_addr;
+            address->iface_addr = (iface_addr_len > 0) ? ptr : NULL;
+            ptr                 = UCS_PTR_BYTE_OFFSET(ptr, iface_addr_len);
+        }
+    }
+
+    unpacked_address->address_count = profile->address_count;
+    unpacked_address->packed_size   = UCS_PTR_BYTE_DIFF(buffer, ptr);
+    return UCS_OK;
+}
+
 ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
                                 unsigned unpack_flags,
                                 ucp_unpacked_address_t *unpacked_address)
@@ -943,6 +1439,7 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
     /* Initialize the unpacked address to empty */
     unpacked_address->address_count = 0;
     unpacked_address->address_list  = NULL;
+    unpacked_address->packed_size   = 0;
 
     ptr                             = buffer;
     address_header                  = *(const uint8_t *)ptr;
@@ -972,8 +1469,15 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
                          sizeof(unpacked_address->name));
     }
 
+    if (address_header & UCP_ADDRESS_HEADER_FLAG_PROFILE) {
+        return ucp_address_unpack_compact(worker, buffer, ptr, unpack_flags,
+                                          unpacked_address);
+    }
+
     /* Empty address list */
     if (*(uint8_t*)ptr == UCP_NULL_RESOURCE) {
+        unpacked_address->packed_size =
+                UCS_PTR_BYTE_DIFF(buffer, UCS_PTR_TYPE_OFFSET(ptr, uint8_t));
         return UCS_OK;
     }
 
@@ -1102,9 +1606,25 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
 
     unpacked_address->address_count = address - address_list;
     unpacked_address->address_list  = address_list;
+    unpacked_address->packed_size   = UCS_PTR_BYTE_DIFF(buffer, ptr);
     return UCS_OK;
 
 err_free:
     ucs_free(address_list);
     return UCS_ERR_INVALID_PARAM;
 }
+
+void ucp_address_profiles_init(ucp_worker_h worker)
+{
+    kh_init_inplace(ucp_worker_addr_profile, &worker->addr_profile_hash);
+}
+
+void ucp_address_profiles_cleanup(ucp_worker_h worker)
+{
+    ucp_address_profile_t *profile;
+
+    kh_foreach_value(&worker->addr_profile_hash, profile, {
+        ucs_free(profile);
+    })
+    kh_destroy_inplace(ucp_worker_addr_profile, &worker->addr_profile_hash);
+}
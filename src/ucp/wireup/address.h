@@ -63,7 +63,12 @@ enum {
                                             UCP_ADDRESS_PACK_FLAG_EP_ADDR    |
                                             UCP_ADDRESS_PACK_FLAG_TL_RSC_IDX,
 
-    UCP_ADDRESS_PACK_FLAG_NO_TRACE        = UCS_BIT(16) /* Suppress debug tracing */
+    UCP_ADDRESS_PACK_FLAG_NO_TRACE        = UCS_BIT(16), /* Suppress debug tracing */
+
+    UCP_ADDRESS_PACK_FLAG_PROFILE         = UCS_BIT(17)  /* Replace the fields which
+                                                            are common to all workers
+                                                            on a similar node by a
+                                                            system profile key */
 };
 
 
@@ -112,6 +117,8 @@ struct ucp_unpacked_address {
     char                        name[UCP_WORKER_ADDRESS_NAME_MAX];
     unsigned                    address_count;  /* Length of address list */
     ucp_address_entry_t         *address_list;  /* Pointer to address list */
+    size_t                      packed_size;    /* Size of the packed address,
+                                                   set by ucp_address_unpack */
 };
 
 
@@ -177,4 +184,20 @@ ucs_status_t ucp_address_unpack(ucp_worker_h worker, const void *buffer,
                                 ucp_unpacked_address_t *unpacked_address);
 
 
+/**
+ * Initialize the cache of decoded address profiles of a worker.
+ *
+ * @param [in]  worker           Worker object.
+ */
+void ucp_address_profiles_init(ucp_worker_h worker);
+
+
+/**
+ * Release the cache of decoded address profiles of a worker.
+ *
+ * @param [in]  worker           Worker object.
+ */
+void ucp_address_profiles_cleanup(ucp_worker_h worker);
+
+
 #endif
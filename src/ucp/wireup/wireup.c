@@ -526,6 +526,11 @@ ucp_wireup_process_request(ucp_worker_h worker, ucp_ep_h ep,
                                 UCS_CONN_MATCH_QUEUE_UNEXP);
         } else {
             ucp_ep_flush_state_reset(ep);
+            if (ep->flags & UCP_EP_FLAG_LAZY_CONNECT) {
+                /* the peer connects first, so the lazy endpoint is connected
+                 * by this request rather than by its first operation */
+                ep_init_flags |= ucp_ep_lazy_conn_release(ep);
+            }
         }
 
         ucp_ep_update_remote_id(ep, msg->src_ep_id);
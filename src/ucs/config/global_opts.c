@@ -222,7 +222,10 @@ static ucs_config_field_t ucs_global_opts_table[] = {
    ucs_offsetof(ucs_global_opts_t, profile_file), UCS_CONFIG_TYPE_STRING},
 
   {"PROFILE_LOG_SIZE", "4m",
-   "Maximal size of profiling log. New records will replace old records.",
+   "Maximal size of profiling log per thread. New records will replace old\n"
+   "records, so the log keeps the most recent events. Log collection can be\n"
+   "paused and resumed at runtime by writing 0/1 to \"ucs/profile/log_enable\"\n"
+   "VFS file, and \"ucs/profile/dump\" saves the current log to PROFILE_FILE.",
    ucs_offsetof(ucs_global_opts_t, profile_log_size), UCS_CONFIG_TYPE_MEMUNITS},
 
   {"RCACHE_CHECK_PFN", "0",
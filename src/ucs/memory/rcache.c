@@ -18,6 +18,7 @@
 #include <ucs/sys/math.h>
 #include <ucs/sys/sys.h>
 #include <ucs/type/spinlock.h>
+#include <ucs/vfs/base/vfs_obj.h>
 #include <ucm/api/ucm.h>
 
 #include "rcache.h"
@@ -78,6 +79,24 @@ typedef struct {
 } ucs_rcache_region_validate_pfn_t;
 
 
+static const ucs_counters_class_t ucs_rcache_counters_class = {
+    .name          = "rcache",
+    .num_counters  = UCS_RCACHE_STAT_LAST,
+    .gauges        = 0,
+    .counter_names = {
+        [UCS_RCACHE_GETS]               = "gets",
+        [UCS_RCACHE_HITS_FAST]          = "hits_fast",
+        [UCS_RCACHE_HITS_SLOW]          = "hits_slow",
+        [UCS_RCACHE_MISSES]             = "misses",
+        [UCS_RCACHE_MERGES]             = "regions_merged",
+        [UCS_RCACHE_UNMAPS]             = "unmap_events",
+        [UCS_RCACHE_UNMAP_INVALIDATES]  = "regions_inv_unmap",
+        [UCS_RCACHE_PUTS]               = "puts",
+        [UCS_RCACHE_REGS]               = "mem_regs",
+        [UCS_RCACHE_DEREGS]             = "mem_deregs",
+    }
+};
+
 #ifdef ENABLE_STATS
 static ucs_stats_class_t ucs_rcache_stats_class = {
     .name = "rcache",
@@ -346,7 +365,7 @@ static void ucs_mem_region_destroy_internal(ucs_rcache_t *rcache,
     ucs_assert(!(region->flags & UCS_RCACHE_REGION_FLAG_PGTABLE));
 
     if (region->flags & UCS_RCACHE_REGION_FLAG_REGISTERED) {
-        UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_DEREGS, 1);
+        UCS_RCACHE_STAT_ADD(rcache, UCS_RCACHE_DEREGS, 1);
         {
             UCS_PROFILE_CODE("mem_dereg") {
                 rcache->params.ops->mem_dereg(rcache->params.context, rcache,
@@ -443,7 +462,7 @@ static void ucs_rcache_invalidate_range(ucs_rcache_t *rcache, ucs_pgt_addr_t sta
         /* all regions on the list are in the page table */
         ucs_rcache_region_invalidate(rcache, region,
                                      flags | UCS_RCACHE_REGION_PUT_FLAG_IN_PGTABLE);
-        UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_UNMAP_INVALIDATES, 1);
+        UCS_RCACHE_STAT_ADD(rcache, UCS_RCACHE_UNMAP_INVALIDATES, 1);
     }
 }
 
@@ -530,7 +549,7 @@ static void ucs_rcache_unmapped_callback(ucm_event_type_t event_type,
     if (!pthread_rwlock_trywrlock(&rcache->pgt_lock)) {
         ucs_rcache_invalidate_range(rcache, start, end,
                                     UCS_RCACHE_REGION_PUT_FLAG_ADD_TO_GC);
-        UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_UNMAPS, 1);
+        UCS_RCACHE_STAT_ADD(rcache, UCS_RCACHE_UNMAPS, 1);
         ucs_rcache_check_inv_queue(rcache, UCS_RCACHE_REGION_PUT_FLAG_ADD_TO_GC);
         pthread_rwlock_unlock(&rcache->pgt_lock);
         return;
@@ -543,7 +562,7 @@ static void ucs_rcache_unmapped_callback(ucm_event_type_t event_type,
         entry->start = start;
         entry->end   = end;
         ucs_queue_push(&rcache->inv_q, &entry->queue);
-        UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_UNMAPS, 1);
+        UCS_RCACHE_STAT_ADD(rcache, UCS_RCACHE_UNMAPS, 1);
     } else {
         ucs_error("Failed to allocate invalidation entry for 0x%lx..0x%lx, "
                   "data corruption may occur", start, end);
@@ -661,7 +680,7 @@ ucs_rcache_check_overlap(ucs_rcache_t *rcache, ucs_pgt_addr_t *start,
             return UCS_ERR_ALREADY_EXISTS;
         }
 
-        UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_MERGES, 1);
+        UCS_RCACHE_STAT_ADD(rcache, UCS_RCACHE_MERGES, 1);
         /*
          * If we don't provide some of the permissions the other region had,
          * we might want to expand our permissions to support them. We can
@@ -784,7 +803,7 @@ retry:
          */
         ucs_rcache_region_validate_pfn(rcache, region);
         status = region->status;
-        UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_HITS_SLOW, 1);
+        UCS_RCACHE_STAT_ADD(rcache, UCS_RCACHE_HITS_SLOW, 1);
         goto out_set_region;
     } else if (status != UCS_OK) {
         /* Could not create a region because there are overlapping regions which
@@ -819,7 +838,7 @@ retry:
     /* If memory registration failed, keep the region and mark it as invalid,
      * to avoid numerous retries of registering the region.
      */
-    UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_REGS, 1);
+    UCS_RCACHE_STAT_ADD(rcache, UCS_RCACHE_REGS, 1);
 
     region->prot      = prot;
     region->flags     = UCS_RCACHE_REGION_FLAG_PGTABLE;
@@ -869,7 +888,7 @@ retry:
         ucs_rcache_lru_evict(rcache);
     }
 
-    UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_MISSES, 1);
+    UCS_RCACHE_STAT_ADD(rcache, UCS_RCACHE_MISSES, 1);
 
     ucs_rcache_region_trace(rcache, region, "created");
 
@@ -897,7 +916,7 @@ ucs_status_t ucs_rcache_get(ucs_rcache_t *rcache, void *address, size_t length,
                    length);
 
     pthread_rwlock_rdlock(&rcache->pgt_lock);
-    UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_GETS, 1);
+    UCS_RCACHE_STAT_ADD(rcache, UCS_RCACHE_GETS, 1);
     if (ucs_queue_is_empty(&rcache->inv_q)) {
         pgt_region = UCS_PROFILE_CALL(ucs_pgtable_lookup, &rcache->pgtable,
                                       start);
@@ -910,7 +929,7 @@ ucs_status_t ucs_rcache_get(ucs_rcache_t *rcache, void *address, size_t length,
                 ucs_rcache_region_validate_pfn(rcache, region);
                 ucs_rcache_region_lru_get(rcache, region);
                 *region_p = region;
-                UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_HITS_FAST, 1);
+                UCS_RCACHE_STAT_ADD(rcache, UCS_RCACHE_HITS_FAST, 1);
                 pthread_rwlock_unlock(&rcache->pgt_lock);
                 return UCS_OK;
             }
@@ -932,7 +951,7 @@ void ucs_rcache_region_put(ucs_rcache_t *rcache, ucs_rcache_region_t *region)
     ucs_rcache_region_lru_put(rcache, region);
     ucs_rcache_region_put_internal(rcache, region,
                                    UCS_RCACHE_REGION_PUT_FLAG_TAKE_PGLOCK);
-    UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_PUTS, 1);
+    UCS_RCACHE_STAT_ADD(rcache, UCS_RCACHE_PUTS, 1);
 }
 
 static void ucs_rcache_before_fork(void)
@@ -999,6 +1018,30 @@ static void ucs_rcache_global_list_remove(ucs_rcache_t *rcache) {
     pthread_mutex_unlock(&ucs_rcache_global_list_lock);
 }
 
+static void ucs_rcache_vfs_show_counters(void *obj, ucs_string_buffer_t *strb)
+{
+    ucs_rcache_t *rcache = obj;
+
+    ucs_counters_print(&rcache->counters, 0, strb);
+}
+
+static void ucs_rcache_vfs_show_gauges(void *obj, ucs_string_buffer_t *strb)
+{
+    ucs_rcache_t *rcache = obj;
+
+    ucs_string_buffer_appendf(strb, "regions %lu\n", rcache->num_regions);
+    ucs_string_buffer_appendf(strb, "total_size %zu\n", rcache->total_size);
+    ucs_string_buffer_appendf(strb, "lru_regions %lu\n", rcache->lru.count);
+}
+
+static void ucs_rcache_vfs_init(ucs_rcache_t *rcache)
+{
+    ucs_vfs_obj_add_dir(NULL, rcache, "ucs/rcache/%s-%p", rcache->name,
+                        rcache);
+    ucs_vfs_obj_add_ro_file(rcache, ucs_rcache_vfs_show_counters, "counters");
+    ucs_vfs_obj_add_ro_file(rcache, ucs_rcache_vfs_show_gauges, "gauges");
+}
+
 static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
                            const char *name, ucs_stats_node_t *stats_parent)
 {
@@ -1028,12 +1071,17 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
         goto err;
     }
 
+    status = ucs_counters_init(&self->counters, &ucs_rcache_counters_class);
+    if (status != UCS_OK) {
+        goto err_destroy_stats;
+    }
+
     self->params = *params;
 
     self->name = strdup(name);
     if (self->name == NULL) {
         status = UCS_ERR_NO_MEMORY;
-        goto err_destroy_stats;
+        goto err_cleanup_counters;
     }
 
     ret = pthread_rwlock_init(&self->pgt_lock, NULL);
@@ -1081,6 +1129,7 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
         goto err_unset_event;
     }
 
+    ucs_rcache_vfs_init(self);
     return UCS_OK;
 
 err_unset_event:
@@ -1096,6 +1145,8 @@ err_destroy_rwlock:
     pthread_rwlock_destroy(&self->pgt_lock);
 err_free_name:
     free(self->name);
+err_cleanup_counters:
+    ucs_counters_cleanup(&self->counters);
 err_destroy_stats:
     UCS_STATS_NODE_FREE(self->stats);
 err:
@@ -1104,6 +1155,7 @@ err:
 
 static UCS_CLASS_CLEANUP_FUNC(ucs_rcache_t)
 {
+    ucs_vfs_obj_remove(self);
     ucs_rcache_global_list_remove(self);
     ucm_unset_event_handler(self->params.ucm_events, ucs_rcache_unmapped_callback,
                             self);
@@ -1127,6 +1179,7 @@ static UCS_CLASS_CLEANUP_FUNC(ucs_rcache_t)
     ucs_pgtable_cleanup(&self->pgtable);
     ucs_spinlock_destroy(&self->lock);
     pthread_rwlock_destroy(&self->pgt_lock);
+    ucs_counters_cleanup(&self->counters);
     UCS_STATS_NODE_FREE(self->stats);
     free(self->name);
 }
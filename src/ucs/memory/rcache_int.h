@@ -8,6 +8,7 @@
 #define UCS_REG_CACHE_INT_H_
 
 #include <ucs/datastruct/list.h>
+#include <ucs/stats/counters.h>
 #include <ucs/type/spinlock.h>
 
 
@@ -28,6 +29,14 @@ enum {
 };
 
 
+/* Update both the statistics node and the always-on counters */
+#define UCS_RCACHE_STAT_ADD(_rcache, _counter, _value) \
+    { \
+        UCS_STATS_UPDATE_COUNTER((_rcache)->stats, _counter, _value); \
+        ucs_counters_add(&(_rcache)->counters, _counter, _value); \
+    }
+
+
 struct ucs_rcache {
     ucs_rcache_params_t      params;      /**< rcache parameters (immutable) */
 
@@ -68,6 +77,8 @@ struct ucs_rcache {
     char                     *name;       /**< Name of the cache, for debug purpose */
 
     UCS_STATS_NODE_DECLARE(stats)
+    ucs_counters_t           counters;    /**< Always-on counters, same
+                                               indices as stats counters */
 
     ucs_list_link_t          list;        /**< list entry in global ucs_rcache list */
 };
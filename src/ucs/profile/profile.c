@@ -10,12 +10,14 @@
 
 #include "profile.h"
 
+#include <ucs/config/parser.h>
 #include <ucs/datastruct/list.h>
 #include <ucs/debug/debug_int.h>
 #include <ucs/debug/log.h>
 #include <ucs/sys/string.h>
 #include <ucs/sys/sys.h>
 #include <ucs/time/time.h>
+#include <ucs/vfs/base/vfs_obj.h>
 #include <pthread.h>
 
 
@@ -35,6 +37,9 @@ typedef struct ucs_profile_global_context {
     pthread_mutex_t               mutex;         /**< Protects updating the locations array */
     pthread_key_t                 tls_key;       /**< TLS key for per-thread context */
     ucs_list_link_t               thread_list;   /**< List of all thread contexts */
+    unsigned                      generation;    /**< Incremented on every init */
+    volatile int                  log_enable;    /**< Whether log records are collected */
+    int                           vfs_init;      /**< Whether VFS nodes were added */
 } ucs_profile_global_context_t;
 
 
@@ -46,6 +51,7 @@ typedef struct ucs_profile_thread_context {
     ucs_time_t                        end_time;      /**< Thread end time */
     ucs_list_link_t                   list;          /**< Entry in thread list */
     int                               is_completed;  /**< Set to 1 when thread exits */
+    unsigned                          generation;    /**< Global context generation */
 
     struct {
         ucs_profile_record_t          *start;        /**< Circular log buffer start */
@@ -83,8 +89,17 @@ static ucs_profile_global_context_t ucs_profile_global_ctx = {
     .mutex         = PTHREAD_MUTEX_INITIALIZER,
     .thread_list   = UCS_LIST_INITIALIZER(&ucs_profile_global_ctx.thread_list,
                                           &ucs_profile_global_ctx.thread_list),
+    .generation    = 0,
+    .log_enable    = 1,
+    .vfs_init      = 0
 };
 
+/* Cached per-thread context, to avoid pthread_getspecific() on fast-path. The
+ * TLS key is still used to finalize the context when the thread exits, and the
+ * cached context is valid only if it was created after last global init.
+ */
+static __thread ucs_profile_thread_context_t *ucs_profile_thread_ctx = NULL;
+
 static ucs_status_t ucs_profile_file_write_data(int fd, void *data, size_t size)
 {
     ssize_t written;
@@ -273,6 +288,79 @@ out_unlock:
     pthread_mutex_unlock(&ucs_profile_global_ctx.mutex);
 }
 
+static void ucs_profile_vfs_show_log_enable(void *obj,
+                                            ucs_string_buffer_t *strb)
+{
+    ucs_string_buffer_appendf(strb, "%d\n", ucs_profile_global_ctx.log_enable);
+}
+
+static ucs_status_t
+ucs_profile_vfs_write_log_enable(void *obj, const char *buffer, size_t size)
+{
+    char value_str[16];
+    size_t length;
+    int value;
+
+    length = ucs_min(size, sizeof(value_str) - 1);
+    memcpy(value_str, buffer, length);
+    value_str[length] = '\0';
+
+    if (!ucs_config_sscanf_bool(ucs_strtrim(value_str), &value, NULL)) {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    ucs_debug("profiling log %s", value ? "resumed" : "paused");
+    ucs_profile_global_ctx.log_enable = value;
+    return UCS_OK;
+}
+
+static void ucs_profile_vfs_show_mode(void *obj, ucs_string_buffer_t *strb)
+{
+    unsigned mode;
+
+    ucs_for_each_bit(mode, ucs_global_opts.profile_mode) {
+        ucs_string_buffer_appendf(strb, "%s,", ucs_profile_mode_names[mode]);
+    }
+    ucs_string_buffer_rtrim(strb, ",");
+    ucs_string_buffer_appendf(strb, "\n");
+}
+
+static void ucs_profile_vfs_show_log_records(void *obj,
+                                             ucs_string_buffer_t *strb)
+{
+    ucs_string_buffer_appendf(strb, "%zu\n",
+                              ucs_global_opts.profile_log_size /
+                              sizeof(ucs_profile_record_t));
+}
+
+static void ucs_profile_vfs_show_dump(void *obj, ucs_string_buffer_t *strb)
+{
+    ucs_string_buffer_appendf(strb, "%s\n", ucs_global_opts.profile_file);
+}
+
+static ucs_status_t
+ucs_profile_vfs_write_dump(void *obj, const char *buffer, size_t size)
+{
+    /* Save a snapshot of the profiling data without releasing it, so the
+     * threads can continue recording into their logs */
+    ucs_profile_write();
+    return UCS_OK;
+}
+
+static void ucs_profile_vfs_init()
+{
+    ucs_vfs_obj_add_dir(NULL, &ucs_profile_global_ctx, "ucs/profile");
+    ucs_vfs_obj_add_ro_file(&ucs_profile_global_ctx, ucs_profile_vfs_show_mode,
+                            "mode");
+    ucs_vfs_obj_add_ro_file(&ucs_profile_global_ctx,
+                            ucs_profile_vfs_show_log_records, "log_records");
+    ucs_vfs_obj_add_rw_file(&ucs_profile_global_ctx,
+                            ucs_profile_vfs_show_log_enable,
+                            ucs_profile_vfs_write_log_enable, "log_enable");
+    ucs_vfs_obj_add_rw_file(&ucs_profile_global_ctx, ucs_profile_vfs_show_dump,
+                            ucs_profile_vfs_write_dump, "dump");
+}
+
 static UCS_F_NOINLINE
 ucs_profile_thread_context_t* ucs_profile_thread_init()
 {
@@ -287,10 +375,12 @@ ucs_profile_thread_context_t* ucs_profile_thread_init()
         return NULL;
     }
 
-    ctx->tid        = ucs_get_tid();
-    ctx->start_time = ucs_get_time();
-    ctx->end_time   = 0;
-    ctx->pthread_id = pthread_self();
+    ctx->tid          = ucs_get_tid();
+    ctx->start_time   = ucs_get_time();
+    ctx->end_time     = 0;
+    ctx->pthread_id   = pthread_self();
+    ctx->is_completed = 0;
+    ctx->generation   = ucs_profile_global_ctx.generation;
 
     ucs_debug("profiling context %p: start on thread 0x%lx tid %d mode %d",
               ctx, (unsigned long)pthread_self(), ucs_get_tid(), 
@@ -319,6 +409,7 @@ ucs_profile_thread_context_t* ucs_profile_thread_init()
     }
 
     pthread_setspecific(ucs_profile_global_ctx.tls_key, ctx);
+    ucs_profile_thread_ctx = ctx;
 
     pthread_mutex_lock(&ucs_profile_global_ctx.mutex);
     ucs_list_add_tail(&ucs_profile_global_ctx.thread_list, &ctx->list);
@@ -396,6 +487,11 @@ int ucs_profile_get_location(ucs_profile_type_t type, const char *name,
     /* Location ID must be uninitialized */
     ucs_assert(*loc_id_p == -1);
 
+    if (!ucs_profile_global_ctx.vfs_init) {
+        ucs_profile_vfs_init();
+        ucs_profile_global_ctx.vfs_init = 1;
+    }
+
     ucs_profile_for_each_location(loc) {
         if ((type == loc->super.type) && (line == loc->super.line) &&
             !strcmp(loc->super.name, name) &&
@@ -446,7 +542,7 @@ static void ucs_profile_thread_expand_locations(int loc_id)
     ucs_profile_thread_context_t *ctx;
     unsigned i, new_num_locations;
 
-    ctx = pthread_getspecific(ucs_profile_global_ctx.tls_key);
+    ctx = ucs_profile_thread_ctx;
     ucs_assert(ctx != NULL);
 
     new_num_locations = ucs_max(loc_id, ctx->accum.num_locations);
@@ -474,6 +570,7 @@ void ucs_profile_record(ucs_profile_type_t type, const char *name,
     ucs_profile_thread_context_t *ctx;
     ucs_profile_record_t *rec;
     ucs_time_t current_time;
+    unsigned mode;
     int loc_id;
 
     /* If the location id is -1 or 0, need to re-read it with lock held */
@@ -491,14 +588,24 @@ void ucs_profile_record(ucs_profile_type_t type, const char *name,
     ucs_assert(*loc_id_p                    != 0);
     ucs_assert(ucs_global_opts.profile_mode != 0);
 
+    mode = ucs_global_opts.profile_mode;
+    if (ucs_unlikely(!ucs_profile_global_ctx.log_enable)) {
+        /* Log collection was paused at runtime */
+        mode &= ~UCS_BIT(UCS_PROFILE_MODE_LOG);
+        if (mode == 0) {
+            return;
+        }
+    }
+
     /* Get thread-specific profiling context */
-    ctx = pthread_getspecific(ucs_profile_global_ctx.tls_key);
-    if (ucs_unlikely(ctx == NULL)) {
+    ctx = ucs_profile_thread_ctx;
+    if (ucs_unlikely((ctx == NULL) ||
+                     (ctx->generation != ucs_profile_global_ctx.generation))) {
         ctx = ucs_profile_thread_init();
     }
 
     current_time = ucs_get_time();
-    if (ucs_global_opts.profile_mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
+    if (mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
         if (ucs_unlikely(loc_id > ctx->accum.num_locations)) {
             /* expand the locations array of the current thread */
             ucs_profile_thread_expand_locations(loc_id);
@@ -520,7 +627,7 @@ void ucs_profile_record(ucs_profile_type_t type, const char *name,
         ++loc->count;
     }
 
-    if (ucs_global_opts.profile_mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
+    if (mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
         rec              = ctx->log.current;
         rec->timestamp   = current_time;
         rec->param64     = param64;
@@ -587,6 +694,7 @@ void ucs_profile_dump()
     if (ctx) {
         ucs_profile_thread_finalize(ctx);
         pthread_setspecific(ucs_profile_global_ctx.tls_key, NULL);
+        ucs_profile_thread_ctx = NULL;
     }
 
     /* write and cleanup all completed threads (including the current thread) */
@@ -603,6 +711,7 @@ void ucs_profile_global_init()
 
     pthread_key_create(&ucs_profile_global_ctx.tls_key,
                        ucs_profile_thread_key_destr);
+    ++ucs_profile_global_ctx.generation;
 }
 
 void ucs_profile_global_cleanup()
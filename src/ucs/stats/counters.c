@@ -0,0 +1,169 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "counters.h"
+
+#include <ucs/arch/atomic.h>
+#include <ucs/arch/bitops.h>
+#include <ucs/arch/cpu.h>
+#include <ucs/debug/assert.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
+#include <ucs/sys/math.h>
+#include <ucs/sys/sys.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <string.h>
+
+
+static struct {
+    pthread_mutex_t lock;       /* Protects free_slots */
+    pthread_key_t   tls_key;    /* Releases the slot of an exiting thread */
+    uint64_t        free_slots; /* Mask of unassigned slots */
+} ucs_counters_global_ctx = {
+    .lock       = PTHREAD_MUTEX_INITIALIZER,
+    .free_slots = UINT64_MAX
+};
+
+__thread unsigned ucs_counters_thread_slot = UCS_COUNTERS_SLOT_NONE;
+
+
+static void ucs_counters_thread_key_destr(void *arg)
+{
+    unsigned slot = (uintptr_t)arg - 1;
+
+    /* Values accumulated by the thread remain in the blocks of its slot, so
+     * the thread which gets the slot next continues from these values */
+    pthread_mutex_lock(&ucs_counters_global_ctx.lock);
+    ucs_counters_global_ctx.free_slots |= UCS_BIT(slot);
+    pthread_mutex_unlock(&ucs_counters_global_ctx.lock);
+
+    /* Updates from TLS destructors which run later go to the shared block */
+    ucs_counters_thread_slot = UCS_COUNTERS_SLOT_SHARED;
+}
+
+static void ucs_counters_thread_slot_init()
+{
+    unsigned slot;
+
+    pthread_mutex_lock(&ucs_counters_global_ctx.lock);
+    if (ucs_counters_global_ctx.free_slots == 0) {
+        slot = UCS_COUNTERS_SLOT_SHARED;
+    } else {
+        slot = ucs_ffs64(ucs_counters_global_ctx.free_slots);
+        ucs_counters_global_ctx.free_slots &= ~UCS_BIT(slot);
+    }
+    pthread_mutex_unlock(&ucs_counters_global_ctx.lock);
+
+    if (slot != UCS_COUNTERS_SLOT_SHARED) {
+        pthread_setspecific(ucs_counters_global_ctx.tls_key,
+                            (void*)(uintptr_t)(slot + 1));
+    } else {
+        ucs_debug("no free counters slot, using shared atomic counters");
+    }
+
+    ucs_counters_thread_slot = slot;
+}
+
+ucs_status_t ucs_counters_init(ucs_counters_t *counters,
+                               const ucs_counters_class_t *cls)
+{
+    size_t size;
+    int ret;
+
+    UCS_STATIC_ASSERT(UCS_COUNTERS_MAX_THREADS <= 64);
+    ucs_assert(cls->num_counters <= 64);
+
+    /* Pad every block to a whole number of cache lines, to prevent false
+     * sharing between the blocks of different threads */
+    counters->cls    = cls;
+    counters->stride = ucs_align_up_pow2(ucs_max(cls->num_counters, 1),
+                                         UCS_SYS_CACHE_LINE_SIZE /
+                                         sizeof(int64_t));
+    size             = sizeof(int64_t) * counters->stride *
+                       (UCS_COUNTERS_SLOT_SHARED + 1);
+
+    ret = ucs_posix_memalign((void**)&counters->values,
+                             UCS_SYS_CACHE_LINE_SIZE, size, "counters");
+    if (ret != 0) {
+        ucs_error("failed to allocate '%s' counters", cls->name);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    memset(counters->values, 0, size);
+    return UCS_OK;
+}
+
+void ucs_counters_cleanup(ucs_counters_t *counters)
+{
+    ucs_free(counters->values);
+}
+
+void ucs_counters_add_slow(ucs_counters_t *counters, unsigned index,
+                           int64_t value)
+{
+    ucs_assert(index < counters->cls->num_counters);
+
+    if (ucs_counters_thread_slot == UCS_COUNTERS_SLOT_NONE) {
+        ucs_counters_thread_slot_init();
+        if (ucs_counters_thread_slot < UCS_COUNTERS_MAX_THREADS) {
+            ucs_counters_add(counters, index, value);
+            return;
+        }
+    }
+
+    ucs_atomic_add64((volatile uint64_t*)
+                     &counters->values[(UCS_COUNTERS_SLOT_SHARED *
+                                        counters->stride) + index],
+                     value);
+}
+
+int64_t ucs_counters_get(const ucs_counters_t *counters, unsigned index)
+{
+    const volatile int64_t *values = counters->values;
+    int64_t sum                    = 0;
+    unsigned slot;
+
+    ucs_assert(index < counters->cls->num_counters);
+
+    for (slot = 0; slot <= UCS_COUNTERS_SLOT_SHARED; ++slot) {
+        sum += values[(slot * counters->stride) + index];
+    }
+
+    return sum;
+}
+
+void ucs_counters_print(const ucs_counters_t *counters, int gauges,
+                        ucs_string_buffer_t *strb)
+{
+    const ucs_counters_class_t *cls = counters->cls;
+    unsigned index;
+
+    for (index = 0; index < cls->num_counters; ++index) {
+        if (!!(cls->gauges & UCS_BIT(index)) != !!gauges) {
+            continue;
+        }
+
+        ucs_string_buffer_appendf(strb, "%s %" PRId64 "\n",
+                                  cls->counter_names[index],
+                                  ucs_counters_get(counters, index));
+    }
+}
+
+UCS_STATIC_INIT
+{
+    pthread_key_create(&ucs_counters_global_ctx.tls_key,
+                       ucs_counters_thread_key_destr);
+}
+
+UCS_STATIC_CLEANUP
+{
+    pthread_key_delete(ucs_counters_global_ctx.tls_key);
+}
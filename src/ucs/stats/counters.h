@@ -0,0 +1,147 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCS_COUNTERS_H_
+#define UCS_COUNTERS_H_
+
+#include <ucs/datastruct/string_buffer.h>
+#include <ucs/sys/compiler_def.h>
+#include <ucs/type/status.h>
+#include <stdint.h>
+#include <limits.h>
+
+BEGIN_C_DECLS
+
+/** @file counters.h */
+
+/*
+ * Always-on lightweight counters.
+ *
+ * Unlike statistics nodes (which are compiled in only with --enable-stats),
+ * these counters are always available. Each thread updates a private,
+ * cache-line aligned block of values without atomics, and the values are
+ * summed up only when read (e.g by a VFS file callback).
+ *
+ * Threads are assigned a slot on their first update. If all slots are taken,
+ * the thread falls back to a shared block which is updated atomically.
+ *
+ * The blocks of all slots are allocated in advance, since updates may happen
+ * with locks held which are also taken from memory hooks, where calling
+ * malloc() could deadlock.
+ */
+
+
+/* Maximal number of threads with a private counters block */
+#define UCS_COUNTERS_MAX_THREADS   64
+
+/* Slot index for threads which use the shared, atomically updated block */
+#define UCS_COUNTERS_SLOT_SHARED   UCS_COUNTERS_MAX_THREADS
+
+/* Slot index of a thread which did not update any counter yet */
+#define UCS_COUNTERS_SLOT_NONE     UINT_MAX
+
+
+/**
+ * Counters class, describes the names and types of counters in a set.
+ */
+typedef struct ucs_counters_class {
+    const char *name;            /**< Class name */
+    unsigned   num_counters;     /**< Number of counters in the class */
+    uint64_t   gauges;           /**< Mask of counters which are gauges (may
+                                      go down) rather than monotonic counters */
+    const char *counter_names[]; /**< Counter names */
+} ucs_counters_class_t;
+
+
+/**
+ * Counters set.
+ */
+typedef struct ucs_counters {
+    const ucs_counters_class_t *cls;    /**< Counters class */
+    int64_t                    *values; /**< Blocks of values, one per slot */
+    unsigned                   stride;  /**< Distance between the blocks of
+                                             adjacent slots, in values */
+} ucs_counters_t;
+
+
+/* Slot of the current thread. Initial-exec TLS model saves a call to
+ * __tls_get_addr() on every update from other libraries */
+extern __thread unsigned ucs_counters_thread_slot
+    __attribute__((tls_model("initial-exec")));
+
+
+/**
+ * Initialize a counters set.
+ *
+ * @param counters   Counters set to initialize.
+ * @param cls        Counters class. Must remain valid until the set is
+ *                   cleaned up.
+ */
+ucs_status_t ucs_counters_init(ucs_counters_t *counters,
+                               const ucs_counters_class_t *cls);
+
+
+/**
+ * Release a counters set. Must not be called concurrently with updates.
+ *
+ * @param counters   Counters set to release.
+ */
+void ucs_counters_cleanup(ucs_counters_t *counters);
+
+
+/**
+ * Slow path of @ref ucs_counters_add.
+ */
+void ucs_counters_add_slow(ucs_counters_t *counters, unsigned index,
+                           int64_t value);
+
+
+/**
+ * Get the current value of a counter, summed over all threads.
+ *
+ * @param counters   Counters set.
+ * @param index      Counter index.
+ *
+ * @return Aggregated counter value.
+ */
+int64_t ucs_counters_get(const ucs_counters_t *counters, unsigned index);
+
+
+/**
+ * Print the values of all counters, or all gauges, in the set as
+ * "<name> <value>" lines.
+ *
+ * @param counters   Counters set.
+ * @param gauges     Whether to print gauges (nonzero) or counters (0).
+ * @param strb       String buffer to print to.
+ */
+void ucs_counters_print(const ucs_counters_t *counters, int gauges,
+                        ucs_string_buffer_t *strb);
+
+
+/**
+ * Add a value to a counter.
+ *
+ * @param counters   Counters set.
+ * @param index      Counter index.
+ * @param value      Value to add, may be negative for gauges.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucs_counters_add(ucs_counters_t *counters, unsigned index, int64_t value)
+{
+    unsigned slot = ucs_counters_thread_slot;
+
+    if (ucs_likely(slot < UCS_COUNTERS_MAX_THREADS)) {
+        counters->values[(slot * counters->stride) + index] += value;
+        return;
+    }
+
+    ucs_counters_add_slow(counters, index, value);
+}
+
+END_C_DECLS
+
+#endif
@@ -25,6 +25,7 @@
 typedef enum {
     UCS_VFS_NODE_TYPE_DIR,
     UCS_VFS_NODE_TYPE_RO_FILE,
+    UCS_VFS_NODE_TYPE_RW_FILE,
     UCS_VFS_NODE_TYPE_SUBDIR,
     UCS_VFS_NODE_TYPE_LAST
 } ucs_vfs_node_type_t;
@@ -35,16 +36,17 @@ typedef enum {
 
 typedef struct ucs_vfs_node ucs_vfs_node_t;
 struct ucs_vfs_node {
-    ucs_vfs_node_type_t    type;
-    int                    refcount;
-    uint8_t                flags;
-    void                   *obj;
-    ucs_vfs_node_t         *parent;
-    ucs_list_link_t        children;
-    ucs_vfs_file_show_cb_t text_cb;
-    ucs_vfs_refresh_cb_t   refresh_cb;
-    ucs_list_link_t        list;
-    char                   path[0];
+    ucs_vfs_node_type_t     type;
+    int                     refcount;
+    uint8_t                 flags;
+    void                    *obj;
+    ucs_vfs_node_t          *parent;
+    ucs_list_link_t         children;
+    ucs_vfs_file_show_cb_t  text_cb;
+    ucs_vfs_file_write_cb_t write_cb;
+    ucs_vfs_refresh_cb_t    refresh_cb;
+    ucs_list_link_t         list;
+    char                    path[0];
 };
 
 KHASH_MAP_INIT_STR(vfs_path, ucs_vfs_node_t*);
@@ -113,6 +115,7 @@ static void ucs_vfs_node_init(ucs_vfs_node_t *node, ucs_vfs_node_type_t type,
     node->obj        = obj;
     node->parent     = parent_node;
     node->text_cb    = NULL;
+    node->write_cb   = NULL;
     node->refresh_cb = NULL;
     ucs_list_head_init(&node->children);
 }
@@ -267,11 +270,18 @@ static void ucs_vfs_refresh_dir(ucs_vfs_node_t *node)
     node->flags &= ~UCS_VFS_FLAGS_DIRTY;
 }
 
+/* must be called with lock held */
+static int ucs_vfs_check_file(ucs_vfs_node_t *node)
+{
+    return ucs_vfs_check_node(node, UCS_VFS_NODE_TYPE_RO_FILE) ||
+           ucs_vfs_check_node(node, UCS_VFS_NODE_TYPE_RW_FILE);
+}
+
 /* must be called with lock held */
 static void
-ucs_vfs_read_ro_file(ucs_vfs_node_t *node, ucs_string_buffer_t *strb)
+ucs_vfs_read_file(ucs_vfs_node_t *node, ucs_string_buffer_t *strb)
 {
-    ucs_assert(ucs_vfs_check_node(node, UCS_VFS_NODE_TYPE_RO_FILE) == 1);
+    ucs_assert(ucs_vfs_check_file(node) == 1);
 
     ucs_spin_unlock(&ucs_vfs_obj_context.lock);
 
@@ -280,6 +290,23 @@ ucs_vfs_read_ro_file(ucs_vfs_node_t *node, ucs_string_buffer_t *strb)
     ucs_spin_lock(&ucs_vfs_obj_context.lock);
 }
 
+/* must be called with lock held and incremented refcount */
+static ucs_status_t
+ucs_vfs_write_file(ucs_vfs_node_t *node, const char *buffer, size_t size)
+{
+    ucs_status_t status;
+
+    ucs_assert(ucs_vfs_check_node(node, UCS_VFS_NODE_TYPE_RW_FILE) == 1);
+
+    ucs_spin_unlock(&ucs_vfs_obj_context.lock);
+
+    status = node->write_cb(node->parent->obj, buffer, size);
+
+    ucs_spin_lock(&ucs_vfs_obj_context.lock);
+
+    return status;
+}
+
 /* must be called with lock held */
 static void ucs_vfs_path_list_dir_cb(ucs_vfs_node_t *node,
                                      ucs_vfs_list_dir_cb_t dir_cb, void *arg)
@@ -323,6 +350,27 @@ void ucs_vfs_obj_add_ro_file(void *obj, ucs_vfs_file_show_cb_t text_cb,
     ucs_spin_unlock(&ucs_vfs_obj_context.lock);
 }
 
+void ucs_vfs_obj_add_rw_file(void *obj, ucs_vfs_file_show_cb_t text_cb,
+                             ucs_vfs_file_write_cb_t write_cb,
+                             const char *rel_path, ...)
+{
+    ucs_vfs_node_t *node;
+    va_list ap;
+
+    ucs_spin_lock(&ucs_vfs_obj_context.lock);
+
+    va_start(ap, rel_path);
+    node = ucs_vfs_node_add(obj, UCS_VFS_NODE_TYPE_RW_FILE, NULL, rel_path, ap);
+    va_end(ap);
+
+    if (node != NULL) {
+        node->text_cb  = text_cb;
+        node->write_cb = write_cb;
+    }
+
+    ucs_spin_unlock(&ucs_vfs_obj_context.lock);
+}
+
 void ucs_vfs_obj_remove(void *obj)
 {
     ucs_vfs_node_t *node;
@@ -370,9 +418,13 @@ ucs_status_t ucs_vfs_path_get_info(const char *path, ucs_vfs_path_info_t *info)
 
     switch (node->type) {
     case UCS_VFS_NODE_TYPE_RO_FILE:
+    case UCS_VFS_NODE_TYPE_RW_FILE:
         ucs_string_buffer_init(&strb);
-        ucs_vfs_read_ro_file(node, &strb);
+        ucs_vfs_read_file(node, &strb);
         info->mode = S_IFREG | S_IRUSR;
+        if (node->type == UCS_VFS_NODE_TYPE_RW_FILE) {
+            info->mode |= S_IWUSR;
+        }
         info->size = ucs_string_buffer_length(&strb);
         ucs_string_buffer_cleanup(&strb);
         status = UCS_OK;
@@ -405,14 +457,14 @@ ucs_status_t ucs_vfs_path_read_file(const char *path, ucs_string_buffer_t *strb)
     ucs_spin_lock(&ucs_vfs_obj_context.lock);
 
     node = ucs_vfs_node_find_by_path(path);
-    if (!ucs_vfs_check_node(node, UCS_VFS_NODE_TYPE_RO_FILE)) {
+    if (!ucs_vfs_check_file(node)) {
         status = UCS_ERR_NO_ELEM;
         goto out_unlock;
     }
 
     ucs_vfs_node_increase_refcount(node);
 
-    ucs_vfs_read_ro_file(node, strb);
+    ucs_vfs_read_file(node, strb);
     status = UCS_OK;
 
     ucs_vfs_node_decrease_refcount(node);
@@ -423,6 +475,32 @@ out_unlock:
     return status;
 }
 
+ucs_status_t ucs_vfs_path_write_file(const char *path, const char *buffer,
+                                     size_t size)
+{
+    ucs_vfs_node_t *node;
+    ucs_status_t status;
+
+    ucs_spin_lock(&ucs_vfs_obj_context.lock);
+
+    node = ucs_vfs_node_find_by_path(path);
+    if (!ucs_vfs_check_node(node, UCS_VFS_NODE_TYPE_RW_FILE)) {
+        status = UCS_ERR_NO_ELEM;
+        goto out_unlock;
+    }
+
+    ucs_vfs_node_increase_refcount(node);
+
+    status = ucs_vfs_write_file(node, buffer, size);
+
+    ucs_vfs_node_decrease_refcount(node);
+
+out_unlock:
+    ucs_spin_unlock(&ucs_vfs_obj_context.lock);
+
+    return status;
+}
+
 ucs_status_t
 ucs_vfs_path_list_dir(const char *path, ucs_vfs_list_dir_cb_t dir_cb, void *arg)
 {
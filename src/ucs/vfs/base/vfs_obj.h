@@ -19,7 +19,7 @@ BEGIN_C_DECLS
  */
 typedef struct {
     /**
-     * Size of the content in case of read-only file, and number of child
+     * Size of the content in case of a file, and number of child
      * directories if node is directory.
      */
     size_t size;
@@ -41,6 +41,19 @@ typedef struct {
 typedef void (*ucs_vfs_file_show_cb_t)(void *obj, ucs_string_buffer_t *strb);
 
 
+/**
+ * Function to update @a obj with the data written to its VFS file.
+ *
+ * @param [in] obj    Pointer to the object to be updated.
+ * @param [in] buffer Data written to the file.
+ * @param [in] size   Size of the data in @a buffer.
+ *
+ * @return UCS_OK if the data was accepted, or error code otherwise.
+ */
+typedef ucs_status_t (*ucs_vfs_file_write_cb_t)(void *obj, const char *buffer,
+                                                size_t size);
+
+
 /**
  * Function to update representation of object in VFS.
  * 
@@ -85,6 +98,21 @@ void ucs_vfs_obj_add_ro_file(void *obj, ucs_vfs_file_show_cb_t text_cb,
                              const char *rel_path, ...) UCS_F_PRINTF(3, 4);
 
 
+/**
+ * Add writable file to control object features in VFS. If @a obj is NULL, the
+ * mount directory will be used as the base for @a rel_path.
+ *
+ * @param [in] obj      Pointer to the object. @a rel_path is relative to @a obj
+ *                      directory.
+ * @param [in] text_cb  Callback method that generates the content of the file.
+ * @param [in] write_cb Callback method that processes data written to the file.
+ * @param [in] rel_path Format string which specifies relative path to the file.
+ */
+void ucs_vfs_obj_add_rw_file(void *obj, ucs_vfs_file_show_cb_t text_cb,
+                             ucs_vfs_file_write_cb_t write_cb,
+                             const char *rel_path, ...) UCS_F_PRINTF(4, 5);
+
+
 /**
  * Recursively remove directories and files associated with the object and its
  * children from VFS. The method removes all empty parent sub-directories.
@@ -136,6 +164,23 @@ ucs_status_t
 ucs_vfs_path_read_file(const char *path, ucs_string_buffer_t *strb);
 
 
+/**
+ * Write data to VFS node corresponding to the specified path. The data is
+ * processed by ucs_vfs_file_write_cb_t of the node.
+ *
+ * @param [in] path        String wich specifies path to find the node in VFS.
+ * @param [in] buffer      Data to write.
+ * @param [in] size        Size of the data in @a buffer.
+ *
+ * @return UCS_OK          Data was written successfully.
+ * @return UCS_ERR_NO_ELEM VFS node corresponding to specified path does not
+ *                         exist or it is not a writable file.
+ * @return Error code returned by ucs_vfs_file_write_cb_t of the node.
+ */
+ucs_status_t ucs_vfs_path_write_file(const char *path, const char *buffer,
+                                     size_t size);
+
+
 /**
  * Invoke callback @a dir_cb for children of VFS node corresponding to the
  * specified path.
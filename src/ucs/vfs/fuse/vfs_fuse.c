@@ -128,6 +128,30 @@ static int ucs_vfs_fuse_read(const char *path, char *buf, size_t size,
     return nread;
 }
 
+static int ucs_vfs_fuse_write(const char *path, const char *buf, size_t size,
+                              off_t offset, struct fuse_file_info *fi)
+{
+    ucs_status_t status;
+
+    status = ucs_vfs_path_write_file(path, buf, size);
+    if (status == UCS_ERR_NO_ELEM) {
+        return -ENOENT;
+    } else if (status != UCS_OK) {
+        return -EINVAL;
+    }
+
+    return size;
+}
+
+static int ucs_vfs_fuse_truncate(const char *path, off_t size,
+                                 struct fuse_file_info *fi)
+{
+    /* File content is generated on every read, so there is nothing to
+     * truncate. Allow it to support shell redirection to writable files.
+     */
+    return 0;
+}
+
 static int ucs_vfs_fuse_readdir(const char *path, void *buf,
                                 fuse_fill_dir_t filler, off_t offset,
                                 struct fuse_file_info *fi,
@@ -158,11 +182,13 @@ static int ucs_vfs_fuse_release(const char *path, struct fuse_file_info *fi)
 }
 
 struct fuse_operations ucs_vfs_fuse_operations = {
-    .getattr = ucs_vfs_fuse_getattr,
-    .open    = ucs_vfs_fuse_open,
-    .read    = ucs_vfs_fuse_read,
-    .readdir = ucs_vfs_fuse_readdir,
-    .release = ucs_vfs_fuse_release,
+    .getattr  = ucs_vfs_fuse_getattr,
+    .open     = ucs_vfs_fuse_open,
+    .read     = ucs_vfs_fuse_read,
+    .write    = ucs_vfs_fuse_write,
+    .truncate = ucs_vfs_fuse_truncate,
+    .readdir  = ucs_vfs_fuse_readdir,
+    .release  = ucs_vfs_fuse_release,
 };
 
 static void ucs_vfs_fuse_main()
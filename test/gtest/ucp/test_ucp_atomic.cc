@@ -7,6 +7,8 @@
 
 #include "test_ucp_memheap.h"
 
+#include <algorithm>
+
 extern "C" {
 #include <ucp/core/ucp_types.h> /* for atomic mode */
 }
@@ -71,6 +73,39 @@ public:
         EXPECT_EQ(prev, reply_data); /* expect the previous value */
     }
 
+    /* Many outstanding operations on the same location, which are aggregated
+     * by software atomics */
+    void fetch_add_nb(size_t size, void *target_ptr, ucp_rkey_h rkey,
+                      void *expected_data, void *arg)
+    {
+        const unsigned num_ops = 64;
+        T prev                 = *(T*)target_ptr;
+        T value                = 1;
+        std::vector<T> replies(num_ops);
+        std::vector<void*> reqs;
+        ucp_request_param_t param;
+
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_DATATYPE |
+                             UCP_OP_ATTR_FIELD_REPLY_BUFFER;
+        param.datatype     = ucp_dt_make_contig(sizeof(T));
+        for (unsigned i = 0; i < num_ops; ++i) {
+            param.reply_buffer = &replies[i];
+            reqs.push_back(ucp_atomic_op_nbx(sender().ep(), UCP_ATOMIC_OP_ADD,
+                                             &value, 1, (uintptr_t)target_ptr,
+                                             rkey, &param));
+        }
+
+        ASSERT_UCS_OK(requests_wait(reqs));
+
+        /* every operation fetched a different value */
+        std::sort(replies.begin(), replies.end());
+        for (unsigned i = 0; i < num_ops; ++i) {
+            EXPECT_EQ((T)(prev + i), replies[i]) << "i=" << i;
+        }
+
+        *(T*)expected_data = prev + num_ops;
+    }
+
 protected:
     static const uint64_t POST_ATOMIC_OPS  = UCS_BIT(UCP_ATOMIC_OP_ADD) |
                                              UCS_BIT(UCP_ATOMIC_OP_AND) |
@@ -192,6 +227,16 @@ UCS_TEST_P(test_ucp_atomic64, fetch) {
     test(static_cast<send_func_t>(&test_ucp_atomic64::fetch), FETCH_ATOMIC_OPS);
 }
 
+UCS_TEST_P(test_ucp_atomic64, fetch_add_nb) {
+    test(static_cast<send_func_t>(&test_ucp_atomic64::fetch_add_nb),
+         UCS_BIT(UCP_ATOMIC_OP_ADD), 10);
+}
+
+UCS_TEST_P(test_ucp_atomic64, fetch_add_nb_no_batch, "AMO_SW_BATCH=1") {
+    test(static_cast<send_func_t>(&test_ucp_atomic64::fetch_add_nb),
+         UCS_BIT(UCP_ATOMIC_OP_ADD), 10);
+}
+
 
 #if ENABLE_PARAMS_CHECK
 UCS_TEST_P(test_ucp_atomic32, misaligned_post) {
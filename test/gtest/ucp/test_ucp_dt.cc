@@ -51,6 +51,108 @@ UCS_TEST_F(test_ucp_dt_iov, seek)
     }
 };
 
+class test_ucp_dt_strided : public ucs::test {
+protected:
+    static const size_t BLOCK_COUNT  = 7;
+    static const size_t BLOCK_LENGTH = 12;
+    static const size_t STRIDE       = 40;
+    static const size_t COUNT        = 50;
+
+    size_t extent() const {
+        return ((BLOCK_COUNT - 1) * STRIDE) + BLOCK_LENGTH;
+    }
+
+    /* Reference packing of the strided buffer */
+    std::string pack_reference(const std::string &buffer) const {
+        std::string packed;
+
+        for (size_t i = 0; i < COUNT; ++i) {
+            for (size_t j = 0; j < BLOCK_COUNT; ++j) {
+                packed.append(buffer, (i * extent()) + (j * STRIDE),
+                              BLOCK_LENGTH);
+            }
+        }
+        return packed;
+    }
+};
+
+UCS_TEST_F(test_ucp_dt_strided, pack_unpack) {
+    ucp_datatype_t datatype;
+
+    ASSERT_UCS_OK(ucp_dt_create_strided(BLOCK_COUNT, BLOCK_LENGTH, STRIDE,
+                                        &datatype));
+    ASSERT_TRUE(UCP_DT_IS_GENERIC(datatype));
+
+    const ucp_generic_dt_ops_t *ops = &ucp_dt_to_generic(datatype)->ops;
+    void *context                   = ucp_dt_to_generic(datatype)->context;
+    std::string buffer(COUNT * extent(), 0);
+    ucs::fill_random(buffer);
+    std::string packed_ref = pack_reference(buffer);
+
+    /* Pack in random fragments */
+    void *state = ops->start_pack(context, &buffer[0], COUNT);
+    ASSERT_EQ(packed_ref.size(), ops->packed_size(state));
+
+    std::string packed(packed_ref.size(), 0);
+    for (size_t offset = 0; offset < packed.size();) {
+        offset += ops->pack(state, offset, &packed[offset],
+                            (ucs::rand() % (3 * BLOCK_LENGTH)) + 1);
+    }
+    ops->finish(state);
+    EXPECT_EQ(packed_ref, packed);
+
+    /* Unpack in random fragments, and in reverse order */
+    std::string unpacked(buffer.size(), 0);
+    state = ops->start_unpack(context, &unpacked[0], COUNT);
+    for (size_t end = packed.size(); end > 0;) {
+        size_t length = std::min(end, (ucs::rand() % (3 * BLOCK_LENGTH)) + 1);
+        end          -= length;
+        ASSERT_UCS_OK(ops->unpack(state, end, &packed[end], length));
+    }
+    EXPECT_EQ(UCS_ERR_MESSAGE_TRUNCATED,
+              ops->unpack(state, packed.size(), &packed[0], 1));
+    ops->finish(state);
+
+    /* Blocks are copied and gaps are not touched */
+    std::string expected(buffer.size(), 0);
+    for (size_t i = 0; i < COUNT; ++i) {
+        for (size_t j = 0; j < BLOCK_COUNT; ++j) {
+            size_t offset = (i * extent()) + (j * STRIDE);
+            expected.replace(offset, BLOCK_LENGTH, buffer, offset,
+                             BLOCK_LENGTH);
+        }
+    }
+    EXPECT_EQ(expected, unpacked);
+
+    ucp_dt_destroy(datatype);
+}
+
+UCS_TEST_F(test_ucp_dt_strided, dense_is_contig) {
+    ucp_datatype_t datatype;
+
+    ASSERT_UCS_OK(ucp_dt_create_strided(BLOCK_COUNT, BLOCK_LENGTH,
+                                        BLOCK_LENGTH, &datatype));
+    EXPECT_EQ(ucp_dt_make_contig(BLOCK_COUNT * BLOCK_LENGTH), datatype);
+    ucp_dt_destroy(datatype);
+
+    ASSERT_UCS_OK(ucp_dt_create_strided(1, BLOCK_LENGTH, STRIDE, &datatype));
+    EXPECT_EQ(ucp_dt_make_contig(BLOCK_LENGTH), datatype);
+    ucp_dt_destroy(datatype);
+}
+
+UCS_TEST_F(test_ucp_dt_strided, invalid_params) {
+    ucp_datatype_t datatype;
+
+    scoped_log_handler wrap_err(wrap_errors_logger);
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucp_dt_create_strided(0, BLOCK_LENGTH, STRIDE, &datatype));
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucp_dt_create_strided(BLOCK_COUNT, 0, STRIDE, &datatype));
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucp_dt_create_strided(BLOCK_COUNT, STRIDE + 1, STRIDE,
+                                    &datatype));
+}
+
 class test_ucp_dt_iter : public ucs::test_with_param<ucp_datatype_t> {
 protected:
     virtual void init() {
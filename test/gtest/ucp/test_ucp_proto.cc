@@ -14,8 +14,11 @@ extern "C" {
 #include <ucp/proto/proto_select.h>
 #include <ucp/proto/proto_select.inl>
 #include <ucp/core/ucp_worker.inl>
+#include <ucs/vfs/base/vfs_obj.h>
 }
 
+#include <sstream>
+
 class test_ucp_proto : public ucp_test {
 public:
     static void get_test_variants(std::vector<ucp_test_variant>& variants) {
@@ -111,4 +114,105 @@ UCS_TEST_P(test_ucp_proto, worker_print_info_rkey)
     ucp_worker_print_info(worker(), stdout);
 }
 
+UCS_TEST_P(test_ucp_proto, adaptive_thresholds, "PROTO_ADAPTIVE=y",
+           "PROTO_ADAPTIVE_INTERVAL=1", "PROTO_ADAPTIVE_SAMPLES=2")
+{
+    static const size_t max_length = UCS_MBYTE;
+    std::vector<char> send_buffer(max_length), recv_buffer(max_length);
+    ucp_request_param_t param;
+
+    param.op_attr_mask = 0;
+    for (int iter = 0; iter < 20; ++iter) {
+        for (size_t length = 1; length <= max_length;
+             length += (length / 4) + 1) {
+            void *rreq = ucp_tag_recv_nbx(receiver().worker(), &recv_buffer[0],
+                                          length, 0, 0, &param);
+            void *sreq = ucp_tag_send_nbx(sender().ep(), &send_buffer[0],
+                                          length, 0, &param);
+            ASSERT_UCS_OK(request_wait(sreq));
+            ASSERT_UCS_OK(request_wait(rreq));
+        }
+    }
+
+    /* Adapted thresholds must remain sorted and cover all message sizes */
+    ucp_proto_select_t *proto_select =
+            &worker()->ep_config[sender().ep()->cfg_index].proto_select;
+    ucp_proto_select_elem_t select_elem;
+    kh_foreach_value(&proto_select->hash, select_elem, {
+        const ucp_proto_threshold_elem_t *thresh_elem = select_elem.thresholds;
+        while (thresh_elem->max_msg_length != SIZE_MAX) {
+            EXPECT_LT(thresh_elem[0].max_msg_length,
+                      thresh_elem[1].max_msg_length);
+            ++thresh_elem;
+        }
+    })
+
+    ucp_ep_print_info(sender().ep(), stdout);
+}
+
+UCS_TEST_P(test_ucp_proto, proto_trace, "PROTO_TRACE_RATE=2",
+           "PROTO_TRACE_SIZE=16")
+{
+    static const unsigned num_sends = 40;
+    static const size_t length      = 256;
+    std::vector<char> send_buffer(length), recv_buffer(length);
+    ucp_proto_trace_t *trace = &worker()->proto_trace;
+    ucp_request_param_t param;
+    char path[256];
+
+    param.op_attr_mask = 0;
+
+    /* Tracing is off by default */
+    EXPECT_FALSE(trace->enable);
+
+    snprintf(path, sizeof(path), "/ucp/context/%s-%p/worker/%s-%p/proto_trace",
+             sender().ucph()->name, sender().ucph(), worker()->address_name,
+             worker());
+    ASSERT_UCS_OK(ucs_vfs_path_write_file((std::string(path) +
+                                           "/enable").c_str(), "1\n", 2));
+    EXPECT_TRUE(trace->enable);
+
+    for (unsigned i = 0; i < num_sends; ++i) {
+        void *rreq = ucp_tag_recv_nbx(receiver().worker(), &recv_buffer[0],
+                                      length, 0, 0, &param);
+        /* Sync send always allocates a request, unlike the inline path */
+        void *sreq = ucp_tag_send_sync_nbx(sender().ep(), &send_buffer[0],
+                                           length, 0, &param);
+        ASSERT_UCS_OK(request_wait(sreq));
+        ASSERT_UCS_OK(request_wait(rreq));
+    }
+
+    ASSERT_UCS_OK(ucs_vfs_path_write_file((std::string(path) +
+                                           "/enable").c_str(), "0", 1));
+    EXPECT_EQ(num_sends / 2, trace->count);
+
+    ucs_string_buffer_t strb;
+    ucs_string_buffer_init(&strb);
+    ASSERT_UCS_OK(ucs_vfs_path_read_file((std::string(path) +
+                                          "/records").c_str(), &strb));
+    std::string dump = ucs_string_buffer_cstr(&strb);
+    ucs_string_buffer_cleanup(&strb);
+
+    /* The ring keeps only the latest records */
+    std::istringstream records(dump);
+    unsigned num_records = 0;
+    std::string line;
+    while (std::getline(records, line)) {
+        if (line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string proto, op, mem_type, lanes, queued, status;
+        size_t size;
+        fields >> proto >> op >> mem_type >> size >> lanes >> queued >> status;
+        EXPECT_EQ("tag_send_sync", op) << line;
+        EXPECT_EQ("host", mem_type) << line;
+        EXPECT_EQ(length, size) << line;
+        EXPECT_EQ("ok", status) << line;
+        ++num_records;
+    }
+    EXPECT_EQ(trace->size, num_records);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_proto)
@@ -57,7 +57,27 @@ public:
         request_release(status_ptr);
     }
 
+    /* Completion is tracked by the counter, and checked after flush */
+    void put_counter(size_t size, void *target_ptr, ucp_rkey_h rkey,
+                     void *expected_data, void *arg) {
+        ucs_status_ptr_t status_ptr = do_put(size, target_ptr, rkey,
+                                             expected_data, arg, true);
+        ASSERT_EQ(UCS_STATUS_PTR(UCS_OK), status_ptr);
+        ++m_num_ops;
+    }
+
+    void get_counter(size_t size, void *target_ptr, ucp_rkey_h rkey,
+                     void *expected_data, void *arg) {
+        ucs_status_ptr_t status_ptr = do_get(size, target_ptr, rkey,
+                                             expected_data, true);
+        ASSERT_EQ(UCS_STATUS_PTR(UCS_OK), status_ptr);
+        ++m_num_ops;
+    }
+
 protected:
+    test_ucp_rma() : m_counter(0), m_num_ops(0) {
+    }
+
     static size_t default_max_size() {
         return (100 * UCS_MBYTE) / ucs::test_time_multiplier();
     }
@@ -84,6 +104,87 @@ protected:
                            UCS_MEMORY_TYPE_HOST, UCP_MEM_MAP_NONBLOCK);
     }
 
+    /* PGAS-style access of random remote locations, with up to 'window'
+     * operations in flight */
+    void test_random_access(bool use_counter, bool report = true) {
+        const size_t region_size = UCS_MBYTE;
+        const size_t window      = 256;
+        const size_t num_ops     = 100000 / ucs::test_time_multiplier();
+        std::vector<void*> reqs;
+        ucp_mem_map_params_t params;
+        ucp_mem_attr_t attr;
+        ucp_mem_h memh;
+        void *rkey_buffer;
+        size_t rkey_size;
+        ucp_rkey_h rkey;
+        uint64_t data;
+        double start;
+
+        params.field_mask = UCP_MEM_MAP_PARAM_FIELD_LENGTH |
+                            UCP_MEM_MAP_PARAM_FIELD_FLAGS;
+        params.length     = region_size;
+        params.flags      = UCP_MEM_MAP_ALLOCATE;
+        ASSERT_UCS_OK(ucp_mem_map(receiver().ucph(), &params, &memh));
+        ASSERT_UCS_OK(ucp_rkey_pack(receiver().ucph(), memh, &rkey_buffer,
+                                    &rkey_size));
+        ASSERT_UCS_OK(ucp_ep_rkey_unpack(sender().ep(), rkey_buffer, &rkey));
+
+        attr.field_mask = UCP_MEM_ATTR_FIELD_ADDRESS;
+        ASSERT_UCS_OK(ucp_mem_query(memh, &attr));
+
+        m_counter = 0;
+        start     = ucs_get_accurate_time();
+        for (size_t i = 0; i < num_ops; ++i) {
+            uint64_t offset = (ucs::rand() % (region_size / sizeof(data))) *
+                              sizeof(data);
+            data            = i;
+            ucs_status_ptr_t status_ptr = ucp_put_nbx(
+                    sender().ep(), &data, sizeof(data),
+                    (uintptr_t)attr.address + offset, rkey,
+                    rma_param(use_counter));
+            ASSERT_FALSE(UCS_PTR_IS_ERR(status_ptr));
+
+            if (use_counter) {
+                /* requests are not returned in counter mode */
+                ASSERT_TRUE(status_ptr == NULL);
+                if ((i + 1 - m_counter) >= window) {
+                    while (m_counter < (i + 1)) {
+                        progress();
+                    }
+                }
+            } else if (status_ptr != NULL) {
+                reqs.push_back(status_ptr);
+                if (reqs.size() >= window) {
+                    ASSERT_UCS_OK(requests_wait(reqs));
+                    reqs.clear();
+                }
+            }
+        }
+
+        if (use_counter) {
+            while (m_counter < num_ops) {
+                progress();
+            }
+        } else {
+            ASSERT_UCS_OK(requests_wait(reqs));
+        }
+        flush_worker(sender());
+
+        double time = ucs_get_accurate_time() - start;
+        if (report) {
+            UCS_TEST_MESSAGE << "random put " << sizeof(data) << " bytes with "
+                             << (use_counter ? "counter" : "requests") << ": "
+                             << (num_ops / time / 1e6) << " Mops/sec";
+        }
+
+        ucp_rkey_destroy(rkey);
+        ucp_rkey_buffer_release(rkey_buffer);
+        ASSERT_UCS_OK(ucp_mem_unmap(receiver().ucph(), memh));
+    }
+
+    uint64_t m_counter;
+    uint64_t m_num_ops;
+
 private:
     /* Test variants */
     enum {
@@ -91,24 +192,26 @@ private:
         ENABLE_PROTO = UCS_BIT(1)
     };
 
+    const ucp_request_param_t *rma_param(bool use_counter) {
+        m_param.op_attr_mask = use_counter ? UCP_OP_ATTR_FIELD_COUNTER : 0;
+        m_param.counter      = &m_counter;
+        return &m_param;
+    }
+
     ucs_status_ptr_t do_put(size_t size, void *target_ptr, ucp_rkey_h rkey,
-                            void *expected_data, void *arg) {
+                            void *expected_data, void *arg,
+                            bool use_counter = false) {
         ucs_memory_type_t *mem_types = reinterpret_cast<ucs_memory_type_t*>(arg);
         mem_buffer::pattern_fill(expected_data, size, ucs::rand(), mem_types[0]);
 
-        ucp_request_param_t param;
-        param.op_attr_mask = 0;
         return ucp_put_nbx(sender().ep(), expected_data, size,
-                           (uintptr_t)target_ptr, rkey, &param);
+                           (uintptr_t)target_ptr, rkey, rma_param(use_counter));
     }
 
     ucs_status_ptr_t do_get(size_t size, void *target_ptr, ucp_rkey_h rkey,
-                            void *expected_data) {
-        ucp_request_param_t param;
-
-        param.op_attr_mask = 0;
+                            void *expected_data, bool use_counter = false) {
         return ucp_get_nbx(sender().ep(), expected_data, size,
-                           (uintptr_t)target_ptr, rkey, &param);
+                           (uintptr_t)target_ptr, rkey, rma_param(use_counter));
     }
 
     void test_message_sizes(send_func_t send_func, size_t max_size,
@@ -151,6 +254,8 @@ private:
     bool enable_proto() {
         return get_variant_value() & ENABLE_PROTO;
     }
+
+    ucp_request_param_t m_param;
 };
 
 UCS_TEST_P(test_ucp_rma, put_blocking) {
@@ -169,6 +274,24 @@ UCS_TEST_P(test_ucp_rma, get_nonblocking) {
     test_mem_types(static_cast<send_func_t>(&test_ucp_rma::get_nbi));
 }
 
+UCS_TEST_P(test_ucp_rma, put_counter) {
+    test_mem_types(static_cast<send_func_t>(&test_ucp_rma::put_counter));
+    EXPECT_EQ(m_num_ops, m_counter);
+}
+
+UCS_TEST_P(test_ucp_rma, get_counter) {
+    test_mem_types(static_cast<send_func_t>(&test_ucp_rma::get_counter));
+    EXPECT_EQ(m_num_ops, m_counter);
+}
+
+UCS_TEST_P(test_ucp_rma, random_access_rate) {
+    /* warmup */
+    test_random_access(true, false);
+
+    test_random_access(true);
+    test_random_access(false);
+}
+
 UCS_TEST_P(test_ucp_rma, get_blocking_zcopy, "ZCOPY_THRESH=0") {
     /* test get_zcopy minimal message length is respected */
     test_mem_types(static_cast<send_func_t>(&test_ucp_rma::get_b),
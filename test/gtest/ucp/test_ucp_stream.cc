@@ -193,6 +193,7 @@ protected:
     template <typename T, unsigned recv_flags>
     void do_send_exp_recv_test(ucp_datatype_t datatype);
     void do_send_recv_data_recv_test(ucp_datatype_t datatype);
+    void do_recv_bw_test();
 
     /* for self-validation of generic datatype
      * NOTE: it's tested only with byte array data since it's recv completion
@@ -643,6 +644,68 @@ UCS_TEST_P(test_ucp_stream, send_zero_ending_iov_recv_data) {
     }
 }
 
+void test_ucp_stream::do_recv_bw_test()
+{
+    const size_t total_size   = 16 * UCS_MBYTE;
+    ucp_request_param_t param = {0};
+    std::vector<char> sbuf(total_size);
+    std::vector<char> rbuf(total_size);
+
+    ucs::fill_random(sbuf);
+
+    for (size_t chunk = 64 * UCS_KBYTE; chunk <= total_size; chunk *= 4) {
+        std::vector<void*> sreqs;
+        size_t roffset   = 0;
+        size_t num_recvs = 0;
+        size_t length;
+
+        std::fill(rbuf.begin(), rbuf.end(), 0);
+        ucs_time_t start_time = ucs_get_time();
+
+        for (size_t soffset = 0; soffset < total_size; soffset += chunk) {
+            void *sreq = ucp_stream_send_nbx(sender().ep(), &sbuf[soffset],
+                                             chunk, &param);
+            ASSERT_UCS_PTR_OK(sreq);
+            sreqs.push_back(sreq);
+        }
+
+        /* Without WAITALL, each receive completes with the data which arrived
+         * so far */
+        while (roffset < total_size) {
+            void *rreq = ucp_stream_recv_nbx(receiver().ep(), &rbuf[roffset],
+                                             chunk, &length, &param);
+            ASSERT_UCS_PTR_OK(rreq);
+            if (rreq != NULL) {
+                length = wait_stream_recv(rreq);
+            }
+
+            roffset += length;
+            ++num_recvs;
+        }
+
+        for (size_t i = 0; i < sreqs.size(); ++i) {
+            request_wait(sreqs[i]);
+        }
+
+        double elapsed = ucs_time_to_sec(ucs_get_time() - start_time);
+        UCS_TEST_MESSAGE << "chunk " << (chunk / UCS_KBYTE) << " KB: "
+                         << (total_size / elapsed / UCS_MBYTE) << " MB/s, "
+                         << (total_size / num_recvs)
+                         << " bytes per receive on average";
+
+        EXPECT_EQ(total_size, roffset);
+        EXPECT_TRUE(sbuf == rbuf);
+    }
+}
+
+UCS_TEST_P(test_ucp_stream, recv_bw) {
+    do_recv_bw_test();
+}
+
+UCS_TEST_P(test_ucp_stream, recv_bw_coalesce, "STREAM_RECV_COALESCE=y") {
+    do_recv_bw_test();
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_stream)
 
 class test_ucp_stream_many2one : public test_ucp_stream_base {
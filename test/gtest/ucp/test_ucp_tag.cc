@@ -555,3 +555,58 @@ UCS_TEST_P(test_ucp_tag_nbx, external_request_free)
 }
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_nbx)
+
+
+class test_ucp_tag_persistent : public test_ucp_tag {
+protected:
+    void persistent_send_recv(size_t size, unsigned iters)
+    {
+        ucp_request_param_t param = {0};
+        std::vector<char> send_buffer(size);
+        std::vector<char> recv_buffer(size);
+
+        void *preq = ucp_tag_send_init_nbx(sender().ep(), &send_buffer[0],
+                                           size, 0x111, &param);
+        ASSERT_UCS_PTR_OK(preq);
+        ASSERT_TRUE(preq != NULL);
+        EXPECT_EQ(UCS_OK, ucp_request_check_status(preq));
+
+        for (unsigned i = 0; i < iters; ++i) {
+            /* The buffer may be modified between operations */
+            ucs::fill_random(send_buffer);
+
+            void *rreq = ucp_tag_recv_nbx(receiver().worker(), &recv_buffer[0],
+                                          size, 0x111, (ucp_tag_t)-1, &param);
+            ASSERT_UCS_PTR_OK(rreq);
+
+            ASSERT_UCS_OK(ucp_request_start(preq));
+            if (ucp_request_check_status(preq) == UCS_INPROGRESS) {
+                EXPECT_EQ(UCS_ERR_BUSY, ucp_request_start(preq));
+            }
+
+            while (ucp_request_check_status(preq) == UCS_INPROGRESS) {
+                progress();
+            }
+            EXPECT_EQ(UCS_OK, ucp_request_check_status(preq));
+            ASSERT_UCS_OK(request_wait(rreq));
+            EXPECT_EQ(send_buffer, recv_buffer);
+        }
+
+        ucp_request_free(preq);
+    }
+};
+
+UCS_TEST_P(test_ucp_tag_persistent, eager) {
+    persistent_send_recv(100, 20);
+}
+
+UCS_TEST_P(test_ucp_tag_persistent, rndv, "RNDV_THRESH=1000") {
+    persistent_send_recv(64 * UCS_KBYTE, 20);
+}
+
+UCS_TEST_P(test_ucp_tag_persistent, proto_v2, "PROTO_ENABLE=y") {
+    persistent_send_recv(100, 10);
+    persistent_send_recv(64 * UCS_KBYTE, 10);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_persistent)
@@ -11,6 +11,7 @@
 extern "C" {
 #include <ucp/core/ucp_request.h>
 #include <ucp/core/ucp_types.h>
+#include <ucp/core/ucp_worker.h>
 }
 
 using namespace ucs; /* For vector<char> serialization */
@@ -100,6 +101,38 @@ UCS_TEST_P(test_ucp_tag_match, send_recv_unexp) {
     EXPECT_EQ(send_data, recv_data);
 }
 
+UCS_TEST_P(test_ucp_tag_match, counters_unexp) {
+    ucs_counters_t *rx_counters = &receiver().worker()->counters;
+    ucs_counters_t *tx_counters = &sender().worker()->counters;
+    ucp_tag_recv_info_t info;
+    ucs_status_t        status;
+
+    uint64_t send_data = 0xdeadbeefdeadbeef;
+    uint64_t recv_data = 0;
+
+    send_b(&send_data, sizeof(send_data), DATATYPE, 0x111337);
+
+    short_progress_loop(); /* Receive messages as unexpected */
+
+    EXPECT_EQ(1, ucs_counters_get(rx_counters,
+                                  UCP_WORKER_COUNTER_TAG_UNEXP_DEPTH));
+
+    status = recv_b(&recv_data, sizeof(recv_data), DATATYPE, 0x1337, 0xffff, &info);
+    ASSERT_UCS_OK(status);
+
+    EXPECT_EQ(0, ucs_counters_get(rx_counters,
+                                  UCP_WORKER_COUNTER_TAG_UNEXP_DEPTH));
+    EXPECT_EQ(1, ucs_counters_get(rx_counters,
+                                  UCP_WORKER_COUNTER_TAG_RX_EAGER));
+    if (!use_proto()) {
+        EXPECT_EQ(1, ucs_counters_get(tx_counters,
+                                      UCP_WORKER_COUNTER_TAG_TX_EAGER));
+        EXPECT_EQ((int64_t)sizeof(send_data),
+                  ucs_counters_get(tx_counters,
+                                   UCP_WORKER_COUNTER_TAG_TX_EAGER_BYTES));
+    }
+}
+
 UCS_TEST_SKIP_COND_P(test_ucp_tag_match, send_recv_unexp_rqfree,
                      /* request free cannot be used for external requests */
                      (get_variant_value() == RECV_REQ_EXTERNAL)) {
@@ -189,6 +189,29 @@ UCS_TEST_P(test_ucp_tag_mem_type, basic)
 
 }
 
+UCS_TEST_P(test_ucp_tag_mem_type, pipeline_depth, "RNDV_FRAG_SIZE=64k",
+           "RNDV_PIPELINE_DEPTH=2")
+{
+    ucp_datatype_t type = ucp_dt_make_contig(1);
+    size_t max_length   = 4 * UCS_MBYTE;
+
+    UCS_TEST_MESSAGE << "TEST: "
+                     << ucs_memory_type_names[m_send_mem_type] << " <-> "
+                     << ucs_memory_type_names[m_recv_mem_type];
+
+    mem_buffer m_recv_mem_buf(max_length, m_recv_mem_type);
+    mem_buffer m_send_mem_buf(max_length, m_send_mem_type);
+
+    /* lengths which are not a multiple of the fragment size, and much
+     * larger than the pipeline window */
+    for (unsigned i = 0; i < 3; ++i) {
+        size_t length = max_length - (ucs::rand() % (64 * UCS_KBYTE));
+
+        do_basic_send(m_send_mem_buf.ptr(), m_recv_mem_buf.ptr(), length, type,
+                      m_send_mem_buf.mem_type(), m_recv_mem_buf.mem_type());
+    }
+}
+
 UCS_TEST_P(test_ucp_tag_mem_type, xfer_mismatch_length)
 {
     ucp_datatype_t type = ucp_dt_make_contig(1);
@@ -122,4 +122,53 @@ UCS_TEST_P(test_ucp_tag_perf, multi_unexp) {
     check_scalability(1.5, false);
 }
 
+UCS_TEST_P(test_ucp_tag_perf, vector_halo) {
+    const unsigned iters = 20;
+
+    /* Send a column of a 2D grid of doubles, as in a halo exchange */
+    for (size_t dim = 64; dim <= 4096; dim *= 4) {
+        std::vector<double> grid(dim * dim), recv_grid(dim * dim);
+        std::vector<ucp_dt_iov_t> send_iov(dim), recv_iov(dim);
+        ucp_datatype_t column;
+
+        ucs::fill_random(grid);
+        ASSERT_UCS_OK(ucp_dt_create_strided(dim, sizeof(double),
+                                            dim * sizeof(double), &column));
+        for (size_t i = 0; i < dim; ++i) {
+            send_iov[i].buffer = &grid[i * dim];
+            send_iov[i].length = sizeof(double);
+            recv_iov[i].buffer = &recv_grid[i * dim];
+            recv_iov[i].length = sizeof(double);
+        }
+
+        ucs_time_t start_time = ucs_get_time();
+        for (unsigned i = 0; i < iters; ++i) {
+            request *rreq = recv_nb(&recv_grid[0], 1, column, i, TAG_MASK);
+            send_b(&grid[0], 1, column, i);
+            wait_and_validate(rreq);
+        }
+        double strided_time = ucs_time_to_sec(ucs_get_time() - start_time);
+
+        for (size_t i = 0; i < dim; ++i) {
+            EXPECT_EQ(grid[i * dim], recv_grid[i * dim]) << "row " << i;
+        }
+
+        start_time = ucs_get_time();
+        for (unsigned i = 0; i < iters; ++i) {
+            request *rreq = recv_nb(&recv_iov[0], dim, DATATYPE_IOV, i,
+                                    TAG_MASK);
+            send_b(&send_iov[0], dim, DATATYPE_IOV, i);
+            wait_and_validate(rreq);
+        }
+        double iov_time = ucs_time_to_sec(ucs_get_time() - start_time);
+
+        UCS_TEST_MESSAGE << "halo of " << dim << " doubles: strided "
+                         << (strided_time * UCS_USEC_PER_SEC / iters)
+                         << " us, iov "
+                         << (iov_time * UCS_USEC_PER_SEC / iters) << " us";
+
+        ucp_dt_destroy(column);
+    }
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_perf)
@@ -58,6 +58,15 @@ public:
         test_ucp_tag::init();
     }
 
+    double rate(ucp_lane_index_t lane) {
+        ucp_worker_h worker = sender().worker();
+        ucp_rsc_index_t rsc = ucp_ep_get_rsc_index(sender().ep(), lane);
+        uct_iface_attr_t *attr = ucp_worker_iface_get_attr(worker, rsc);
+
+        return ucp_tl_iface_bandwidth(worker->context, &attr->bandwidth) /
+               ucs_max(ucp_ep_config(sender().ep())->am.max_bcopy, 1);
+    }
+
     bool skip_on_ib_dc() {
 #if HAVE_DC_DV
         // skip due to DCI stuck bug
@@ -1005,6 +1014,39 @@ UCS_TEST_P(test_ucp_tag_xfer, iov_with_empty_buffers, "ZCOPY_THRESH=512") {
                                "IOV"));
 }
 
+UCS_TEST_P(test_ucp_tag_xfer, am_bw_stripe, "RNDV_THRESH=1248576") {
+    ucp_ep_config_t *config = ucp_ep_config(sender().ep());
+    const ucp_ep_config_key_t *key = &config->key;
+    std::map<ucp_lane_index_t, unsigned> count;
+
+    ASSERT_GE(config->am_bw_stripe.length, 1);
+    ASSERT_LE(config->am_bw_stripe.length, UCP_EP_AM_BW_STRIPE_MAX);
+
+    /* every stripe entry must be one of the AM bandwidth lanes */
+    for (unsigned i = 0; i < config->am_bw_stripe.length; ++i) {
+        ucp_lane_index_t lane = config->am_bw_stripe.lanes[i];
+        EXPECT_NE(key->am_bw_lanes + UCP_MAX_LANES,
+                  std::find(key->am_bw_lanes, key->am_bw_lanes + UCP_MAX_LANES,
+                            lane)) << "lane " << (int)lane;
+        ++count[lane];
+    }
+
+    /* a lane which sends fragments at a higher rate must not appear less
+     * often than a slower one */
+    for (std::map<ucp_lane_index_t, unsigned>::iterator it1 = count.begin();
+         it1 != count.end(); ++it1) {
+        for (std::map<ucp_lane_index_t, unsigned>::iterator it2 = count.begin();
+             it2 != count.end(); ++it2) {
+            if (rate(it1->first) > rate(it2->first)) {
+                EXPECT_GE(it1->second, it2->second);
+            }
+        }
+    }
+
+    /* multi-fragment eager message striped over the lanes */
+    test_xfer(&test_ucp_tag_xfer::test_xfer_contig, true, false, false);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_xfer)
 
 
@@ -1150,3 +1192,72 @@ UCS_TEST_P(test_ucp_tag_stats, rndv_unexpected, "RNDV_THRESH=1000") {
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_stats)
 
 #endif
+
+
+class test_ucp_tag_tx_sched : public test_ucp_tag {
+public:
+    void init() {
+        test_ucp_tag::init();
+        /* second endpoint to the same receiver */
+        sender().connect(&receiver(), get_ep_params(), 1);
+    }
+
+protected:
+    void test_xfer_two_eps(size_t size, unsigned count) {
+        std::vector<std::vector<char> > sbufs, rbufs;
+        std::vector<void*> sreqs, rreqs;
+        ucp_request_param_t param;
+
+        param.op_attr_mask = 0;
+        for (unsigned i = 0; i < 2 * count; ++i) {
+            sbufs.push_back(std::vector<char>(size));
+            rbufs.push_back(std::vector<char>(size, 0));
+            ucs::fill_random(sbufs.back());
+        }
+
+        /* every endpoint sends its own tag, so its messages are matched in
+         * order regardless of how the sends of the endpoints interleave */
+        for (unsigned i = 0; i < 2 * count; ++i) {
+            rreqs.push_back(ucp_tag_recv_nbx(receiver().worker(),
+                                             &rbufs[i][0], size, i % 2,
+                                             (ucp_tag_t)-1, &param));
+        }
+
+        for (unsigned i = 0; i < 2 * count; ++i) {
+            sreqs.push_back(ucp_tag_send_nbx(sender().ep(0, i % 2),
+                                             &sbufs[i][0], size, i % 2,
+                                             &param));
+        }
+
+        ASSERT_UCS_OK(requests_wait(sreqs));
+        ASSERT_UCS_OK(requests_wait(rreqs));
+
+        for (unsigned i = 0; i < 2 * count; ++i) {
+            EXPECT_EQ(sbufs[i], rbufs[i]) << "message " << i;
+        }
+
+        /* all fragmented sends left the pending queues */
+        EXPECT_EQ(0u, sender().worker()->tx_sched.num_eps);
+        for (int ep_index = 0; ep_index < 2; ++ep_index) {
+            EXPECT_EQ(0u, ucp_ep_ext_control(sender().ep(0, ep_index))
+                                  ->tx_sched.num_reqs);
+        }
+    }
+};
+
+UCS_TEST_P(test_ucp_tag_tx_sched, eager, "TX_SCHED_QUANTUM=1k",
+           "RNDV_THRESH=inf") {
+    test_xfer_two_eps(256 * UCS_KBYTE, 16);
+}
+
+UCS_TEST_P(test_ucp_tag_tx_sched, rndv, "TX_SCHED_QUANTUM=1k",
+           "RNDV_THRESH=1k") {
+    test_xfer_two_eps(UCS_MBYTE, 8);
+}
+
+UCS_TEST_P(test_ucp_tag_tx_sched, disabled, "TX_SCHED_QUANTUM=inf",
+           "RNDV_THRESH=inf") {
+    test_xfer_two_eps(256 * UCS_KBYTE, 16);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_tx_sched)
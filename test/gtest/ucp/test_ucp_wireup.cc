@@ -511,6 +511,108 @@ UCS_TEST_P(test_ucp_wireup_1sided, empty_address) {
     ucs_free(buffer);
 }
 
+UCS_TEST_P(test_ucp_wireup_1sided, compact_address) {
+    const int count = 1000 / ucs::test_time_multiplier();
+    ucp_worker_attr_t attr;
+    ucp_address_t *address;
+    size_t address_length;
+    double start, full_time, compact_time;
+
+    attr.field_mask    = UCP_WORKER_ATTR_FIELD_ADDRESS |
+                         UCP_WORKER_ATTR_FIELD_ADDRESS_FLAGS;
+    attr.address_flags = UCP_WORKER_ADDRESS_FLAG_COMPACT;
+    ASSERT_UCS_OK(ucp_worker_query(receiver().worker(), &attr));
+    ASSERT_UCS_OK(ucp_worker_get_address(receiver().worker(), &address,
+                                         &address_length));
+    EXPECT_LT(attr.address_length, address_length);
+
+    /* unpack by another worker with the same configuration */
+    ucp_unpacked_address full, compact;
+    ASSERT_UCS_OK(ucp_address_unpack(sender().worker(), address,
+                                     UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT,
+                                     &full));
+    ASSERT_UCS_OK(ucp_address_unpack(sender().worker(), attr.address,
+                                     UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT,
+                                     &compact));
+    EXPECT_EQ(address_length, full.packed_size);
+    EXPECT_EQ(attr.address_length, compact.packed_size);
+    EXPECT_EQ(full.uuid, compact.uuid);
+    EXPECT_EQ(std::string(full.name), std::string(compact.name));
+    ASSERT_EQ(full.address_count, compact.address_count);
+
+    for (unsigned i = 0; i < full.address_count; ++i) {
+        const ucp_address_entry_t *fae = &full.address_list[i];
+        const ucp_address_entry_t *cae = &compact.address_list[i];
+
+        EXPECT_EQ(fae->tl_name_csum, cae->tl_name_csum);
+        EXPECT_EQ(fae->md_index, cae->md_index);
+        EXPECT_EQ(fae->md_flags, cae->md_flags);
+        EXPECT_EQ(fae->dev_index, cae->dev_index);
+        EXPECT_EQ(fae->dev_num_paths, cae->dev_num_paths);
+        EXPECT_EQ(fae->iface_attr.cap_flags, cae->iface_attr.cap_flags);
+        EXPECT_EQ(fae->iface_attr.priority, cae->iface_attr.priority);
+        EXPECT_EQ(fae->iface_attr.dst_rsc_index,
+                  cae->iface_attr.dst_rsc_index);
+        EXPECT_EQ(0u, cae->num_ep_addrs);
+        EXPECT_EQ(fae->dev_addr == NULL, cae->dev_addr == NULL);
+        EXPECT_EQ(fae->iface_addr == NULL, cae->iface_addr == NULL);
+    }
+
+    ucs_free(full.address_list);
+    ucs_free(compact.address_list);
+
+    start = ucs_get_accurate_time();
+    for (int i = 0; i < count; ++i) {
+        ASSERT_UCS_OK(ucp_address_unpack(sender().worker(), address,
+                                         UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT,
+                                         &full));
+        ucs_free(full.address_list);
+    }
+    full_time = ucs_get_accurate_time() - start;
+
+    start = ucs_get_accurate_time();
+    for (int i = 0; i < count; ++i) {
+        ASSERT_UCS_OK(ucp_address_unpack(sender().worker(), attr.address,
+                                         UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT,
+                                         &compact));
+        ucs_free(compact.address_list);
+    }
+    compact_time = ucs_get_accurate_time() - start;
+
+    UCS_TEST_MESSAGE << "address size " << address_length << " -> "
+                     << attr.address_length << " bytes, unpack time "
+                     << (full_time * UCS_USEC_PER_SEC / count) << " -> "
+                     << (compact_time * UCS_USEC_PER_SEC / count) << " us";
+
+    ucp_worker_release_address(receiver().worker(), address);
+    ucp_worker_release_address(receiver().worker(), attr.address);
+}
+
+UCS_TEST_P(test_ucp_wireup_1sided, compact_address_connect) {
+    ucp_worker_attr_t attr;
+    ucp_ep_params_t ep_params;
+    ucp_ep_h ep;
+
+    attr.field_mask    = UCP_WORKER_ATTR_FIELD_ADDRESS |
+                         UCP_WORKER_ATTR_FIELD_ADDRESS_FLAGS;
+    attr.address_flags = UCP_WORKER_ADDRESS_FLAG_COMPACT;
+    ASSERT_UCS_OK(ucp_worker_query(receiver().worker(), &attr));
+
+    ep_params             = get_ep_params();
+    ep_params.field_mask |= UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+    ep_params.address     = attr.address;
+    ASSERT_UCS_OK(ucp_ep_create(sender().worker(), &ep_params, &ep));
+    ucp_worker_release_address(receiver().worker(), attr.address);
+
+    send_recv(ep, receiver().worker(), receiver().ep(), 1, 1);
+    flush_worker(sender());
+
+    void *req = ucp_ep_close_nb(ep, UCP_EP_CLOSE_MODE_FLUSH);
+    if (UCS_PTR_IS_PTR(req)) {
+        request_wait(req);
+    }
+}
+
 UCS_TEST_P(test_ucp_wireup_1sided, one_sided_wireup) {
     sender().connect(&receiver(), get_ep_params());
     send_recv(sender().ep(), receiver().worker(), receiver().ep(), 1, 1);
@@ -920,6 +1022,91 @@ UCS_TEST_P(test_ucp_wireup_errh_peer, msg_before_ep_create) {
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_wireup_errh_peer)
 
+class test_ucp_wireup_lazy : public test_ucp_wireup {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant>& variants)
+    {
+        test_ucp_wireup::get_test_variants(variants, UCP_FEATURE_RMA |
+                                           UCP_FEATURE_TAG | UCP_FEATURE_STREAM);
+    }
+
+    virtual void init() {
+        modify_config("EP_LAZY_CONNECT", "y");
+        test_ucp_wireup::init();
+        /* loopback endpoints are always connected right away */
+        skip_loopback();
+    }
+
+protected:
+    static bool is_lazy(ucp_ep_h ep) {
+        return ep->flags & UCP_EP_FLAG_LAZY_CONNECT;
+    }
+
+    double connect_time(entity &from, const entity &to, unsigned count) {
+        double start = ucs_get_accurate_time();
+
+        for (unsigned i = 0; i < count; ++i) {
+            from.connect(&to, get_ep_params(), i);
+        }
+
+        return ucs_get_accurate_time() - start;
+    }
+};
+
+UCS_TEST_P(test_ucp_wireup_lazy, connect_on_first_op) {
+    sender().connect(&receiver(), get_ep_params());
+    receiver().connect(&sender(), get_ep_params());
+    EXPECT_TRUE(is_lazy(sender().ep()));
+    EXPECT_EQ(UCP_WORKER_CFG_INDEX_NULL, sender().ep()->cfg_index);
+
+    send_recv(sender().ep(), receiver().worker(), receiver().ep(), 8, 1);
+    EXPECT_FALSE(is_lazy(sender().ep()));
+
+    send_recv(receiver().ep(), sender().worker(), sender().ep(), 8, 1);
+    EXPECT_FALSE(is_lazy(receiver().ep()));
+    flush_workers();
+}
+
+UCS_TEST_P(test_ucp_wireup_lazy, close_unconnected) {
+    sender().connect(&receiver(), get_ep_params());
+    EXPECT_TRUE(is_lazy(sender().ep()));
+
+    flush_worker(sender());
+    flush_ep(sender());
+    disconnect(sender());
+}
+
+UCS_TEST_P(test_ucp_wireup_lazy, startup_time) {
+    const unsigned count = ucs_min(64, max_connections() / 2);
+    entity &lazy_sender  = sender();
+    entity &peer         = receiver();
+    double lazy_time, eager_time;
+
+    lazy_time = connect_time(lazy_sender, peer, count);
+    for (unsigned i = 0; i < count; ++i) {
+        ASSERT_TRUE(is_lazy(lazy_sender.ep(0, i)));
+    }
+
+    /* the new entity becomes the last one, so use saved references below */
+    modify_config("EP_LAZY_CONNECT", "n");
+    eager_time = connect_time(*create_entity(), peer, count);
+
+    UCS_TEST_MESSAGE << count << " endpoints created in "
+                     << (lazy_time * UCS_USEC_PER_SEC) << " us lazily, "
+                     << (eager_time * UCS_USEC_PER_SEC) << " us eagerly";
+
+    /* only the used endpoint is connected */
+    peer.connect(&lazy_sender, get_ep_params());
+    send_recv(lazy_sender.ep(), peer.worker(), peer.ep(), 8, 1);
+    EXPECT_FALSE(is_lazy(lazy_sender.ep(0, 0)));
+    for (unsigned i = 1; i < count; ++i) {
+        EXPECT_TRUE(is_lazy(lazy_sender.ep(0, i)));
+    }
+    flush_workers();
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_wireup_lazy)
+
 class test_ucp_wireup_fallback : public test_ucp_wireup {
 public:
     test_ucp_wireup_fallback() {
@@ -1506,4 +1693,75 @@ UCS_TEST_P(test_ucp_wireup_keepalive, attr) {
     EXPECT_NE(0, ep_config->key.ep_check_map);
 }
 
+/* measure the keepalive cost of idle endpoints and how long a peer failure
+ * could remain undetected, as a function of the number of endpoints */
+UCS_TEST_P(test_ucp_wireup_keepalive, scale, "KEEPALIVE_INTERVAL=0.1s") {
+    const double interval = 0.1;
+    const int max_eps     = std::min(512, max_connections());
+    std::vector<std::pair<ucp_ep_h, ucp_ep_h> > pairs;
+    ucs_time_t start, now, last_rx, max_gap, progress_time;
+    unsigned progress_count;
+    ucp_ep_h ep;
+
+    skip_loopback();
+    if (!sender().has_lane_with_caps(UCT_IFACE_FLAG_EP_CHECK)) {
+        UCS_TEST_SKIP_R("Unsupported");
+    }
+
+    for (int num_eps = 1; num_eps <= max_eps; num_eps *= 8) {
+        for (int i = sender().get_num_eps(); i < num_eps; ++i) {
+            sender().connect(&receiver(), get_ep_params(), i);
+            flush_ep(sender(), 0, i);
+        }
+
+        /* initiate p2p pairing, to match the endpoints of each pair */
+        for (int i = 0; i < num_eps; ++i) {
+            ep = sender().ep(0, i);
+            ucp_ep_resolve_remote_id(ep, 0);
+            while (!(ep->flags & UCP_EP_FLAG_REMOTE_ID)) {
+                progress();
+            }
+        }
+
+        pairs.clear();
+        for (int i = 0; i < num_eps; ++i) {
+            ASSERT_UCS_OK(ucp_worker_get_ep_by_id(receiver().worker(),
+                                                  ucp_ep_remote_id(
+                                                          sender().ep(0, i)),
+                                                  &ep));
+            pairs.push_back(std::make_pair(sender().ep(0, i), ep));
+        }
+
+        progress_time  = 0;
+        progress_count = 0;
+        max_gap        = 0;
+        start          = ucs_get_time();
+        do {
+            now = ucs_get_time();
+            sender().progress();
+            progress_time += ucs_get_time() - now;
+            ++progress_count;
+            receiver().progress();
+
+            /* a failure is detected by the next keepalive message, in any
+             * direction, after the peer stops responding */
+            now = ucs_get_time();
+            for (size_t i = 0; i < pairs.size(); ++i) {
+                last_rx = std::max(
+                        ucp_ep_ext_control(pairs[i].first)->keepalive.rx_time,
+                        ucp_ep_ext_control(pairs[i].second)->keepalive.rx_time);
+                max_gap = std::max(max_gap, now - last_rx);
+            }
+        } while (ucs_time_to_sec(now - start) < (10 * interval));
+
+        UCS_TEST_MESSAGE << num_eps << " endpoints: "
+                         << (ucs_time_to_nsec(progress_time) / progress_count)
+                         << " ns per progress, max detection latency "
+                         << (ucs_time_to_sec(max_gap) / interval)
+                         << " intervals";
+        EXPECT_LT(ucs_time_to_sec(max_gap),
+                  4 * interval * ucs::test_time_multiplier());
+    }
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_wireup_keepalive)
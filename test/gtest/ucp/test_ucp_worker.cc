@@ -11,6 +11,7 @@
 extern "C" {
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_worker.inl>
+#include <ucp/core/ucp_ep.inl>
 #include <ucp/core/ucp_request.h>
 #include <ucp/wireup/wireup_ep.h>
 #include <uct/base/uct_iface.h>
@@ -612,3 +613,269 @@ UCS_TEST_P(test_ucp_worker_thread_mode, query)
 }
 
 UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_worker_thread_mode, all, "all")
+
+
+class test_ucp_worker_config : public ucp_test {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant> &variants)
+    {
+        add_variant_with_value(variants, UCP_FEATURE_RMA, 0, "");
+        add_variant_with_value(variants, UCP_FEATURE_RMA, 1, "proto");
+    }
+
+    virtual void init()
+    {
+        if (get_variant_value()) {
+            modify_config("PROTO_ENABLE", "y");
+        }
+        ucp_test::init();
+    }
+
+protected:
+    static const int COUNT = 100000;
+
+    int count() const
+    {
+        return COUNT / ucs::test_time_multiplier();
+    }
+
+    static void report_rate(const std::string &name, int count, double time)
+    {
+        UCS_TEST_MESSAGE << name << ": " << (count / time / 1e6)
+                         << " Mops/sec, " << (time * UCS_USEC_PER_SEC / count)
+                         << " us per operation";
+    }
+
+    void mem_map(ucp_mem_h *memh_p, void **rkey_buffer_p,
+                 size_t *rkey_size_p)
+    {
+        ucp_mem_map_params_t params;
+
+        params.field_mask = UCP_MEM_MAP_PARAM_FIELD_ADDRESS |
+                            UCP_MEM_MAP_PARAM_FIELD_LENGTH |
+                            UCP_MEM_MAP_PARAM_FIELD_FLAGS;
+        params.address    = NULL;
+        params.length     = 4096;
+        params.flags      = UCP_MEM_MAP_ALLOCATE;
+        ASSERT_UCS_OK(ucp_mem_map(receiver().ucph(), &params, memh_p));
+        ASSERT_UCS_OK(ucp_rkey_pack(receiver().ucph(), *memh_p, rkey_buffer_p,
+                                    rkey_size_p));
+    }
+
+    void mem_unmap(ucp_mem_h memh, void *rkey_buffer)
+    {
+        ucp_rkey_buffer_release(rkey_buffer);
+        ASSERT_UCS_OK(ucp_mem_unmap(receiver().ucph(), memh));
+    }
+
+    void put(ucp_mem_h memh, ucp_rkey_h rkey)
+    {
+        uint64_t data = 0;
+        ucp_request_param_t param;
+        ucp_mem_attr_t attr;
+
+        attr.field_mask = UCP_MEM_ATTR_FIELD_ADDRESS;
+        ASSERT_UCS_OK(ucp_mem_query(memh, &attr));
+
+        param.op_attr_mask = 0;
+        ASSERT_UCS_OK(request_wait(ucp_put_nbx(sender().ep(), &data,
+                                               sizeof(data),
+                                               (uintptr_t)attr.address, rkey,
+                                               &param)));
+        flush_worker(sender());
+    }
+
+    void test_rkey_unpack_rate(const std::string &name)
+    {
+        ucp_mem_h memh;
+        void *rkey_buffer;
+        size_t rkey_size;
+        ucp_rkey_h rkey;
+        double start;
+
+        sender().connect(&receiver(), get_ep_params());
+        mem_map(&memh, &rkey_buffer, &rkey_size);
+
+        ASSERT_UCS_OK(ucp_ep_rkey_unpack(sender().ep(), rkey_buffer, &rkey));
+        ucp_worker_cfg_index_t rkey_cfg_index = rkey->cfg_index;
+        ucp_rkey_destroy(rkey);
+
+        start = ucs_get_accurate_time();
+        for (int i = 0; i < count(); ++i) {
+            ASSERT_UCS_OK(ucp_ep_rkey_unpack(sender().ep(), rkey_buffer, &rkey));
+            if (get_variant_value()) {
+                ASSERT_EQ(rkey_cfg_index, rkey->cfg_index);
+            }
+            ucp_rkey_destroy(rkey);
+        }
+        report_rate(name, count(), ucs_get_accurate_time() - start);
+
+        if (get_variant_value()) {
+            EXPECT_EQ(rkey_cfg_index,
+                      ucp_ep_config(sender().ep())->rkey_cfg_cache.cfg_index);
+        }
+
+        mem_unmap(memh, rkey_buffer);
+    }
+};
+
+UCS_TEST_P(test_ucp_worker_config, ep_config_lookup)
+{
+    sender().connect(&receiver(), get_ep_params());
+
+    ucp_worker_h worker           = sender().worker();
+    ucp_worker_cfg_index_t ep_cfg = sender().ep()->cfg_index;
+    ucp_ep_config_key_t key       = ucp_ep_config(sender().ep())->key;
+    ucp_worker_cfg_index_t cfg_index;
+    double start;
+
+    /* same key is resolved to the existing configuration */
+    start = ucs_get_accurate_time();
+    for (int i = 0; i < count(); ++i) {
+        ASSERT_UCS_OK(ucp_worker_get_ep_config(worker, &key, 0, &cfg_index));
+        ASSERT_EQ(ep_cfg, cfg_index);
+    }
+    report_rate("ep config lookup", count(), ucs_get_accurate_time() - start);
+
+    /* different key creates a new configuration, which is found later */
+    unsigned config_count = worker->ep_config_count;
+    key.err_mode          = (key.err_mode == UCP_ERR_HANDLING_MODE_NONE) ?
+                            UCP_ERR_HANDLING_MODE_PEER :
+                            UCP_ERR_HANDLING_MODE_NONE;
+    ASSERT_UCS_OK(ucp_worker_get_ep_config(worker, &key, 0, &cfg_index));
+    EXPECT_NE(ep_cfg, cfg_index);
+    EXPECT_EQ(config_count + 1, worker->ep_config_count);
+
+    ucp_worker_cfg_index_t new_cfg_index;
+    ASSERT_UCS_OK(ucp_worker_get_ep_config(worker, &key, 0, &new_cfg_index));
+    EXPECT_EQ(cfg_index, new_cfg_index);
+    EXPECT_EQ(config_count + 1, worker->ep_config_count);
+}
+
+UCS_TEST_P(test_ucp_worker_config, ep_create_rate)
+{
+    const int num_eps = ucs_min(64, max_connections() / 2);
+    double start;
+
+    start = ucs_get_accurate_time();
+    for (int i = 0; i < num_eps; ++i) {
+        sender().connect(&receiver(), get_ep_params(), i);
+    }
+    report_rate("ep create", num_eps, ucs_get_accurate_time() - start);
+
+    for (int i = 1; i < num_eps; ++i) {
+        EXPECT_EQ(sender().ep()->cfg_index, sender().ep(0, i)->cfg_index);
+    }
+}
+
+UCS_TEST_P(test_ucp_worker_config, rkey_unpack_rate)
+{
+    test_rkey_unpack_rate("rkey unpack");
+}
+
+UCS_TEST_P(test_ucp_worker_config, rkey_unpack_rate_cached, "RKEY_CACHE_SIZE=16")
+{
+    test_rkey_unpack_rate("cached rkey unpack");
+}
+
+UCS_TEST_P(test_ucp_worker_config, flush_worker_rate)
+{
+    const int max_eps   = ucs_min(64, max_connections() / 2);
+    const int iters     = ucs_max(count() / 100, 1);
+    ucp_worker_h worker = sender().worker();
+    uint64_t data       = 0;
+    ucp_request_param_t param;
+    ucp_mem_attr_t attr;
+    ucp_mem_h memh;
+    void *rkey_buffer;
+    size_t rkey_size;
+    ucp_rkey_h rkey;
+    double start;
+    void *request;
+
+    sender().connect(&receiver(), get_ep_params());
+    mem_map(&memh, &rkey_buffer, &rkey_size);
+    ASSERT_UCS_OK(ucp_ep_rkey_unpack(sender().ep(), rkey_buffer, &rkey));
+
+    attr.field_mask    = UCP_MEM_ATTR_FIELD_ADDRESS;
+    param.op_attr_mask = 0;
+    ASSERT_UCS_OK(ucp_mem_query(memh, &attr));
+
+    /* only the first endpoint issues RMA operations, others are idle */
+    for (int num_eps = 1; num_eps <= max_eps; num_eps *= 4) {
+        for (int i = sender().get_num_eps(); i < num_eps; ++i) {
+            sender().connect(&receiver(), get_ep_params(), i);
+        }
+
+        start = ucs_get_accurate_time();
+        for (int i = 0; i < iters; ++i) {
+            /* worker flush completes the put operation */
+            request = ucp_put_nbx(sender().ep(), &data, sizeof(data),
+                                  (uintptr_t)attr.address, rkey, &param);
+            ASSERT_FALSE(UCS_PTR_IS_ERR(request));
+            if (request != NULL) {
+                ucp_request_free(request);
+            }
+            flush_worker(sender());
+        }
+        report_rate("put and flush worker with " +
+                    ucs::to_string(num_eps) + " endpoints",
+                    iters, ucs_get_accurate_time() - start);
+
+        /* idle endpoints are not tracked by worker flush */
+        EXPECT_LE(ucs_list_length(&worker->dirty_eps), 1ul);
+    }
+
+    ucp_rkey_destroy(rkey);
+    mem_unmap(memh, rkey_buffer);
+}
+
+UCS_TEST_P(test_ucp_worker_config, rkey_cache, "RKEY_CACHE_SIZE=2")
+{
+    static const size_t num_keys = 3;
+    ucp_worker_h worker          = sender().worker();
+    ucp_mem_h memh[num_keys];
+    void *rkey_buffer[num_keys];
+    size_t rkey_size[num_keys];
+    ucp_rkey_h rkey[num_keys], rkey2;
+
+    sender().connect(&receiver(), get_ep_params());
+
+    for (size_t i = 0; i < num_keys; ++i) {
+        mem_map(&memh[i], &rkey_buffer[i], &rkey_size[i]);
+    }
+
+    /* same packed buffer returns the same handle */
+    ASSERT_UCS_OK(ucp_ep_rkey_unpack(sender().ep(), rkey_buffer[0], &rkey[0]));
+    ASSERT_UCS_OK(ucp_ep_rkey_unpack(sender().ep(), rkey_buffer[0], &rkey2));
+    EXPECT_EQ(rkey[0], rkey2);
+    EXPECT_EQ(1u, kh_size(&worker->rkey_cache.hash));
+
+    /* shared handle remains usable after one of the users releases it */
+    ucp_rkey_destroy(rkey2);
+    put(memh[0], rkey[0]);
+
+    /* cache size is bounded, and evicted keys remain valid until released.
+     * Some transports pack identical keys for different regions, which share
+     * a single cache entry. */
+    std::set<std::string> packed_keys;
+    for (size_t i = 0; i < num_keys; ++i) {
+        packed_keys.insert(std::string((const char*)rkey_buffer[i],
+                                       rkey_size[i]));
+    }
+
+    for (size_t i = 1; i < num_keys; ++i) {
+        ASSERT_UCS_OK(ucp_ep_rkey_unpack(sender().ep(), rkey_buffer[i],
+                                         &rkey[i]));
+    }
+    EXPECT_EQ(std::min<size_t>(packed_keys.size(), 2),
+              kh_size(&worker->rkey_cache.hash));
+    put(memh[0], rkey[0]);
+
+    for (size_t i = 0; i < num_keys; ++i) {
+        ucp_rkey_destroy(rkey[i]);
+        mem_unmap(memh[i], rkey_buffer[i]);
+    }
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_worker_config)
@@ -0,0 +1,130 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include <common/test.h>
+extern "C" {
+#include <ucs/stats/counters.h>
+}
+
+#include <pthread.h>
+#include <sstream>
+
+
+class test_counters : public ucs::test {
+protected:
+    enum {
+        COUNTER_OPS,
+        COUNTER_BYTES,
+        COUNTER_DEPTH,
+        COUNTER_LAST
+    };
+
+    static const ucs_counters_class_t counters_class;
+
+    static const unsigned ITERS = 10000;
+
+    virtual void init()
+    {
+        ucs::test::init();
+        ASSERT_UCS_OK(ucs_counters_init(&m_counters, &counters_class));
+    }
+
+    virtual void cleanup()
+    {
+        ucs_counters_cleanup(&m_counters);
+        ucs::test::cleanup();
+    }
+
+    static void *thread_func(void *arg)
+    {
+        ucs_counters_t *counters = (ucs_counters_t*)arg;
+
+        for (unsigned i = 0; i < ITERS; ++i) {
+            ucs_counters_add(counters, COUNTER_OPS, 1);
+            ucs_counters_add(counters, COUNTER_BYTES, 8);
+            ucs_counters_add(counters, COUNTER_DEPTH, 1);
+            ucs_counters_add(counters, COUNTER_DEPTH, -1);
+        }
+        return NULL;
+    }
+
+    void run_threads(unsigned num_threads)
+    {
+        std::vector<pthread_t> threads(num_threads);
+
+        for (unsigned i = 0; i < num_threads; ++i) {
+            int ret = pthread_create(&threads[i], NULL, thread_func,
+                                     &m_counters);
+            ASSERT_EQ(0, ret);
+        }
+
+        for (unsigned i = 0; i < num_threads; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    std::string print(int gauges)
+    {
+        ucs_string_buffer_t strb = UCS_STRING_BUFFER_INITIALIZER;
+
+        ucs_counters_print(&m_counters, gauges, &strb);
+        std::string result(ucs_string_buffer_cstr(&strb));
+        ucs_string_buffer_cleanup(&strb);
+        return result;
+    }
+
+    ucs_counters_t m_counters;
+};
+
+const ucs_counters_class_t test_counters::counters_class = {
+    "test",
+    COUNTER_LAST,
+    UCS_BIT(COUNTER_DEPTH),
+    {"ops", "bytes", "depth"}
+};
+
+UCS_TEST_F(test_counters, add_get) {
+    for (int i = 0; i < 10; ++i) {
+        ucs_counters_add(&m_counters, COUNTER_OPS, 1);
+        ucs_counters_add(&m_counters, COUNTER_BYTES, 100);
+        ucs_counters_add(&m_counters, COUNTER_DEPTH, i % 2 ? -1 : 2);
+    }
+
+    EXPECT_EQ(10,   ucs_counters_get(&m_counters, COUNTER_OPS));
+    EXPECT_EQ(1000, ucs_counters_get(&m_counters, COUNTER_BYTES));
+    EXPECT_EQ(5,    ucs_counters_get(&m_counters, COUNTER_DEPTH));
+
+    EXPECT_EQ("ops 10\nbytes 1000\n", print(0));
+    EXPECT_EQ("depth 5\n", print(1));
+}
+
+UCS_TEST_F(test_counters, multi_thread) {
+    unsigned num_threads = 4;
+
+    run_threads(num_threads);
+    ucs_counters_add(&m_counters, COUNTER_OPS, 1);
+
+    EXPECT_EQ((int64_t)(num_threads * ITERS + 1),
+              ucs_counters_get(&m_counters, COUNTER_OPS));
+    EXPECT_EQ((int64_t)(num_threads * ITERS * 8),
+              ucs_counters_get(&m_counters, COUNTER_BYTES));
+    EXPECT_EQ(0, ucs_counters_get(&m_counters, COUNTER_DEPTH));
+}
+
+UCS_TEST_F(test_counters, slot_overflow) {
+    /* Run more concurrent threads than private slots, so some of them use the
+     * shared block, and then run again to reuse slots of exited threads */
+    unsigned num_threads = UCS_COUNTERS_MAX_THREADS + 8;
+
+    run_threads(num_threads);
+    run_threads(num_threads);
+
+    EXPECT_EQ((int64_t)(2 * num_threads * ITERS),
+              ucs_counters_get(&m_counters, COUNTER_OPS));
+    EXPECT_EQ((int64_t)(2 * num_threads * ITERS * 8),
+              ucs_counters_get(&m_counters, COUNTER_BYTES));
+    EXPECT_EQ(0, ucs_counters_get(&m_counters, COUNTER_DEPTH));
+}
@@ -9,6 +9,7 @@ extern "C" {
 #include <ucs/sys/sys.h>
 #include <ucs/time/time.h>
 #include <ucs/profile/profile.h>
+#include <ucs/vfs/base/vfs_obj.h>
 }
 
 #include <pthread.h>
@@ -361,6 +362,46 @@ UCS_TEST_P(test_profile, log_accum) {
             "log,accum");
 }
 
+UCS_TEST_P(test_profile, log_enable) {
+    const int ITER = 5;
+
+    scoped_profile p(*this, PROFILE_FILENAME, "log");
+    run_profiled_code(ITER);
+
+    /* Records made while the log is paused should not be collected */
+    std::string value = "0";
+    ASSERT_UCS_OK(ucs_vfs_path_write_file("/ucs/profile/log_enable",
+                                          value.c_str(), value.size()));
+    run_profiled_code(ITER);
+
+    value = "1";
+    ASSERT_UCS_OK(ucs_vfs_path_write_file("/ucs/profile/log_enable",
+                                          value.c_str(), value.size()));
+    run_profiled_code(ITER);
+
+    std::string data = p.read();
+    const void *ptr  = &data[0];
+
+    const ucs_profile_header_t *hdr =
+                    reinterpret_cast<const ucs_profile_header_t*>(ptr);
+    ptr = reinterpret_cast<const ucs_profile_location_t*>(hdr + 1) +
+          hdr->num_locations;
+
+    uint64_t num_records = 0;
+    for (unsigned i = 0; i < hdr->num_threads; ++i) {
+        const ucs_profile_thread_header_t *thread_hdr =
+                        reinterpret_cast<const ucs_profile_thread_header_t*>(ptr);
+        num_records += thread_hdr->num_records;
+        ptr = reinterpret_cast<const ucs_profile_record_t*>(
+                      reinterpret_cast<const ucs_profile_thread_location_t*>(
+                              thread_hdr + 1) + hdr->num_locations) +
+              thread_hdr->num_records;
+    }
+
+    EXPECT_EQ(2 * num_threads() * ITER * NUM_LOCAITONS, num_records);
+    EXPECT_EQ(&data[data.size()], ptr) << data.size();
+}
+
 INSTANTIATE_TEST_CASE_P(st, test_profile, ::testing::Values(1));
 INSTANTIATE_TEST_CASE_P(mt, test_profile, ::testing::Values(2, 4, 8));
 
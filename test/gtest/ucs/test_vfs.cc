@@ -254,3 +254,72 @@ UCS_MT_TEST_F(test_vfs_obj, set_dirty_and_refresh, 4) {
     barrier();
     ucs_vfs_obj_remove(&obj);
 }
+
+class test_vfs_obj_rw : public test_vfs_obj {
+public:
+    static void value_show_cb(void *obj, ucs_string_buffer_t *strb)
+    {
+        ucs_string_buffer_appendf(strb, "%d", *static_cast<int*>(obj));
+    }
+
+    static ucs_status_t value_write_cb(void *obj, const char *buffer,
+                                       size_t size)
+    {
+        std::string value(buffer, size);
+
+        if (value.find_first_not_of("0123456789") != std::string::npos) {
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        *static_cast<int*>(obj) = atoi(value.c_str());
+        return UCS_OK;
+    }
+};
+
+UCS_TEST_F(test_vfs_obj_rw, path_write_file) {
+    int obj = 5;
+
+    ucs_vfs_obj_add_dir(NULL, &obj, "obj");
+    ucs_vfs_obj_add_ro_file(&obj, test_vfs_obj::file_show_cb, "info");
+    ucs_vfs_obj_add_rw_file(&obj, value_show_cb, value_write_cb, "value");
+
+    ucs_vfs_path_info_t path_info;
+    ucs_status_t status = ucs_vfs_path_get_info("/obj/value", &path_info);
+    EXPECT_EQ(UCS_OK, status);
+    EXPECT_TRUE(path_info.mode & S_IFREG);
+    EXPECT_TRUE(path_info.mode & S_IWUSR);
+
+    status = ucs_vfs_path_get_info("/obj/info", &path_info);
+    EXPECT_EQ(UCS_OK, status);
+    EXPECT_FALSE(path_info.mode & S_IWUSR);
+
+    std::string value = "42";
+    status = ucs_vfs_path_write_file("/obj/value", value.c_str(),
+                                     value.size());
+    EXPECT_EQ(UCS_OK, status);
+    EXPECT_EQ(42, obj);
+
+    ucs_string_buffer_t strb;
+    ucs_string_buffer_init(&strb);
+    status = ucs_vfs_path_read_file("/obj/value", &strb);
+    EXPECT_EQ(UCS_OK, status);
+    EXPECT_EQ(value, ucs_string_buffer_cstr(&strb));
+    ucs_string_buffer_cleanup(&strb);
+
+    value  = "bad";
+    status = ucs_vfs_path_write_file("/obj/value", value.c_str(),
+                                     value.size());
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, status);
+    EXPECT_EQ(42, obj);
+
+    /* read-only files, directories and invalid paths are not writable */
+    status = ucs_vfs_path_write_file("/obj/info", value.c_str(), value.size());
+    EXPECT_EQ(UCS_ERR_NO_ELEM, status);
+    status = ucs_vfs_path_write_file("/obj", value.c_str(), value.size());
+    EXPECT_EQ(UCS_ERR_NO_ELEM, status);
+    status = ucs_vfs_path_write_file("invalid_path", value.c_str(),
+                                     value.size());
+    EXPECT_EQ(UCS_ERR_NO_ELEM, status);
+
+    ucs_vfs_obj_remove(&obj);
+}